@@ -0,0 +1,74 @@
+﻿#ifndef BATCH_PROCESSOR_H
+#define BATCH_PROCESSOR_H
+
+#include <QVector3D>
+#include <string>
+#include <vector>
+#include <mesh_io.h>
+#include <process_context.h>
+#include <process_params.h>
+
+/**
+ * @brief 一个文件的输入: 扇形三角化后的网格, 与界面程序交给 MeshProcessor::processOBJData 的数据相同
+ */
+struct BatchInput {
+    std::vector<QVector3D> vertices;
+    std::vector<unsigned int> indices;
+};
+
+/// 运行某个作业的 MeshProcessor, 成功时把结果网格写入 output 并返回 true
+using BatchRunFunction = bool (*)(const BatchInput& input, const geometry::ProcessParams& params,
+                                  const geometry::ProcessContext& context, geometry::MeshData& output);
+
+/// 可由命令行设置的参数
+struct BatchParam {
+    const char* name;
+    const char* defaultValue;
+    const char* description;
+};
+
+/**
+ * @brief 按名字注册的处理器
+ * 同一个作业可以注册成多个处理器(例如 hw5 的 tutte/lscm/arap_param), 区别只在 fixedParams。
+ */
+struct BatchProcessor {
+    const char* name;
+    const char* description;
+    std::vector<BatchParam> params;   ///< 可设置的参数及默认值
+    geometry::ProcessParams fixedParams; ///< 固定传给处理器、不能从命令行修改的参数
+    BatchRunFunction run;
+    const char* outputFormat = nullptr;  ///< 没有 -f 时的输出格式, 为空时沿用输入格式
+};
+
+/// 所有注册的处理器, 按名字排序
+const std::vector<BatchProcessor>& batchProcessors();
+
+/// 按名字查找, 不存在时返回 nullptr
+const BatchProcessor* findBatchProcessor(const std::string& name);
+
+/**
+ * @brief 用某个作业的 MeshProcessor 处理一个网格
+ * 处理器提供 setParams 时先传入参数; 结果导出时不带法向(处理后的顶点法向没有重算)。
+ * 处理器写了顶点属性 "v:quality" 时随网格导出(见 exportMeshData)。
+ */
+template <class Processor>
+bool runMeshProcessor(const BatchInput& input, const geometry::ProcessParams& params,
+                      const geometry::ProcessContext& context, geometry::MeshData& output) {
+    Processor processor;
+    if constexpr (requires { processor.setParams(params); }) processor.setParams(params);
+    const auto result = processor.processOBJData(input.vertices, input.indices, context);
+    if (context.isCancelled() || result.first.empty()) return false;
+    geometry::exportMeshData(processor.getMesh(), output, false);
+    return true;
+}
+
+// 各作业的入口, 由 processor_adapter.cpp 按作业分别编译生成
+bool runHw2(const BatchInput&, const geometry::ProcessParams&, const geometry::ProcessContext&, geometry::MeshData&);
+bool runHw3(const BatchInput&, const geometry::ProcessParams&, const geometry::ProcessContext&, geometry::MeshData&);
+bool runHw5(const BatchInput&, const geometry::ProcessParams&, const geometry::ProcessContext&, geometry::MeshData&);
+bool runHw7(const BatchInput&, const geometry::ProcessParams&, const geometry::ProcessContext&, geometry::MeshData&);
+bool runHw8(const BatchInput&, const geometry::ProcessParams&, const geometry::ProcessContext&, geometry::MeshData&);
+bool runHw9(const BatchInput&, const geometry::ProcessParams&, const geometry::ProcessContext&, geometry::MeshData&);
+bool runHw10(const BatchInput&, const geometry::ProcessParams&, const geometry::ProcessContext&, geometry::MeshData&);
+
+#endif // BATCH_PROCESSOR_H
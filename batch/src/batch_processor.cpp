@@ -0,0 +1,53 @@
+﻿#include "batch_processor.h"
+#include <algorithm>
+
+namespace {
+
+geometry::ProcessParams fixed(std::initializer_list<std::pair<const char*, const char*>> entries) {
+    geometry::ProcessParams params;
+    for (const auto& entry : entries) params.set(entry.first, entry.second);
+    return params;
+}
+
+std::vector<BatchProcessor> createProcessors() {
+    std::vector<BatchProcessor> processors = {
+        { "curvature", "hw2 离散曲率(网格不变, 逐顶点曲率写成 PLY 顶点属性 quality)",
+          { { "type", "cotangent", "mean / gaussian / cotangent" } }, {}, runHw2, "ply" },
+        { "denoise", "hw3 双边法向滤波去噪",
+          { { "sigma_r", "0.25", "法向差的权重宽度" }, { "sigma_s", "0.25", "面心距离的权重宽度" } },
+          fixed({ { "method", "bilateral" } }), runHw3 },
+        { "curvature_flow", "hw3 余切拉普拉斯曲率流",
+          { { "step", "0.0001", "每次迭代的步长" } }, fixed({ { "method", "flow" } }), runHw3 },
+        { "tutte", "hw5 Tutte 嵌入(均匀权, 边界映射到单位圆)",
+          {}, fixed({ { "init", "tutte" }, { "refine", "none" } }), runHw5 },
+        { "mvc", "hw7 均值坐标(mean value)权的 Tutte 嵌入", {}, {}, runHw7 },
+        { "lscm", "hw5 最小二乘共形参数化",
+          {}, fixed({ { "init", "lscm" }, { "refine", "none" } }), runHw5 },
+        { "arap_param", "hw5 ARAP 参数化(局部-全局优化)",
+          { { "init", "tutte", "初始参数化 tutte / lscm" } }, fixed({ { "refine", "arap" } }), runHw5 },
+        { "arap_interp", "hw8 以 Tutte 嵌入为目标的 ARAP 插值(局部-全局)",
+          { { "t", "1", "插值参数, 目标 Jacobian 为 R(t*theta)((1-t)I + t*S)" } }, {}, runHw8 },
+        { "qem", "hw9 QEM 网格简化", { { "faces", "100", "简化目标, 与界面程序相同, 按 OpenMesh 的目标顶点数解释" } }, {}, runHw9 },
+        { "smooth", "hw10 拉普拉斯平滑",
+          { { "iterations", "20", "迭代次数" }, { "lambda", "0.9", "平滑系数" },
+            { "precision", "double", "平滑内核的存储精度 double / float" } }, {}, runHw10 },
+    };
+    std::sort(processors.begin(), processors.end(), [](const BatchProcessor& a, const BatchProcessor& b) {
+        return std::string(a.name) < b.name;
+    });
+    return processors;
+}
+
+} // namespace
+
+const std::vector<BatchProcessor>& batchProcessors() {
+    static const std::vector<BatchProcessor> processors = createProcessors();
+    return processors;
+}
+
+const BatchProcessor* findBatchProcessor(const std::string& name) {
+    for (const BatchProcessor& processor : batchProcessors()) {
+        if (name == processor.name) return &processor;
+    }
+    return nullptr;
+}
@@ -0,0 +1,275 @@
+﻿// mesh_batch: 不依赖界面, 用注册的处理器批量处理网格文件
+//
+//   mesh_batch --list
+//   mesh_batch <processor> [-p key=value]... [-o dir] [-f obj|ply|gpmc] [-j jobs] [-q] <file|dir>...
+//
+// 目录只扫描一层, 读取 .obj/.ply/.stl/.gpmc; 结果写到 <dir>/<文件名>.<processor>.<格式>,
+// 格式依次取 -f、处理器注册的输出格式、输入格式(.stl 写成 .obj)。
+// 多个文件在 geometry 的全局线程池上并发处理, 与内核中的并行循环共用同一组线程。
+#include "batch_processor.h"
+#include <mesh_io.h>
+#include <parallel.h>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Options {
+    const BatchProcessor* processor = nullptr;
+    geometry::ProcessParams params;
+    std::vector<std::string> inputs;
+    fs::path outputDir = ".";
+    std::string format;   ///< 为空时用处理器的输出格式, 再没有则沿用输入格式(.stl 输入写成 .obj)
+    unsigned jobs = 0;    ///< 同时处理的文件数, 0 为硬件线程数
+    bool quiet = false;   ///< 屏蔽处理器自身的 std::cout 输出
+};
+
+struct FileResult {
+    bool ok = false;
+    size_t verticesIn = 0, facesIn = 0;
+    size_t verticesOut = 0, facesOut = 0;
+    double milliseconds = 0.0;
+};
+
+std::string lowerExtension(const fs::path& path) {
+    std::string ext = path.extension().string();
+    if (!ext.empty()) ext.erase(0, 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return ext;
+}
+
+bool isMeshFile(const fs::path& path) {
+    const std::string ext = lowerExtension(path);
+    return ext == "obj" || ext == "ply" || ext == "stl" || ext == "gpmc";
+}
+
+void printUsage() {
+    std::cerr << "Usage: mesh_batch --list\n"
+              << "       mesh_batch <processor> [-p key=value]... [-o dir] [-f obj|ply|gpmc] [-j jobs] [-q] <file|dir>...\n"
+              << "  -p key=value  processor parameter (see --list)\n"
+              << "  -o dir        output directory (default: current directory)\n"
+              << "  -f format     output format (default: the processor's, else same as input, .stl -> obj)\n"
+              << "  -j jobs       files processed concurrently (default: hardware threads)\n"
+              << "  -q            silence processor output, print only the per-file report" << std::endl;
+}
+
+void printProcessors() {
+    for (const BatchProcessor& processor : batchProcessors()) {
+        std::cout << processor.name << "  " << processor.description;
+        if (processor.outputFormat) std::cout << "  [writes ." << processor.outputFormat << "]";
+        std::cout << "\n";
+        for (const BatchParam& param : processor.params) {
+            std::cout << "    " << param.name << "=" << param.defaultValue << "  " << param.description << "\n";
+        }
+    }
+    std::cout << std::flush;
+}
+
+bool parseArguments(int argc, char* argv[], Options& options) {
+    if (argc < 2) return false;
+    options.processor = findBatchProcessor(argv[1]);
+    if (!options.processor) {
+        std::cerr << "Error: Unknown processor '" << argv[1] << "' (see mesh_batch --list)" << std::endl;
+        return false;
+    }
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "-p" && hasValue) {
+            if (!options.params.parse(argv[++i])) return false;
+        } else if (arg == "-o" && hasValue) {
+            options.outputDir = argv[++i];
+        } else if (arg == "-f" && hasValue) {
+            options.format = argv[++i];
+            std::transform(options.format.begin(), options.format.end(), options.format.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            if (options.format != "obj" && options.format != "ply" && options.format != "gpmc") {
+                std::cerr << "Error: Unsupported output format '" << options.format << "'" << std::endl;
+                return false;
+            }
+        } else if (arg == "-j" && hasValue) {
+            const int jobs = std::atoi(argv[++i]);
+            if (jobs < 1) {
+                std::cerr << "Error: -j expects a positive number" << std::endl;
+                return false;
+            }
+            options.jobs = static_cast<unsigned>(jobs);
+        } else if (arg == "-q") {
+            options.quiet = true;
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::cerr << "Error: Unknown or incomplete option '" << arg << "'" << std::endl;
+            return false;
+        } else {
+            options.inputs.push_back(arg);
+        }
+    }
+    if (options.inputs.empty()) {
+        std::cerr << "Error: No input files" << std::endl;
+        return false;
+    }
+    for (const auto& entry : options.params.entries()) {
+        const auto& known = options.processor->params;
+        if (std::none_of(known.begin(), known.end(), [&](const BatchParam& p) { return entry.first == p.name; })) {
+            std::cerr << "Error: Processor " << options.processor->name << " has no parameter '" << entry.first << "'" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/// 展开目录(只扫描一层, 按文件名排序), 不存在的输入报错
+bool collectFiles(const std::vector<std::string>& inputs, std::vector<fs::path>& files) {
+    for (const std::string& input : inputs) {
+        std::error_code ec;
+        if (fs::is_directory(input, ec)) {
+            std::vector<fs::path> found;
+            for (const auto& entry : fs::directory_iterator(input, ec)) {
+                if (entry.is_regular_file() && isMeshFile(entry.path())) found.push_back(entry.path());
+            }
+            std::sort(found.begin(), found.end());
+            if (found.empty()) std::cerr << "Warning: No mesh files in " << input << std::endl;
+            files.insert(files.end(), found.begin(), found.end());
+        } else if (fs::is_regular_file(input, ec)) {
+            files.emplace_back(input);
+        } else {
+            std::cerr << "Error: Cannot find " << input << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/// 多边形按扇形三角化: (c0, ck, ck+1)
+void triangulate(const geometry::MeshData& data, BatchInput& input) {
+    const size_t vertexCount = data.getVertexCount();
+    input.vertices.resize(vertexCount);
+    for (size_t i = 0; i < vertexCount; ++i) {
+        input.vertices[i] = QVector3D(data.positions[3 * i], data.positions[3 * i + 1], data.positions[3 * i + 2]);
+    }
+    input.indices.clear();
+    input.indices.reserve((data.getCornerCount() - 2 * data.getFaceCount()) * 3);
+    for (size_t f = 0; f < data.getFaceCount(); ++f) {
+        const std::uint32_t begin = data.faceOffsets[f];
+        const std::uint32_t end = data.faceOffsets[f + 1];
+        for (std::uint32_t k = begin + 1; k + 1 < end; ++k) {
+            input.indices.push_back(static_cast<unsigned int>(data.faceVertices[begin]));
+            input.indices.push_back(static_cast<unsigned int>(data.faceVertices[k]));
+            input.indices.push_back(static_cast<unsigned int>(data.faceVertices[k + 1]));
+        }
+    }
+}
+
+FileResult processFile(const fs::path& path, const fs::path& outputPath, const Options& options,
+                       const geometry::ProcessParams& params) {
+    FileResult result;
+    const auto start = std::chrono::steady_clock::now();
+    geometry::MeshData data;
+    if (!geometry::readMesh(path.string(), data)) return result;
+    BatchInput input;
+    triangulate(data, input);
+    result.verticesIn = input.vertices.size();
+    result.facesIn = input.indices.size() / 3;
+    data.clear();
+
+    geometry::MeshData output;
+    if (!options.processor->run(input, params, geometry::ProcessContext(), output)) {
+        std::cerr << "Error: " << options.processor->name << " failed on " << path.string() << std::endl;
+        return result;
+    }
+    result.verticesOut = output.getVertexCount();
+    result.facesOut = output.getFaceCount();
+    result.ok = geometry::writeMesh(outputPath.string(), output);
+    result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc == 2 && std::string(argv[1]) == "--list") {
+        printProcessors();
+        return 0;
+    }
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+    std::vector<fs::path> files;
+    if (!collectFiles(options.inputs, files)) return 2;
+    if (files.empty()) return 0;
+
+    // 输出文件名: <文件名>.<processor>.<格式>, 不同目录的同名文件会互相覆盖, 提前拒绝
+    std::vector<fs::path> outputs;
+    std::set<fs::path> seen;
+    for (const fs::path& file : files) {
+        std::string format = !options.format.empty() ? options.format
+                           : options.processor->outputFormat ? options.processor->outputFormat
+                           : lowerExtension(file);
+        if (format == "stl") format = "obj";
+        outputs.push_back(options.outputDir / (file.stem().string() + "." + options.processor->name + "." + format));
+        if (!seen.insert(outputs.back()).second) {
+            std::cerr << "Error: Several inputs would be written to " << outputs.back().string() << std::endl;
+            return 2;
+        }
+    }
+    std::error_code ec;
+    fs::create_directories(options.outputDir, ec);
+    if (ec) {
+        std::cerr << "Error: Cannot create " << options.outputDir.string() << ": " << ec.message() << std::endl;
+        return 2;
+    }
+
+    // 参数 = 注册的默认值 + 固定参数 + 命令行参数
+    geometry::ProcessParams params;
+    for (const BatchParam& param : options.processor->params) params.set(param.name, param.defaultValue);
+    for (const auto& entry : options.processor->fixedParams.entries()) params.set(entry.first, entry.second);
+    for (const auto& entry : options.params.entries()) params.set(entry.first, entry.second);
+
+    // 报告始终写到原来的标准输出; -q 时处理器自己的 std::cout 输出被丢弃
+    std::ostream report(std::cout.rdbuf());
+    if (options.quiet) std::cout.rdbuf(nullptr);
+
+    const unsigned jobs = options.jobs > 0 ? options.jobs : geometry::parallel::hardwareThreads();
+    const unsigned tasks = static_cast<unsigned>(std::min<size_t>(jobs, files.size()));
+    std::vector<FileResult> results(files.size());
+    std::atomic<size_t> next { 0 };
+    std::atomic<size_t> finished { 0 };
+    std::mutex reportMutex;
+    const auto start = std::chrono::steady_clock::now();
+    geometry::parallel::runTasks(tasks, [&](unsigned) {
+        for (size_t i = next.fetch_add(1); i < files.size(); i = next.fetch_add(1)) {
+            results[i] = processFile(files[i], outputs[i], options, params);
+            const FileResult& r = results[i];
+            std::lock_guard<std::mutex> lock(reportMutex);
+            report << "[" << ++finished << "/" << files.size() << "] " << files[i].string();
+            if (r.ok) {
+                report << " -> " << outputs[i].string() << "  " << r.verticesIn << "/" << r.facesIn
+                       << " -> " << r.verticesOut << "/" << r.facesOut << " v/f  "
+                       << std::fixed << std::setprecision(1) << r.milliseconds << " ms" << std::endl;
+            } else {
+                report << "  FAILED" << std::endl;
+            }
+        }
+    });
+    const double total = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (options.quiet) std::cout.rdbuf(report.rdbuf());
+    const size_t failed = std::count_if(results.begin(), results.end(), [](const FileResult& r) { return !r.ok; });
+    std::cout << options.processor->name << ": " << files.size() - failed << " succeeded, " << failed << " failed, "
+              << std::fixed << std::setprecision(1) << total << " ms with " << tasks << " concurrent file(s)" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,10 @@
+﻿// 本文件对每个作业各编译一次(见 batch/CMakeLists.txt):
+// 编译时 MeshProcessor 被定义为该作业独有的类名, BATCH_RUN_FUNCTION 为对应的 runHwN,
+// 这样各作业同名的 MeshProcessor 可以链接进同一个程序。
+#include "mesh_processor.h"
+#include "batch_processor.h"
+
+bool BATCH_RUN_FUNCTION(const BatchInput& input, const geometry::ProcessParams& params,
+                        const geometry::ProcessContext& context, geometry::MeshData& output) {
+    return runMeshProcessor<MeshProcessor>(input, params, context, output);
+}
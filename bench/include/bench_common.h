@@ -0,0 +1,98 @@
+﻿#ifndef GEOMETRY_BENCH_COMMON_H
+#define GEOMETRY_BENCH_COMMON_H
+
+#include <Eigen/Core>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace geometry {
+class HalfEdgeMesh;
+}
+
+/**
+ * @brief 合成三角网格: 扁平的位置数组(xyz)和三角形索引, 可以直接交给 buildFromArrays
+ */
+struct SyntheticMesh {
+    std::vector<float> positions;
+    std::vector<std::uint32_t> indices;
+
+    size_t vertexCount() const { return positions.size() / 3; }
+    size_t triangleCount() const { return indices.size() / 3; }
+
+    /// 转成 buildFromOBJ / MeshKernel::build 的输入
+    std::vector<Eigen::Vector3d> vertexPositions() const;
+    std::vector<std::vector<int>> faceIndices() const;
+};
+
+/// n x n 个正方形的平面网格, 每个正方形分成两个三角形, z 带确定性的小起伏(面不共面)
+SyntheticMesh makeGrid(int n);
+
+/// 闭合环面, rings x sides 个正方形(主半径 10, 管半径 3)
+SyntheticMesh makeTorus(int rings, int sides);
+
+/**
+ * @brief 经纬网格球面, n x n 个正方形, 极点和经线接缝处开口(有边界)
+ * 半径带低频起伏, noise > 0 时再叠加标准差为 noise 的高斯噪声(模拟扫描数据)
+ */
+SyntheticMesh makeSphere(int n, float noise = 0.0f, unsigned seed = 1);
+
+/// 把顶点、面和半边随机打乱并按新顺序重新分配元素对象(模拟无序的输入文件)
+void shuffleMesh(geometry::HalfEdgeMesh& mesh, unsigned seed);
+
+/// 由 geometry_bench.cpp 中替换的全局 operator new 统计的分配次数
+size_t allocationCount();
+
+inline double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/// 运行 repeats 次, 返回最短耗时(毫秒)
+template <class F>
+double bestOf(int repeats, F&& f) {
+    double best = std::numeric_limits<double>::infinity();
+    for (int r = 0; r < repeats; ++r) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        best = std::min(best, elapsedMs(start));
+    }
+    return best;
+}
+
+inline double megabytes(size_t bytes) {
+    return bytes / (1024.0 * 1024.0);
+}
+
+/// 让只用于计时的计算结果保持"被使用", 避免整个循环被优化掉
+inline volatile double benchSink = 0.0;
+inline void doNotOptimize(double value) {
+    benchSink = value;
+}
+
+/**
+ * @brief 一组基准测试, 按名字从命令行选择
+ * 结果表写到 report; 库自身的 std::cout 输出在运行期间被丢弃
+ */
+struct BenchSuite {
+    const char* name;
+    const char* description;
+    void (*run)(std::ostream& report);
+};
+
+void runKernelBench(std::ostream& report);
+void runPairingBench(std::ostream& report);
+void runNormalsBench(std::ostream& report);
+void runCirculatorBench(std::ostream& report);
+void runPrecisionBench(std::ostream& report);
+void runBuildBench(std::ostream& report);
+void runCodecBench(std::ostream& report);
+void runReorderBench(std::ostream& report);
+void runGarbageCollectionBench(std::ostream& report);
+void runStreamBench(std::ostream& report);
+void runCacheBench(std::ostream& report);
+
+#endif // GEOMETRY_BENCH_COMMON_H
@@ -0,0 +1,33 @@
+﻿// build: 从 Qt 顶点/索引数组构建半边网格的两条路径
+#include "bench_common.h"
+#include <halfedge.h>
+#include <mesh_converter.h>
+#include <iomanip>
+#include <ostream>
+
+void runBuildBench(std::ostream& report) {
+    const SyntheticMesh grid = makeGrid(500);
+    std::vector<QVector3D> vertices(grid.vertexCount());
+    for (size_t v = 0; v < vertices.size(); ++v) {
+        vertices[v] = QVector3D(grid.positions[3 * v], grid.positions[3 * v + 1], grid.positions[3 * v + 2]);
+    }
+    const std::vector<unsigned int> indices(grid.indices.begin(), grid.indices.end());
+    report << "triangulated grid 500x500: " << grid.vertexCount() << " vertices, "
+           << grid.triangleCount() << " triangles" << std::endl;
+
+    auto measure = [&](const char* name, auto&& build) {
+        geometry::HalfEdgeMesh mesh;
+        const size_t before = allocationCount();
+        const double ms = bestOf(1, [&] { build(mesh); });
+        const size_t count = allocationCount() - before;
+        report << "  " << std::left << std::setw(58) << name << std::right << std::setw(10) << count
+               << " allocations" << std::fixed << std::setprecision(1) << std::setw(8) << ms << " ms" << std::endl;
+    };
+    measure("convertQtToEigen + convertIndicesToFaces + buildFromOBJ", [&](geometry::HalfEdgeMesh& mesh) {
+        mesh.buildFromOBJ(geometry::MeshConverter::convertQtToEigen(vertices),
+                          geometry::MeshConverter::convertIndicesToFaces(indices));
+    });
+    measure("buildMeshFromQtData (spans)", [&](geometry::HalfEdgeMesh& mesh) {
+        geometry::MeshConverter::buildMeshFromQtData(mesh, vertices, indices);
+    });
+}
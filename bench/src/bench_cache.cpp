@@ -0,0 +1,102 @@
+﻿// cache: 半边缓存的写入和映射, 以及处理函数由缓存与由数组构建半边网格的耗时和一致性(在系统临时目录中读写 OBJ 和缓存)
+#include "bench_common.h"
+#include <halfedge.h>
+#include <mesh_cache.h>
+#include <mesh_converter.h>
+#include <mesh_io.h>
+#include <filesystem>
+#include <iomanip>
+#include <ostream>
+#include <string>
+
+namespace {
+
+/// 两个网格的位置和所有连接关系(按数组下标)是否完全相同
+bool sameMesh(const geometry::HalfEdgeMesh& a, const geometry::HalfEdgeMesh& b) {
+    if (a.vertices.size() != b.vertices.size() || a.faces.size() != b.faces.size() ||
+        a.halfEdges.size() != b.halfEdges.size()) {
+        return false;
+    }
+    auto index = [](const auto* element) { return element ? element->index : -1; };
+    for (size_t v = 0; v < a.vertices.size(); ++v) {
+        if (a.vertices[v]->position != b.vertices[v]->position ||
+            index(a.vertices[v]->halfEdge) != index(b.vertices[v]->halfEdge)) {
+            return false;
+        }
+    }
+    for (size_t f = 0; f < a.faces.size(); ++f) {
+        if (index(a.faces[f]->halfEdge) != index(b.faces[f]->halfEdge)) return false;
+    }
+    for (size_t h = 0; h < a.halfEdges.size(); ++h) {
+        const geometry::HalfEdge* x = a.halfEdges[h].get();
+        const geometry::HalfEdge* y = b.halfEdges[h].get();
+        if (index(x->vertex) != index(y->vertex) || index(x->face) != index(y->face) || index(x->next) != index(y->next) ||
+            index(x->prev) != index(y->prev) || index(x->pair) != index(y->pair)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+void runCacheBench(std::ostream& report) {
+    const SyntheticMesh grid = makeGrid(700);
+    std::vector<QVector3D> vertices(grid.vertexCount());
+    for (size_t v = 0; v < vertices.size(); ++v) {
+        vertices[v] = QVector3D(grid.positions[3 * v], grid.positions[3 * v + 1], grid.positions[3 * v + 2]);
+    }
+    const std::vector<unsigned int> indices(grid.indices.begin(), grid.indices.end());
+    report << "triangulated grid 700x700: " << grid.vertexCount() << " vertices, "
+           << grid.triangleCount() << " triangles" << std::endl;
+
+    const std::filesystem::path dir = std::filesystem::temp_directory_path();
+    const std::string objPath = (dir / "geometry_bench_cache.obj").string();
+    const std::string cachePath = geometry::meshCachePath(objPath);
+    geometry::MeshData data;
+    data.positions = grid.positions;
+    data.faceVertices.assign(grid.indices.begin(), grid.indices.end());
+    data.faceOffsets.resize(grid.triangleCount() + 1);
+    for (size_t f = 0; f < data.faceOffsets.size(); ++f) data.faceOffsets[f] = static_cast<std::uint32_t>(3 * f);
+
+    // 第一次打开: 解析文本, 由数组构建(配对半边)并写缓存; 之后打开只映射缓存, 处理函数由缓存构建
+    geometry::MeshData parsed;
+    geometry::HalfEdgeMesh fromArrays, fromCache;
+    geometry::MeshCache cache;
+    bool ok = geometry::writeOBJ(objPath, data);
+    double parseMs = 0.0, arraysMs = 0.0, writeMs = 0.0, mapMs = 0.0, cacheMs = 0.0;
+    if (ok) parseMs = bestOf(1, [&] { ok = geometry::readOBJ(objPath, parsed); });
+    arraysMs = bestOf(3, [&] { geometry::MeshConverter::buildMeshFromQtData(fromArrays, vertices, indices); });
+    if (ok) writeMs = bestOf(1, [&] { ok = geometry::writeMeshCache(cachePath, fromArrays, objPath); });
+    if (ok) mapMs = bestOf(3, [&] { ok = cache.open(cachePath) && cache.matchesSource(objPath); });
+    if (ok) cacheMs = bestOf(3, [&] { geometry::MeshConverter::buildMeshFromQtData(fromCache, vertices, indices, &cache); });
+    const size_t cacheBytes = ok ? static_cast<size_t>(cache.header().fileSize) : 0;
+
+    // 移动一个顶点后缓存不再对应这份网格, 应当被忽略(位置取自输入)
+    std::vector<QVector3D> moved = vertices;
+    moved[0].setX(moved[0].x() + 1.0f);
+    geometry::HalfEdgeMesh fromMoved;
+    if (ok) geometry::MeshConverter::buildMeshFromQtData(fromMoved, moved, indices, &cache);
+    const bool rejected = ok && fromMoved.vertices[0]->position.x() == static_cast<double>(moved[0].x());
+
+    cache.close();
+    std::error_code ec;
+    std::filesystem::remove(objPath, ec);
+    std::filesystem::remove(cachePath, ec);
+    if (!ok) {
+        report << "  FAILED to write or read the OBJ / cache in " << dir.string() << std::endl;
+        return;
+    }
+
+    auto row = [&](const char* name, double ms) -> std::ostream& {
+        return report << "  " << std::left << std::setw(44) << name << std::right << std::fixed << std::setprecision(1)
+                      << std::setw(10) << ms << " ms";
+    };
+    row("readOBJ (text parse, first open)", parseMs) << std::endl;
+    row("buildMeshFromQtData without cache", arraysMs) << "  (pairs half-edges)" << std::endl;
+    row("writeMeshCache (first open)", writeMs) << "  (" << megabytes(cacheBytes) << " MB)" << std::endl;
+    row("MeshCache::open + matchesSource", mapMs) << std::endl;
+    row("buildMeshFromQtData with cache", cacheMs) << "  ("
+        << (sameMesh(fromArrays, fromCache) ? "identical to the build without cache" : "DIFFERENT") << ")" << std::endl;
+    report << "  cache after moving a vertex: " << (rejected ? "ignored" : "USED") << std::endl;
+}
@@ -0,0 +1,56 @@
+﻿// circulators: 一环邻域遍历, 临时 vector 与不分配内存的循环器
+#include "bench_common.h"
+#include <halfedge.h>
+#include <circulators.h>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+void runCirculatorBench(std::ostream& report) {
+    const SyntheticMesh grid = makeGrid(500);
+    geometry::HalfEdgeMesh mesh;
+    mesh.buildFromArrays(grid.positions, grid.indices);
+    report << "triangulated grid 500x500: " << mesh.getVertexCount() << " vertices" << std::endl;
+
+    // 旧的作业代码: 每个顶点先把一环邻接顶点收集到临时 vector 再使用
+    Eigen::Vector3d vectorSum = Eigen::Vector3d::Zero();
+    size_t vectorNeighbors = 0;
+    size_t before = allocationCount();
+    const double vectorMs = bestOf(1, [&] {
+        for (const auto& vertex : mesh.vertices) {
+            std::vector<geometry::Vertex*> ring;
+            geometry::HalfEdge* start = vertex->halfEdge;
+            geometry::HalfEdge* he = start;
+            while (he) {
+                ring.push_back(he->next->vertex);
+                he = he->pair ? he->pair->next : nullptr;
+                if (he == start) break;
+            }
+            for (geometry::Vertex* neighbor : ring) vectorSum += neighbor->position;
+            vectorNeighbors += ring.size();
+        }
+    });
+    const size_t vectorAllocations = allocationCount() - before;
+
+    Eigen::Vector3d ringSum = Eigen::Vector3d::Zero();
+    size_t ringNeighbors = 0;
+    before = allocationCount();
+    const double ringMs = bestOf(1, [&] {
+        for (const auto& vertex : mesh.vertices) {
+            for (geometry::Vertex* neighbor : geometry::vertexVertices(vertex.get())) {
+                ringSum += neighbor->position;
+                ++ringNeighbors;
+            }
+        }
+    });
+    const size_t ringAllocations = allocationCount() - before;
+
+    // 循环器额外给出边界顶点通过入边才能到达的最后一个邻接顶点, 所以邻接数略多
+    report << "  one-ring gather        allocations      time  neighbours" << std::endl;
+    report << std::fixed << std::setprecision(2)
+           << "  std::vector per vertex " << std::setw(11) << vectorAllocations << std::setw(7) << vectorMs << " ms"
+           << std::setw(12) << vectorNeighbors << std::endl
+           << "  vertexVertices         " << std::setw(11) << ringAllocations << std::setw(7) << ringMs << " ms"
+           << std::setw(12) << ringNeighbors << std::endl;
+    doNotOptimize(vectorSum.norm() + ringSum.norm());
+}
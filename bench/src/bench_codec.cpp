@@ -0,0 +1,44 @@
+﻿// codec: .gpmc 压缩率和解码速度
+#include "bench_common.h"
+#include <halfedge.h>
+#include <mesh_codec.h>
+#include <mesh_io.h>
+#include <iomanip>
+#include <ostream>
+
+void runCodecBench(std::ostream& report) {
+    // 带高斯噪声的球面近似扫描数据: 噪声让位置残差不能被完全预测
+    const SyntheticMesh sphere = makeSphere(700, 2e-4f, 1);
+    geometry::HalfEdgeMesh mesh;
+    mesh.buildFromArrays(sphere.positions, sphere.indices);
+    const size_t nV = mesh.getVertexCount();
+    const size_t nF = mesh.getFaceCount();
+    // 二进制 PLY 的数据部分: 每个顶点 3 个 float, 每个面 1 字节计数 + 3 个 int
+    const size_t plyBytes = 12 * nV + 13 * nF;
+    report << "noisy sphere 700x700: " << nV << " vertices, " << nF << " triangles, binary PLY "
+           << std::fixed << std::setprecision(1) << plyBytes / (1024.0 * 1024.0) << " MB" << std::endl;
+    report << "  bits  block      size   bits/tri  ratio    encode    decode  Mtri/s" << std::endl;
+
+    for (int bits : { 14, 16 }) {
+        for (size_t blockFaces : { size_t(1) << 14, size_t(1) << 16, size_t(1) << 18 }) {
+            geometry::MeshCodecOptions options;
+            options.positionBits = bits;
+            options.blockFaces = blockFaces;
+            std::vector<std::uint8_t> bytes;
+            const double encodeMs = bestOf(1, [&] { geometry::encodeMesh(mesh, bytes, options); });
+            geometry::MeshData decoded;
+            bool ok = true;
+            const double decodeMs = bestOf(3, [&] { ok = geometry::decodeMesh(bytes.data(), bytes.size(), decoded) && ok; });
+            ok = ok && decoded.getFaceCount() == nF;
+
+            report << std::fixed << std::setw(6) << bits << std::setw(6) << (blockFaces >> 10) << "k"
+                   << std::setprecision(2) << std::setw(8) << bytes.size() / (1024.0 * 1024.0) << " MB"
+                   << std::setprecision(1) << std::setw(9) << 8.0 * bytes.size() / nF
+                   << std::setw(6) << static_cast<double>(plyBytes) / bytes.size() << "x"
+                   << std::setprecision(0) << std::setw(7) << encodeMs << " ms"
+                   << std::setw(7) << decodeMs << " ms"
+                   << std::setprecision(1) << std::setw(8) << nF / decodeMs / 1000.0
+                   << (ok ? "" : "  DECODE FAILED") << std::endl;
+        }
+    }
+}
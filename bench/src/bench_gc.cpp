@@ -0,0 +1,74 @@
+﻿// gc: garbageCollection 在只标记了半边(边折叠/翻转的写法)时的一致性和耗时
+#include "bench_common.h"
+#include <halfedge.h>
+#include <iomanip>
+#include <ostream>
+#include <random>
+#include <unordered_set>
+
+namespace {
+
+/// 回收后所有存活元素的指针都必须指向数组中的元素, 且 index 等于下标; 只比较地址, 不解引用可能已释放的对象
+bool isConsistent(const geometry::HalfEdgeMesh& mesh) {
+    std::unordered_set<const void*> live;
+    for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+        if (mesh.vertices[i]->deleted || mesh.vertices[i]->index != static_cast<int>(i)) return false;
+        live.insert(mesh.vertices[i].get());
+    }
+    for (size_t i = 0; i < mesh.faces.size(); ++i) {
+        if (mesh.faces[i]->deleted || mesh.faces[i]->index != static_cast<int>(i)) return false;
+        live.insert(mesh.faces[i].get());
+    }
+    for (size_t i = 0; i < mesh.halfEdges.size(); ++i) {
+        if (mesh.halfEdges[i]->deleted || mesh.halfEdges[i]->index != static_cast<int>(i)) return false;
+        live.insert(mesh.halfEdges[i].get());
+    }
+    auto isLive = [&](const void* p) { return p && live.count(p); };
+    for (const auto& v : mesh.vertices) {
+        if (!isLive(v->halfEdge) || v->halfEdge->vertex != v.get()) return false;
+    }
+    for (const auto& f : mesh.faces) {
+        if (!isLive(f->halfEdge) || f->halfEdge->face != f.get()) return false;
+    }
+    for (const auto& he : mesh.halfEdges) {
+        if (!isLive(he->vertex) || !isLive(he->face) || !isLive(he->next) || !isLive(he->prev)) return false;
+        if (he->pair && (!isLive(he->pair) || he->pair->pair != he.get())) return false;
+        if (he->next->prev != he.get() || he->next->face != he->face) return false;
+    }
+    return mesh.isValid();
+}
+
+const char* verdict(bool ok) {
+    return ok ? "consistent" : "INCONSISTENT";
+}
+
+} // namespace
+
+void runGarbageCollectionBench(std::ostream& report) {
+    // 两个三角形共享一条边, 只删除第一条半边: 它所在的面必须一起被回收
+    {
+        const std::vector<float> positions = { 0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0 };
+        const std::vector<std::uint32_t> indices = { 0, 1, 2, 0, 2, 3 };
+        geometry::HalfEdgeMesh mesh;
+        mesh.buildFromArrays(positions, indices);
+        mesh.halfEdges[0]->deleted = true;
+        mesh.garbageCollection();
+        report << "two triangles, lone half-edge deleted: " << mesh.getVertexCount() << " vertices, "
+               << mesh.getFaceCount() << " faces left  (" << verdict(isConsistent(mesh) && mesh.getFaceCount() == 1)
+               << ")" << std::endl;
+    }
+
+    // 网格中随机标记 1% 的半边, 分别用原顺序和局部性重排回收
+    const SyntheticMesh grid = makeGrid(500);
+    for (bool reorder : { false, true }) {
+        geometry::HalfEdgeMesh mesh;
+        mesh.buildFromArrays(grid.positions, grid.indices);
+        std::mt19937 rng(11);
+        std::uniform_int_distribution<size_t> pick(0, mesh.halfEdges.size() - 1);
+        for (size_t k = 0; k < mesh.halfEdges.size() / 100; ++k) mesh.halfEdges[pick(rng)]->deleted = true;
+        const double ms = bestOf(1, [&] { mesh.garbageCollection(reorder); });
+        report << "grid 500x500, 1% half-edges deleted, " << (reorder ? "reordered  " : "in order   ")
+               << std::fixed << std::setprecision(1) << std::setw(8) << ms << " ms  ("
+               << verdict(isConsistent(mesh)) << ", " << mesh.getFaceCount() << " faces left)" << std::endl;
+    }
+}
@@ -0,0 +1,44 @@
+﻿// kernel: 指针风格 HalfEdgeMesh 与下标风格 MeshKernel / TriangleMesh 的内存和耗时
+#include "bench_common.h"
+#include <halfedge.h>
+#include <mesh_kernel.h>
+#include <tri_mesh.h>
+#include <iomanip>
+#include <ostream>
+
+namespace {
+
+void printRow(std::ostream& report, const char* name, size_t bytes, double buildMs, double normalsMs) {
+    report << "  " << std::left << std::setw(14) << name << std::right << std::fixed
+           << std::setprecision(1) << std::setw(9) << megabytes(bytes) << " MB"
+           << std::setw(10) << buildMs << " ms" << std::setw(10) << normalsMs << " ms" << std::endl;
+}
+
+} // namespace
+
+void runKernelBench(std::ostream& report) {
+    const SyntheticMesh grid = makeGrid(500);
+    const auto positions = grid.vertexPositions();
+    const auto faces = grid.faceIndices();
+    report << "triangulated grid 500x500: " << grid.vertexCount() << " vertices, "
+           << grid.triangleCount() << " triangles" << std::endl;
+    report << "  structure        memory       build  vertex normals" << std::endl;
+
+    geometry::HalfEdgeMesh mesh;
+    const double meshBuild = bestOf(1, [&] { mesh.buildFromOBJ(positions, faces); });
+    const double meshNormals = bestOf(3, [&] { mesh.computeNormals(); });
+    printRow(report, "HalfEdgeMesh", mesh.memoryUsage(), meshBuild, meshNormals);
+    mesh.clear();
+
+    std::vector<Eigen::Vector3d> normals;
+    geometry::MeshKernel kernel;
+    const double kernelBuild = bestOf(1, [&] { kernel.build(positions, faces); });
+    const double kernelNormals = bestOf(3, [&] { kernel.computeVertexNormals(normals); });
+    printRow(report, "MeshKernel", kernel.memoryUsage(), kernelBuild, kernelNormals);
+    kernel.clear();
+
+    geometry::TriangleMesh triangles;
+    const double triangleBuild = bestOf(1, [&] { triangles.build(positions, faces); });
+    const double triangleNormals = bestOf(3, [&] { triangles.computeVertexNormals(normals); });
+    printRow(report, "TriangleMesh", triangles.memoryUsage(), triangleBuild, triangleNormals);
+}
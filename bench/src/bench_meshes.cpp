@@ -0,0 +1,106 @@
+﻿#include "bench_common.h"
+#include <halfedge.h>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+namespace {
+
+/// 为 rows x cols 个正方形的参数网格生成三角形; wrapRows/wrapCols 为 true 时该方向首尾相连, 顶点少一排
+void appendQuads(SyntheticMesh& mesh, int rows, int cols, bool wrapRows, bool wrapCols) {
+    const int stride = wrapCols ? cols : cols + 1;
+    const int rowCount = wrapRows ? rows : rows + 1;
+    auto id = [&](int i, int j) {
+        return static_cast<std::uint32_t>((i % rowCount) * stride + (j % stride));
+    };
+    mesh.indices.reserve(static_cast<size_t>(rows) * cols * 6);
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            const std::uint32_t a = id(i, j), b = id(i, j + 1), c = id(i + 1, j + 1), d = id(i + 1, j);
+            mesh.indices.insert(mesh.indices.end(), { a, b, c, a, c, d });
+        }
+    }
+}
+
+} // namespace
+
+std::vector<Eigen::Vector3d> SyntheticMesh::vertexPositions() const {
+    std::vector<Eigen::Vector3d> result(vertexCount());
+    for (size_t v = 0; v < result.size(); ++v) {
+        result[v] = Eigen::Vector3d(positions[3 * v], positions[3 * v + 1], positions[3 * v + 2]);
+    }
+    return result;
+}
+
+std::vector<std::vector<int>> SyntheticMesh::faceIndices() const {
+    std::vector<std::vector<int>> result(triangleCount());
+    for (size_t f = 0; f < result.size(); ++f) {
+        result[f] = { static_cast<int>(indices[3 * f]), static_cast<int>(indices[3 * f + 1]),
+                      static_cast<int>(indices[3 * f + 2]) };
+    }
+    return result;
+}
+
+SyntheticMesh makeGrid(int n) {
+    SyntheticMesh mesh;
+    mesh.positions.reserve(static_cast<size_t>(n + 1) * (n + 1) * 3);
+    for (int i = 0; i <= n; ++i) {
+        for (int j = 0; j <= n; ++j) {
+            mesh.positions.insert(mesh.positions.end(),
+                                  { static_cast<float>(j), static_cast<float>(i), 0.1f * ((i * 7 + j * 3) % 5) });
+        }
+    }
+    appendQuads(mesh, n, n, false, false);
+    return mesh;
+}
+
+SyntheticMesh makeTorus(int rings, int sides) {
+    const double R = 10.0, r = 3.0;
+    SyntheticMesh mesh;
+    mesh.positions.reserve(static_cast<size_t>(rings) * sides * 3);
+    for (int i = 0; i < rings; ++i) {
+        for (int j = 0; j < sides; ++j) {
+            const double u = 2.0 * M_PI * i / rings, v = 2.0 * M_PI * j / sides;
+            mesh.positions.insert(mesh.positions.end(), {
+                static_cast<float>((R + r * std::cos(v)) * std::cos(u)),
+                static_cast<float>((R + r * std::cos(v)) * std::sin(u)),
+                static_cast<float>(r * std::sin(v)) });
+        }
+    }
+    appendQuads(mesh, rings, sides, true, true);
+    return mesh;
+}
+
+SyntheticMesh makeSphere(int n, float noise, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> gauss(0.0f, noise > 0.0f ? noise : 1.0f);
+    SyntheticMesh mesh;
+    mesh.positions.reserve(static_cast<size_t>(n + 1) * (n + 1) * 3);
+    for (int i = 0; i <= n; ++i) {
+        for (int j = 0; j <= n; ++j) {
+            const double theta = M_PI * (i + 0.5) / (n + 1), phi = 2.0 * M_PI * j / (n + 1);
+            double radius = 1.0 + 0.05 * std::sin(7 * theta) * std::cos(9 * phi);
+            if (noise > 0.0f) radius += gauss(rng);
+            mesh.positions.insert(mesh.positions.end(), {
+                static_cast<float>(radius * std::sin(theta) * std::cos(phi)),
+                static_cast<float>(radius * std::sin(theta) * std::sin(phi)),
+                static_cast<float>(radius * std::cos(theta)) });
+        }
+    }
+    appendQuads(mesh, n, n, false, false);
+    return mesh;
+}
+
+void shuffleMesh(geometry::HalfEdgeMesh& mesh, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::vector<int> vertexOrder(mesh.getVertexCount());
+    std::vector<int> faceOrder(mesh.getFaceCount());
+    std::vector<int> halfEdgeOrder(mesh.getHalfEdgeCount());
+    std::iota(vertexOrder.begin(), vertexOrder.end(), 0);
+    std::iota(faceOrder.begin(), faceOrder.end(), 0);
+    std::iota(halfEdgeOrder.begin(), halfEdgeOrder.end(), 0);
+    std::shuffle(vertexOrder.begin(), vertexOrder.end(), rng);
+    std::shuffle(faceOrder.begin(), faceOrder.end(), rng);
+    std::shuffle(halfEdgeOrder.begin(), halfEdgeOrder.end(), rng);
+    mesh.permute(vertexOrder, faceOrder, halfEdgeOrder, true);
+}
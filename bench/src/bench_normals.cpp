@@ -0,0 +1,92 @@
+﻿// normals: 全量与增量法向更新, 以及 MeshKernel 上逐元素与成批(SIMD)的全量法向
+#include "bench_common.h"
+#include <halfedge.h>
+#include <kernel_algorithms.h>
+#include <mesh_kernel.h>
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <random>
+
+namespace {
+
+/// 成批版本之前的 computeVertexNormals: 逐面 faceAreaVector, 逐顶点累加后归一化
+template <class Kernel>
+void scalarVertexNormals(const Kernel& kernel, std::vector<typename Kernel::Vector3>& normals) {
+    using Index = typename Kernel::Index;
+    using AccumulatorVector3 = typename Kernel::AccumulatorVector3;
+    std::vector<AccumulatorVector3> faceNormals(kernel.getFaceCount());
+    geometry::parallel::parallelFor(0, faceNormals.size(), [&](size_t f) {
+        faceNormals[f] = geometry::detail::faceAreaVector(kernel, static_cast<Index>(f));
+    });
+    normals.resize(kernel.getVertexCount());
+    geometry::parallel::parallelFor(0, normals.size(), [&](size_t v) {
+        AccumulatorVector3 n = AccumulatorVector3::Zero();
+        const Index start = kernel.halfEdge(static_cast<Index>(v));
+        Index h = start;
+        while (h >= 0) {
+            if (kernel.face(h) >= 0) n += faceNormals[kernel.face(h)];
+            h = kernel.rotate(h);
+            if (h == start) break;
+        }
+        if (n.norm() > 0) n.normalize();
+        normals[v] = n.template cast<typename Kernel::Vector3::Scalar>();
+    });
+}
+
+template <class Kernel>
+void reportKernelNormals(std::ostream& report, const char* name, const SyntheticMesh& source) {
+    Kernel kernel;
+    kernel.build(source.vertexPositions(), source.faceIndices());
+    std::vector<typename Kernel::Vector3> scalar, batched;
+    const double scalarMs = bestOf(5, [&] { scalarVertexNormals(kernel, scalar); });
+    const double batchedMs = bestOf(5, [&] { kernel.computeVertexNormals(batched); });
+    double deviation = 0.0;
+    for (size_t v = 0; v < scalar.size(); ++v) {
+        deviation = std::max(deviation, static_cast<double>((scalar[v] - batched[v]).norm()));
+    }
+    report << "  " << std::left << std::setw(12) << name << std::right << std::fixed << std::setprecision(2)
+           << " per element " << std::setw(8) << scalarMs << " ms, batched " << std::setw(8) << batchedMs
+           << " ms  (max deviation " << std::scientific << std::setprecision(1) << deviation << ")" << std::endl;
+}
+
+} // namespace
+
+void runNormalsBench(std::ostream& report) {
+    const SyntheticMesh torus = makeTorus(1000, 500);
+    geometry::HalfEdgeMesh mesh;
+    mesh.buildFromArrays(torus.positions, torus.indices);
+    const int nV = static_cast<int>(mesh.getVertexCount());
+    report << "torus 1000x500: " << nV << " vertices, " << mesh.getFaceCount() << " faces" << std::endl;
+
+    const double fullMs = bestOf(3, [&] { mesh.computeNormals(); });
+    report << std::fixed << std::setprecision(2)
+           << "  computeNormals (full)        " << std::setw(9) << fullMs << " ms" << std::endl;
+
+    // 模拟交互编辑: 移动若干顶点后只更新受影响的法向, 再与全量结果比较
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> pick(0, nV - 1);
+    for (int edited : { 1, 100, 10000 }) {
+        for (int k = 0; k < edited; ++k) {
+            const int v = pick(rng);
+            mesh.vertices[v]->position += Eigen::Vector3d(0.01, -0.02, 0.015);
+            mesh.markVertexDirty(v);
+        }
+        const double incrementalMs = bestOf(1, [&] { mesh.updateNormals(); });
+        std::vector<Eigen::Vector3d> incremental(nV);
+        for (int v = 0; v < nV; ++v) incremental[v] = mesh.vertices[v]->normal;
+        mesh.computeNormals();
+        double deviation = 0.0;
+        for (int v = 0; v < nV; ++v) {
+            deviation = std::max(deviation, (incremental[v] - mesh.vertices[v]->normal).norm());
+        }
+        report << "  updateNormals, " << std::setw(5) << edited << " edited   " << std::fixed << std::setprecision(2)
+               << std::setw(9) << incrementalMs << " ms  (max deviation from full "
+               << std::scientific << std::setprecision(1) << deviation << ")" << std::endl;
+    }
+
+    // MeshKernel 全量法向: 逐元素计算与 NormalBatchSize 个元素一批的分量数组计算
+    report << "MeshKernel computeVertexNormals on the same torus:" << std::endl;
+    reportKernelNormals<geometry::MeshKernel>(report, "MeshKernel", torus);
+    reportKernelNormals<geometry::MeshKernelf>(report, "MeshKernelf", torus);
+}
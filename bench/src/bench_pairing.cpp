@@ -0,0 +1,77 @@
+﻿// pairing: 对偶半边配对, 旧的 std::map 查找与 pairHalfEdges 的基数排序
+#include "bench_common.h"
+#include <halfedge.h>
+#include <parallel.h>
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <ostream>
+
+namespace {
+
+/// 旧版 buildFromOBJ 的配对方式: 逐条半边在 std::map 中查找反向边, 找不到则登记自己
+std::vector<int> pairWithMap(const SyntheticMesh& mesh) {
+    std::vector<int> twin(mesh.indices.size(), -1);
+    std::map<std::pair<int, int>, int> edgeMap;
+    for (size_t h = 0; h < mesh.indices.size(); ++h) {
+        const int from = static_cast<int>(mesh.indices[h]);
+        const int to = static_cast<int>(mesh.indices[h % 3 == 2 ? h - 2 : h + 1]);
+        auto it = edgeMap.find({ to, from });
+        if (it != edgeMap.end()) {
+            twin[h] = it->second;
+            twin[it->second] = static_cast<int>(h);
+        } else {
+            edgeMap[{ from, to }] = static_cast<int>(h);
+        }
+    }
+    return twin;
+}
+
+/// pairHalfEdges 的方式: (min, max) 顶点键做稳定基数排序, 相同的边相邻后逐组配对
+std::vector<int> pairWithRadixSort(const SyntheticMesh& mesh) {
+    struct EdgeKey {
+        std::uint64_t key;
+        int halfEdge;
+    };
+    const size_t nH = mesh.indices.size();
+    const int vertexBits = geometry::parallel::bitWidth(mesh.vertexCount());
+    std::vector<EdgeKey> keys(nH);
+    geometry::parallel::parallelFor(0, nH, [&](size_t h) {
+        const std::uint64_t from = mesh.indices[h];
+        const std::uint64_t to = mesh.indices[h % 3 == 2 ? h - 2 : h + 1];
+        keys[h] = { (std::min(from, to) << vertexBits) | std::max(from, to), static_cast<int>(h) };
+    });
+    geometry::parallel::parallelRadixSort(keys, 2 * vertexBits, [](const EdgeKey& k) { return k.key; });
+
+    std::vector<int> twin(nH, -1);
+    for (size_t i = 0; i + 1 < nH; ++i) {
+        if (keys[i].key != keys[i + 1].key) continue;
+        if (i + 2 < nH && keys[i + 2].key == keys[i].key) continue; // 非流形边不配对
+        twin[keys[i].halfEdge] = keys[i + 1].halfEdge;
+        twin[keys[i + 1].halfEdge] = keys[i].halfEdge;
+        ++i;
+    }
+    return twin;
+}
+
+} // namespace
+
+void runPairingBench(std::ostream& report) {
+    const SyntheticMesh grid = makeGrid(500);
+    report << "triangulated grid 500x500: " << grid.indices.size() << " half-edges" << std::endl;
+
+    std::vector<int> mapTwins, radixTwins;
+    const double mapMs = bestOf(3, [&] { mapTwins = pairWithMap(grid); });
+    const double radixMs = bestOf(3, [&] { radixTwins = pairWithRadixSort(grid); });
+
+    const auto positions = grid.vertexPositions();
+    const auto faces = grid.faceIndices();
+    geometry::HalfEdgeMesh mesh;
+    const double buildMs = bestOf(3, [&] { mesh.buildFromOBJ(positions, faces); });
+
+    report << std::fixed << std::setprecision(1)
+           << "  std::map pairing        " << std::setw(8) << mapMs << " ms" << std::endl
+           << "  radix-sort pairing      " << std::setw(8) << radixMs << " ms  ("
+           << (mapTwins == radixTwins ? "same twins" : "TWINS DIFFER") << ")" << std::endl
+           << "  buildFromOBJ (total)    " << std::setw(8) << buildMs << " ms" << std::endl;
+}
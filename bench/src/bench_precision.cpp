@@ -0,0 +1,165 @@
+﻿// precision: MeshKernelf(float 存储, double 累加)与 MeshKernel 的耗时、访存量和误差, 以及 hw2/hw10 的计算路径
+#include "bench_common.h"
+#include <circulators.h>
+#include <halfedge.h>
+#include <kernel_algorithms.h>
+#include <mesh_kernel.h>
+#include <parallel.h>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+#include <random>
+
+namespace {
+
+/// 带扫描噪声的球面, 再在 double 中加一层微小扰动, 使坐标不能被 float 精确表示(float 内核的输入有真实的舍入误差)
+std::vector<Eigen::Vector3d> perturbedPositions(const SyntheticMesh& mesh) {
+    std::mt19937 rng(17);
+    std::normal_distribution<double> jitter(0.0, 1e-6);
+    std::vector<Eigen::Vector3d> positions = mesh.vertexPositions();
+    for (Eigen::Vector3d& p : positions) p += Eigen::Vector3d(jitter(rng), jitter(rng), jitter(rng));
+    return positions;
+}
+
+/// 平滑每次迭代读写的字节数: 读旧位置、写新位置, 加上一环的 CSR 下标(offsets + 邻接顶点)
+template <class Kernel>
+size_t smoothBytesPerIteration(const Kernel& kernel) {
+    std::vector<typename Kernel::Index> offsets, ring;
+    geometry::detail::buildVertexRings(kernel, offsets, ring);
+    return 2 * kernel.positions.size() * sizeof(typename Kernel::Vector3)
+         + (offsets.size() + ring.size()) * sizeof(typename Kernel::Index);
+}
+
+/// 修改前 hw10 的一次迭代: 在 HalfEdgeMesh 上用循环器遍历邻域
+void smoothHalfEdgeMesh(geometry::HalfEdgeMesh& mesh, int iterations, double lambda) {
+    std::vector<Eigen::Vector3d> newPositions(mesh.vertices.size());
+    for (int iter = 0; iter < iterations; ++iter) {
+        geometry::parallel::parallelFor(0, mesh.vertices.size(), [&](size_t i) {
+            const geometry::Vertex* vertex = mesh.vertices[i].get();
+            Eigen::Vector3d sum = Eigen::Vector3d::Zero();
+            int count = 0;
+            for (geometry::Vertex* neighbor : geometry::vertexVertices(vertex)) {
+                sum += neighbor->position;
+                ++count;
+            }
+            newPositions[i] = count > 0 ? Eigen::Vector3d(vertex->position + lambda * (sum / count - vertex->position))
+                                        : vertex->position;
+        }, 1024);
+        geometry::parallel::parallelFor(0, mesh.vertices.size(), [&](size_t i) {
+            mesh.vertices[i]->position = newPositions[i];
+        });
+    }
+}
+
+/// hw2 的 cotangent 曲率(仍在 HalfEdgeMesh 上用循环器计算, 未改为内核): 边界点记为 NaN
+std::vector<double> cotangentCurvatureHalfEdgeMesh(const geometry::HalfEdgeMesh& mesh) {
+    std::vector<double> magnitudes(mesh.vertices.size(), std::numeric_limits<double>::quiet_NaN());
+    geometry::parallel::parallelFor(0, mesh.vertices.size(), [&](size_t i) {
+        const geometry::Vertex* vi = mesh.vertices[i].get();
+        if (vi->isBoundary()) return;
+        double area = 0.0;
+        Eigen::Vector3d laplacian = Eigen::Vector3d::Zero();
+        for (geometry::HalfEdge* hf : geometry::outgoingHalfEdges(vi)) {
+            const Eigen::Vector3d& p0 = hf->prev->vertex->position;
+            const Eigen::Vector3d& p1 = hf->getEndVertex()->position;
+            const Eigen::Vector3d& p2 = hf->pair->prev->vertex->position;
+            const Eigen::Vector3d e01 = p1 - p0, e0i = vi->position - p0;
+            const Eigen::Vector3d e21 = p1 - p2, e2i = vi->position - p2;
+            const double cos0 = e01.dot(e0i) / (e01.norm() * e0i.norm());
+            const double cos2 = e21.dot(e2i) / (e21.norm() * e2i.norm());
+            laplacian += (cos0 / std::sqrt(1 - cos0 * cos0) + cos2 / std::sqrt(1 - cos2 * cos2)) * (p1 - vi->position);
+            area += e01.cross(e0i).norm() + e21.cross(e2i).norm();
+        }
+        magnitudes[i] = (laplacian / (4 * area)).norm();
+    }, 1024);
+    return magnitudes;
+}
+
+} // namespace
+
+void runPrecisionBench(std::ostream& report) {
+    const SyntheticMesh sphere = makeSphere(700, 0.0005f);
+    const auto positions = perturbedPositions(sphere);
+    const auto faces = sphere.faceIndices();
+    report << "noisy sphere 700x700, positions jittered by 1e-6 in double: " << sphere.vertexCount()
+           << " vertices, " << sphere.triangleCount() << " triangles" << std::endl;
+
+    // hw10 的路径: 先由 HalfEdgeMesh 转成内核, 再在内核上计算
+    geometry::HalfEdgeMesh mesh;
+    mesh.buildFromOBJ(positions, faces);
+    geometry::MeshKernelf single;
+    geometry::MeshKernel full;
+    const double convertfMs = bestOf(3, [&] { single = geometry::MeshKernelf::fromHalfEdgeMesh(mesh); });
+    const double convertdMs = bestOf(3, [&] { full = geometry::MeshKernel::fromHalfEdgeMesh(mesh); });
+
+    std::vector<Eigen::Vector3f> normalsf;
+    std::vector<Eigen::Vector3d> normalsd;
+    const double normalsfMs = bestOf(3, [&] { single.computeVertexNormals(normalsf); });
+    const double normalsdMs = bestOf(3, [&] { full.computeVertexNormals(normalsd); });
+    double normalDeviation = 0.0;
+    for (size_t v = 0; v < normalsd.size(); ++v) {
+        normalDeviation = std::max(normalDeviation, (normalsf[v].cast<double>() - normalsd[v]).norm());
+    }
+
+    // 曲率误差: 相对于最大值(hw2 按值域的比例划分颜色), 以及逐顶点相对误差的最大值
+    std::vector<float> curvaturef;
+    std::vector<double> curvatured;
+    const double curvaturefMs = bestOf(3, [&] { single.computeMeanCurvature(curvaturef); });
+    const double curvaturedMs = bestOf(3, [&] { full.computeMeanCurvature(curvatured); });
+    std::vector<double> curvatureHw2;
+    const double curvatureHw2Ms = bestOf(3, [&] { curvatureHw2 = cotangentCurvatureHalfEdgeMesh(mesh); });
+    // 以 hw2 的结果为基准, 跳过 hw2 记为 NaN 的边界点
+    double curvatureMax = 0.0;
+    for (double c : curvatureHw2) {
+        if (c > curvatureMax) curvatureMax = c;
+    }
+    auto curvatureDeviation = [&](const auto& curvature, double& ofMax, double& perVertex) {
+        ofMax = perVertex = 0.0;
+        for (size_t v = 0; v < curvatureHw2.size(); ++v) {
+            if (std::isnan(curvatureHw2[v])) continue;
+            const double difference = std::abs(curvature[v] - curvatureHw2[v]);
+            ofMax = std::max(ofMax, difference / curvatureMax);
+            if (curvatureHw2[v] > 0) perVertex = std::max(perVertex, difference / curvatureHw2[v]);
+        }
+    };
+    double curvaturefOfMax, curvaturefPerVertex, curvaturedOfMax, curvaturedPerVertex;
+    curvatureDeviation(curvaturef, curvaturefOfMax, curvaturefPerVertex);
+    curvatureDeviation(curvatured, curvaturedOfMax, curvaturedPerVertex);
+
+    // 平滑会修改位置, 每次重复前恢复原位置(计入耗时, 只是一次数组复制); 迭代次数和系数与 hw10 默认参数相同
+    const auto originalf = single.positions;
+    const auto originald = full.positions;
+    const double smoothfMs = bestOf(3, [&] {
+        single.positions = originalf;
+        single.laplacianSmooth(20, 0.9);
+    });
+    const double smoothdMs = bestOf(3, [&] {
+        full.positions = originald;
+        full.laplacianSmooth(20, 0.9);
+    });
+    double smoothDeviation = 0.0;
+    for (size_t v = 0; v < full.positions.size(); ++v) {
+        smoothDeviation = std::max(smoothDeviation, (single.positions[v].cast<double>() - full.positions[v]).norm());
+    }
+    const double previousSmoothMs = bestOf(1, [&] { smoothHalfEdgeMesh(mesh, 20, 0.9); });
+
+    report << "  kernel                        float      double  max deviation" << std::endl;
+    report << std::fixed << std::setprecision(1)
+           << "  memory (MB)              " << std::setw(10) << megabytes(single.memoryUsage())
+           << std::setw(12) << megabytes(full.memoryUsage()) << std::endl
+           << "  smooth traffic (MB/iter) " << std::setw(10) << megabytes(smoothBytesPerIteration(single))
+           << std::setw(12) << megabytes(smoothBytesPerIteration(full)) << std::endl
+           << "  fromHalfEdgeMesh (ms)    " << std::setw(10) << convertfMs << std::setw(12) << convertdMs << std::endl
+           << "  vertex normals (ms)      " << std::setw(10) << normalsfMs << std::setw(12) << normalsdMs
+           << std::scientific << std::setprecision(1) << std::setw(15) << normalDeviation << std::endl
+           << std::fixed << "  smooth 20x0.9 (ms)       " << std::setw(10) << smoothfMs << std::setw(12) << smoothdMs
+           << std::scientific << std::setw(15) << smoothDeviation << std::endl
+           << std::fixed << "  mean curvature (ms)      " << std::setw(10) << curvaturefMs << std::setw(12) << curvaturedMs
+           << std::endl
+           << std::fixed << "  previous hw10 loop on HalfEdgeMesh, smooth 20x0.9: " << previousSmoothMs << " ms" << std::endl
+           << "  hw2 cotangent loop on HalfEdgeMesh: " << curvatureHw2Ms << " ms; kernel deviation from it: float "
+           << std::scientific << curvaturefOfMax << " (of max), " << curvaturefPerVertex << " (per vertex), double "
+           << curvaturedOfMax << " (of max), " << curvaturedPerVertex << " (per vertex)" << std::endl;
+}
@@ -0,0 +1,100 @@
+﻿// reorder: 元素顺序对遍历、稀疏矩阵乘法和直接分解的影响
+#include "bench_common.h"
+#include <halfedge.h>
+#include <mesh_reorder.h>
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+#include <iomanip>
+#include <ostream>
+
+namespace {
+
+/// 均匀权图拉普拉斯(对角加一个小正则项使其正定), 稀疏模式直接取自 getAdjacency
+Eigen::SparseMatrix<double> graphLaplacian(geometry::HalfEdgeMesh& mesh) {
+    const geometry::VertexAdjacency& adjacency = mesh.getAdjacency();
+    Eigen::SparseMatrix<double> L;
+    adjacency.initMatrix(L);
+    for (int j = 0; j < adjacency.getVertexCount(); ++j) {
+        const int degree = adjacency.outerIndex[j + 1] - adjacency.outerIndex[j] - 1;
+        for (int k = adjacency.outerIndex[j]; k < adjacency.outerIndex[j + 1]; ++k) {
+            L.valuePtr()[k] = adjacency.innerIndex[k] == j ? degree + 1e-3 : -1.0;
+        }
+    }
+    return L;
+}
+
+/// 打乱顺序的球面, 再按 ordering 重排(ordering < 0 时保持打乱后的顺序), 返回重排耗时
+double buildMesh(geometry::HalfEdgeMesh& mesh, int n, int ordering) {
+    const SyntheticMesh sphere = makeSphere(n);
+    mesh.buildFromArrays(sphere.positions, sphere.indices);
+    shuffleMesh(mesh, 3);
+    if (ordering < 0) return 0.0;
+    return bestOf(1, [&] { geometry::reorderMesh(mesh, static_cast<geometry::MeshOrdering>(ordering)); });
+}
+
+} // namespace
+
+void runReorderBench(std::ostream& report) {
+    // 分解用较小的网格: 打乱顺序下自然顺序分解的填充接近稠密, 耗时随规模三次方增长
+    const int traversalGrid = 700;
+    const int factorGrid = 100;
+    report << "shuffled sphere " << traversalGrid << "x" << traversalGrid << " for SpMV / one-ring, "
+           << factorGrid << "x" << factorGrid << " for LDLT" << std::endl;
+    report << "  ordering       reorder     SpMV  one-ring  nnz(L) natural  natural LDLT  AMD LDLT" << std::endl;
+
+    const char* names[] = { "shuffled", "FaceLocality", "Morton", "Hilbert", "RCM" };
+    for (int ordering = -1; ordering < 4; ++ordering) {
+        geometry::HalfEdgeMesh mesh;
+        const double reorderMs = buildMesh(mesh, traversalGrid, ordering);
+
+        const Eigen::SparseMatrix<double> L = graphLaplacian(mesh);
+        Eigen::VectorXd x = Eigen::VectorXd::Ones(L.rows());
+        Eigen::VectorXd y;
+        const double spmvMs = bestOf(1, [&] {
+            for (int r = 0; r < 20; ++r) {
+                y = L * x;
+                x = 0.1 * y;
+            }
+        }) / 20;
+
+        // 指针风格的一环遍历(hw 模块的典型访问方式)
+        Eigen::Vector3d sum = Eigen::Vector3d::Zero();
+        const double ringMs = bestOf(1, [&] {
+            for (int r = 0; r < 5; ++r) {
+                for (const auto& vertex : mesh.vertices) {
+                    geometry::HalfEdge* start = vertex->halfEdge;
+                    geometry::HalfEdge* he = start;
+                    do {
+                        sum += he->next->vertex->position;
+                        he = he->prev->pair;
+                    } while (he && he != start);
+                }
+            }
+        }) / 5;
+
+        geometry::HalfEdgeMesh small;
+        buildMesh(small, factorGrid, ordering);
+        const Eigen::SparseMatrix<double> Ls = graphLaplacian(small);
+        Eigen::Index naturalNonZeros = 0;
+        const double naturalMs = bestOf(1, [&] {
+            Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>, Eigen::Lower, Eigen::NaturalOrdering<int>> ldlt(Ls);
+            naturalNonZeros = ldlt.matrixL().nestedExpression().nonZeros();
+        });
+        const double amdMs = bestOf(1, [&] {
+            Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> ldlt(Ls);
+        });
+
+        report << "  " << std::left << std::setw(13) << names[ordering + 1] << std::right << std::fixed;
+        if (ordering < 0) {
+            report << "       -   ";
+        } else {
+            report << std::setprecision(0) << std::setw(6) << reorderMs << " ms";
+        }
+        report << std::setprecision(1) << std::setw(6) << spmvMs << " ms"
+               << std::setw(7) << ringMs << " ms"
+               << std::setprecision(2) << std::setw(13) << naturalNonZeros / 1e6 << "M"
+               << std::setprecision(0) << std::setw(11) << naturalMs << " ms"
+               << std::setw(7) << amdMs << " ms" << std::endl;
+        doNotOptimize(sum.norm() + y.norm());
+    }
+}
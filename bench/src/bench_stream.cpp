@@ -0,0 +1,119 @@
+﻿// stream: 流式分块处理与整体在内存中处理的结果对比, 以及重叠区的大小(在系统临时目录中读写 PLY)
+#include "bench_common.h"
+#include <mesh_io.h>
+#include <mesh_kernel.h>
+#include <out_of_core.h>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <ostream>
+#include <string>
+
+namespace {
+
+constexpr int SmoothIterations = 3;
+constexpr double SmoothLambda = 0.5;
+
+/// 输出 PLY 的顶点记录(x y z nx ny nz curvature)和面数, 布局由 processOutOfCore 决定
+struct StreamOutput {
+    std::vector<float> records;
+    size_t faceCount = 0;
+};
+
+bool readStreamOutput(const std::string& path, size_t vertexCount, StreamOutput& output) {
+    std::ifstream in(path, std::ios::binary);
+    const std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const size_t headerEnd = bytes.find("end_header\n");
+    const size_t faceLine = bytes.find("element face ");
+    if (headerEnd == std::string::npos || faceLine == std::string::npos) return false;
+    output.faceCount = std::stoull(bytes.substr(faceLine + 13));
+    output.records.resize(vertexCount * 7);
+    if (bytes.size() < headerEnd + 11 + output.records.size() * sizeof(float)) return false;
+    std::memcpy(output.records.data(), bytes.data() + headerEnd + 11, output.records.size() * sizeof(float));
+    return true;
+}
+
+/// 流式处理 mesh(可以附加无效的面), 与整个网格在 MeshKernelf 上的结果逐顶点比较
+void compareWithInCore(std::ostream& report, const char* name, const SyntheticMesh& mesh, size_t maxChunkVertices,
+                       const std::vector<std::uint32_t>& invalidFaces = {}) {
+    const std::filesystem::path dir = std::filesystem::temp_directory_path();
+    const std::string inputPath = (dir / "geometry_bench_stream_in.ply").string();
+    const std::string outputPath = (dir / "geometry_bench_stream_out.ply").string();
+
+    geometry::MeshData data;
+    data.positions = mesh.positions;
+    data.faceVertices.assign(mesh.indices.begin(), mesh.indices.end());
+    data.faceVertices.insert(data.faceVertices.end(), invalidFaces.begin(), invalidFaces.end());
+    data.faceOffsets.resize(data.faceVertices.size() / 3 + 1);
+    for (size_t f = 0; f < data.faceOffsets.size(); ++f) data.faceOffsets[f] = static_cast<std::uint32_t>(3 * f);
+
+    geometry::StreamingOptions options;
+    options.maxChunkVertices = maxChunkVertices;
+    options.smoothIterations = SmoothIterations;
+    options.smoothLambda = SmoothLambda;
+    options.computeCurvature = true;
+    geometry::StreamingStats stats;
+    StreamOutput output;
+    bool ok = geometry::writePLY(inputPath, data);
+    double ms = 0.0;
+    if (ok) ms = bestOf(1, [&] { ok = geometry::processOutOfCore(inputPath, outputPath, options, &stats); });
+    ok = ok && readStreamOutput(outputPath, mesh.vertexCount(), output);
+    std::error_code ec;
+    std::filesystem::remove(inputPath, ec);
+    std::filesystem::remove(outputPath, ec);
+    if (!ok) {
+        report << name << ": FAILED" << std::endl;
+        return;
+    }
+
+    std::vector<Eigen::Vector3f> positions(mesh.vertexCount());
+    for (size_t v = 0; v < positions.size(); ++v) {
+        positions[v] = Eigen::Vector3f(mesh.positions[3 * v], mesh.positions[3 * v + 1], mesh.positions[3 * v + 2]);
+    }
+    geometry::MeshKernelf kernel;
+    kernel.build(positions, mesh.faceIndices());
+    kernel.laplacianSmooth(SmoothIterations, SmoothLambda);
+    std::vector<Eigen::Vector3f> normals;
+    std::vector<float> curvature;
+    kernel.computeVertexNormals(normals);
+    kernel.computeMeanCurvature(curvature);
+    double positionDeviation = 0.0, normalDeviation = 0.0, curvatureDeviation = 0.0;
+    for (size_t v = 0; v < positions.size(); ++v) {
+        const float* r = &output.records[7 * v];
+        positionDeviation = std::max(positionDeviation, double((Eigen::Vector3f(r[0], r[1], r[2]) - kernel.position(v)).norm()));
+        normalDeviation = std::max(normalDeviation, double((Eigen::Vector3f(r[3], r[4], r[5]) - normals[v]).norm()));
+        curvatureDeviation = std::max(curvatureDeviation, double(std::abs(r[6] - curvature[v])));
+    }
+
+    report << name << ": " << mesh.vertexCount() << " vertices, " << mesh.triangleCount() << " triangles";
+    if (!invalidFaces.empty()) report << " + " << invalidFaces.size() / 3 << " invalid";
+    report << std::endl
+           << "  " << stats.chunkCount << " chunks of <= " << maxChunkVertices << " owned vertices, largest with halo "
+           << stats.maxLocalVertices << " vertices (" << std::fixed << std::setprecision(1)
+           << 100.0 * stats.maxLocalVertices / mesh.vertexCount() << "% of the mesh), " << ms << " ms" << std::endl
+           << "  faces written " << output.faceCount << " ("
+           << (output.faceCount == mesh.triangleCount() ? "invalid faces dropped" : "WRONG COUNT") << ")" << std::endl
+           << "  max deviation from in-core MeshKernelf: position " << std::scientific << std::setprecision(1)
+           << positionDeviation << ", normal " << normalDeviation << ", curvature " << curvatureDeviation << std::endl;
+}
+
+} // namespace
+
+void runStreamBench(std::ostream& report) {
+    compareWithInCore(report, "noisy sphere 300x300", makeSphere(300, 0.0005f), 12000);
+
+    // 左半边间距 1, 右半边间距 40: 粗的一侧的长边不应加宽细的一侧的重叠区
+    SyntheticMesh graded = makeGrid(400);
+    for (size_t v = 0; v < graded.vertexCount(); ++v) {
+        float& x = graded.positions[3 * v];
+        if (x > 200.0f) x = 200.0f + 40.0f * (x - 200.0f);
+    }
+    compareWithInCore(report, "graded grid 400x400 (spacing 1 | 40)", graded, 12000);
+
+    // 索引越界的面: 被跳过, 不写入输出
+    const std::uint32_t outside = static_cast<std::uint32_t>(graded.vertexCount()) + 5;
+    compareWithInCore(report, "graded grid 400x400", graded, 12000, { 0, 1, outside, outside, 2, 3 });
+}
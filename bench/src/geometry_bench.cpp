@@ -0,0 +1,101 @@
+﻿// geometry_bench: 用合成网格测量几何库各项优化的基准程序(-DBUILD_GEOMETRY_BENCH=ON 时构建)
+//
+//   geometry_bench --list
+//   geometry_bench [suite]...       不给 suite 时依次运行全部
+//
+// 网格在程序中按固定参数和随机种子生成, 除 stream 在系统临时目录中读写 PLY 外不读写文件, 所以结果只取决于机器和线程数。
+// 全局 operator new 被替换为计数版本, 供需要统计堆分配次数的测试使用。
+#include "bench_common.h"
+#include <parallel.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::atomic<size_t> allocations { 0 };
+
+const std::vector<BenchSuite>& benchSuites() {
+    static const std::vector<BenchSuite> suites = {
+        { "kernel", "HalfEdgeMesh / MeshKernel / TriangleMesh 的内存和构建、法向耗时(500x500 网格)", runKernelBench },
+        { "pairing", "对偶半边配对: std::map 与并行基数排序(500x500 网格)", runPairingBench },
+        { "normals", "全量 computeNormals、脏顶点增量 updateNormals 和 MeshKernel 成批法向(1000x500 环面)", runNormalsBench },
+        { "circulators", "一环邻域遍历: 临时 vector 与循环器(500x500 网格)", runCirculatorBench },
+        { "precision", "MeshKernelf 与 MeshKernel 的耗时、访存量和误差, hw2/hw10 的计算路径(带噪声的 700x700 球面)", runPrecisionBench },
+        { "build", "从 Qt 数组构建半边网格的分配次数和耗时(500x500 网格)", runBuildBench },
+        { "codec", "压缩码流大小和解码速度(带噪声的 700x700 球面)", runCodecBench },
+        { "reorder", "各重排策略下的 SpMV、一环遍历和 LDLT 分解(打乱的 700x700 球面)", runReorderBench },
+        { "gc", "只标记半边删除时 garbageCollection 的一致性检查和耗时(500x500 网格)", runGarbageCollectionBench },
+        { "stream", "流式分块处理与整体处理的结果对比和重叠区大小(300x300 球面, 疏密不均的 400x400 网格)", runStreamBench },
+        { "cache", "半边缓存的写入、映射, 由缓存与由数组构建半边网格的耗时和一致性(700x700 网格)", runCacheBench },
+    };
+    return suites;
+}
+
+const BenchSuite* findSuite(const std::string& name) {
+    for (const BenchSuite& suite : benchSuites()) {
+        if (name == suite.name) return &suite;
+    }
+    return nullptr;
+}
+
+void printUsage() {
+    std::cerr << "Usage: geometry_bench --list\n"
+              << "       geometry_bench [suite]...   (all suites when none is given)" << std::endl;
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    ++allocations;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+size_t allocationCount() {
+    return allocations.load();
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 2 && std::string(argv[1]) == "--list") {
+        for (const BenchSuite& suite : benchSuites()) {
+            std::cout << suite.name << "  " << suite.description << "\n";
+        }
+        std::cout << std::flush;
+        return 0;
+    }
+    std::vector<const BenchSuite*> selected;
+    for (int i = 1; i < argc; ++i) {
+        const BenchSuite* suite = findSuite(argv[i]);
+        if (!suite) {
+            std::cerr << "Error: Unknown suite '" << argv[i] << "' (see geometry_bench --list)" << std::endl;
+            printUsage();
+            return 2;
+        }
+        selected.push_back(suite);
+    }
+    if (selected.empty()) {
+        for (const BenchSuite& suite : benchSuites()) selected.push_back(&suite);
+    }
+
+    // 报告写到原来的标准输出, 库在构建网格时打印的信息被丢弃
+    std::ostream report(std::cout.rdbuf());
+    std::cout.rdbuf(nullptr);
+    report << "geometry_bench: " << geometry::parallel::hardwareThreads() << " hardware thread(s)" << std::endl;
+    for (const BenchSuite* suite : selected) {
+        report << "\n== " << suite->name << " ==" << std::endl;
+        const auto start = std::chrono::steady_clock::now();
+        suite->run(report);
+        report << "(" << std::fixed << std::setprecision(1) << elapsedMs(start) / 1000.0 << " s)" << std::endl;
+    }
+    std::cout.rdbuf(report.rdbuf());
+    return 0;
+}
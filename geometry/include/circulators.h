@@ -0,0 +1,144 @@
+﻿#ifndef GEOMETRY_CIRCULATORS_H
+#define GEOMETRY_CIRCULATORS_H
+
+#include "halfedge.h"
+#include <type_traits>
+
+namespace geometry {
+
+/**
+ * @brief 一环邻域循环器, 可直接用于 range-for, 不分配内存
+ *
+ * 用法:
+ *   for (Vertex* vj : vertexVertices(vi)) { ... }
+ *   for (HalfEdge* he : outgoingHalfEdges(vi)) { ... }
+ *   for (Face* f : vertexFaces(vi)) { ... }
+ *   for (Vertex* v : faceVertices(f)) { ... }
+ *
+ * 绕顶点的循环从 vertex->halfEdge 开始沿 pair->next 逆时针旋转,
+ * 回到起点(内部顶点)或遇到没有 pair 的边(边界顶点)时结束。
+ * 构建/垃圾回收后边界顶点的 halfEdge 是扇形的第一条出边, 因此能覆盖完整扇形。
+ * 边界顶点的最后一个邻接顶点只能通过入边到达, vertexVertices 会额外给出它。
+ */
+
+/// 迭代器的取值方式
+enum class RingValue { HalfEdge, Vertex, Face };
+
+template <RingValue Value>
+class VertexRingIterator {
+public:
+    using value_type = std::conditional_t<Value == RingValue::HalfEdge, HalfEdge*,
+                       std::conditional_t<Value == RingValue::Vertex, Vertex*, Face*>>;
+
+    VertexRingIterator() = default;
+    explicit VertexRingIterator(HalfEdge* start) : start_(start), current_(start) {}
+
+    value_type operator*() const {
+        if constexpr (Value == RingValue::HalfEdge) {
+            return current_;
+        } else if constexpr (Value == RingValue::Vertex) {
+            // 边界尾部存的是入边, 邻接顶点是它的起点
+            return tail_ ? current_->vertex : current_->next->vertex;
+        } else {
+            return current_->face;
+        }
+    }
+
+    VertexRingIterator& operator++() {
+        if (tail_) {
+            current_ = nullptr;
+            tail_ = false;
+            return *this;
+        }
+        HalfEdge* next = current_->pair ? current_->pair->next : nullptr;
+        if (next == start_) {
+            next = nullptr; // 内部顶点转完一圈
+        } else if (!next) {
+            if constexpr (Value == RingValue::Vertex) {
+                // 边界顶点: 起始出边的前一条是边界入边, 它的起点是最后一个邻接顶点
+                next = start_->prev;
+                tail_ = true;
+            }
+        }
+        current_ = next;
+        return *this;
+    }
+
+    bool operator==(const VertexRingIterator& other) const {
+        return current_ == other.current_ && tail_ == other.tail_;
+    }
+    bool operator!=(const VertexRingIterator& other) const { return !(*this == other); }
+
+private:
+    HalfEdge* start_ = nullptr;
+    HalfEdge* current_ = nullptr;
+    bool tail_ = false;
+};
+
+/// 沿 next 遍历一个面的所有半边
+template <RingValue Value>
+class FaceRingIterator {
+public:
+    using value_type = std::conditional_t<Value == RingValue::HalfEdge, HalfEdge*, Vertex*>;
+
+    FaceRingIterator() = default;
+    explicit FaceRingIterator(HalfEdge* start) : start_(start), current_(start) {}
+
+    value_type operator*() const {
+        if constexpr (Value == RingValue::HalfEdge) {
+            return current_;
+        } else {
+            return current_->vertex;
+        }
+    }
+
+    FaceRingIterator& operator++() {
+        current_ = current_->next;
+        if (current_ == start_) current_ = nullptr;
+        return *this;
+    }
+
+    bool operator==(const FaceRingIterator& other) const { return current_ == other.current_; }
+    bool operator!=(const FaceRingIterator& other) const { return current_ != other.current_; }
+
+private:
+    HalfEdge* start_ = nullptr;
+    HalfEdge* current_ = nullptr;
+};
+
+/// begin/end 组成的轻量区间
+template <class Iterator>
+class RingRange {
+public:
+    explicit RingRange(HalfEdge* start) : start_(start) {}
+    Iterator begin() const { return Iterator(start_); }
+    Iterator end() const { return Iterator(); }
+
+private:
+    HalfEdge* start_;
+};
+
+/// 顶点的所有出边
+inline RingRange<VertexRingIterator<RingValue::HalfEdge>> outgoingHalfEdges(const Vertex* v) {
+    return RingRange<VertexRingIterator<RingValue::HalfEdge>>(v->halfEdge);
+}
+/// 顶点的一环邻接顶点(按旋转顺序)
+inline RingRange<VertexRingIterator<RingValue::Vertex>> vertexVertices(const Vertex* v) {
+    return RingRange<VertexRingIterator<RingValue::Vertex>>(v->halfEdge);
+}
+/// 顶点的相邻面
+inline RingRange<VertexRingIterator<RingValue::Face>> vertexFaces(const Vertex* v) {
+    return RingRange<VertexRingIterator<RingValue::Face>>(v->halfEdge);
+}
+/// 面的所有半边
+inline RingRange<FaceRingIterator<RingValue::HalfEdge>> faceHalfEdges(const Face* f) {
+    return RingRange<FaceRingIterator<RingValue::HalfEdge>>(f->halfEdge);
+}
+/// 面的所有顶点
+inline RingRange<FaceRingIterator<RingValue::Vertex>> faceVertices(const Face* f) {
+    return RingRange<FaceRingIterator<RingValue::Vertex>>(f->halfEdge);
+}
+
+} // namespace geometry
+
+#endif // GEOMETRY_CIRCULATORS_H
@@ -2,36 +2,33 @@
 #define GEOMETRY_HALFEDGE_H
 
 #include <vector>
-#include <map>
+#include <utility>
 #include <memory>
+#include <string>
+#include <span>
+#include <cstdint>
+#include <algorithm>
 #include <Eigen/Dense>
+#include "property.h"
 
 namespace geometry {
 
 class Vertex;
 class Face;
 class HalfEdge;
+class MeshCache;
 
+// 算法专用的数据(旧位置、颜色、纹理坐标、边界序号等)不再放在元素类里,
+// 通过 HalfEdgeMesh 的属性注册表按 index 存取, 见 property.h
 class Vertex {
 public:
     bool deleted = false; // 标记该半边是否被删除
-    bool fixed = false;// 是否是固定的点
-    bool handle = false; // 是否是拖拽控制点（handle点）
     Eigen::Vector3d position;
-	Eigen::Vector3d old_position; // 用于某些算法中存储旧位置
-	Eigen::Vector3d old_normal;   // 用于某些算法中存储旧法线
     Eigen::Vector3d normal;// 
-    Eigen::Vector2d texCoords;
-    Eigen::Vector3d color;
     HalfEdge* halfEdge;
-	int boundary_index = -1; // 边界索引，-1表示非边界顶点
 	int index;// 顶点索引
     Vertex(const Eigen::Vector3d& pos, int idx)
-        : position(pos), normal(Eigen::Vector3d::Zero()), texCoords(Eigen::Vector2d::Zero()),
-          color(Eigen::Vector3d::Ones()), halfEdge(nullptr), index(idx) {}
-    Vertex(const Eigen::Vector3d& pos, const Eigen::Vector3d& norm,
-           const Eigen::Vector2d& tex, const Eigen::Vector3d& col, int idx)
-        : position(pos), normal(norm), texCoords(tex), color(col), halfEdge(nullptr), index(idx) {}
+        : position(pos), normal(Eigen::Vector3d::Zero()), halfEdge(nullptr), index(idx) {}
     void computeNormal();
     void normalizeNormal() { if (normal.norm() > 0) normal.normalize(); }
     int getDegree() const;
@@ -44,9 +41,8 @@ public:
     HalfEdge* halfEdge;
     int index;
     Eigen::Vector3d normal;
-	Eigen::Vector3d old_normal; // 用于某些算法中存储旧法线
-	Eigen::Vector3d center_point;// 面心
-    Face(int idx) : halfEdge(nullptr), index(idx), normal(Eigen::Vector3d::Zero()) {}
+    double area;    ///< 缓存的面积, 由 computeNormal() 与法向量一起更新
+    Face(int idx) : halfEdge(nullptr), index(idx), normal(Eigen::Vector3d::Zero()), area(0.0) {}
     void computeNormal();
     double computeArea() const;
     int getVertexCount() const;
@@ -61,15 +57,75 @@ public:
     HalfEdge* next;   ///< 下一条
     HalfEdge* prev;   ///< 上一条
     HalfEdge* pair;   ///< 对偶
-    Eigen::Vector3d edgeColor; ///< 边颜色(默认白色)，可用于高亮特定边
 
-    HalfEdge() : vertex(nullptr), face(nullptr), next(nullptr), prev(nullptr), pair(nullptr), edgeColor(Eigen::Vector3d::Ones()) {}
+    HalfEdge() : index(-1), vertex(nullptr), face(nullptr), next(nullptr), prev(nullptr), pair(nullptr) {}
 
     double getLength() const;
     Eigen::Vector3d getDirection() const;
     bool isBoundary() const { return pair == nullptr; }
     Vertex* getEndVertex() const { return next->vertex; }
 };
+/**
+ * @brief 顶点邻接关系的压缩行(CSR)缓存, 每个顶点的段内包含自身(对角元)
+ *
+ * 邻接关系是对称的, 所以这份 outerIndex/innerIndex 可以原样作为
+ * Eigen::SparseMatrix(默认列主序)的压缩存储: 第 i 段就是第 i 列。
+ * 用 initMatrix() 复制模式后, 权值直接写入 valuePtr(), 不需要三元组排序:
+ *   values[adjacency.diagonal[i]]           -> A(i, i)
+ *   values[adjacency.halfEdgeSlot[h->index]] -> A(h 的起点, h 的终点)
+ */
+struct VertexAdjacency {
+    std::vector<int> outerIndex;   ///< 长度 nV + 1, 顶点 j 的邻接位于 [outerIndex[j], outerIndex[j + 1])
+    std::vector<int> innerIndex;   ///< 每段内按顶点号升序排列的邻接顶点(含自身)
+    std::vector<int> diagonal;     ///< A(i, i) 在数值数组中的位置
+    std::vector<int> halfEdgeSlot; ///< 半边 h(i -> j) 对应的 A(i, j) 在数值数组中的位置
+
+    int getVertexCount() const { return outerIndex.empty() ? 0 : static_cast<int>(outerIndex.size()) - 1; }
+    int nonZeros() const { return static_cast<int>(innerIndex.size()); }
+
+    /// A(row, col) 的位置(二分查找), 不在模式中时返回 -1
+    int slot(int row, int col) const {
+        auto first = innerIndex.begin() + outerIndex[col];
+        auto last = innerIndex.begin() + outerIndex[col + 1];
+        auto it = std::lower_bound(first, last, row);
+        return (it != last && *it == row) ? static_cast<int>(it - innerIndex.begin()) : -1;
+    }
+
+    /**
+     * @brief 把模式复制到列主序 Eigen::SparseMatrix(压缩模式), 数值全部置零
+     */
+    template <class SparseMatrixType>
+    void initMatrix(SparseMatrixType& matrix) const {
+        const int n = getVertexCount();
+        matrix.resize(n, n);
+        matrix.resizeNonZeros(nonZeros());
+        std::copy(outerIndex.begin(), outerIndex.end(), matrix.outerIndexPtr());
+        std::copy(innerIndex.begin(), innerIndex.end(), matrix.innerIndexPtr());
+        std::fill(matrix.valuePtr(), matrix.valuePtr() + nonZeros(), 0);
+    }
+};
+
+/**
+ * @brief 有序边界环的缓存
+ *
+ * 所有环的边界半边按环顺序连续存放, 第 l 个环位于 [loopOffsets[l], loopOffsets[l + 1])。
+ * 环的方向与面的朝向一致(沿边界半边 next 方向), 与各 hw 里原来的遍历顺序相同。
+ * 非流形的"蝴蝶结"顶点可能在环中出现多次, vertexSlot 记录它第一次出现的位置。
+ */
+struct BoundaryLoops {
+    std::vector<int> loopOffsets;   ///< 长度为环数 + 1
+    std::vector<int> halfEdges;     ///< 边界半边 index(pair 为空), 按环顺序
+    std::vector<int> vertices;      ///< 与 halfEdges 一一对应的起点 index
+    std::vector<double> arcLength;  ///< 从所在环起点沿边界到该顶点的累计弧长
+    std::vector<double> loopLength; ///< 每个环的周长
+    std::vector<int> vertexLoop;    ///< 每个顶点所在的环, 内部顶点和孤立顶点为 -1
+    std::vector<int> vertexSlot;    ///< 每个顶点在 vertices 中第一次出现的位置, 内部顶点为 -1
+
+    int loopCount() const { return loopOffsets.empty() ? 0 : static_cast<int>(loopOffsets.size()) - 1; }
+    int loopSize(int loop) const { return loopOffsets[loop + 1] - loopOffsets[loop]; }
+    bool isBoundaryVertex(int vertexIndex) const { return vertexLoop[vertexIndex] >= 0; }
+};
+
 // 什么是HalfEdgeMesh， 这个类主要是用来存储和操作半边数据结构的
 class HalfEdgeMesh {
 public:
@@ -87,8 +143,40 @@ public:
                       const std::vector<Eigen::Vector3d>& vertexNormals,
                       const std::vector<Eigen::Vector2d>& vertexTexCoords,
                       const std::vector<std::vector<int>>& faceIndices);
+    /**
+     * @brief 从扁平数组构建(零拷贝输入, 不创建中间容器)
+     * @param positions 顶点位置 xyz, 长度 3V(可以直接指向 QVector3D/MeshData 的数组)
+     * @param faceIndices 顶点索引; faceOffsets 为空时每 3 个为一个三角形
+     * @param faceOffsets 可选, 多边形面 f 的角点位于 faceIndices[faceOffsets[f], faceOffsets[f + 1])
+     */
+    void buildFromArrays(std::span<const float> positions,
+                         std::span<const std::uint32_t> faceIndices,
+                         std::span<const std::uint32_t> faceOffsets = {});
+    /**
+     * @brief 从二进制缓存(见 mesh_cache.h)直接恢复网格
+     * 连接关系按缓存中的下标数组直接接上指针, 不做半边配对; 边界环缓存一并恢复。
+     * 缓存中的下标越界时返回 false, 网格保持为空。
+     */
+    bool buildFromCache(const MeshCache& cache);
     void clear();
-    void computeNormals();
+    /**
+     * @brief 删除所有标记为 deleted 的元素, 压缩数组并把 index 重新编号为数组下标
+     * @param reorderForLocality 为 true 时在同一遍中按面的广度优先顺序重排面/半边/顶点
+     */
+    void garbageCollection(bool reorderForLocality = false);
+    /**
+     * @brief 按给定顺序(新下标 -> 旧下标)重排元素数组、属性、脏标记和非流形边记录
+     * 不在顺序中的元素被释放, 调用方要保证剩下的元素之间的指针不指向它们。
+     * @param relocate 为 true 时按新顺序重新分配元素对象(所有元素指针失效, 但遍历的内存访问连续),
+     *                 否则只移动指针, 元素对象地址不变
+     */
+    void permute(const std::vector<int>& vertexOrder, const std::vector<int>& faceOrder,
+                 const std::vector<int>& halfEdgeOrder, bool relocate = false);
+    void computeNormals(); ///< 全量(并行)重算所有面和顶点的法向量
+    /// 顶点位置被修改后调用, 记录脏顶点; 下次 updateNormals() 只重算受影响的面和顶点
+    void markVertexDirty(int vertexIndex);
+    /// 增量更新: 重算脏顶点相邻的面, 再重算这些面上所有顶点的法向量
+    void updateNormals();
     size_t getVertexCount() const { return vertices.size(); }
     size_t getFaceCount() const { return faces.size(); }
     size_t getHalfEdgeCount() const { return halfEdges.size(); }
@@ -96,10 +184,81 @@ public:
     bool isValid() const;
     std::pair<Eigen::Vector3d, Eigen::Vector3d> getBoundingBox() const;
     double getTotalSurfaceArea() const;
+    size_t memoryUsage() const; ///< 估算占用字节数(与 MeshKernel::memoryUsage 对比)
+    /// 最近一次构建中未能配对的非流形/朝向不一致边, 每条为 (较小, 较大) 顶点索引对, 整体按字典序排列
+    const std::vector<std::pair<int, int>>& getNonManifoldEdges() const { return nonManifoldEdges; }
+
+    // ---------------- 属性注册表 ----------------
+    // 按名字注册的逐元素数组, 用元素的 index 访问, 例如:
+    //   auto& oldPos = mesh.vertexProperty<Eigen::Vector3d>("v:old_position");
+    //   oldPos[v->index] = v->position;
+    // vertexProperty 在属性不存在时创建它(已存在则直接返回), getVertexProperty 只查找。
+    // 重新构建网格时已注册的属性会保留, 数组长度随元素数量调整并填充默认值。
+    template <class T>
+    Property<T>& vertexProperty(const std::string& name, const T& defaultValue = T()) {
+        return vertexProps.add<T>(name, defaultValue);
+    }
+    template <class T>
+    Property<T>& faceProperty(const std::string& name, const T& defaultValue = T()) {
+        return faceProps.add<T>(name, defaultValue);
+    }
+    template <class T>
+    Property<T>& halfEdgeProperty(const std::string& name, const T& defaultValue = T()) {
+        return halfEdgeProps.add<T>(name, defaultValue);
+    }
+    template <class T>
+    Property<T>* getVertexProperty(const std::string& name) const { return vertexProps.get<T>(name); }
+    template <class T>
+    Property<T>* getFaceProperty(const std::string& name) const { return faceProps.get<T>(name); }
+    template <class T>
+    Property<T>* getHalfEdgeProperty(const std::string& name) const { return halfEdgeProps.get<T>(name); }
+    void removeVertexProperty(const std::string& name) { vertexProps.remove(name); }
+    void removeFaceProperty(const std::string& name) { faceProps.remove(name); }
+    void removeHalfEdgeProperty(const std::string& name) { halfEdgeProps.remove(name); }
+
+    PropertyContainer& vertexProperties() { return vertexProps; }
+    PropertyContainer& faceProperties() { return faceProps; }
+    PropertyContainer& halfEdgeProperties() { return halfEdgeProps; }
+    /// 元素数组被外部直接修改后(如 MeshKernel::toHalfEdgeMesh), 调整属性数组长度
+    void resizeProperties();
+
+    /// 顶点邻接 CSR(首次调用时构建并缓存, 拓扑改变前一直有效)
+    const VertexAdjacency& getAdjacency();
+    /// 有序边界环(拓扑部分缓存, 弧长每次按当前位置重新累加)
+    const BoundaryLoops& getBoundaryLoops();
+    /// O(1) 边界判断: 只读边界环的拓扑缓存, 不累加弧长。
+    /// 缓存失效后的第一次调用会重建它, 在并行循环中使用前应先调用一次(或 getBoundaryLoops)
+    bool isBoundaryVertex(int vertexIndex) {
+        ensureBoundaryLoops();
+        return boundary.isBoundaryVertex(vertexIndex);
+    }
+    /// 拓扑被外部直接修改后调用, 丢弃邻接和边界环缓存并递增拓扑版本号
+    void invalidateTopologyCaches() {
+        adjacencyValid = false;
+        boundaryValid = false;
+        ++topologyVersion;
+    }
+    /// 拓扑版本号: 重建、垃圾回收或 invalidateTopologyCaches 时递增, 只移动顶点时不变
+    std::uint64_t getTopologyVersion() const { return topologyVersion; }
 private:
-    HalfEdge* getOrCreateHalfEdgePair(Vertex* v1, Vertex* v2,
-                                      std::map<std::pair<int,int>, HalfEdge*>& edgeMap,
-                                      HalfEdge* currentHalfEdge);
+    std::vector<std::pair<int, int>> nonManifoldEdges;
+    std::vector<int> dirtyVertices;
+    std::vector<char> vertexDirtyFlag;
+    VertexAdjacency adjacency;
+    bool adjacencyValid = false;
+    BoundaryLoops boundary;
+    bool boundaryValid = false;
+    std::uint64_t topologyVersion = 0;
+    PropertyContainer vertexProps;
+    PropertyContainer faceProps;
+    PropertyContainer halfEdgeProps;
+    void buildFaces(const std::vector<std::vector<int>>& faceIndices);
+    void pairHalfEdges();
+    void ensureBoundaryLoops() {
+        if (!boundaryValid) buildBoundaryLoops();
+    }
+    void buildBoundaryLoops();       ///< 只遍历拓扑, 填写 loopOffsets/halfEdges/vertices/vertexLoop/vertexSlot
+    void updateBoundaryArcLength();  ///< 按当前位置重新累加 arcLength/loopLength
 };
 
 } // namespace geometry
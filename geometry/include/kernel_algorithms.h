@@ -0,0 +1,382 @@
+﻿#ifndef GEOMETRY_KERNEL_ALGORITHMS_H
+#define GEOMETRY_KERNEL_ALGORITHMS_H
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include "halfedge.h"
+#include "parallel.h"
+
+namespace geometry {
+namespace detail {
+
+/**
+ * @brief BasicMeshKernel 与 BasicTriangleMesh 共用的算法实现
+ *
+ * 两种网格只在拓扑访问上不同(next/prev/face 存储或由下标算出, 边界半边显式或不存在),
+ * 下面的函数只通过这组接口访问拓扑:
+ *   halfEdge(v), faceHalfEdge(f), next(h), prev(h), twin(h), face(h),
+ *   fromVertex(h), toVertex(h), rotate(h), isBoundaryVertex(v)
+ * 三角网格另外提供 faceVertices(f), 面内计算直接取三个角点。
+ * 约定: face(h) < 0 表示边界半边; twin(h) 或 rotate(h) 为 InvalidIndex 表示没有对偶(扇形末端)。
+ * MeshKernel 的 rotate 总能回到起点, 处理扇形末端的分支对它不会执行。
+ */
+
+/**
+ * @brief 面的面积向量, 模长是面积的两倍, 方向为面法向
+ * 提供 faceVertices(f) 的三角网格直接用三个角点的叉积, 其余沿 next 用 Newell 方法
+ */
+template <class Mesh>
+typename Mesh::AccumulatorVector3 faceAreaVector(const Mesh& mesh, typename Mesh::Index f) {
+    using Index = typename Mesh::Index;
+    using Accumulator = typename Mesh::Accumulator;
+    using AccumulatorVector3 = typename Mesh::AccumulatorVector3;
+    if constexpr (requires { mesh.faceVertices(f); }) {
+        const Index* fv = mesh.faceVertices(f);
+        const AccumulatorVector3 p0 = mesh.positions[fv[0]].template cast<Accumulator>();
+        const AccumulatorVector3 p1 = mesh.positions[fv[1]].template cast<Accumulator>();
+        const AccumulatorVector3 p2 = mesh.positions[fv[2]].template cast<Accumulator>();
+        return (p1 - p0).cross(p2 - p0);
+    }
+    AccumulatorVector3 n = AccumulatorVector3::Zero();
+    const Index start = mesh.faceHalfEdge(f);
+    Index h = start;
+    do {
+        const AccumulatorVector3 v1 = mesh.positions[mesh.fromVertex(h)].template cast<Accumulator>();
+        const AccumulatorVector3 v2 = mesh.positions[mesh.toVertex(h)].template cast<Accumulator>();
+        n.x() += (v1.y() - v2.y()) * (v1.z() + v2.z());
+        n.y() += (v1.z() - v2.z()) * (v1.x() + v2.x());
+        n.z() += (v1.x() - v2.x()) * (v1.y() + v2.y());
+        h = mesh.next(h);
+    } while (h != start);
+    return n;
+}
+
+/**
+ * @brief 法向计算中一批同时处理的元素个数
+ * 每批的坐标按分量放进定长 Eigen::Array, 逐分量的运算由 Eigen 展开成 SIMD 指令(SSE2/AVX/NEON),
+ * 与编译器是否自动向量化无关。8 个 double 正好是两个 AVX 寄存器或四个 SSE2 寄存器。
+ */
+constexpr int NormalBatchSize = 8;
+
+/// 三角形的三个角点; 不是三角形时返回 false(由调用方回退到 faceAreaVector)
+template <class Mesh>
+bool triangleCorners(const Mesh& mesh, typename Mesh::Index f, typename Mesh::Index (&corners)[3]) {
+    using Index = typename Mesh::Index;
+    if constexpr (requires { mesh.faceVertices(f); }) {
+        const Index* fv = mesh.faceVertices(f);
+        corners[0] = fv[0];
+        corners[1] = fv[1];
+        corners[2] = fv[2];
+        return true;
+    }
+    const Index h0 = mesh.faceHalfEdge(f);
+    const Index h1 = mesh.next(h0);
+    const Index h2 = mesh.next(h1);
+    if (mesh.next(h2) != h0) return false;
+    corners[0] = mesh.fromVertex(h0);
+    corners[1] = mesh.fromVertex(h1);
+    corners[2] = mesh.fromVertex(h2);
+    return true;
+}
+
+/**
+ * @brief 所有面的面积向量(见 faceAreaVector), 按 NormalBatchSize 个面一批并行计算
+ * 三角形的角点先聚集到分量数组再统一做叉积; 多边形面逐个走 faceAreaVector。
+ * 每个面在 Accumulator 中计算, 按存储精度 Scalar 写出(float 网格的中间数组也只占一半)
+ */
+template <class Mesh>
+void computeFaceAreaVectors(const Mesh& mesh, std::vector<typename Mesh::Vector3>& areaVectors) {
+    using Index = typename Mesh::Index;
+    using Scalar = typename Mesh::Vector3::Scalar;
+    using Accumulator = typename Mesh::Accumulator;
+    using Lanes = Eigen::Array<Accumulator, NormalBatchSize, 1>;
+    const size_t nF = mesh.getFaceCount();
+    areaVectors.resize(nF);
+    const size_t batches = (nF + NormalBatchSize - 1) / NormalBatchSize;
+    parallel::parallelFor(0, batches, [&](size_t b) {
+        const size_t begin = b * NormalBatchSize;
+        const int count = static_cast<int>(std::min<size_t>(NormalBatchSize, nF - begin));
+        Lanes x[3], y[3], z[3];
+        bool polygon[NormalBatchSize] = {};
+        for (int l = 0; l < NormalBatchSize; ++l) {
+            Index corners[3] = { 0, 0, 0 }; // 末批补齐的空位和多边形面用顶点 0 占位, 结果不写回
+            if (l < count && !triangleCorners(mesh, static_cast<Index>(begin + l), corners)) {
+                polygon[l] = true;
+                corners[0] = corners[1] = corners[2] = 0;
+            }
+            for (int k = 0; k < 3; ++k) {
+                const auto& p = mesh.positions[corners[k]];
+                x[k][l] = static_cast<Accumulator>(p.x());
+                y[k][l] = static_cast<Accumulator>(p.y());
+                z[k][l] = static_cast<Accumulator>(p.z());
+            }
+        }
+        const Lanes ux = x[1] - x[0], uy = y[1] - y[0], uz = z[1] - z[0];
+        const Lanes vx = x[2] - x[0], vy = y[2] - y[0], vz = z[2] - z[0];
+        const Lanes nx = uy * vz - uz * vy;
+        const Lanes ny = uz * vx - ux * vz;
+        const Lanes nz = ux * vy - uy * vx;
+        for (int l = 0; l < count; ++l) {
+            const Index f = static_cast<Index>(begin + l);
+            const typename Mesh::AccumulatorVector3 n = polygon[l] ? faceAreaVector(mesh, f)
+                                                                   : typename Mesh::AccumulatorVector3(nx[l], ny[l], nz[l]);
+            areaVectors[f] = n.template cast<Scalar>();
+        }
+    }, 256);
+}
+
+/**
+ * @brief 面积加权的顶点法向(与 HalfEdgeMesh::computeNormals 相同), 并行计算
+ * 面积向量由 computeFaceAreaVectors 成批计算; 顶点一环的累加是不规则的聚集访问,
+ * 逐个顶点进行, 归一化再按批在分量数组上完成
+ */
+template <class Mesh>
+void computeVertexNormals(const Mesh& mesh, std::vector<typename Mesh::Vector3>& normals) {
+    using Index = typename Mesh::Index;
+    using Scalar = typename Mesh::Vector3::Scalar;
+    using Accumulator = typename Mesh::Accumulator;
+    using AccumulatorVector3 = typename Mesh::AccumulatorVector3;
+    using Lanes = Eigen::Array<Accumulator, NormalBatchSize, 1>;
+    const size_t nV = mesh.getVertexCount();
+
+    // 不归一化直接累加就是面积加权
+    std::vector<typename Mesh::Vector3> faceNormals;
+    computeFaceAreaVectors(mesh, faceNormals);
+
+    normals.resize(nV);
+    const size_t batches = (nV + NormalBatchSize - 1) / NormalBatchSize;
+    parallel::parallelFor(0, batches, [&](size_t b) {
+        const size_t begin = b * NormalBatchSize;
+        const int count = static_cast<int>(std::min<size_t>(NormalBatchSize, nV - begin));
+        Lanes nx = Lanes::Zero(), ny = Lanes::Zero(), nz = Lanes::Zero();
+        for (int l = 0; l < count; ++l) {
+            AccumulatorVector3 n = AccumulatorVector3::Zero();
+            const Index start = mesh.halfEdge(static_cast<Index>(begin + l));
+            Index h = start;
+            while (h >= 0) {
+                if (mesh.face(h) >= 0) n += faceNormals[mesh.face(h)].template cast<Accumulator>();
+                h = mesh.rotate(h);
+                if (h == start) break;
+            }
+            nx[l] = n.x();
+            ny[l] = n.y();
+            nz[l] = n.z();
+        }
+        const Lanes length = (nx * nx + ny * ny + nz * nz).sqrt();
+        const Lanes scale = (length > 0).select(length.inverse(), Lanes::Ones());
+        nx *= scale;
+        ny *= scale;
+        nz *= scale;
+        for (int l = 0; l < count; ++l) {
+            normals[begin + l] = AccumulatorVector3(nx[l], ny[l], nz[l]).template cast<Scalar>();
+        }
+    }, 256);
+}
+
+/**
+ * @brief cotangent 平均曲率的模长(与 hw2 cotangentCurvature 的公式相同)
+ * 只处理三角形; 边界顶点、孤立顶点和扇形不闭合的非流形顶点结果为 0。
+ * 每个顶点在 Accumulator 中累加, 结果按存储精度写出
+ */
+template <class Mesh>
+void computeMeanCurvature(const Mesh& mesh, std::vector<typename Mesh::Vector3::Scalar>& curvature) {
+    using Index = typename Mesh::Index;
+    using Scalar = typename Mesh::Vector3::Scalar;
+    using Accumulator = typename Mesh::Accumulator;
+    using AccumulatorVector3 = typename Mesh::AccumulatorVector3;
+    const Index nV = static_cast<Index>(mesh.getVertexCount());
+    curvature.assign(nV, Scalar(0));
+    parallel::parallelFor(0, nV, [&](size_t v) {
+        if (mesh.isBoundaryVertex(static_cast<Index>(v))) return;
+        const AccumulatorVector3 pi = mesh.positions[v].template cast<Accumulator>();
+        AccumulatorVector3 laplacian = AccumulatorVector3::Zero();
+        Accumulator area = 0.0;
+        const Index start = mesh.halfEdge(static_cast<Index>(v));
+        Index h = start;
+        do {
+            // h: vi -> v1, 两侧三角形的第三个顶点 v0(h 所在面) 和 v2(对偶所在面)
+            const Index t = mesh.twin(h);
+            if (t < 0 || mesh.face(t) < 0) return; // 扇形不闭合: 与边界顶点一样跳过, 不保留部分结果
+            const AccumulatorVector3 p1 = mesh.positions[mesh.toVertex(h)].template cast<Accumulator>();
+            const AccumulatorVector3 p0 = mesh.positions[mesh.toVertex(mesh.next(h))].template cast<Accumulator>();
+            const AccumulatorVector3 p2 = mesh.positions[mesh.toVertex(mesh.next(t))].template cast<Accumulator>();
+
+            const AccumulatorVector3 e01 = p1 - p0, e0i = pi - p0;
+            const AccumulatorVector3 e21 = p1 - p2, e2i = pi - p2;
+            const Accumulator cot0 = e01.dot(e0i) / e01.cross(e0i).norm();
+            const Accumulator cot2 = e21.dot(e2i) / e21.cross(e2i).norm();
+
+            laplacian += (cot0 + cot2) * (p1 - pi);
+            area += e01.cross(e0i).norm() + e21.cross(e2i).norm();
+            h = mesh.next(t);
+        } while (h != start);
+        curvature[v] = area > 0 ? static_cast<Scalar>((laplacian / (4 * area)).norm()) : Scalar(0);
+    }, 1024);
+}
+
+/**
+ * @brief 每个顶点的一环邻接顶点, 按 rotate 的顺序排成 CSR(offsets 长度为顶点数 + 1)
+ * 边界扇形的末端补上起始出边前一条入边的起点, 与逐半边遍历得到的邻域相同
+ */
+template <class Mesh>
+void buildVertexRings(const Mesh& mesh, std::vector<typename Mesh::Index>& offsets,
+                      std::vector<typename Mesh::Index>& ring) {
+    using Index = typename Mesh::Index;
+    const size_t nV = mesh.getVertexCount();
+    // 两遍遍历: 先数度数, 前缀和之后每个顶点写自己的区间
+    auto visit = [&](Index v, auto&& emit) {
+        const Index start = mesh.halfEdge(v);
+        Index h = start;
+        while (h >= 0) {
+            emit(mesh.toVertex(h));
+            const Index r = mesh.rotate(h);
+            if (r < 0) emit(mesh.fromVertex(mesh.prev(start))); // 边界扇形末端
+            h = r;
+            if (h == start) break;
+        }
+    };
+    offsets.assign(nV + 1, 0);
+    parallel::parallelFor(0, nV, [&](size_t v) {
+        Index degree = 0;
+        visit(static_cast<Index>(v), [&](Index) { ++degree; });
+        offsets[v + 1] = degree;
+    });
+    for (size_t v = 0; v < nV; ++v) offsets[v + 1] += offsets[v];
+    ring.resize(offsets[nV]);
+    parallel::parallelFor(0, nV, [&](size_t v) {
+        Index k = offsets[v];
+        visit(static_cast<Index>(v), [&](Index n) { ring[k++] = n; });
+    });
+}
+
+/**
+ * @brief 均匀权 Laplace 平滑(与 hw10 相同): p <- p + lambda * (邻域平均 - p)
+ * 开始时把一环邻域整理成 buildVertexRings 的紧凑数组, 之后每次迭代只读位置和邻接下标、写新位置数组,
+ * 不再访问半边数组; 顶点之间互不依赖, 可以直接并行。
+ * 每次迭代后调用 onIteration(完成的迭代次数, 迭代前的位置), 返回 false 时提前停止
+ */
+template <class Mesh, class IterationCallback>
+void laplacianSmooth(Mesh& mesh, int iterations, typename Mesh::Accumulator lambda, IterationCallback&& onIteration) {
+    using Index = typename Mesh::Index;
+    using Vector3 = typename Mesh::Vector3;
+    using Scalar = typename Vector3::Scalar;
+    using Accumulator = typename Mesh::Accumulator;
+    using AccumulatorVector3 = typename Mesh::AccumulatorVector3;
+    if (iterations <= 0) return;
+    const size_t nV = mesh.getVertexCount();
+    std::vector<Index> offsets, ring;
+    buildVertexRings(mesh, offsets, ring);
+    std::vector<Vector3> newPositions(nV);
+    for (int iter = 0; iter < iterations; ++iter) {
+        const std::vector<Vector3>& positions = mesh.positions;
+        parallel::parallelFor(0, nV, [&](size_t v) {
+            const Index begin = offsets[v];
+            const Index end = offsets[v + 1];
+            if (begin == end) {
+                newPositions[v] = positions[v];
+                return;
+            }
+            AccumulatorVector3 sum = AccumulatorVector3::Zero();
+            for (Index k = begin; k < end; ++k) sum += positions[ring[k]].template cast<Accumulator>();
+            const AccumulatorVector3 p = positions[v].template cast<Accumulator>();
+            newPositions[v] = (p + lambda * (sum / Accumulator(end - begin) - p)).template cast<Scalar>();
+        });
+        mesh.positions.swap(newPositions);
+        if (!onIteration(iter + 1, static_cast<const std::vector<Vector3>&>(newPositions))) return;
+    }
+}
+
+template <class Mesh>
+void laplacianSmooth(Mesh& mesh, int iterations, typename Mesh::Accumulator lambda) {
+    laplacianSmooth(mesh, iterations, lambda, [](int, const auto&) { return true; });
+}
+
+/**
+ * @brief 从 HalfEdgeMesh 取出位置和面列表(按 vertex->index 对应顶点), 交给 Mesh::build
+ */
+template <class Mesh>
+Mesh fromHalfEdgeMesh(const HalfEdgeMesh& mesh) {
+    std::vector<Eigen::Vector3d> vertexPositions(mesh.vertices.size());
+    for (const auto& vertex : mesh.vertices) {
+        vertexPositions[vertex->index] = vertex->position;
+    }
+
+    std::vector<std::vector<int>> faceIndices;
+    faceIndices.reserve(mesh.faces.size());
+    for (const auto& face : mesh.faces) {
+        if (face->deleted || !face->halfEdge) continue;
+        std::vector<int> loop;
+        HalfEdge* he = face->halfEdge;
+        do {
+            loop.push_back(he->vertex->index);
+            he = he->next;
+        } while (he && he != face->halfEdge);
+        faceIndices.push_back(std::move(loop));
+    }
+
+    Mesh result;
+    result.build(vertexPositions, faceIndices);
+    return result;
+}
+
+/**
+ * @brief 导出为 HalfEdgeMesh, 拓扑直接由数组转换, 不再做对偶配对
+ * 只为面半边创建对象(按原顺序编号), 边界半边和缺失的对偶映射为 nullptr(与 buildFromOBJ 结果一致)
+ */
+template <class Mesh>
+void toHalfEdgeMesh(const Mesh& source, HalfEdgeMesh& mesh) {
+    using Index = typename Mesh::Index;
+    mesh.clear();
+    const Index nV = static_cast<Index>(source.getVertexCount());
+    const Index nF = static_cast<Index>(source.getFaceCount());
+    const Index nH = static_cast<Index>(source.getHalfEdgeCount());
+
+    mesh.vertices.reserve(nV);
+    for (Index v = 0; v < nV; ++v) {
+        mesh.vertices.push_back(std::make_unique<Vertex>(source.positions[v].template cast<double>(), v));
+    }
+    mesh.faces.reserve(nF);
+    for (Index f = 0; f < nF; ++f) {
+        mesh.faces.push_back(std::make_unique<Face>(f));
+    }
+
+    std::vector<HalfEdge*> map(nH, nullptr);
+    mesh.halfEdges.reserve(nH);
+    for (Index h = 0; h < nH; ++h) {
+        if (source.face(h) < 0) continue;
+        auto he = std::make_unique<HalfEdge>();
+        he->index = static_cast<int>(mesh.halfEdges.size());
+        he->vertex = mesh.vertices[source.fromVertex(h)].get();
+        he->face = mesh.faces[source.face(h)].get();
+        map[h] = he.get();
+        mesh.halfEdges.push_back(std::move(he));
+    }
+    for (Index h = 0; h < nH; ++h) {
+        HalfEdge* he = map[h];
+        if (!he) continue;
+        he->next = map[source.next(h)];
+        he->next->prev = he;
+        const Index t = source.twin(h);
+        he->pair = t >= 0 ? map[t] : nullptr;
+    }
+    for (Index f = 0; f < nF; ++f) {
+        mesh.faces[f]->halfEdge = map[source.faceHalfEdge(f)];
+    }
+    for (Index v = 0; v < nV; ++v) {
+        Index h = source.halfEdge(v);
+        if (h < 0) continue;
+        // 边界顶点: 取边界出边逆时针旋转后的第一条面半边,
+        // 这样沿 pair->next 遍历可以覆盖整个扇形
+        if (source.face(h) < 0) h = source.rotate(h);
+        mesh.vertices[v]->halfEdge = map[h];
+    }
+
+    mesh.resizeProperties();
+    mesh.computeNormals();
+}
+
+} // namespace detail
+} // namespace geometry
+
+#endif // GEOMETRY_KERNEL_ALGORITHMS_H
@@ -0,0 +1,54 @@
+﻿#ifndef GEOMETRY_MAPPED_FILE_H
+#define GEOMETRY_MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+
+namespace geometry {
+
+/**
+ * @brief 只读内存映射文件(Windows 用 CreateFileMapping, 其他平台用 mmap)
+ *
+ * 映射后整个文件可以当作一段连续的 const char 访问, 由操作系统按页加载,
+ * 解析器可以直接在上面切块并行处理, 不需要先读进自己的缓冲区。
+ * 空文件可以成功打开, 此时 data() 为 nullptr、size() 为 0。
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path) { open(path); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept { swap(other); }
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            swap(other);
+        }
+        return *this;
+    }
+
+    /// 映射整个文件, 失败时输出错误并返回 false
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return open_; }
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    void swap(MappedFile& other) noexcept;
+
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool open_ = false;
+    void* fileHandle_ = nullptr;    ///< Windows 文件句柄
+    void* mappingHandle_ = nullptr; ///< Windows 映射句柄
+    int fd_ = -1;                   ///< POSIX 文件描述符
+};
+
+} // namespace geometry
+
+#endif // GEOMETRY_MAPPED_FILE_H
@@ -0,0 +1,119 @@
+﻿#ifndef GEOMETRY_MESH_CACHE_H
+#define GEOMETRY_MESH_CACHE_H
+
+#include <string>
+#include <span>
+#include <cstdint>
+#include <cstddef>
+#include "mapped_file.h"
+
+namespace geometry {
+
+class HalfEdgeMesh;
+
+/// 缓存文件格式版本, 布局或内容约定改变时递增(旧版本缓存会被视为无效并重新生成)
+/// 2: 界面程序的缓存保存三角化并重排后的网格(与交给处理函数的顶点/索引一一对应), 不再是文件中的多边形
+constexpr std::uint32_t MeshCacheVersion = 2;
+
+/// 缓存中的数据段, 每段 8 字节对齐
+enum class MeshCacheSection : std::uint32_t {
+    Positions,      ///< double xyz, 3V
+    VertexHalfEdge, ///< 顶点出边, V, 孤立顶点为 -1
+    FaceHalfEdge,   ///< 面的起始半边, F
+    HalfEdgeVertex, ///< 半边起点, H
+    HalfEdgeFace,   ///< 半边所在面, H
+    HalfEdgeNext,   ///< H
+    HalfEdgePrev,   ///< H
+    HalfEdgeTwin,   ///< 对偶半边, H, 边界半边为 -1
+    LoopOffsets,    ///< 边界环偏移, L + 1
+    LoopHalfEdges,  ///< 按环顺序排列的边界半边, B
+    Count
+};
+
+/**
+ * @brief 缓存文件头, 按本机字节序写入
+ * sourceSize/sourceTime 记录生成缓存时源文件的大小和修改时间, 用来判断缓存是否过期
+ */
+struct MeshCacheHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t endianTag; ///< 0x01020304, 读入时不一致说明字节序不同
+    std::uint64_t fileSize;
+    std::uint64_t sourceSize;
+    std::int64_t sourceTime;
+    std::uint64_t vertexCount;
+    std::uint64_t faceCount;
+    std::uint64_t halfEdgeCount;
+    std::uint64_t loopCount;
+    std::uint64_t boundaryCount;
+    std::uint64_t sectionOffset[static_cast<size_t>(MeshCacheSection::Count)];
+};
+
+/**
+ * @brief 只读的二进制网格缓存(内存映射)
+ *
+ * 保存位置和完整的半边连接关系(next/prev/twin/vertex/face 以及边界环),
+ * 打开时只检查文件头和各段范围, 数据直接在映射内存上访问, 不做任何解析。
+ * HalfEdgeMesh::buildFromCache 用这些数组直接连接指针, 不需要重新配对半边。
+ */
+class MeshCache {
+public:
+    MeshCache() = default;
+    explicit MeshCache(const std::string& path) { open(path); }
+
+    /// 映射并校验缓存文件, 格式或版本不符时返回 false
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return header_ != nullptr; }
+
+    /// 源文件的大小和修改时间是否与生成缓存时一致
+    bool matchesSource(const std::string& sourcePath) const;
+
+    const MeshCacheHeader& header() const { return *header_; }
+    size_t getVertexCount() const { return static_cast<size_t>(header_->vertexCount); }
+    size_t getFaceCount() const { return static_cast<size_t>(header_->faceCount); }
+    size_t getHalfEdgeCount() const { return static_cast<size_t>(header_->halfEdgeCount); }
+    size_t getLoopCount() const { return static_cast<size_t>(header_->loopCount); }
+
+    std::span<const double> positions() const { return section<double>(MeshCacheSection::Positions, 3 * getVertexCount()); }
+    std::span<const std::int32_t> vertexHalfEdge() const { return indices(MeshCacheSection::VertexHalfEdge, getVertexCount()); }
+    std::span<const std::int32_t> faceHalfEdge() const { return indices(MeshCacheSection::FaceHalfEdge, getFaceCount()); }
+    std::span<const std::int32_t> halfEdgeVertex() const { return indices(MeshCacheSection::HalfEdgeVertex, getHalfEdgeCount()); }
+    std::span<const std::int32_t> halfEdgeFace() const { return indices(MeshCacheSection::HalfEdgeFace, getHalfEdgeCount()); }
+    std::span<const std::int32_t> halfEdgeNext() const { return indices(MeshCacheSection::HalfEdgeNext, getHalfEdgeCount()); }
+    std::span<const std::int32_t> halfEdgePrev() const { return indices(MeshCacheSection::HalfEdgePrev, getHalfEdgeCount()); }
+    std::span<const std::int32_t> halfEdgeTwin() const { return indices(MeshCacheSection::HalfEdgeTwin, getHalfEdgeCount()); }
+    std::span<const std::int32_t> loopOffsets() const { return indices(MeshCacheSection::LoopOffsets, getLoopCount() + 1); }
+    std::span<const std::int32_t> loopHalfEdges() const {
+        return indices(MeshCacheSection::LoopHalfEdges, static_cast<size_t>(header_->boundaryCount));
+    }
+
+private:
+    template <class T>
+    std::span<const T> section(MeshCacheSection s, size_t count) const {
+        const char* base = file.data() + header_->sectionOffset[static_cast<size_t>(s)];
+        return { reinterpret_cast<const T*>(base), count };
+    }
+    std::span<const std::int32_t> indices(MeshCacheSection s, size_t count) const {
+        return section<std::int32_t>(s, count);
+    }
+
+    MappedFile file;
+    const MeshCacheHeader* header_ = nullptr;
+};
+
+/// 源文件对应的缓存路径(同目录下的 <源文件名>.hecache)
+std::string meshCachePath(const std::string& sourcePath);
+
+/**
+ * @brief 把半边网格写成缓存文件
+ *
+ * 网格中不能有标记为 deleted 的元素(先调用 garbageCollection), index 必须等于数组下标。
+ * 先写入唯一命名的临时文件再改名: 其他进程不会读到写了一半的缓存, 并发写同一缓存的进程/线程也不会互相覆盖临时文件。
+ * @param sourcePath 非空时记录源文件的大小和修改时间, 供 matchesSource 判断是否过期
+ */
+bool writeMeshCache(const std::string& path, HalfEdgeMesh& mesh, const std::string& sourcePath = std::string());
+
+} // namespace geometry
+
+#endif // GEOMETRY_MESH_CACHE_H
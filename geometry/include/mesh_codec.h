@@ -0,0 +1,62 @@
+﻿#ifndef GEOMETRY_MESH_CODEC_H
+#define GEOMETRY_MESH_CODEC_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace geometry {
+
+class HalfEdgeMesh;
+struct MeshData;
+
+/// 压缩格式版本, 码流布局改变时递增
+constexpr std::uint32_t MeshCodecVersion = 1;
+
+/**
+ * @brief 压缩参数
+ */
+struct MeshCodecOptions {
+    int positionBits = 16;          ///< 每个坐标分量的量化位数(1~24), 按包围盒最长边统一量化
+    size_t blockFaces = 1 << 14;    ///< 每个独立块的面数, 块越小解码并行度越高(块内哈希表也更容易留在缓存中)
+};
+
+/**
+ * @brief 把半边网格压缩成字节流
+ *
+ * 码流由若干互不依赖的块组成, 每块包含一段连续的面:
+ *  - 面按对偶图广度优先顺序遍历, 顶点按第一次被引用的顺序重新编号(块内顶点编号连续);
+ *  - 连接关系: 每个角点编码为"新顶点"、最近引用缓存(move-to-front)中的位置,
+ *    或相对上一次显式引用的顶点编号差值;
+ *  - 位置: 量化后用平行四边形预测(相邻三角形已在本块解码时), 否则用面内已知顶点或前一个顶点预测, 只存残差;
+ *  - 所有符号流都用静态 rANS 熵编码。
+ * 预测只使用本块的顶点, 所以块可以并行编码和解码。已删除的元素被跳过。
+ * @param vertexOrder 可选输出, 解码后第 i 个顶点对应的原顶点 index
+ */
+bool encodeMesh(const HalfEdgeMesh& mesh, std::vector<std::uint8_t>& bytes,
+                const MeshCodecOptions& options = MeshCodecOptions(),
+                std::vector<int>* vertexOrder = nullptr);
+
+/**
+ * @brief 解码 encodeMesh 生成的字节流(各块多线程并行解码)
+ *
+ * 得到的 MeshData 只有 positions/faceOffsets/faceVertices, 顶点为遍历顺序,
+ * 位置精度为量化精度。码流损坏或截断时输出错误并返回 false。
+ */
+bool decodeMesh(const std::uint8_t* bytes, size_t size, MeshData& data);
+bool decodeMesh(const std::uint8_t* bytes, size_t size, HalfEdgeMesh& mesh);
+
+/**
+ * @brief 压缩文件(.gpmc)的读写
+ * MeshData 版本先构建半边网格再压缩, 用于只有面列表的调用方。
+ */
+bool writeCompressedMesh(const std::string& path, const HalfEdgeMesh& mesh,
+                         const MeshCodecOptions& options = MeshCodecOptions());
+bool writeCompressedMesh(const std::string& path, const MeshData& data,
+                         const MeshCodecOptions& options = MeshCodecOptions());
+bool readCompressedMesh(const std::string& path, MeshData& data);
+
+} // namespace geometry
+
+#endif // GEOMETRY_MESH_CODEC_H
@@ -4,8 +4,12 @@
 #include <QVector3D>
 #include <vector>
 #include <utility>
+#include <span>
+#include <cstdint>
+#include <limits>
 #include <Eigen/Dense>
 #include "halfedge.h"
+#include "triangle_order.h"
 
 namespace geometry {
 
@@ -39,20 +43,55 @@ public:
 
  /**
  * @brief buildMeshFromQtData ʹ Qt  +  ݽṹ
+ * ֱԱƽ齻 HalfEdgeMesh::buildFromArrays, м
  * @param mesh  HalfEdgeMesh (ڲؽ)
  * @param qVertices б (λ)
  * @param indices Ƭ (ÿ3һ)
+ * @param cache ǿλúһͬʱ HalfEdgeMesh::buildFromCache(԰),
+ *              һʱԻ
  */
  static void buildMeshFromQtData(HalfEdgeMesh& mesh,
  const std::vector<QVector3D>& qVertices,
- const std::vector<unsigned int>& indices);
+ const std::vector<unsigned int>& indices,
+ const MeshCache* cache = nullptr);
 
  /**
  * @brief convertMeshToQtData HalfEdgeMesh -> (QVector3D , )
+ *  exportIndices , ˳ͬ
+ * @param stats ǿʱдǰ ACMR
  * @return pair(, )
  */
  static std::pair<std::vector<QVector3D>, std::vector<unsigned int>>
- convertMeshToQtData(const HalfEdgeMesh& mesh);
+ convertMeshToQtData(const HalfEdgeMesh& mesh, TriangleOrderStats* stats = nullptr);
+
+ // ---------------- () ----------------
+ // д÷ float (xyz ,  i λ out[3i]), ڴ;
+ // ֻд [begin, end) ڵĶ, 峤Ϊ 3 * min(end, )
+ // ֻ˰汾ű仯ʱд, ֻƶıÿֻ֡Ҫλá
+
+ /// δʱʹõİ汾
+ static constexpr std::uint64_t NoTopologyVersion = std::numeric_limits<std::uint64_t>::max();
+
+ ///  QVector3D 鿴 float 
+ static std::span<float> asFloatSpan(std::vector<QVector3D>& vertices);
+
+ static void exportPositions(const HalfEdgeMesh& mesh, std::span<float> out,
+ size_t begin = 0, size_t end = std::numeric_limits<size_t>::max());
+ static void exportNormals(const HalfEdgeMesh& mesh, std::span<float> out,
+ size_t begin = 0, size_t end = std::numeric_limits<size_t>::max());
+ ///  "v:color" ʱдɫ
+ static void exportColors(const HalfEdgeMesh& mesh, std::span<float> out,
+ size_t begin = 0, size_t end = std::numeric_limits<size_t>::max());
+
+ /**
+ * @brief exportIndices ˰汾 version ͬʱд
+ * ȫΪʱ, д㻺/Ȼ(optimizeTriangleOrder, Ų)
+ * @param version ϴεʱİ汾(״ NoTopologyVersion), ǰ汾
+ * @param stats ǿҷʱдǰ ACMR
+ * @return дʱ true
+ */
+ static bool exportIndices(const HalfEdgeMesh& mesh, std::vector<unsigned int>& indices, std::uint64_t& version,
+ TriangleOrderStats* stats = nullptr);
 };
 
 } // namespace geometry
@@ -0,0 +1,170 @@
+﻿#ifndef GEOMETRY_MESH_IO_H
+#define GEOMETRY_MESH_IO_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <Eigen/Dense>
+#include "mapped_file.h"
+
+namespace geometry {
+
+class HalfEdgeMesh;
+
+/**
+ * @brief 从文件读入的原始多边形网格(与具体格式无关)
+ *
+ * 所有数据都是扁平数组, 可以直接交给 GPU 或半边构建:
+ *  - 面 f 的角点位于 [faceOffsets[f], faceOffsets[f + 1])
+ *  - faceTexCoords/faceNormals 与 faceVertices 一一对应, 某个角点没有 vt/vn 时为 -1,
+ *    整个文件都没有 vt/vn 时数组为空
+ *  - 所有索引都从 0 开始, 且已检查过范围
+ */
+struct MeshData {
+    std::vector<float> positions;             ///< 顶点位置 xyz
+    std::vector<float> texCoords;             ///< 纹理坐标 uv
+    std::vector<float> normals;               ///< 法向 xyz
+    std::vector<std::uint32_t> faceOffsets;   ///< 长度为面数 + 1
+    std::vector<std::int32_t> faceVertices;   ///< 每个角点的顶点索引
+    std::vector<std::int32_t> faceTexCoords;  ///< 每个角点的纹理坐标索引
+    std::vector<std::int32_t> faceNormals;    ///< 每个角点的法向索引
+    std::vector<float> quality;               ///< 逐顶点标量(例如曲率), 为空表示没有; 只有 PLY 会写出
+
+    size_t getVertexCount() const { return positions.size() / 3; }
+    size_t getFaceCount() const { return faceOffsets.empty() ? 0 : faceOffsets.size() - 1; }
+    size_t getCornerCount() const { return faceVertices.size(); }
+    bool isEmpty() const { return positions.empty() || getFaceCount() == 0; }
+    void clear();
+
+    /// 转为 HalfEdgeMesh::buildFromOBJ 使用的格式
+    std::vector<Eigen::Vector3d> getPositions() const;
+    std::vector<std::vector<int>> getFaceLists() const;
+};
+
+/**
+ * @brief 读取 OBJ 文件(内存映射 + 多线程解析)
+ *
+ * 支持 v / vt / vn / f, 面可以是任意多边形, 角点可以写成 v、v/vt、v//vn、v/vt/vn,
+ * 索引可以为负(相对于当前已读入的元素数)。其他记录(o/g/s/usemtl/注释等)被忽略。
+ * 越界索引所在的面会被跳过并给出警告。
+ */
+bool readOBJ(const std::string& path, MeshData& data);
+
+/**
+ * @brief 解析内存中的 OBJ 文本, readOBJ 的核心
+ */
+bool parseOBJ(const char* text, size_t size, MeshData& data);
+
+/**
+ * @brief 读取二进制 PLY(大端或小端)
+ *
+ * 顶点元素取 x/y/z, 可选 nx/ny/nz 和 u/v(或 s/t、texture_u/texture_v), 类型任意;
+ * 面元素取 vertex_indices(或 vertex_index)列表, 计数和索引类型任意;
+ * 其余元素和属性(包括列表)按头部描述跳过。
+ * 顶点记录恰好是本机字节序的 float x/y/z 时整块拷贝, 否则按记录并行提取。
+ */
+bool readPLY(const std::string& path, MeshData& data);
+bool parsePLY(const char* bytes, size_t size, MeshData& data);
+
+/**
+ * @brief 读取 STL(二进制或 ASCII), 并焊接重合的顶点
+ *
+ * STL 每个三角形都自带三个顶点坐标, 直接使用会得到互不相连的三角形汤,
+ * 因此读入后用 weldVertices 合并位置相同的角点, 退化的三角形被删除。
+ * 面法向存入 normals, 每个角点的 faceNormals 指向所在三角形的法向。
+ * @param weldTolerance 焊接网格尺寸, 0 表示只合并坐标完全相同的角点
+ */
+bool readSTL(const std::string& path, MeshData& data, float weldTolerance = 0.0f);
+bool parseSTL(const char* bytes, size_t size, MeshData& data, float weldTolerance = 0.0f);
+
+/**
+ * @brief 空间哈希焊接: 把 n 个角点位置(xyz 连续存放)合并成顶点
+ *
+ * 每个角点按坐标(tolerance > 0 时按 tolerance 取整后的格子)求 64 位哈希,
+ * 并行基数排序后相同哈希的角点相邻, 在组内比较格子坐标确定代表角点。
+ * 顶点按代表角点第一次出现的顺序编号, 结果与线程数无关。
+ * tolerance > 0 时只合并落在同一格子里的点, 跨格子边界的近邻不会合并。
+ * @param cornerPositions 输入, 长度 3n
+ * @param positions 输出, 焊接后的顶点位置
+ * @param cornerVertex 输出, 长度 n, 每个角点对应的顶点下标
+ */
+void weldVertices(const std::vector<float>& cornerPositions, float tolerance,
+                  std::vector<float>& positions, std::vector<std::int32_t>& cornerVertex);
+
+/**
+ * @brief 按记录随机访问的二进制 PLY 三角网格(内存映射, 不把数据读入内存)
+ *
+ * 供流式(out-of-core)处理使用: 顶点和面都按定长记录直接在映射上读取。
+ * 要求顶点元素只含标量属性, 面元素只有 vertex_indices 一个列表且全部是三角形,
+ * 其他元素也必须是定长的; writePLY 写出的三角网格满足这些条件。
+ */
+class PlyTriangleStream {
+public:
+    /// 映射文件并检查布局, 不满足条件时输出错误并返回 false
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return file.isOpen() && vertexStride > 0; }
+
+    size_t getVertexCount() const { return vertexCount; }
+    size_t getFaceCount() const { return faceCount; }
+    Eigen::Vector3f position(size_t v) const;
+    void triangle(size_t f, std::uint32_t vertices[3]) const;
+
+private:
+    MappedFile file;
+    bool swap = false;
+    size_t vertexCount = 0;
+    size_t faceCount = 0;
+    const char* vertexData = nullptr;
+    size_t vertexStride = 0;
+    size_t positionOffset[3] = {};
+    int positionType[3] = {};
+    const char* faceData = nullptr;
+    size_t faceStride = 0;
+    size_t indexOffset = 0; ///< 记录内第一个索引的偏移(跳过计数)
+    int indexType = 0;
+};
+
+/**
+ * @brief 按扩展名(.obj/.ply/.stl/.gpmc, 不区分大小写)选择读取器
+ * .gpmc 为 mesh_codec.h 中的压缩格式
+ */
+bool readMesh(const std::string& path, MeshData& data);
+
+/**
+ * @brief 把半边网格导出为 MeshData(跳过已删除的元素, 顶点重新连续编号)
+ *
+ * withNormals 为 true 时写入逐顶点法向, 顶点属性 "v:texcoord"(Eigen::Vector2d)存在时写入纹理坐标,
+ * 这两种属性都是逐顶点的, 角点的 vt/vn 索引等于顶点索引。
+ * 顶点属性 "v:quality"(double)存在时写入 quality。
+ */
+void exportMeshData(const HalfEdgeMesh& mesh, MeshData& data, bool withNormals = true);
+
+/**
+ * @brief 写出 OBJ(含 vt/vn)
+ *
+ * 顶点和面分块并行用 std::to_chars 格式化(浮点数为可精确读回的最短表示),
+ * 拼成一整块缓冲后一次写入文件。
+ */
+bool writeOBJ(const std::string& path, const MeshData& data);
+bool writeOBJ(const std::string& path, const HalfEdgeMesh& mesh);
+
+/**
+ * @brief 写出本机字节序的二进制 PLY
+ *
+ * 顶点记录为 float x/y/z, 法向和纹理坐标是逐顶点的时候追加 nx/ny/nz、u/v, 有 quality 时追加 quality
+ * (MeshLab 等按这个属性名把标量映射为颜色);
+ * 只有位置时顶点数据直接从 positions 整块拷贝。面记录的位置可由 faceOffsets 直接算出, 并行写入。
+ */
+bool writePLY(const std::string& path, const MeshData& data);
+bool writePLY(const std::string& path, const HalfEdgeMesh& mesh);
+
+/**
+ * @brief 按扩展名(.obj/.ply/.gpmc, 不区分大小写)选择写出格式
+ */
+bool writeMesh(const std::string& path, const MeshData& data);
+
+} // namespace geometry
+
+#endif // GEOMETRY_MESH_IO_H
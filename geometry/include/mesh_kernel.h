@@ -0,0 +1,164 @@
+﻿#ifndef GEOMETRY_MESH_KERNEL_H
+#define GEOMETRY_MESH_KERNEL_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <Eigen/Dense>
+
+namespace geometry {
+
+class HalfEdgeMesh;
+
+/**
+ * @brief 标量类型对应的累加精度
+ *
+ * 位置和各算法输出的逐元素数组(面积向量、法向、曲率)可以用 float 存储, 这些数组的内存和带宽减半;
+ * 但面积/法向/曲率这类求和仍在 double 中进行, 结果再转回存储精度。
+ * 拓扑下标在两种精度下都是 32 位, 所以整个内核的占用并不减半。需要其他组合时特化这个模板即可。
+ */
+template <class Scalar>
+struct ScalarTraits {
+    using Accumulator = double;
+};
+
+/**
+ * @brief BasicMeshKernel 连续存储(SoA)的半边网格内核, 按位置的标量类型模板化
+ *
+ * MeshKernel(double) 与 HalfEdgeMesh 精度一致; MeshKernelf(float) 只存 float 位置,
+ * 几何计算在 ScalarTraits<float>::Accumulator(double) 中累加, 即混合精度模式。
+ * 两种实例在 mesh_kernel.cpp 中显式实例化。
+ *
+ * 与 HalfEdgeMesh 的区别:
+ *  - 所有元素用 32 位索引(句柄)表示, 不再逐个 new 对象
+ *  - 位置/拓扑全部存放在并行数组中, 遍历一环邻域时只访问连续内存
+ *  - 对偶半边隐式存储: twin(h) == h ^ 1, 每条无向边占用相邻的两个半边槽
+ *  - 边界半边显式存在(face == -1), 其 next 沿边界环连接
+ *
+ * 约定(与 HalfEdge 一致): heVertex[h] 为半边的起点。
+ * 需要指针风格 API 时, 用 toHalfEdgeMesh()/fromHalfEdgeMesh() 互相转换。
+ */
+template <class Scalar>
+class BasicMeshKernel {
+public:
+    using Index = std::int32_t;
+    using Vector3 = Eigen::Matrix<Scalar, 3, 1>;
+    using Accumulator = typename ScalarTraits<Scalar>::Accumulator;
+    using AccumulatorVector3 = Eigen::Matrix<Accumulator, 3, 1>;
+    static constexpr Index InvalidIndex = -1;
+
+    // ---------------- 并行数组 ----------------
+    std::vector<Vector3> positions;         ///< 顶点位置(紧密排列)
+    std::vector<Index> vHalfEdge;           ///< 顶点 -> 一条出边(边界顶点优先取边界出边)
+    std::vector<Index> fHalfEdge;           ///< 面 -> 一条半边
+    std::vector<Index> heNext;              ///< 半边 -> 下一条
+    std::vector<Index> heVertex;            ///< 半边 -> 起点
+    std::vector<Index> heFace;              ///< 半边 -> 所在面(-1 表示边界半边)
+
+    BasicMeshKernel() = default;
+
+    /**
+     * @brief 从顶点位置和多边形面列表构建内核(与 HalfEdgeMesh::buildFromOBJ 的输入一致)
+     * 输入精度与存储精度不同时逐个转换
+     */
+    void build(const std::vector<Eigen::Vector3d>& vertexPositions,
+               const std::vector<std::vector<int>>& faceIndices);
+    void build(const std::vector<Eigen::Vector3f>& vertexPositions,
+               const std::vector<std::vector<int>>& faceIndices);
+    void clear();
+
+    // ---------------- 规模 ----------------
+    size_t getVertexCount() const { return positions.size(); }
+    size_t getFaceCount() const { return fHalfEdge.size(); }
+    size_t getHalfEdgeCount() const { return heNext.size(); }
+    size_t getEdgeCount() const { return heNext.size() / 2; }
+    bool isEmpty() const { return positions.empty(); }
+
+    // ---------------- 拓扑访问 ----------------
+    static Index twin(Index h) { return h ^ 1; }
+    static Index edge(Index h) { return h >> 1; }
+    Index next(Index h) const { return heNext[h]; }
+    Index prev(Index h) const;
+    Index fromVertex(Index h) const { return heVertex[h]; }
+    Index toVertex(Index h) const { return heVertex[heNext[h]]; }
+    Index face(Index h) const { return heFace[h]; }
+    Index halfEdge(Index v) const { return vHalfEdge[v]; }
+    Index faceHalfEdge(Index f) const { return fHalfEdge[f]; }
+    /// 绕起点逆时针旋转到下一条出边
+    Index rotate(Index h) const { return heNext[twin(h)]; }
+
+    bool isBoundaryHalfEdge(Index h) const { return heFace[h] < 0; }
+    bool isBoundaryEdge(Index h) const { return heFace[h] < 0 || heFace[twin(h)] < 0; }
+    /// 构建时边界出边被放在 vHalfEdge 中, 因此是 O(1)
+    bool isBoundaryVertex(Index v) const {
+        Index h = vHalfEdge[v];
+        return h < 0 || heFace[h] < 0;
+    }
+
+    const Vector3& position(Index v) const { return positions[v]; }
+    Vector3& position(Index v) { return positions[v]; }
+
+    int getDegree(Index v) const;
+    int getFaceVertexCount(Index f) const;
+
+    // ---------------- 几何(在 Accumulator 精度中计算) ----------------
+    Vector3 computeFaceNormal(Index f) const;
+    Accumulator computeFaceArea(Index f) const;
+    Accumulator getTotalSurfaceArea() const;
+
+    /**
+     * @brief 面积加权的顶点法向(与 HalfEdgeMesh::computeNormals 相同), 并行计算
+     */
+    void computeVertexNormals(std::vector<Vector3>& normals) const;
+
+    /**
+     * @brief cotangent 平均曲率的模长(与 hw2 cotangentCurvature 的公式相同), 按存储精度输出
+     * 只处理三角形; 边界顶点、孤立顶点和扇形不闭合的非流形顶点结果为 0
+     */
+    void computeMeanCurvature(std::vector<Scalar>& curvature) const;
+
+    /// 平滑的逐迭代回调: (已完成的迭代次数, 本次迭代前的位置), 返回 false 时停止
+    using SmoothCallback = std::function<bool(int iteration, const std::vector<Vector3>& previous)>;
+
+    /**
+     * @brief 均匀权 Laplace 平滑(与 hw10 相同): p <- p + lambda * (邻域平均 - p)
+     * 一环邻域先整理成紧凑的下标数组, 每次迭代只读位置和这组下标、写新数组, 顶点之间并行
+     * @param onIteration 非空时每次迭代后调用, 用于进度、取消和统计位移
+     */
+    void laplacianSmooth(int iterations, Accumulator lambda, const SmoothCallback& onIteration = {});
+
+    bool isValid() const;
+
+    /// 估算内核占用的字节数(所有数组容量之和)
+    size_t memoryUsage() const;
+
+    // ---------------- 与指针风格 HalfEdgeMesh 的适配 ----------------
+    /**
+     * @brief 从 HalfEdgeMesh 构建内核(按 vertex->index 对应顶点)
+     * 没有已删除元素时直接翻译 next/pair, 不再重新配对
+     */
+    static BasicMeshKernel fromHalfEdgeMesh(const HalfEdgeMesh& mesh);
+
+    /**
+     * @brief 把内核导出为 HalfEdgeMesh, 拓扑直接由数组转换, 不再做对偶配对
+     * 边界半边不会生成对象, 对应的 pair 为 nullptr(与 buildFromOBJ 结果一致)
+     */
+    void toHalfEdgeMesh(HalfEdgeMesh& mesh) const;
+
+private:
+    /// positions 已写入后, 由面列表建立拓扑
+    void buildTopology(const std::vector<std::vector<int>>& faceIndices);
+    /// 连接边界半边的 next 并选出每个顶点的出边(面半边和边界半边的起点已写入)
+    void linkBoundary();
+};
+
+extern template class BasicMeshKernel<float>;
+extern template class BasicMeshKernel<double>;
+
+using MeshKernel = BasicMeshKernel<double>;
+using MeshKernelf = BasicMeshKernel<float>;
+
+} // namespace geometry
+
+#endif // GEOMETRY_MESH_KERNEL_H
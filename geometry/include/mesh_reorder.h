@@ -0,0 +1,59 @@
+﻿#ifndef GEOMETRY_MESH_REORDER_H
+#define GEOMETRY_MESH_REORDER_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace geometry {
+
+class HalfEdgeMesh;
+
+/// 元素重排策略
+enum class MeshOrdering {
+    FaceLocality,        ///< 面按对偶图广度优先, 顶点按第一次被访问的顺序(与 garbageCollection(true) 相同)
+    Morton,              ///< 顶点按位置的 Morton(Z 序)编码排序
+    Hilbert,             ///< 顶点按位置的 Hilbert 曲线编码排序, 相邻性比 Morton 更好
+    ReverseCuthillMcKee  ///< 顶点按 RCM 排序, 使拉普拉斯矩阵带宽最小, 适合直接分解
+};
+
+/**
+ * @brief 一次重排的置换, 三个数组都是 新下标 -> 旧下标
+ * 可以用来把重排后网格上的逐元素结果映射回原始顺序, 或交给 restoreMeshOrder 还原网格本身。
+ */
+struct MeshPermutation {
+    std::vector<int> vertexOrder;
+    std::vector<int> faceOrder;
+    std::vector<int> halfEdgeOrder;
+
+    bool isEmpty() const { return vertexOrder.empty() && faceOrder.empty() && halfEdgeOrder.empty(); }
+};
+
+/**
+ * @brief 计算重排顺序(不修改网格), 已删除的元素不出现在结果中
+ *
+ * 顶点顺序由策略决定; 除 FaceLocality 外, 面按其最小的新顶点编号稳定排序,
+ * 所以按面遍历时顶点访问基本单调。每个面的半边总是按面的顺序连续存放。
+ */
+MeshPermutation computeMeshOrdering(const HalfEdgeMesh& mesh, MeshOrdering ordering);
+
+/**
+ * @brief 按指定策略重排网格的所有元素数组、index、属性和缓存
+ *
+ * 元素对象按新顺序重新分配, 遍历时的内存访问也随之连续; 所有元素指针都会失效。
+ * 网格中有已删除的元素时先执行 garbageCollection(), 返回的置换相对于回收之后的网格。
+ */
+MeshPermutation reorderMesh(HalfEdgeMesh& mesh, MeshOrdering ordering);
+
+/**
+ * @brief 撤销 reorderMesh, 把网格恢复为重排之前的顺序(期间拓扑不能改变)
+ * 元素数量与置换不一致时输出错误并返回 false。
+ */
+bool restoreMeshOrder(HalfEdgeMesh& mesh, const MeshPermutation& permutation);
+
+/// 置换的逆(旧下标 -> 新下标), 不在置换中的下标为 -1
+std::vector<int> invertOrder(const std::vector<int>& order, size_t size);
+
+} // namespace geometry
+
+#endif // GEOMETRY_MESH_REORDER_H
@@ -0,0 +1,51 @@
+﻿#ifndef GEOMETRY_OUT_OF_CORE_H
+#define GEOMETRY_OUT_OF_CORE_H
+
+#include <string>
+#include <cstddef>
+
+namespace geometry {
+
+/**
+ * @brief 流式(out-of-core)处理的参数
+ */
+struct StreamingOptions {
+    size_t maxChunkVertices = size_t(1) << 20; ///< 每块拥有的顶点数目标上限(不含重叠区)
+    int smoothIterations = 0;                  ///< 均匀 Laplace 平滑迭代次数(与 hw10 相同), 0 表示不平滑
+    double smoothLambda = 0.5;
+    bool computeNormals = true;                ///< 输出面积加权顶点法向 nx/ny/nz
+    bool computeCurvature = false;             ///< 输出平均曲率(与 hw2 的 cotangent 公式相同), 属性名 curvature
+    std::string tempDirectory;                 ///< 分块临时文件目录, 为空时使用输出文件所在目录
+};
+
+/**
+ * @brief 流式处理的统计信息, maxLocalVertices/maxLocalFaces 决定峰值内存
+ */
+struct StreamingStats {
+    size_t chunkCount = 0;
+    size_t maxLocalVertices = 0; ///< 单块(含重叠区)的最大顶点数
+    size_t maxLocalFaces = 0;    ///< 单块(含重叠区)的最大面数
+};
+
+/**
+ * @brief 对大于内存的三角网格做流式局部处理, 输入输出都是二进制 PLY
+ *
+ * 输入通过 PlyTriangleStream 内存映射访问, 整个过程不建立全局的网格对象:
+ *  1. 把包围盒划成均匀格子(最多 2^18 个), 统计每个格子的顶点数和以格子内顶点为端点的最长边;
+ *  2. 按顶点数递归二分格子(kd 划分)得到块, 每块拥有的顶点数不超过 maxChunkVertices;
+ *  3. 每块的重叠区 = 从块出发走"环数"步能到达的格子, 每一步从一个格子最多走出该格子的最长边,
+ *     环数 = 平滑迭代次数 + (需要法向或曲率时再加 1), 保证每个被拥有顶点所依赖的所有顶点
+ *     都带着完整的一环邻域落在块内; 长边只加宽它所在的地方, 不影响网格的其他部分;
+ *  4. 面按顶点所在格子写入各块的临时文件(保持原始面顺序);
+ *  5. 逐块读入临时文件, 在局部 MeshKernelf 上做平滑/法向/曲率, 只写回本块拥有的顶点。
+ * 每个顶点只由一个块写出, 接缝两侧结果一致; 输出的顶点顺序与输入相同, 面顺序也相同,
+ * 但顶点索引越界的面被跳过(不写入输出)。
+ * 峰值内存取决于单块(含重叠区)的大小, 与输入总规模无关。
+ * 单个格子的顶点数超过上限, 或重叠区内的顶点数超过上限的 4 倍时给出警告。
+ */
+bool processOutOfCore(const std::string& inputPath, const std::string& outputPath,
+                      const StreamingOptions& options, StreamingStats* stats = nullptr);
+
+} // namespace geometry
+
+#endif // GEOMETRY_OUT_OF_CORE_H
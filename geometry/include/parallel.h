@@ -0,0 +1,192 @@
+﻿#ifndef GEOMETRY_PARALLEL_H
+#define GEOMETRY_PARALLEL_H
+
+#include <vector>
+#include <array>
+#include <thread>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include "thread_pool.h"
+
+namespace geometry {
+namespace parallel {
+
+/**
+ * @brief 可用的硬件线程数(至少为 1)
+ */
+inline unsigned hardwareThreads() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1u : n;
+}
+
+/**
+ * @brief 计算 [0, n) 按 grain 粒度切块时使用的块数(不超过硬件线程数)
+ */
+inline unsigned chunkCount(size_t n, size_t grain) {
+    if (n == 0) return 0;
+    size_t chunks = (n + grain - 1) / grain;
+    return static_cast<unsigned>(std::min<size_t>(chunks, hardwareThreads()));
+}
+
+/**
+ * @brief 在全局线程池(见 thread_pool.h)中运行 tasks 个任务 f(t), 调用线程也参与执行
+ * 任务之间不能互相等待; 在池中的任务里调用(嵌套并行)时不会创建新线程。
+ */
+template <class F>
+void runTasks(unsigned tasks, F&& f) {
+    if (hardwareThreads() == 1) { // 单核上切换线程只有开销
+        for (unsigned t = 0; t < tasks; ++t) f(t);
+        return;
+    }
+    ThreadPool::global().run(tasks, f);
+}
+
+/**
+ * @brief 并行遍历 [begin, end), 每个元素调用 f(i)
+ * 元素少于 grain 时直接在当前线程执行; 否则切成至多 4 倍线程数的块, 先做完的线程窃取剩下的块
+ */
+template <class F>
+void parallelFor(size_t begin, size_t end, F&& f, size_t grain = 4096) {
+    if (end <= begin) return;
+    const size_t n = end - begin;
+    grain = std::max<size_t>(1, grain);
+    const size_t chunks = std::min<size_t>((n + grain - 1) / grain, size_t(4) * hardwareThreads());
+    const size_t step = (n + chunks - 1) / chunks;
+    runTasks(static_cast<unsigned>((n + step - 1) / step), [&](unsigned t) {
+        const size_t b = begin + t * step;
+        const size_t e = std::min(end, b + step);
+        for (size_t i = b; i < e; ++i) f(i);
+    });
+}
+
+/**
+ * @brief 确定性的并行归约: 返回 combine(...combine(identity, map(begin))..., map(end - 1))
+ *
+ * [begin, end) 按固定的 grain 切块(与线程数无关), 块内从左到右累积, 块结果再按块顺序合并,
+ * 所以同样的输入和 grain 在任何线程数、任何调度下都得到逐位相同的结果(浮点求和也一样)。
+ * combine 需要满足结合律, identity 是它的单位元。
+ */
+template <class T, class Map, class Combine>
+T parallelReduce(size_t begin, size_t end, T identity, Map map, Combine combine, size_t grain = 4096) {
+    if (end <= begin) return identity;
+    grain = std::max<size_t>(1, grain);
+    const size_t blocks = (end - begin + grain - 1) / grain;
+    std::vector<T> partial(blocks, identity);
+    parallelFor(0, blocks, [&](size_t k) {
+        const size_t b = begin + k * grain;
+        const size_t e = std::min(end, b + grain);
+        T value = identity;
+        for (size_t i = b; i < e; ++i) value = combine(value, map(i));
+        partial[k] = value;
+    }, 1);
+    T result = identity;
+    for (const T& value : partial) result = combine(result, value);
+    return result;
+}
+
+/// map(i) 在 [begin, end) 上的和, 确定性同 parallelReduce
+template <class T, class Map>
+T parallelSum(size_t begin, size_t end, T zero, Map map, size_t grain = 4096) {
+    return parallelReduce(begin, end, zero, map, [](const T& a, const T& b) -> T { return a + b; }, grain);
+}
+
+/// map(i) 在 [begin, end) 上的最小值, 区间为空时返回 init(init 也参与比较)
+template <class T, class Map>
+T parallelMin(size_t begin, size_t end, T init, Map map, size_t grain = 4096) {
+    return parallelReduce(begin, end, init, map, [](const T& a, const T& b) { return std::min(a, b); }, grain);
+}
+
+/// map(i) 在 [begin, end) 上的最大值, 区间为空时返回 init(init 也参与比较)
+template <class T, class Map>
+T parallelMax(size_t begin, size_t end, T init, Map map, size_t grain = 4096) {
+    return parallelReduce(begin, end, init, map, [](const T& a, const T& b) { return std::max(a, b); }, grain);
+}
+
+/**
+ * @brief 并行遍历网格的顶点/面/半边, f 收到元素指针(下标为 e->index)
+ * 模板参数是网格类型, 可以用于 HalfEdgeMesh 或 const HalfEdgeMesh; 网格中不能有已删除的空位。
+ * 每个元素只应写自己的数据(或按自己的 index 写属性), 需要汇总时用 parallelReduce。
+ */
+template <class Mesh, class F>
+void forEachVertex(Mesh& mesh, F&& f, size_t grain = 1024) {
+    parallelFor(0, mesh.vertices.size(), [&](size_t i) { f(mesh.vertices[i].get()); }, grain);
+}
+
+template <class Mesh, class F>
+void forEachFace(Mesh& mesh, F&& f, size_t grain = 1024) {
+    parallelFor(0, mesh.faces.size(), [&](size_t i) { f(mesh.faces[i].get()); }, grain);
+}
+
+template <class Mesh, class F>
+void forEachHalfEdge(Mesh& mesh, F&& f, size_t grain = 2048) {
+    parallelFor(0, mesh.halfEdges.size(), [&](size_t i) { f(mesh.halfEdges[i].get()); }, grain);
+}
+
+/**
+ * @brief 并行 LSD 基数排序(稳定), 每轮 8 位
+ * @param data 待排序数组
+ * @param keyBits 键的有效位数(只处理低 keyBits 位)
+ * @param key 键提取函数, 返回 std::uint64_t
+ *
+ * 每个线程统计自己分块的直方图, 按 (数位, 线程) 顺序求前缀和后分散写入,
+ * 因此与串行版本结果完全相同(相同键保持原始顺序)。
+ */
+template <class T, class KeyFn>
+void parallelRadixSort(std::vector<T>& data, int keyBits, KeyFn key) {
+    const size_t n = data.size();
+    if (n < 2 || keyBits <= 0) return;
+
+    const unsigned chunks = std::max(1u, chunkCount(n, 1 << 16));
+    const size_t step = (n + chunks - 1) / chunks;
+    std::vector<T> buffer(n);
+    std::vector<std::array<size_t, 256>> histogram(chunks);
+
+    for (int shift = 0; shift < keyBits; shift += 8) {
+        runTasks(chunks, [&](unsigned t) {
+            auto& h = histogram[t];
+            h.fill(0);
+            const size_t b = t * step;
+            const size_t e = std::min(n, b + step);
+            for (size_t i = b; i < e; ++i) {
+                ++h[(key(data[i]) >> shift) & 0xFF];
+            }
+        });
+
+        size_t offset = 0;
+        for (size_t digit = 0; digit < 256; ++digit) {
+            for (unsigned t = 0; t < chunks; ++t) {
+                const size_t count = histogram[t][digit];
+                histogram[t][digit] = offset;
+                offset += count;
+            }
+        }
+
+        runTasks(chunks, [&](unsigned t) {
+            auto& h = histogram[t];
+            const size_t b = t * step;
+            const size_t e = std::min(n, b + step);
+            for (size_t i = b; i < e; ++i) {
+                buffer[h[(key(data[i]) >> shift) & 0xFF]++] = data[i];
+            }
+        });
+        data.swap(buffer);
+    }
+}
+
+/**
+ * @brief 表示 [0, n) 内的值需要的位数
+ */
+inline int bitWidth(std::uint64_t n) {
+    int bits = 0;
+    while (n > 0) {
+        ++bits;
+        n >>= 1;
+    }
+    return bits;
+}
+
+} // namespace parallel
+} // namespace geometry
+
+#endif // GEOMETRY_PARALLEL_H
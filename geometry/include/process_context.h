@@ -0,0 +1,89 @@
+﻿#ifndef GEOMETRY_PROCESS_CONTEXT_H
+#define GEOMETRY_PROCESS_CONTEXT_H
+
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+
+namespace geometry {
+
+/**
+ * @brief 长时间运行的处理任务的上下文: 协作式取消 + 进度上报
+ *
+ * 调用方通过 cancel() 请求取消, 内核在迭代之间轮询 isCancelled() 并尽快返回(结果视为无效)。
+ * 进度以 [0, 1] 的比例上报, 回调只在整数百分比增加时触发, 可以在任意线程(包括并行循环内)调用。
+ * 拷贝共享同一份状态; subRange 返回把进度映射到父区间一段的拷贝, 用于把多个阶段串起来。
+ * 默认构造的上下文永不取消, 进度被忽略, 适合同步调用。
+ */
+class ProcessContext {
+public:
+    using ProgressCallback = std::function<void(int)>; ///< 参数为 0-100 的百分比
+
+    ProcessContext() = default;
+
+    /// 创建一个新任务的上下文, callback 可以为空
+    static ProcessContext create(ProgressCallback callback = {}) {
+        ProcessContext context;
+        context.state = std::make_shared<State>();
+        context.state->callback = std::move(callback);
+        return context;
+    }
+
+    /// 请求取消(线程安全, 可重复调用)
+    void cancel() const {
+        if (state) state->cancelled.store(true, std::memory_order_relaxed);
+    }
+
+    bool isCancelled() const {
+        return state && state->cancelled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 上报当前阶段内的进度
+     * @param fraction 阶段内完成的比例, 超出 [0, 1] 时截断; 比已上报的进度小时忽略
+     */
+    void setProgress(double fraction) const {
+        if (!state || !state->callback || isCancelled()) return; // 已取消的任务不再刷新进度
+        fraction = std::clamp(fraction, 0.0, 1.0);
+        const int percent = static_cast<int>(std::floor(100.0 * (begin + (end - begin) * fraction)));
+        int last = state->percent.load(std::memory_order_relaxed);
+        while (percent > last) {
+            if (state->percent.compare_exchange_weak(last, percent, std::memory_order_relaxed)) {
+                state->callback(percent);
+                return;
+            }
+        }
+    }
+
+    /// 上报第 done 步(共 total 步)完成
+    void setProgress(size_t done, size_t total) const {
+        setProgress(total == 0 ? 1.0 : static_cast<double>(done) / static_cast<double>(total));
+    }
+
+    /// 本阶段的 [from, to] 比例区间对应的子上下文(共享取消状态)
+    ProcessContext subRange(double from, double to) const {
+        ProcessContext context = *this;
+        from = std::clamp(from, 0.0, 1.0);
+        to = std::clamp(to, from, 1.0);
+        context.begin = begin + (end - begin) * from;
+        context.end = begin + (end - begin) * to;
+        return context;
+    }
+
+private:
+    struct State {
+        std::atomic<bool> cancelled { false };
+        std::atomic<int> percent { -1 };
+        ProgressCallback callback;
+    };
+
+    std::shared_ptr<State> state;
+    double begin = 0.0;
+    double end = 1.0;
+};
+
+} // namespace geometry
+
+#endif // GEOMETRY_PROCESS_CONTEXT_H
@@ -0,0 +1,41 @@
+﻿#ifndef GEOMETRY_PROCESS_PARAMS_H
+#define GEOMETRY_PROCESS_PARAMS_H
+
+#include <map>
+#include <string>
+#include <string_view>
+
+namespace geometry {
+
+/**
+ * @brief 处理算法的命名参数(字符串键值对)
+ *
+ * 由命令行的 key=value 或界面设置填入, 算法按名字读取并给出默认值, 所以未设置的参数保持算法原来的行为。
+ * 值无法解析为所需类型时输出警告并使用默认值。
+ */
+class ProcessParams {
+public:
+    ProcessParams() = default;
+
+    /// 解析一条 "key=value", 缺少 '=' 或键为空时输出错误并返回 false
+    bool parse(std::string_view assignment);
+
+    void set(const std::string& key, std::string value) { values[key] = std::move(value); }
+    bool has(const std::string& key) const { return values.count(key) > 0; }
+    bool isEmpty() const { return values.empty(); }
+
+    std::string getString(const std::string& key, const std::string& fallback) const;
+    double getDouble(const std::string& key, double fallback) const;
+    int getInt(const std::string& key, int fallback) const;
+    bool getBool(const std::string& key, bool fallback) const; ///< 接受 1/0, true/false, on/off, yes/no
+
+    /// 所有参数, 按键排序
+    const std::map<std::string, std::string>& entries() const { return values; }
+
+private:
+    std::map<std::string, std::string> values;
+};
+
+} // namespace geometry
+
+#endif // GEOMETRY_PROCESS_PARAMS_H
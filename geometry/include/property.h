@@ -0,0 +1,156 @@
+﻿#ifndef GEOMETRY_PROPERTY_H
+#define GEOMETRY_PROPERTY_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <utility>
+#include <iostream>
+#include <algorithm>
+
+namespace geometry {
+
+/**
+ * @brief 属性数组的类型擦除基类
+ * 每个属性是一段按元素 index 排列的连续数组, 元素增删时由 PropertyContainer 统一调整长度
+ */
+class BaseProperty {
+public:
+    explicit BaseProperty(std::string name) : name_(std::move(name)) {}
+    virtual ~BaseProperty() = default;
+
+    const std::string& name() const { return name_; }
+    virtual void resize(size_t n) = 0;
+    /// 按 newToOld 重排: 新数组第 i 个元素取旧数组第 newToOld[i] 个, 长度变为 newToOld.size()
+    virtual void reorder(const std::vector<int>& newToOld) = 0;
+    virtual size_t memoryUsage() const = 0;
+
+private:
+    std::string name_;
+};
+
+/**
+ * @brief 类型为 T 的属性数组, 用元素 index 访问: prop[v->index]
+ */
+template <class T>
+class Property : public BaseProperty {
+public:
+    using reference = typename std::vector<T>::reference;
+    using const_reference = typename std::vector<T>::const_reference;
+
+    Property(const std::string& name, const T& defaultValue)
+        : BaseProperty(name), defaultValue_(defaultValue) {}
+
+    reference operator[](size_t i) { return data_[i]; }
+    const_reference operator[](size_t i) const { return data_[i]; }
+    size_t size() const { return data_.size(); }
+
+    /// 把所有元素重置为默认值
+    void reset() { std::fill(data_.begin(), data_.end(), defaultValue_); }
+    std::vector<T>& data() { return data_; }
+    const std::vector<T>& data() const { return data_; }
+
+    void resize(size_t n) override { data_.resize(n, defaultValue_); }
+    void reorder(const std::vector<int>& newToOld) override {
+        std::vector<T> reordered;
+        reordered.reserve(newToOld.size());
+        for (int i : newToOld) reordered.push_back(std::move(data_[i]));
+        data_.swap(reordered);
+    }
+    size_t memoryUsage() const override { return data_.capacity() * sizeof(T); }
+
+private:
+    std::vector<T> data_;
+    T defaultValue_;
+};
+
+/**
+ * @brief 某一类元素(顶点/面/半边)上的全部属性
+ *
+ * 类似 OpenMesh 的动态属性: 算法按名字注册自己需要的数据, 用完可以删除,
+ * 核心元素类只保留拓扑和位置。
+ */
+class PropertyContainer {
+public:
+    PropertyContainer() = default;
+    PropertyContainer(const PropertyContainer&) = delete;
+    PropertyContainer& operator=(const PropertyContainer&) = delete;
+    PropertyContainer(PropertyContainer&&) = default;
+    PropertyContainer& operator=(PropertyContainer&&) = default;
+
+    /**
+     * @brief 添加属性, 已存在同名同类型属性时直接返回它
+     * 同名但类型不同时会替换旧属性并给出警告
+     */
+    template <class T>
+    Property<T>& add(const std::string& name, const T& defaultValue = T()) {
+        for (auto& p : properties_) {
+            if (p->name() != name) continue;
+            if (auto* typed = dynamic_cast<Property<T>*>(p.get())) return *typed;
+            std::cerr << "Warning: property '" << name << "' re-added with a different type" << std::endl;
+            p = std::make_unique<Property<T>>(name, defaultValue);
+            p->resize(size_);
+            return static_cast<Property<T>&>(*p);
+        }
+        properties_.push_back(std::make_unique<Property<T>>(name, defaultValue));
+        properties_.back()->resize(size_);
+        return static_cast<Property<T>&>(*properties_.back());
+    }
+
+    /// 查找属性, 不存在或类型不符时返回 nullptr
+    template <class T>
+    Property<T>* get(const std::string& name) const {
+        for (const auto& p : properties_) {
+            if (p->name() == name) return dynamic_cast<Property<T>*>(p.get());
+        }
+        return nullptr;
+    }
+
+    bool exists(const std::string& name) const {
+        for (const auto& p : properties_) {
+            if (p->name() == name) return true;
+        }
+        return false;
+    }
+
+    void remove(const std::string& name) {
+        for (auto it = properties_.begin(); it != properties_.end(); ++it) {
+            if ((*it)->name() == name) {
+                properties_.erase(it);
+                return;
+            }
+        }
+    }
+
+    /// 调整所有属性数组的长度(元素数量变化时调用), 新元素取默认值
+    void resize(size_t n) {
+        size_ = n;
+        for (auto& p : properties_) p->resize(n);
+    }
+    /// 元素被压缩/重排时调用, 见 BaseProperty::reorder
+    void reorder(const std::vector<int>& newToOld) {
+        size_ = newToOld.size();
+        for (auto& p : properties_) p->reorder(newToOld);
+    }
+    /// 删除全部属性
+    void clear() {
+        properties_.clear();
+        size_ = 0;
+    }
+
+    size_t size() const { return size_; }
+    size_t propertyCount() const { return properties_.size(); }
+    size_t memoryUsage() const {
+        size_t bytes = 0;
+        for (const auto& p : properties_) bytes += p->memoryUsage();
+        return bytes;
+    }
+
+private:
+    std::vector<std::unique_ptr<BaseProperty>> properties_;
+    size_t size_ = 0;
+};
+
+} // namespace geometry
+
+#endif // GEOMETRY_PROPERTY_H
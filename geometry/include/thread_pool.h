@@ -0,0 +1,99 @@
+﻿#ifndef GEOMETRY_THREAD_POOL_H
+#define GEOMETRY_THREAD_POOL_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <type_traits>
+
+namespace geometry {
+namespace parallel {
+
+/**
+ * @brief 工作窃取线程池
+ *
+ * 每个 worker 有自己的双端队列: 分叉出的子任务压在发起线程队列的尾部, 发起线程从尾部取(后进先出,
+ * 缓存里还是热的), 空闲线程从其他队列的头部窃取。不在池中的线程共用一个额外的队列。
+ * run() 的调用线程自己也执行任务, 等待期间继续取/窃取任务, 所以嵌套的并行循环不会死锁,
+ * 也不会额外创建线程。submit() 提交的独立任务进入全局先进先出队列, 只由空闲的 worker 取出,
+ * 等待中的线程不会去执行它们(长任务不会卡住一次并行循环)。
+ */
+class ThreadPool {
+public:
+    /// @param workerCount 后台线程数(至少为 1)
+    explicit ThreadPool(unsigned workerCount);
+    ~ThreadPool(); ///< 执行完已提交的任务后结束所有线程
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief 进程内共享的线程池, 首次使用时创建
+     * 后台线程数为硬件线程数 - 1(至少为 1): 发起并行循环的线程本身也参与计算。
+     */
+    static ThreadPool& global();
+
+    unsigned workerCount() const { return static_cast<unsigned>(workers.size()); }
+
+    /// 当前线程是否是本线程池的 worker
+    bool isWorkerThread() const;
+
+    /**
+     * @brief 提交一个独立任务(不等待), 由空闲的 worker 按提交顺序取出执行
+     * 任务不能抛出异常; 任务内部可以继续使用 run()/parallelFor。
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief 分叉-合并: 执行 f(0), ..., f(tasks - 1), 全部完成后返回
+     * 任务之间不能互相等待(不保证同时运行)。任务抛出的第一个异常在所有任务结束后重新抛出。
+     */
+    template <class F>
+    void run(unsigned tasks, F&& f) {
+        if (tasks == 0) return;
+        if (tasks == 1) {
+            f(0u);
+            return;
+        }
+        using Fn = std::remove_reference_t<F>;
+        runBatch(tasks, [](void* context, unsigned t) { (*static_cast<Fn*>(context))(t); },
+                 const_cast<void*>(static_cast<const void*>(&f)));
+    }
+
+private:
+    struct Batch;
+    struct Item {
+        Batch* batch;
+        unsigned index;
+    };
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Item> items;
+    };
+
+    void runBatch(unsigned tasks, void (*call)(void*, unsigned), void* context);
+    void execute(const Item& item);
+    bool takeItem(size_t self, Item& item); ///< 先取自己队列的尾部, 再窃取其他队列的头部
+    bool takeTask(std::function<void()>& task);
+    void notifyWorkers(size_t count);
+    void workerLoop(size_t id);
+    size_t queueIndex() const; ///< 当前线程使用的队列(池外线程共用最后一个)
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<Queue>> queues; ///< 每个 worker 一个, 最后一个给池外线程
+    std::mutex taskMutex;
+    std::deque<std::function<void()>> tasks;    ///< submit() 提交的独立任务
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<size_t> pending { 0 };          ///< 已入队但尚未被取出的任务数
+    bool stopping = false;
+};
+
+} // namespace parallel
+} // namespace geometry
+
+#endif // GEOMETRY_THREAD_POOL_H
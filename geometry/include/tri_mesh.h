@@ -0,0 +1,127 @@
+﻿#ifndef GEOMETRY_TRI_MESH_H
+#define GEOMETRY_TRI_MESH_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <Eigen/Dense>
+#include "mesh_kernel.h"
+
+namespace geometry {
+
+class HalfEdgeMesh;
+
+/**
+ * @brief BasicTriangleMesh 只含三角形的半边网格, next/prev/face 由下标算出
+ *
+ * 与 BasicMeshKernel 的区别:
+ *  - 半边 3f + k 就是面 f 的第 k 条边, 因此 face = h / 3, next/prev 在 3 个槽位内循环,
+ *    这三个数组都不需要存储, 每条半边只保留起点和对偶(8 字节)
+ *  - 对偶显式存储, 边界半边没有对象(heTwin == -1), 与 HalfEdgeMesh 的 pair == nullptr 一致
+ *  - 边界顶点的 vHalfEdge 是扇形的第一条出边(前一条入边没有对偶), 与 HalfEdgeMesh 相同
+ *  - 面内计算不再循环, 法向/面积直接由三个角点得到
+ *  - 顶点法向、曲率、平滑和 HalfEdgeMesh 适配与 BasicMeshKernel 共用 kernel_algorithms.h 的实现
+ *
+ * 多边形输入会按扇形三角化(给出警告)。约定: heVertex[h] 为半边的起点。
+ */
+template <class Scalar>
+class BasicTriangleMesh {
+public:
+    using Index = std::int32_t;
+    using Vector3 = Eigen::Matrix<Scalar, 3, 1>;
+    using Accumulator = typename ScalarTraits<Scalar>::Accumulator;
+    using AccumulatorVector3 = Eigen::Matrix<Accumulator, 3, 1>;
+    static constexpr Index InvalidIndex = -1;
+
+    // ---------------- 并行数组 ----------------
+    std::vector<Vector3> positions; ///< 顶点位置
+    std::vector<Index> vHalfEdge;   ///< 顶点 -> 一条出边(边界顶点为扇形第一条)
+    std::vector<Index> heVertex;    ///< 半边 -> 起点, 长度 3 * 面数
+    std::vector<Index> heTwin;      ///< 半边 -> 对偶(-1 表示边界)
+
+    BasicTriangleMesh() = default;
+
+    /**
+     * @brief 从顶点位置和面列表构建(与 HalfEdgeMesh::buildFromOBJ 的输入一致)
+     */
+    void build(const std::vector<Eigen::Vector3d>& vertexPositions,
+               const std::vector<std::vector<int>>& faceIndices);
+    void build(const std::vector<Eigen::Vector3f>& vertexPositions,
+               const std::vector<std::vector<int>>& faceIndices);
+    void clear();
+
+    // ---------------- 规模 ----------------
+    size_t getVertexCount() const { return positions.size(); }
+    size_t getFaceCount() const { return heVertex.size() / 3; }
+    size_t getHalfEdgeCount() const { return heVertex.size(); }
+    bool isEmpty() const { return positions.empty(); }
+
+    // ---------------- 拓扑访问 ----------------
+    static Index face(Index h) { return h / 3; }
+    static Index next(Index h) { return h % 3 == 2 ? h - 2 : h + 1; }
+    static Index prev(Index h) { return h % 3 == 0 ? h + 2 : h - 1; }
+    static Index faceHalfEdge(Index f) { return 3 * f; }
+    Index twin(Index h) const { return heTwin[h]; }
+    Index fromVertex(Index h) const { return heVertex[h]; }
+    Index toVertex(Index h) const { return heVertex[next(h)]; }
+    Index halfEdge(Index v) const { return vHalfEdge[v]; }
+    /// 面 f 的三个顶点连续存放在 heVertex[3f .. 3f + 2]
+    const Index* faceVertices(Index f) const { return heVertex.data() + 3 * f; }
+    /// 绕起点旋转到下一条出边(同 pair->next), 遇到边界返回 InvalidIndex
+    Index rotate(Index h) const {
+        const Index t = heTwin[h];
+        return t < 0 ? InvalidIndex : next(t);
+    }
+
+    bool isBoundaryHalfEdge(Index h) const { return heTwin[h] < 0; }
+    bool isBoundaryVertex(Index v) const {
+        const Index h = vHalfEdge[v];
+        return h < 0 || heTwin[prev(h)] < 0;
+    }
+
+    const Vector3& position(Index v) const { return positions[v]; }
+    Vector3& position(Index v) { return positions[v]; }
+
+    int getDegree(Index v) const;
+
+    // ---------------- 几何(在 Accumulator 精度中计算) ----------------
+    Vector3 computeFaceNormal(Index f) const;
+    Accumulator computeFaceArea(Index f) const;
+    Accumulator getTotalSurfaceArea() const;
+    /// 面积加权的顶点法向, 并行计算
+    void computeVertexNormals(std::vector<Vector3>& normals) const;
+    /// cotangent 平均曲率的模长(与 hw2 相同), 边界顶点、孤立顶点和扇形不闭合的非流形顶点为 0
+    void computeMeanCurvature(std::vector<Scalar>& curvature) const;
+    /// 均匀权 Laplace 平滑(与 hw10 相同)
+    void laplacianSmooth(int iterations, Accumulator lambda);
+
+    bool isValid() const;
+
+    /// 估算占用的字节数(所有数组容量之和)
+    size_t memoryUsage() const;
+
+    // ---------------- 与指针风格 HalfEdgeMesh 的适配 ----------------
+    /**
+     * @brief 从 HalfEdgeMesh 构建(多边形面按扇形三角化)
+     */
+    static BasicTriangleMesh fromHalfEdgeMesh(const HalfEdgeMesh& mesh);
+
+    /**
+     * @brief 导出为 HalfEdgeMesh, 半边 index 保持 3f + k, 不再做对偶配对
+     */
+    void toHalfEdgeMesh(HalfEdgeMesh& mesh) const;
+
+private:
+    /// positions 已写入后, 由面列表建立拓扑
+    void buildTopology(const std::vector<std::vector<int>>& faceIndices);
+};
+
+extern template class BasicTriangleMesh<float>;
+extern template class BasicTriangleMesh<double>;
+
+using TriangleMesh = BasicTriangleMesh<double>;
+using TriangleMeshf = BasicTriangleMesh<float>;
+
+} // namespace geometry
+
+#endif // GEOMETRY_TRI_MESH_H
@@ -0,0 +1,46 @@
+﻿#ifndef GEOMETRY_TRIANGLE_ORDER_H
+#define GEOMETRY_TRIANGLE_ORDER_H
+
+#include <span>
+#include <cstdint>
+#include <cstddef>
+
+namespace geometry {
+
+/// 模拟的顶点后变换缓存大小(FIFO), 与 Tipsify 论文中使用的硬件参数一致
+constexpr int DefaultVertexCacheSize = 16;
+
+/**
+ * @brief 三角形重排的统计
+ */
+struct TriangleOrderStats {
+    double acmrBefore = 0.0; ///< 重排前的平均缓存未命中率(每个三角形变换的顶点数)
+    double acmrAfter = 0.0;  ///< 重排后的平均缓存未命中率
+    size_t clusters = 0;     ///< 过度绘制排序使用的簇数(未提供位置时为 0)
+};
+
+/**
+ * @brief 模拟 FIFO 顶点缓存, 计算三角形索引缓冲的 ACMR
+ * 理想值约为 0.5(每个顶点只变换一次), 随机顺序接近 3。越界索引按未命中计。
+ */
+double computeACMR(std::span<const std::uint32_t> indices, size_t vertexCount,
+                   int cacheSize = DefaultVertexCacheSize);
+
+/**
+ * @brief 重排三角形(不改变顶点编号), 先优化顶点缓存命中, 再减少过度绘制
+ *
+ * 第一步是 Tipsify(Sander 等, 2007): 以顶点为扇心依次输出其所有未输出的三角形,
+ * 下一个扇心从刚输出的顶点中选择仍留在缓存中的那个, 整体为线性时间。
+ * 第二步在提供 positions(xyz, 长度至少 3 * vertexCount)时执行: 在 Tipsify 跳转到缓存之外的位置
+ * (以及簇超过 2048 个三角形时的扇形之间)把序列切成簇, 簇按 (簇中心 - 网格中心)·簇法向
+ * 从大到小排列, 朝外的簇先画; 切点处本来就几乎没有缓存复用, 所以这一步对 ACMR 影响很小。
+ * 含越界索引的缓冲保持不变。
+ */
+void optimizeTriangleOrder(std::span<std::uint32_t> indices, size_t vertexCount,
+                           std::span<const float> positions = {},
+                           int cacheSize = DefaultVertexCacheSize,
+                           TriangleOrderStats* stats = nullptr);
+
+} // namespace geometry
+
+#endif // GEOMETRY_TRIANGLE_ORDER_H
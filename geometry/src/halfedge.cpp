@@ -3,6 +3,13 @@
 #include <iostream>
 #include <algorithm>
 #include <limits>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include "parallel.h"
+#include "mesh_cache.h"
+#include "mesh_reorder.h"
 
 namespace geometry {
 
@@ -12,6 +19,7 @@ namespace geometry {
 
 /**
  * @brief 㶥㷨淨ļȨƽ
+ * ʹϻ normal/area, ǰִ computeNormal()
  */
 void Vertex::computeNormal() {
     if (!halfEdge) return;
@@ -24,13 +32,21 @@ void Vertex::computeNormal() {
     do {
         if (he->face) {
             // Ȩ
-            double area = he->face->computeArea();
-            normal += he->face->normal * area;
+            normal += he->face->normal * he->face->area;
             count++;
         }
         he = he->pair ? he->pair->next : nullptr;
-        if (!he) break; // ߽綥
-    } while (he != halfEdge);
+    } while (he && he != halfEdge);
+
+    // ߽綥: ʼ߷ת, һ
+    if (!he) {
+        for (he = halfEdge->prev->pair; he; he = he->prev->pair) {
+            if (he->face) {
+                normal += he->face->normal * he->face->area;
+                count++;
+            }
+        }
+    }
     
     // ׼
     if (count > 0 && normal.norm() > 0) {
@@ -61,15 +77,9 @@ int Vertex::getDegree() const {
  */
 bool Vertex::isBoundary() const {
     if (!halfEdge) return true;
-    
-    HalfEdge* he = halfEdge;
-    do {
-        if (!he->pair) return true; // ֱ߽
-        he = he->pair->next;
-        if (!he) return true;
-    } while (he != halfEdge);
-    
-    return false;
+    // /պ߽綥ĳεĵһ, ǰһû pair ı߽,
+    // ڲ߶ pair, ֻһ
+    return halfEdge->prev->pair == nullptr;
 }
 
 // ============================================================================
@@ -78,6 +88,7 @@ bool Vertex::isBoundary() const {
 
 /**
  * @brief 淨ʹNewellΣ
+ * Newell ģ, ͬʱ» area
  */
 void Face::computeNormal() {
     if (!halfEdge) return;
@@ -98,8 +109,10 @@ void Face::computeNormal() {
     } while (he != halfEdge);
     
     // ׼
-    if (normal.norm() > 0) {
-        normal.normalize();
+    const double length = normal.norm();
+    area = 0.5 * length;
+    if (length > 0) {
+        normal /= length;
     }
 }
 
@@ -182,102 +195,199 @@ void HalfEdgeMesh::clear() {
     vertices.clear();
     faces.clear();
     halfEdges.clear();
+    nonManifoldEdges.clear();
+    dirtyVertices.clear();
+    vertexDirtyFlag.clear();
+    invalidateTopologyCaches();
+    resizeProperties(); // ע, ֻ
 }
 
 /**
- * @brief OBJʽݹṹλã****
+ * @brief ǰԪ鳤
  */
-void HalfEdgeMesh::buildFromOBJ(const std::vector<Eigen::Vector3d>& vertexPositions,
-                               const std::vector<std::vector<int>>& faceIndices) {
-    clear();
+void HalfEdgeMesh::resizeProperties() {
+    vertexProps.resize(vertices.size());
+    faceProps.resize(faces.size());
+    halfEdgeProps.resize(halfEdges.size());
+}
 
-    // ֤
-    if (vertexPositions.empty() || faceIndices.empty()) {
-        return;
+/**
+ * @brief : ɾΪ deleted Ԫ, ѹ鲢±
+ *
+ *  O(n) ɾǱһ:
+ *  - ɾİڵҲɾ
+ *  - ɾİڵҲɾ(۵/תֻǰ), 
+ *    halfEdge/next/prev Իָ򱻻յİ
+ *  - ɾϵа߶ɾ
+ *  - ָɾߵ pair Ϊ nullptr(ñ߱Ϊ߽)
+ *  - ʧЧĶѡһ, ߽綥ĳߵΪܱε,
+ *    ȫɾĶҲһɾ
+ * ȻԪ鰴ͬһ˳ѹ, index Ϊ±ꡣ
+ * Ԫضƶ, ȻԪصָ뱣Ч
+ */
+void HalfEdgeMesh::garbageCollection(bool reorderForLocality) {
+    // 1. ɾ
+    for (auto& he : halfEdges) {
+        if (he->face && (he->deleted || he->vertex->deleted)) he->face->deleted = true;
+    }
+    for (auto& he : halfEdges) {
+        if (he->face && he->face->deleted) he->deleted = true;
+    }
+    for (auto& he : halfEdges) {
+        if (!he->deleted && he->pair && he->pair->deleted) he->pair = nullptr;
     }
 
-    // 
-	vertices.reserve(vertexPositions.size());// Ԥռ
-    
-    for (size_t i = 0; i < vertexPositions.size(); ++i) {
-        vertices.push_back(std::make_unique<Vertex>(vertexPositions[i], static_cast<int>(i)));
+    // 2. ޸ʧЧĶ
+    std::vector<char> reassigned(vertices.size(), 0);
+    for (auto& v : vertices) {
+        if (!v->deleted && v->halfEdge && v->halfEdge->deleted) {
+            v->halfEdge = nullptr;
+            reassigned[v->index] = 1;
+        }
+    }
+    for (auto& he : halfEdges) {
+        if (he->deleted) continue;
+        Vertex* v = he->vertex;
+        // ǰһûжżʱ,  pair->next ;
+        // ɾ³ֵı߽綥ҲҪ
+        if ((reassigned[v->index] && !v->halfEdge) || he->prev->pair == nullptr) v->halfEdge = he.get();
+    }
+    for (auto& v : vertices) {
+        if (reassigned[v->index] && !v->halfEdge) v->deleted = true; // 涼ɾ
     }
 
-    // ڸѴİ
-    std::map<std::pair<int, int>, HalfEdge*> edgeMap;
+    // 3. ˳(± -> ±)
+    std::vector<int> vertexOrder, faceOrder, halfEdgeOrder;
+    if (reorderForLocality) {
+        // 水˳, ÿİ, 㰴һαʵ˳
+        MeshPermutation permutation = computeMeshOrdering(*this, MeshOrdering::FaceLocality);
+        vertexOrder.swap(permutation.vertexOrder);
+        faceOrder.swap(permutation.faceOrder);
+        halfEdgeOrder.swap(permutation.halfEdgeOrder);
+    } else {
+        vertexOrder.reserve(vertices.size());
+        faceOrder.reserve(faces.size());
+        halfEdgeOrder.reserve(halfEdges.size());
+        for (const auto& v : vertices) if (!v->deleted) vertexOrder.push_back(v->index);
+        for (const auto& f : faces) if (!f->deleted) faceOrder.push_back(f->index);
+        for (const auto& he : halfEdges) if (!he->deleted) halfEdgeOrder.push_back(he->index);
+    }
 
-    // ÿ
-    faces.reserve(faceIndices.size());
-    for (size_t faceIdx = 0; faceIdx < faceIndices.size(); ++faceIdx) {
-        const auto& faceVerts = faceIndices[faceIdx];
-        if (faceVerts.size() < 3) {
-            std::cerr << "Warning: Skipping face " << faceIdx << " with less than 3 vertices" << std::endl;
-            continue;
-        }
+    // 4. ˳ѹԪغ
+    const size_t removedVertices = vertices.size() - vertexOrder.size();
+    const size_t removedFaces = faces.size() - faceOrder.size();
+    const size_t removedHalfEdges = halfEdges.size() - halfEdgeOrder.size();
+    permute(vertexOrder, faceOrder, halfEdgeOrder);
 
-        // ֤
-        bool validFace = true;
-        for (int vertexIdx : faceVerts) {
-            if (vertexIdx < 0 || vertexIdx >= static_cast<int>(vertices.size())) {
-                std::cerr << "Error: Invalid vertex index " << vertexIdx << " in face " << faceIdx << std::endl;
-                validFace = false;
-                break;
-            }
-        }
-        if (!validFace) continue;
+    std::cout << "Garbage collection removed " << removedVertices << " vertices, "
+              << removedFaces << " faces, " << removedHalfEdges << " half-edges" << std::endl;
+}
 
-        // 
-        auto face = std::make_unique<Face>(static_cast<int>(faceIdx));
-        std::vector<HalfEdge*> faceHalfEdges;
-        faceHalfEdges.reserve(faceVerts.size());
+void HalfEdgeMesh::permute(const std::vector<int>& vertexOrder, const std::vector<int>& faceOrder,
+                           const std::vector<int>& halfEdgeOrder, bool relocate) {
+    // α߼¼Ƕ, ͬ
+    std::vector<int> vertexOldToNew(vertices.size(), -1);
+    for (size_t i = 0; i < vertexOrder.size(); ++i) vertexOldToNew[vertexOrder[i]] = static_cast<int>(i);
+    std::vector<std::pair<int, int>> remappedEdges;
+    for (const auto& e : nonManifoldEdges) {
+        int a = vertexOldToNew[e.first];
+        int b = vertexOldToNew[e.second];
+        if (a >= 0 && b >= 0) remappedEdges.emplace_back(std::min(a, b), std::max(a, b));
+    }
+    std::sort(remappedEdges.begin(), remappedEdges.end());
+    nonManifoldEdges.swap(remappedEdges);
 
-        // Ϊÿߴ
-        for (size_t i = 0; i < faceVerts.size(); ++i) {
-            int currentIdx = faceVerts[i];
-            int nextIdx = faceVerts[(i + 1) % faceVerts.size()];
+    std::vector<int> remappedDirty;
+    for (int v : dirtyVertices) {
+        if (vertexOldToNew[v] >= 0) remappedDirty.push_back(vertexOldToNew[v]);
+    }
+    dirtyVertices.swap(remappedDirty);
+    vertexDirtyFlag.assign(vertexOrder.size(), 0);
+    for (int v : dirtyVertices) vertexDirtyFlag[v] = 1;
 
-            // °
-            auto halfEdge = std::make_unique<HalfEdge>();
-            halfEdge->vertex = vertices[currentIdx].get();
-            halfEdge->face = face.get();
+    // ԰ index , ±֮ǰ
+    vertexProps.reorder(vertexOrder);
+    faceProps.reorder(faceOrder);
+    halfEdgeProps.reorder(halfEdgeOrder);
 
-            // ӵ
-            halfEdges.push_back(std::move(halfEdge));
-            HalfEdge* currentHalfEdge = halfEdges.back().get();
-
-            // 洢ָԱ
-            faceHalfEdges.push_back(currentHalfEdge);
-
-            // һ򴴽ż
-            HalfEdge* pair = getOrCreateHalfEdgePair(
-                vertices[currentIdx].get(),
-                vertices[nextIdx].get(),
-                edgeMap,
-                currentHalfEdge
-            );
-
-            if (pair) {
-                currentHalfEdge->pair = pair;
-                pair->pair = currentHalfEdge;
-            }
+    if (relocate) {
+        // ˳·Ԫض, ʹʱʵڴҲ˳;
+        // еָָɶ, ͨɶ index ¶
+        std::vector<std::unique_ptr<Vertex>> newVertices(vertexOrder.size());
+        std::vector<std::unique_ptr<Face>> newFaces(faceOrder.size());
+        std::vector<std::unique_ptr<HalfEdge>> newHalfEdges(halfEdgeOrder.size());
+        for (size_t i = 0; i < vertexOrder.size(); ++i) newVertices[i] = std::make_unique<Vertex>(*vertices[vertexOrder[i]]);
+        for (size_t i = 0; i < faceOrder.size(); ++i) newFaces[i] = std::make_unique<Face>(*faces[faceOrder[i]]);
+        for (size_t i = 0; i < halfEdgeOrder.size(); ++i) newHalfEdges[i] = std::make_unique<HalfEdge>(*halfEdges[halfEdgeOrder[i]]);
 
-            // Ƕĵһߣöİָ
-            if (!vertices[currentIdx]->halfEdge) {
-                vertices[currentIdx]->halfEdge = currentHalfEdge;
-            }
+        std::vector<int> faceOldToNew(faces.size(), -1);
+        std::vector<int> halfEdgeOldToNew(halfEdges.size(), -1);
+        for (size_t i = 0; i < faceOrder.size(); ++i) faceOldToNew[faceOrder[i]] = static_cast<int>(i);
+        for (size_t i = 0; i < halfEdgeOrder.size(); ++i) halfEdgeOldToNew[halfEdgeOrder[i]] = static_cast<int>(i);
+        auto mapHalfEdge = [&](HalfEdge* he) -> HalfEdge* {
+            if (!he || halfEdgeOldToNew[he->index] < 0) return nullptr;
+            return newHalfEdges[halfEdgeOldToNew[he->index]].get();
+        };
+        auto mapVertex = [&](Vertex* v) -> Vertex* {
+            if (!v || vertexOldToNew[v->index] < 0) return nullptr;
+            return newVertices[vertexOldToNew[v->index]].get();
+        };
+        auto mapFace = [&](Face* f) -> Face* {
+            if (!f || faceOldToNew[f->index] < 0) return nullptr;
+            return newFaces[faceOldToNew[f->index]].get();
+        };
+        for (auto& v : newVertices) v->halfEdge = mapHalfEdge(v->halfEdge);
+        for (auto& f : newFaces) f->halfEdge = mapHalfEdge(f->halfEdge);
+        for (auto& he : newHalfEdges) {
+            he->vertex = mapVertex(he->vertex);
+            he->face = mapFace(he->face);
+            he->next = mapHalfEdge(he->next);
+            he->prev = mapHalfEdge(he->prev);
+            he->pair = mapHalfEdge(he->pair);
         }
+        for (size_t i = 0; i < newVertices.size(); ++i) newVertices[i]->index = static_cast<int>(i);
+        for (size_t i = 0; i < newFaces.size(); ++i) newFaces[i]->index = static_cast<int>(i);
+        for (size_t i = 0; i < newHalfEdges.size(); ++i) newHalfEdges[i]->index = static_cast<int>(i);
+        vertices.swap(newVertices);
+        faces.swap(newFaces);
+        halfEdges.swap(newHalfEdges);
+    } else {
+        auto compact = [](auto& elements, const std::vector<int>& order) {
+            std::remove_reference_t<decltype(elements)> kept;
+            kept.reserve(order.size());
+            for (int i : order) kept.push_back(std::move(elements[i]));
+            for (size_t i = 0; i < kept.size(); ++i) kept[i]->index = static_cast<int>(i);
+            elements.swap(kept); // δߵԪ kept һͷ
+        };
+        compact(vertices, vertexOrder);
+        compact(faces, faceOrder);
+        compact(halfEdges, halfEdgeOrder);
+    }
+    invalidateTopologyCaches();
+}
 
-        // İ
-        for (size_t i = 0; i < faceHalfEdges.size(); ++i) {
-            faceHalfEdges[i]->next = faceHalfEdges[(i + 1) % faceHalfEdges.size()];
-            faceHalfEdges[i]->prev = faceHalfEdges[(i + faceHalfEdges.size() - 1) % faceHalfEdges.size()];
-        }
+/**
+ * @brief OBJʽݹṹλã****
+ */
+void HalfEdgeMesh::buildFromOBJ(const std::vector<Eigen::Vector3d>& vertexPositions,
+                               const std::vector<std::vector<int>>& faceIndices) {
+    clear();
 
-        // İָ
-        face->halfEdge = faceHalfEdges[0];
-        faces.push_back(std::move(face));
+    // ֤
+    if (vertexPositions.empty() || faceIndices.empty()) {
+        return;
+    }
+
+    // 
+	vertices.reserve(vertexPositions.size());// Ԥռ
+    
+    for (size_t i = 0; i < vertexPositions.size(); ++i) {
+        vertices.push_back(std::make_unique<Vertex>(vertexPositions[i], static_cast<int>(i)));
     }
 
+    buildFaces(faceIndices);
+    pairHalfEdges();
+
     std::cout << "HalfEdgeMesh built successfully: " 
               << vertices.size() << " vertices, " 
               << faces.size() << " faces, " 
@@ -301,7 +411,7 @@ void HalfEdgeMesh::buildFromOBJ(const std::vector<Eigen::Vector3d>& vertexPositi
         return;
     }
 
-    // 㣬
+    // 㣨ԣ
     vertices.reserve(vertexPositions.size());
     for (size_t i = 0; i < vertexPositions.size(); ++i) {
         auto vertex = std::make_unique<Vertex>(vertexPositions[i], static_cast<int>(i));
@@ -311,30 +421,173 @@ void HalfEdgeMesh::buildFromOBJ(const std::vector<Eigen::Vector3d>& vertexPositi
             vertex->normal = vertexNormals[i];
         }
         
-        // ꣨ṩ
-        if (i < vertexTexCoords.size()) {
-            vertex->texCoords = vertexTexCoords[i];
-        }
-        
         vertices.push_back(std::move(vertex));
     }
 
-    // ڸѴİ
-    std::map<std::pair<int, int>, HalfEdge*> edgeMap;
+    buildFaces(faceIndices);
+    pairHalfEdges();
 
-    // ÿ
-    faces.reserve(faceIndices.size());
-    for (size_t faceIdx = 0; faceIdx < faceIndices.size(); ++faceIdx) {
-        const auto& faceVerts = faceIndices[faceIdx];
-        if (faceVerts.size() < 3) {
+    // 걣Ϊ "v:texcoord"ṩ
+    if (!vertexTexCoords.empty()) {
+        auto& texCoords = vertexProperty<Eigen::Vector2d>("v:texcoord", Eigen::Vector2d::Zero());
+        for (size_t i = 0; i < vertices.size() && i < vertexTexCoords.size(); ++i) {
+            texCoords[i] = vertexTexCoords[i];
+        }
+    }
+
+    std::cout << "HalfEdgeMesh built successfully with attributes: " 
+              << vertices.size() << " vertices, " 
+              << faces.size() << " faces, " 
+              << halfEdges.size() << " half-edges" << std::endl;
+    
+    // ûṩԶ
+    if (vertexNormals.empty()) {
+        computeNormals();
+    }
+}
+
+/**
+ * @brief Ӷƻָ
+ *
+ * Ȳм±ķΧ(𻵵Ļ治ָܲ), ٲдԪض,
+ *  next/prev/twin/vertex/face ֱָ롣
+ * ߽绷˲ִӻ, ´ getBoundaryLoops() ʱλü㡣
+ */
+bool HalfEdgeMesh::buildFromCache(const MeshCache& cache) {
+    clear();
+    if (!cache.isOpen()) return false;
+
+    const size_t nV = cache.getVertexCount();
+    const size_t nF = cache.getFaceCount();
+    const size_t nH = cache.getHalfEdgeCount();
+    const auto positions = cache.positions();
+    const auto vertexHalfEdge = cache.vertexHalfEdge();
+    const auto faceHalfEdge = cache.faceHalfEdge();
+    const auto heVertex = cache.halfEdgeVertex();
+    const auto heFace = cache.halfEdgeFace();
+    const auto heNext = cache.halfEdgeNext();
+    const auto hePrev = cache.halfEdgePrev();
+    const auto heTwin = cache.halfEdgeTwin();
+    const auto loopOffsets = cache.loopOffsets();
+    const auto loopHalfEdges = cache.loopHalfEdges();
+
+    // 1. ±귶Χ
+    auto inRange = [](std::int32_t i, size_t n) { return i >= 0 && static_cast<size_t>(i) < n; };
+    std::atomic<bool> valid { true };
+    parallel::parallelFor(0, nH, [&](size_t h) {
+        if (!inRange(heVertex[h], nV) || !inRange(heFace[h], nF) || !inRange(heNext[h], nH) ||
+            !inRange(hePrev[h], nH) || (heTwin[h] != -1 && !inRange(heTwin[h], nH))) {
+            valid = false;
+        }
+    });
+    parallel::parallelFor(0, nV, [&](size_t v) {
+        if (vertexHalfEdge[v] != -1 && !inRange(vertexHalfEdge[v], nH)) valid = false;
+    });
+    parallel::parallelFor(0, nF, [&](size_t f) {
+        if (!inRange(faceHalfEdge[f], nH)) valid = false;
+    });
+    if (loopOffsets[0] != 0 || static_cast<size_t>(loopOffsets[cache.getLoopCount()]) != loopHalfEdges.size()) valid = false;
+    for (size_t l = 0; l < cache.getLoopCount() && valid; ++l) {
+        if (loopOffsets[l + 1] < loopOffsets[l]) valid = false;
+    }
+    for (size_t k = 0; k < loopHalfEdges.size() && valid; ++k) {
+        if (!inRange(loopHalfEdges[k], nH)) valid = false;
+    }
+    if (!valid) {
+        std::cerr << "Error: Mesh cache contains out-of-range indices" << std::endl;
+        return false;
+    }
+
+    // 2. Ԫ(ÿλֻһ߳д)
+    vertices.resize(nV);
+    faces.resize(nF);
+    halfEdges.resize(nH);
+    parallel::parallelFor(0, nV, [&](size_t v) {
+        vertices[v] = std::make_unique<Vertex>(
+            Eigen::Vector3d(positions[3 * v], positions[3 * v + 1], positions[3 * v + 2]), static_cast<int>(v));
+    });
+    parallel::parallelFor(0, nF, [&](size_t f) {
+        faces[f] = std::make_unique<Face>(static_cast<int>(f));
+    });
+    parallel::parallelFor(0, nH, [&](size_t h) {
+        halfEdges[h] = std::make_unique<HalfEdge>();
+        halfEdges[h]->index = static_cast<int>(h);
+    });
+
+    // 3. ָ
+    parallel::parallelFor(0, nH, [&](size_t h) {
+        HalfEdge* he = halfEdges[h].get();
+        he->vertex = vertices[heVertex[h]].get();
+        he->face = faces[heFace[h]].get();
+        he->next = halfEdges[heNext[h]].get();
+        he->prev = halfEdges[hePrev[h]].get();
+        he->pair = heTwin[h] < 0 ? nullptr : halfEdges[heTwin[h]].get();
+    });
+    parallel::parallelFor(0, nV, [&](size_t v) {
+        vertices[v]->halfEdge = vertexHalfEdge[v] < 0 ? nullptr : halfEdges[vertexHalfEdge[v]].get();
+    });
+    parallel::parallelFor(0, nF, [&](size_t f) {
+        faces[f]->halfEdge = halfEdges[faceHalfEdge[f]].get();
+    });
+    resizeProperties();
+
+    // 4. ָ߽绷
+    BoundaryLoops& b = boundary;
+    b.loopOffsets.assign(loopOffsets.begin(), loopOffsets.end());
+    b.halfEdges.assign(loopHalfEdges.begin(), loopHalfEdges.end());
+    b.vertices.resize(b.halfEdges.size());
+    b.vertexLoop.assign(nV, -1);
+    b.vertexSlot.assign(nV, -1);
+    for (int l = 0; l < b.loopCount(); ++l) {
+        for (int k = b.loopOffsets[l]; k < b.loopOffsets[l + 1]; ++k) {
+            const int v = heVertex[b.halfEdges[k]];
+            b.vertices[k] = v;
+            if (b.vertexLoop[v] < 0) {
+                b.vertexLoop[v] = l;
+                b.vertexSlot[v] = k;
+            }
+        }
+    }
+    b.arcLength.resize(b.halfEdges.size());
+    b.loopLength.resize(b.loopCount());
+    boundaryValid = true;
+
+    std::cout << "HalfEdgeMesh loaded from cache: "
+              << vertices.size() << " vertices, "
+              << faces.size() << " faces, "
+              << halfEdges.size() << " half-edges" << std::endl;
+
+    computeNormals();
+    return true;
+}
+
+namespace {
+
+/**
+ * @brief ׷Ͱߣֻ next/prevż
+ * faceSize(f) ص f Ľǵ, corner(f, k)  k ,
+ *  vector<vector<int>> ͱƽ빲ͬһݴ, Ҫм
+ * Ͱߵ index еλһ£Ч治ռλã
+ */
+template <class FaceSize, class Corner>
+void appendFaces(HalfEdgeMesh& mesh, size_t faceCount, size_t cornerCount, FaceSize faceSize, Corner corner) {
+    auto& vertices = mesh.vertices;
+    auto& faces = mesh.faces;
+    auto& halfEdges = mesh.halfEdges;
+    faces.reserve(faces.size() + faceCount);
+    halfEdges.reserve(halfEdges.size() + cornerCount);
+    for (size_t faceIdx = 0; faceIdx < faceCount; ++faceIdx) {
+        const size_t count = faceSize(faceIdx);
+        if (count < 3) {
             std::cerr << "Warning: Skipping face " << faceIdx << " with less than 3 vertices" << std::endl;
             continue;
         }
 
         // ֤
         bool validFace = true;
-        for (int vertexIdx : faceVerts) {
-            if (vertexIdx < 0 || vertexIdx >= static_cast<int>(vertices.size())) {
+        for (size_t k = 0; k < count; ++k) {
+            const std::int64_t vertexIdx = corner(faceIdx, k);
+            if (vertexIdx < 0 || vertexIdx >= static_cast<std::int64_t>(vertices.size())) {
                 std::cerr << "Error: Invalid vertex index " << vertexIdx << " in face " << faceIdx << std::endl;
                 validFace = false;
                 break;
@@ -343,99 +596,383 @@ void HalfEdgeMesh::buildFromOBJ(const std::vector<Eigen::Vector3d>& vertexPositi
         if (!validFace) continue;
 
         // 
-        auto face = std::make_unique<Face>(static_cast<int>(faceIdx));
-        std::vector<HalfEdge*> faceHalfEdges;
-        faceHalfEdges.reserve(faceVerts.size());
+        auto face = std::make_unique<Face>(static_cast<int>(faces.size()));
+        const size_t first = halfEdges.size();
 
         // Ϊÿߴ
-        for (size_t i = 0; i < faceVerts.size(); ++i) {
-            int currentIdx = faceVerts[i];
-            int nextIdx = faceVerts[(i + 1) % faceVerts.size()];
-
-            // °
+        for (size_t k = 0; k < count; ++k) {
+            Vertex* vertex = vertices[static_cast<size_t>(corner(faceIdx, k))].get();
             auto halfEdge = std::make_unique<HalfEdge>();
-            halfEdge->vertex = vertices[currentIdx].get();
+            halfEdge->index = static_cast<int>(halfEdges.size());
+            halfEdge->vertex = vertex;
             halfEdge->face = face.get();
 
-            // ӵ
-            halfEdges.push_back(std::move(halfEdge));
-            HalfEdge* currentHalfEdge = halfEdges.back().get();
-
-            // 洢ָԱ
-            faceHalfEdges.push_back(currentHalfEdge);
-
-            // һ򴴽ż
-            HalfEdge* pair = getOrCreateHalfEdgePair(
-                vertices[currentIdx].get(),
-                vertices[nextIdx].get(),
-                edgeMap,
-                currentHalfEdge
-            );
-
-            if (pair) {
-                currentHalfEdge->pair = pair;
-                pair->pair = currentHalfEdge;
-            }
-
             // Ƕĵһߣöİָ
-            if (!vertices[currentIdx]->halfEdge) {
-                vertices[currentIdx]->halfEdge = currentHalfEdge;
+            if (!vertex->halfEdge) {
+                vertex->halfEdge = halfEdge.get();
             }
+            halfEdges.push_back(std::move(halfEdge));
         }
 
-        // İ
-        for (size_t i = 0; i < faceHalfEdges.size(); ++i) {
-            faceHalfEdges[i]->next = faceHalfEdges[(i + 1) % faceHalfEdges.size()];
-            faceHalfEdges[i]->prev = faceHalfEdges[(i + faceHalfEdges.size() - 1) % faceHalfEdges.size()];
+        // ڰ
+        for (size_t i = 0; i < count; ++i) {
+            halfEdges[first + i]->next = halfEdges[first + (i + 1) % count].get();
+            halfEdges[first + i]->prev = halfEdges[first + (i + count - 1) % count].get();
         }
 
         // İָ
-        face->halfEdge = faceHalfEdges[0];
+        face->halfEdge = halfEdges[first].get();
         faces.push_back(std::move(face));
     }
+}
 
-    std::cout << "HalfEdgeMesh built successfully with attributes: " 
-              << vertices.size() << " vertices, " 
-              << faces.size() << " faces, " 
+} // namespace
+
+/**
+ * @brief бͰߣֻ next/prevż
+ */
+void HalfEdgeMesh::buildFaces(const std::vector<std::vector<int>>& faceIndices) {
+    size_t cornerCount = 0;
+    for (const auto& faceVerts : faceIndices) cornerCount += faceVerts.size();
+
+    appendFaces(*this, faceIndices.size(), cornerCount,
+                [&](size_t f) { return faceIndices[f].size(); },
+                [&](size_t f, size_t k) { return static_cast<std::int64_t>(faceIndices[f][k]); });
+    resizeProperties();
+}
+
+/**
+ * @brief ӱƽ鹹,  Eigen/Ƕ vector м
+ */
+void HalfEdgeMesh::buildFromArrays(std::span<const float> positions,
+                                   std::span<const std::uint32_t> faceIndices,
+                                   std::span<const std::uint32_t> faceOffsets) {
+    clear();
+
+    // ֤
+    if (positions.size() < 3 || faceIndices.empty()) {
+        return;
+    }
+    if (positions.size() % 3 != 0) {
+        std::cerr << "Warning: Position array length " << positions.size() << " is not a multiple of 3" << std::endl;
+    }
+    const bool polygons = !faceOffsets.empty();
+    if (polygons) {
+        for (size_t f = 0; f + 1 < faceOffsets.size(); ++f) {
+            if (faceOffsets[f + 1] < faceOffsets[f]) {
+                std::cerr << "Error: Face offsets are not monotonic at face " << f << std::endl;
+                return;
+            }
+        }
+        if (faceOffsets.size() < 2 || faceOffsets.back() > faceIndices.size()) {
+            std::cerr << "Error: Face offsets exceed the index array" << std::endl;
+            return;
+        }
+    } else if (faceIndices.size() % 3 != 0) {
+        std::cerr << "Warning: Index array length " << faceIndices.size() << " is not a multiple of 3" << std::endl;
+    }
+
+    // (ÿλֻһ߳д)
+    const size_t vertexCount = positions.size() / 3;
+    vertices.resize(vertexCount);
+    parallel::parallelFor(0, vertexCount, [&](size_t i) {
+        vertices[i] = std::make_unique<Vertex>(
+            Eigen::Vector3d(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2]), static_cast<int>(i));
+    });
+
+    if (polygons) {
+        appendFaces(*this, faceOffsets.size() - 1, faceOffsets.back() - faceOffsets.front(),
+                    [&](size_t f) { return static_cast<size_t>(faceOffsets[f + 1] - faceOffsets[f]); },
+                    [&](size_t f, size_t k) { return static_cast<std::int64_t>(faceIndices[faceOffsets[f] + k]); });
+    } else {
+        const size_t faceCount = faceIndices.size() / 3;
+        appendFaces(*this, faceCount, 3 * faceCount,
+                    [](size_t) { return size_t(3); },
+                    [&](size_t f, size_t k) { return static_cast<std::int64_t>(faceIndices[3 * f + k]); });
+    }
+    resizeProperties();
+    pairHalfEdges();
+
+    std::cout << "HalfEdgeMesh built successfully: "
+              << vertices.size() << " vertices, "
+              << faces.size() << " faces, "
               << halfEdges.size() << " half-edges" << std::endl;
-    
-    // ûṩԶ
-    if (vertexNormals.empty()) {
-        computeNormals();
+
+    computeNormals();
+}
+
+/**
+ * @brief Զż
+ *
+ * ÿɼ (min, max, halfEdgeIndex)лͬ:
+ * - ǡҷ෴: Ϊ pair
+ * - ֻһ: ߽, pair  nullptr
+ * - ͬ: /һ£ȫδԲ¼ nonManifoldEdges
+ */
+void HalfEdgeMesh::pairHalfEdges() {
+    nonManifoldEdges.clear();
+    const size_t n = halfEdges.size();
+    if (n == 0) return;
+
+    struct EdgeKey {
+        std::uint64_t key;
+        std::uint32_t halfEdge;
+    };
+    const int bits = parallel::bitWidth(vertices.size());
+    std::vector<EdgeKey> keys(n);
+    parallel::parallelFor(0, n, [&](size_t i) {
+        const HalfEdge* he = halfEdges[i].get();
+        std::uint64_t a = static_cast<std::uint64_t>(he->vertex->index);
+        std::uint64_t b = static_cast<std::uint64_t>(he->next->vertex->index);
+        if (a > b) std::swap(a, b);
+        keys[i] = { (a << bits) | b, static_cast<std::uint32_t>(i) };
+    });
+    parallel::parallelRadixSort(keys, 2 * bits, [](const EdgeKey& k) { return k.key; });
+
+    std::mutex reportMutex;
+    parallel::parallelFor(0, n, [&](size_t i) {
+        if (i > 0 && keys[i - 1].key == keys[i].key) return; // ֻÿĵһԪش
+        size_t j = i + 1;
+        while (j < n && keys[j].key == keys[i].key) ++j;
+        if (j - i == 1) return; // ߽
+
+        HalfEdge* a = halfEdges[keys[i].halfEdge].get();
+        HalfEdge* b = halfEdges[keys[i + 1].halfEdge].get();
+        if (j - i == 2 && a->vertex != b->vertex) {
+            a->pair = b;
+            b->pair = a;
+            return;
+        }
+        std::lock_guard<std::mutex> lock(reportMutex);
+        const auto edge = std::minmax(a->vertex->index, a->next->vertex->index);
+        nonManifoldEdges.emplace_back(edge.first, edge.second);
+    });
+
+    // ߽綥ĳΪεĵһ(ǰһûжż),
+    //  pair->next Ա,  circulators.h
+    for (auto& he : halfEdges) {
+        if (!he->prev->pair) he->vertex->halfEdge = he.get();
+    }
+
+    if (!nonManifoldEdges.empty()) {
+        std::sort(nonManifoldEdges.begin(), nonManifoldEdges.end());
+        std::cerr << "Warning: " << nonManifoldEdges.size()
+                  << " non-manifold or inconsistently oriented edge(s) left unpaired" << std::endl;
+    }
+}
+
+/**
+ * @brief ضڽ CSR, ʧЧʱ¹
+ *
+ * ÿ߹ (, յ)  (յ, ) ڽ, ټÿ,
+ * ÿȥ, ˱߽ߺͷαҲܵõԳƵģʽ
+ */
+const VertexAdjacency& HalfEdgeMesh::getAdjacency() {
+    if (adjacencyValid) return adjacency;
+
+    const int nV = static_cast<int>(vertices.size());
+    const size_t nH = halfEdges.size();
+    VertexAdjacency& adj = adjacency;
+
+    // ÿεϽ:  +  + 
+    std::vector<int> bound(nV + 1, 0);
+    for (int i = 0; i < nV; ++i) bound[i + 1] = 1;
+    for (const auto& he : halfEdges) {
+        ++bound[he->vertex->index + 1];
+        ++bound[he->next->vertex->index + 1];
+    }
+    for (int i = 0; i < nV; ++i) bound[i + 1] += bound[i];
+
+    std::vector<int> scratch(bound[nV]);
+    std::vector<int> fill(bound.begin(), bound.end() - 1);
+    for (int i = 0; i < nV; ++i) scratch[fill[i]++] = i;
+    for (const auto& he : halfEdges) {
+        const int from = he->vertex->index;
+        const int to = he->next->vertex->index;
+        scratch[fill[from]++] = to;
+        scratch[fill[to]++] = from;
+    }
+
+    // ÿȥ(ص, Բ), ¼ȥغĳ
+    std::vector<int> length(nV);
+    parallel::parallelFor(0, nV, [&](size_t i) {
+        auto first = scratch.begin() + bound[i];
+        auto last = scratch.begin() + bound[i + 1];
+        std::sort(first, last);
+        length[i] = static_cast<int>(std::unique(first, last) - first);
+    }, 1024);
+
+    adj.outerIndex.assign(nV + 1, 0);
+    for (int i = 0; i < nV; ++i) adj.outerIndex[i + 1] = adj.outerIndex[i] + length[i];
+    adj.innerIndex.resize(adj.outerIndex[nV]);
+    adj.diagonal.resize(nV);
+    parallel::parallelFor(0, nV, [&](size_t i) {
+        std::copy_n(scratch.begin() + bound[i], length[i], adj.innerIndex.begin() + adj.outerIndex[i]);
+        adj.diagonal[i] = adj.slot(static_cast<int>(i), static_cast<int>(i));
+    }, 1024);
+
+    //  h(i -> j) д A(i, j), λڵ j к i λ
+    adj.halfEdgeSlot.resize(nH);
+    parallel::parallelFor(0, nH, [&](size_t h) {
+        const HalfEdge* he = halfEdges[h].get();
+        adj.halfEdgeSlot[h] = adj.slot(he->vertex->index, he->next->vertex->index);
+    });
+
+    adjacencyValid = true;
+    return adjacency;
+}
+
+/**
+ * @brief ±߽绷˲(㻡)
+ *
+ * ʽ hw ԭһ: δʵı߽߳,  next  pair->next
+ * ҵһ߽, ֱص㡣ʱð index ϣϡ
+ */
+void HalfEdgeMesh::buildBoundaryLoops() {
+    BoundaryLoops& b = boundary;
+    const size_t nH = halfEdges.size();
+    b.loopOffsets.assign(1, 0);
+    b.halfEdges.clear();
+    b.vertices.clear();
+    b.loopLength.clear();
+    b.vertexLoop.assign(vertices.size(), -1);
+    b.vertexSlot.assign(vertices.size(), -1);
+
+    std::vector<char> visited(nH, 0);
+    for (size_t s = 0; s < nH; ++s) {
+        HalfEdge* start = halfEdges[s].get();
+        if (start->pair || visited[s]) continue;
+
+        const int loop = b.loopCount();
+        HalfEdge* he = start;
+        size_t step = 0;
+        do {
+            visited[he->index] = 1;
+            const int v = he->vertex->index;
+            if (b.vertexLoop[v] < 0) {
+                b.vertexLoop[v] = loop;
+                b.vertexSlot[v] = static_cast<int>(b.vertices.size());
+            }
+            b.halfEdges.push_back(he->index);
+            b.vertices.push_back(v);
+
+            HalfEdge* candidate = he->next;
+            while (candidate->pair) candidate = candidate->pair->next;
+            he = candidate;
+            if (++step > nH) { // 쳣ʱȫ˳
+                std::cerr << "Warning: boundary walk aborted (non-manifold?)" << std::endl;
+                break;
+            }
+        } while (he != start && !visited[he->index]);
+        b.loopOffsets.push_back(static_cast<int>(b.halfEdges.size()));
     }
+    b.arcLength.resize(b.halfEdges.size());
+    b.loopLength.resize(b.loopCount());
+    boundaryValid = true;
+}
+
+/**
+ * @brief ǰλۼӱ߽绡ͻܳ
+ * λ(㷨ƶ), ߽綥
+ */
+void HalfEdgeMesh::updateBoundaryArcLength() {
+    BoundaryLoops& b = boundary;
+    for (int l = 0; l < b.loopCount(); ++l) {
+        double length = 0.0;
+        for (int k = b.loopOffsets[l]; k < b.loopOffsets[l + 1]; ++k) {
+            b.arcLength[k] = length;
+            length += halfEdges[b.halfEdges[k]]->getLength();
+        }
+        b.loopLength[l] = length;
+    }
+}
+
+/**
+ * @brief ߽绷: ˻ʧЧʱ±, ÿΰǰλۼ
+ */
+const BoundaryLoops& HalfEdgeMesh::getBoundaryLoops() {
+    ensureBoundaryLoops();
+    updateBoundaryArcLength();
+    return boundary;
 }
 
 /**
  * @brief жķ
  */
 void HalfEdgeMesh::computeNormals() {
-    // ȼķ
-    for (auto& face : faces) {
-        face->computeNormal();
-    }
+    // ȼķ(ͬʱ), ÿֻдԼ, ֱӲ
+    parallel::parallelFor(0, faces.size(), [&](size_t i) {
+        faces[i]->computeNormal();
+    });
     
     // ټжķ棩
-    for (auto& vertex : vertices) {
-        vertex->computeNormal();
-    }
+    parallel::parallelFor(0, vertices.size(), [&](size_t i) {
+        vertices[i]->computeNormal();
+    });
+
+    for (int v : dirtyVertices) vertexDirtyFlag[v] = 0;
+    dirtyVertices.clear();
 }
 
 /**
- * @brief ȡ򴴽ߵĶż
+ * @brief ¼λñ޸ĵĶ
  */
-HalfEdge* HalfEdgeMesh::getOrCreateHalfEdgePair(Vertex* v1, Vertex* v2,
-                                                std::map<std::pair<int, int>, HalfEdge*>& edgeMap,
-                                                HalfEdge* currentHalfEdge) {
-    // Ҷż (v2 -> v1)
-    auto key = std::make_pair(v2->index, v1->index);
-    auto it = edgeMap.find(key);
-    if (it != edgeMap.end()) {
-        return it->second;
-    }
-
-    // ûҵżߣ¼ǰ (v1 -> v2)
-    edgeMap[std::make_pair(v1->index, v2->index)] = currentHalfEdge;
-    return nullptr;
+void HalfEdgeMesh::markVertexDirty(int vertexIndex) {
+    if (vertexIndex < 0 || vertexIndex >= static_cast<int>(vertices.size())) return;
+    if (vertexDirtyFlag.size() < vertices.size()) vertexDirtyFlag.resize(vertices.size(), 0);
+    if (vertexDirtyFlag[vertexIndex]) return;
+    vertexDirtyFlag[vertexIndex] = 1;
+    dirtyVertices.push_back(vertexIndex);
+}
+
+/**
+ * @brief ·
+ * ඥƶֻӰ, Щķ/ֻӰϵж,
+ * ֻԪءඥʱֱȫ·
+ */
+void HalfEdgeMesh::updateNormals() {
+    if (dirtyVertices.empty()) return;
+    if (dirtyVertices.size() * 4 > vertices.size()) {
+        computeNormals();
+        return;
+    }
+
+    // 1. ռඥ(˫ת, ߽綥Ҳܸ)
+    std::vector<int> touchedFaces;
+    for (int v : dirtyVertices) {
+        vertexDirtyFlag[v] = 0;
+        HalfEdge* start = vertices[v]->halfEdge;
+        if (!start) continue;
+        HalfEdge* he = start;
+        do {
+            touchedFaces.push_back(he->face->index);
+            he = he->pair ? he->pair->next : nullptr;
+        } while (he && he != start);
+        if (!he) {
+            for (he = start->prev->pair; he; he = he->prev->pair) touchedFaces.push_back(he->face->index);
+        }
+    }
+    dirtyVertices.clear();
+    std::sort(touchedFaces.begin(), touchedFaces.end());
+    touchedFaces.erase(std::unique(touchedFaces.begin(), touchedFaces.end()), touchedFaces.end());
+
+    // 2. Щ, ռϵж
+    std::vector<int> touchedVertices;
+    for (int f : touchedFaces) {
+        faces[f]->computeNormal();
+        HalfEdge* he = faces[f]->halfEdge;
+        do {
+            touchedVertices.push_back(he->vertex->index);
+            he = he->next;
+        } while (he != faces[f]->halfEdge);
+    }
+    std::sort(touchedVertices.begin(), touchedVertices.end());
+    touchedVertices.erase(std::unique(touchedVertices.begin(), touchedVertices.end()), touchedVertices.end());
+
+    // 3. Ӱ춥ķ
+    for (int v : touchedVertices) {
+        vertices[v]->computeNormal();
+    }
 }
 
 /**
@@ -506,6 +1043,21 @@ std::pair<Eigen::Vector3d, Eigen::Vector3d> HalfEdgeMesh::getBoundingBox() const
     return {minPoint, maxPoint};
 }
 
+/**
+ * @brief ָṹռõֽ
+ * ÿԪһζĶѷ,  unique_ptr 鱾ͷͷ
+ */
+size_t HalfEdgeMesh::memoryUsage() const {
+    constexpr size_t allocOverhead = 16;
+    return vertices.capacity() * sizeof(std::unique_ptr<Vertex>)
+         + faces.capacity() * sizeof(std::unique_ptr<Face>)
+         + halfEdges.capacity() * sizeof(std::unique_ptr<HalfEdge>)
+         + vertices.size() * (sizeof(Vertex) + allocOverhead)
+         + faces.size() * (sizeof(Face) + allocOverhead)
+         + halfEdges.size() * (sizeof(HalfEdge) + allocOverhead)
+         + vertexProps.memoryUsage() + faceProps.memoryUsage() + halfEdgeProps.memoryUsage();
+}
+
 /**
  * @brief ȡܱ
  */
@@ -0,0 +1,110 @@
+﻿#include "mapped_file.h"
+#include <iostream>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace geometry {
+
+bool MappedFile::open(const std::string& path) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Error: Failed to open file " << path << std::endl;
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        std::cerr << "Error: Failed to query size of " << path << std::endl;
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle_ = file;
+    size_ = static_cast<size_t>(fileSize.QuadPart);
+    if (size_ > 0) {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!view) {
+            std::cerr << "Error: Failed to map file " << path << std::endl;
+            if (mapping) CloseHandle(mapping);
+            CloseHandle(file);
+            fileHandle_ = nullptr;
+            size_ = 0;
+            return false;
+        }
+        mappingHandle_ = mapping;
+        data_ = static_cast<const char*>(view);
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: Failed to open file " << path << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        std::cerr << "Error: Failed to query size of " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+    fd_ = fd;
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+        void* view = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view == MAP_FAILED) {
+            std::cerr << "Error: Failed to map file " << path << std::endl;
+            ::close(fd);
+            fd_ = -1;
+            size_ = 0;
+            return false;
+        }
+        madvise(view, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(view);
+    }
+#endif
+    open_ = true;
+    return true;
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+    if (data_) UnmapViewOfFile(data_);
+    if (mappingHandle_) CloseHandle(static_cast<HANDLE>(mappingHandle_));
+    if (fileHandle_) CloseHandle(static_cast<HANDLE>(fileHandle_));
+#else
+    if (data_) munmap(const_cast<char*>(data_), size_);
+    if (fd_ >= 0) ::close(fd_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    open_ = false;
+    fileHandle_ = nullptr;
+    mappingHandle_ = nullptr;
+    fd_ = -1;
+}
+
+void MappedFile::swap(MappedFile& other) noexcept {
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    std::swap(open_, other.open_);
+    std::swap(fileHandle_, other.fileHandle_);
+    std::swap(mappingHandle_, other.mappingHandle_);
+    std::swap(fd_, other.fd_);
+}
+
+} // namespace geometry
@@ -0,0 +1,247 @@
+﻿#include "mesh_cache.h"
+#include "halfedge.h"
+#include "parallel.h"
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace geometry {
+
+namespace {
+
+constexpr char MeshCacheMagic[8] = { 'G', 'P', 'H', 'E', 'M', 'E', 'S', 'H' };
+constexpr std::uint32_t MeshCacheEndianTag = 0x01020304u;
+constexpr size_t SectionCount = static_cast<size_t>(MeshCacheSection::Count);
+
+size_t alignUp(size_t n) { return (n + 7) & ~size_t(7); }
+
+/**
+ * @brief 写缓存用的临时文件名: <path>.<进程随机数>.<序号>.tmp
+ * 多个进程(或同一进程的多个线程, 如 mesh_batch 的并发任务)同时写同一缓存时各用各的临时文件,
+ * 改名是原子的, 最后发布的总是某一次完整写入的文件
+ */
+std::string uniqueTempPath(const std::string& path) {
+    static const std::uint64_t processToken = [] {
+        std::random_device device;
+        return (static_cast<std::uint64_t>(device()) << 32) ^ device();
+    }();
+    static std::atomic<std::uint64_t> counter { 0 };
+    return path + "." + std::to_string(processToken) + "." + std::to_string(counter.fetch_add(1)) + ".tmp";
+}
+
+/// 各段的字节数(由文件头中的元素数量决定)
+void sectionSizes(const MeshCacheHeader& h, size_t sizes[SectionCount]) {
+    const size_t i32 = sizeof(std::int32_t);
+    sizes[static_cast<size_t>(MeshCacheSection::Positions)] = 3 * h.vertexCount * sizeof(double);
+    sizes[static_cast<size_t>(MeshCacheSection::VertexHalfEdge)] = h.vertexCount * i32;
+    sizes[static_cast<size_t>(MeshCacheSection::FaceHalfEdge)] = h.faceCount * i32;
+    sizes[static_cast<size_t>(MeshCacheSection::HalfEdgeVertex)] = h.halfEdgeCount * i32;
+    sizes[static_cast<size_t>(MeshCacheSection::HalfEdgeFace)] = h.halfEdgeCount * i32;
+    sizes[static_cast<size_t>(MeshCacheSection::HalfEdgeNext)] = h.halfEdgeCount * i32;
+    sizes[static_cast<size_t>(MeshCacheSection::HalfEdgePrev)] = h.halfEdgeCount * i32;
+    sizes[static_cast<size_t>(MeshCacheSection::HalfEdgeTwin)] = h.halfEdgeCount * i32;
+    sizes[static_cast<size_t>(MeshCacheSection::LoopOffsets)] = (h.loopCount + 1) * i32;
+    sizes[static_cast<size_t>(MeshCacheSection::LoopHalfEdges)] = h.boundaryCount * i32;
+}
+
+/// 源文件的大小和修改时间, 获取失败时返回 false
+bool sourceStamp(const std::string& sourcePath, std::uint64_t& size, std::int64_t& time) {
+    std::error_code ec;
+    const auto fileSize = std::filesystem::file_size(sourcePath, ec);
+    if (ec) return false;
+    const auto writeTime = std::filesystem::last_write_time(sourcePath, ec);
+    if (ec) return false;
+    size = static_cast<std::uint64_t>(fileSize);
+    time = static_cast<std::int64_t>(writeTime.time_since_epoch().count());
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// MeshCache
+// ============================================================================
+
+bool MeshCache::open(const std::string& path) {
+    close();
+    if (!file.open(path)) return false;
+
+    if (file.size() < sizeof(MeshCacheHeader)) {
+        std::cerr << "Error: Mesh cache " << path << " is too small" << std::endl;
+        close();
+        return false;
+    }
+    const auto* h = reinterpret_cast<const MeshCacheHeader*>(file.data());
+    if (std::memcmp(h->magic, MeshCacheMagic, sizeof(MeshCacheMagic)) != 0) {
+        std::cerr << "Error: " << path << " is not a mesh cache" << std::endl;
+        close();
+        return false;
+    }
+    if (h->version != MeshCacheVersion || h->endianTag != MeshCacheEndianTag) {
+        std::cerr << "Warning: Mesh cache " << path << " has version " << h->version
+                  << " (expected " << MeshCacheVersion << ") or foreign byte order, ignoring it" << std::endl;
+        close();
+        return false;
+    }
+    constexpr std::uint64_t maxCount = std::numeric_limits<std::int32_t>::max();
+    if (h->fileSize != file.size() || h->vertexCount > maxCount || h->faceCount > maxCount ||
+        h->halfEdgeCount > maxCount || h->boundaryCount > h->halfEdgeCount || h->loopCount > h->boundaryCount) {
+        std::cerr << "Error: Mesh cache " << path << " has an inconsistent header" << std::endl;
+        close();
+        return false;
+    }
+    size_t sizes[SectionCount];
+    sectionSizes(*h, sizes);
+    for (size_t s = 0; s < SectionCount; ++s) {
+        const std::uint64_t offset = h->sectionOffset[s];
+        if (offset % 8 != 0 || offset < sizeof(MeshCacheHeader) || offset > file.size() ||
+            file.size() - offset < sizes[s]) {
+            std::cerr << "Error: Mesh cache " << path << " is truncated" << std::endl;
+            close();
+            return false;
+        }
+    }
+    header_ = h;
+    return true;
+}
+
+void MeshCache::close() {
+    header_ = nullptr;
+    file.close();
+}
+
+bool MeshCache::matchesSource(const std::string& sourcePath) const {
+    if (!isOpen()) return false;
+    std::uint64_t size = 0;
+    std::int64_t time = 0;
+    if (!sourceStamp(sourcePath, size, time)) return false;
+    return size == header_->sourceSize && time == header_->sourceTime;
+}
+
+std::string meshCachePath(const std::string& sourcePath) {
+    return sourcePath + ".hecache";
+}
+
+// ============================================================================
+// 写入
+// ============================================================================
+
+bool writeMeshCache(const std::string& path, HalfEdgeMesh& mesh, const std::string& sourcePath) {
+    const size_t nV = mesh.getVertexCount();
+    const size_t nF = mesh.getFaceCount();
+    const size_t nH = mesh.getHalfEdgeCount();
+    if (nV == 0) {
+        std::cerr << "Error: Cannot write an empty mesh cache" << std::endl;
+        return false;
+    }
+
+    // 缓存按数组下标保存连接关系, 要求已经做过垃圾回收
+    std::atomic<bool> compact { true };
+    parallel::parallelFor(0, nH, [&](size_t i) {
+        const HalfEdge* he = mesh.halfEdges[i].get();
+        if (he->deleted || he->index != static_cast<int>(i) || !he->next || !he->prev || !he->face) compact = false;
+    });
+    for (size_t i = 0; i < nV && compact; ++i) {
+        compact = !mesh.vertices[i]->deleted && mesh.vertices[i]->index == static_cast<int>(i);
+    }
+    for (size_t i = 0; i < nF && compact; ++i) {
+        compact = !mesh.faces[i]->deleted && mesh.faces[i]->index == static_cast<int>(i) && mesh.faces[i]->halfEdge;
+    }
+    if (!compact) {
+        std::cerr << "Error: Mesh has deleted or unlinked elements, call garbageCollection() before writing a cache" << std::endl;
+        return false;
+    }
+
+    const BoundaryLoops& loops = mesh.getBoundaryLoops();
+
+    MeshCacheHeader header {};
+    std::memcpy(header.magic, MeshCacheMagic, sizeof(MeshCacheMagic));
+    header.version = MeshCacheVersion;
+    header.endianTag = MeshCacheEndianTag;
+    header.vertexCount = nV;
+    header.faceCount = nF;
+    header.halfEdgeCount = nH;
+    header.loopCount = static_cast<std::uint64_t>(loops.loopCount());
+    header.boundaryCount = loops.halfEdges.size();
+    if (!sourcePath.empty() && !sourceStamp(sourcePath, header.sourceSize, header.sourceTime)) {
+        std::cerr << "Warning: Cannot stat " << sourcePath << ", the cache will never match it" << std::endl;
+    }
+
+    size_t sizes[SectionCount];
+    sectionSizes(header, sizes);
+    size_t offset = alignUp(sizeof(MeshCacheHeader));
+    for (size_t s = 0; s < SectionCount; ++s) {
+        header.sectionOffset[s] = offset;
+        offset = alignUp(offset + sizes[s]);
+    }
+    header.fileSize = offset;
+
+    std::vector<char> buffer(offset, 0);
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    auto sectionPtr = [&](MeshCacheSection s) {
+        return buffer.data() + header.sectionOffset[static_cast<size_t>(s)];
+    };
+    auto* positions = reinterpret_cast<double*>(sectionPtr(MeshCacheSection::Positions));
+    auto* vertexHalfEdge = reinterpret_cast<std::int32_t*>(sectionPtr(MeshCacheSection::VertexHalfEdge));
+    auto* faceHalfEdge = reinterpret_cast<std::int32_t*>(sectionPtr(MeshCacheSection::FaceHalfEdge));
+    auto* heVertex = reinterpret_cast<std::int32_t*>(sectionPtr(MeshCacheSection::HalfEdgeVertex));
+    auto* heFace = reinterpret_cast<std::int32_t*>(sectionPtr(MeshCacheSection::HalfEdgeFace));
+    auto* heNext = reinterpret_cast<std::int32_t*>(sectionPtr(MeshCacheSection::HalfEdgeNext));
+    auto* hePrev = reinterpret_cast<std::int32_t*>(sectionPtr(MeshCacheSection::HalfEdgePrev));
+    auto* heTwin = reinterpret_cast<std::int32_t*>(sectionPtr(MeshCacheSection::HalfEdgeTwin));
+
+    parallel::parallelFor(0, nV, [&](size_t i) {
+        const Vertex* v = mesh.vertices[i].get();
+        positions[3 * i] = v->position.x();
+        positions[3 * i + 1] = v->position.y();
+        positions[3 * i + 2] = v->position.z();
+        vertexHalfEdge[i] = v->halfEdge ? v->halfEdge->index : -1;
+    });
+    parallel::parallelFor(0, nF, [&](size_t i) {
+        faceHalfEdge[i] = mesh.faces[i]->halfEdge->index;
+    });
+    parallel::parallelFor(0, nH, [&](size_t i) {
+        const HalfEdge* he = mesh.halfEdges[i].get();
+        heVertex[i] = he->vertex->index;
+        heFace[i] = he->face->index;
+        heNext[i] = he->next->index;
+        hePrev[i] = he->prev->index;
+        heTwin[i] = he->pair ? he->pair->index : -1;
+    });
+    std::memcpy(sectionPtr(MeshCacheSection::LoopOffsets), loops.loopOffsets.data(),
+                sizes[static_cast<size_t>(MeshCacheSection::LoopOffsets)]);
+    if (!loops.halfEdges.empty()) {
+        std::memcpy(sectionPtr(MeshCacheSection::LoopHalfEdges), loops.halfEdges.data(),
+                    sizes[static_cast<size_t>(MeshCacheSection::LoopHalfEdges)]);
+    }
+
+    // 先写临时文件再改名, 避免留下写了一半的缓存
+    const std::string tempPath = uniqueTempPath(path);
+    std::error_code ec;
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out || !out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()))) {
+            std::cerr << "Error: Failed to write mesh cache " << tempPath << std::endl;
+            out.close();
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+    }
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        std::cerr << "Error: Failed to move mesh cache to " << path << ": " << ec.message() << std::endl;
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    std::cout << "Mesh cache written: " << path << " (" << buffer.size() << " bytes)" << std::endl;
+    return true;
+}
+
+} // namespace geometry
@@ -0,0 +1,831 @@
+﻿#include "mesh_codec.h"
+#include "mesh_io.h"
+#include "mapped_file.h"
+#include "parallel.h"
+#include "halfedge.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <span>
+
+namespace geometry {
+
+namespace {
+
+constexpr char MeshCodecMagic[8] = { 'G', 'P', 'M', 'C', 'O', 'D', 'E', 'C' };
+constexpr int VertexCacheSize = 32;                       ///< 最近引用缓存的长度
+constexpr std::uint8_t SymbolNewVertex = 0;               ///< 角点是新顶点
+constexpr std::uint8_t SymbolExplicit = VertexCacheSize + 1; ///< 缓存未命中, 相对上一次显式引用的差值在 extra 流中
+constexpr std::uint8_t DegreeEscape = 255;                ///< 面的度数 >= 255 时余数在 extra 流中
+
+// ============================================================================
+// 变长整数与字节读取
+// ============================================================================
+
+void putVarint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+void putFloat(std::vector<std::uint8_t>& out, float value) {
+    const std::uint32_t bits = std::bit_cast<std::uint32_t>(value);
+    for (int k = 0; k < 4; ++k) out.push_back(static_cast<std::uint8_t>(bits >> (8 * k)));
+}
+
+std::uint32_t zigzag(std::int32_t v) { return (static_cast<std::uint32_t>(v) << 1) ^ static_cast<std::uint32_t>(v >> 31); }
+std::int32_t unzigzag(std::uint32_t v) { return static_cast<std::int32_t>(v >> 1) ^ -static_cast<std::int32_t>(v & 1); }
+std::uint64_t zigzag64(std::int64_t v) { return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63); }
+std::int64_t unzigzag64(std::uint64_t v) { return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1); }
+
+/// 带边界检查的顺序读取, 越界后 ok 变为 false 并一直返回 0
+struct ByteReader {
+    const std::uint8_t* p = nullptr;
+    const std::uint8_t* end = nullptr;
+    bool ok = true;
+
+    ByteReader() = default;
+    ByteReader(const std::uint8_t* data, size_t size) : p(data), end(data + size) {}
+
+    size_t remaining() const { return static_cast<size_t>(end - p); }
+    std::uint8_t byte() {
+        if (p == end) {
+            ok = false;
+            return 0;
+        }
+        return *p++;
+    }
+    std::uint64_t varint() {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const std::uint8_t b = byte();
+            value |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return value;
+        }
+        ok = false;
+        return 0;
+    }
+    float real() {
+        std::uint32_t bits = 0;
+        for (int k = 0; k < 4; ++k) bits |= static_cast<std::uint32_t>(byte()) << (8 * k);
+        return std::bit_cast<float>(bits);
+    }
+};
+
+// ============================================================================
+// 静态 rANS(字节字母表, 12 位概率精度)
+// ============================================================================
+
+constexpr std::uint32_t RansScaleBits = 12;
+constexpr std::uint32_t RansScale = 1u << RansScaleBits;
+constexpr std::uint32_t RansLower = 1u << 23;
+
+/// 把符号计数归一化为和为 RansScale 的频率, 出现过的符号频率至少为 1
+void normalizeFrequencies(const std::array<size_t, 256>& counts, size_t total, std::array<std::uint32_t, 256>& freq) {
+    std::int64_t sum = 0;
+    for (int s = 0; s < 256; ++s) {
+        freq[s] = counts[s] == 0 ? 0 : std::max<std::uint32_t>(1, static_cast<std::uint32_t>(counts[s] * RansScale / total));
+        sum += freq[s];
+    }
+    // 误差由频率最大的符号吸收
+    while (sum != RansScale) {
+        int best = 0;
+        for (int s = 1; s < 256; ++s) {
+            if (freq[s] > freq[best]) best = s;
+        }
+        if (sum < RansScale) {
+            freq[best] += static_cast<std::uint32_t>(RansScale - sum);
+            sum = RansScale;
+        } else {
+            const std::uint32_t take = static_cast<std::uint32_t>(std::min<std::int64_t>(freq[best] - 1, sum - RansScale));
+            freq[best] -= take;
+            sum -= take;
+        }
+    }
+}
+
+/// 流格式: 符号数, [不同符号数, (符号, 频率)..., 码字节数, 码字节]
+void encodeStream(const std::vector<std::uint8_t>& symbols, std::vector<std::uint8_t>& out) {
+    const size_t n = symbols.size();
+    putVarint(out, n);
+    if (n == 0) return;
+
+    std::array<size_t, 256> counts {};
+    for (std::uint8_t s : symbols) ++counts[s];
+    std::array<std::uint32_t, 256> freq;
+    normalizeFrequencies(counts, n, freq);
+    std::array<std::uint32_t, 256> start;
+    std::uint32_t cumulative = 0;
+    size_t distinct = 0;
+    for (int s = 0; s < 256; ++s) {
+        start[s] = cumulative;
+        cumulative += freq[s];
+        if (freq[s]) ++distinct;
+    }
+    putVarint(out, distinct);
+    for (int s = 0; s < 256; ++s) {
+        if (!freq[s]) continue;
+        out.push_back(static_cast<std::uint8_t>(s));
+        putVarint(out, freq[s]);
+    }
+
+    // 逆序编码, 码字节从缓冲末尾向前写; 每个符号最多 12 位
+    std::vector<std::uint8_t> buffer(2 * n + 8);
+    std::uint8_t* ptr = buffer.data() + buffer.size();
+    std::uint32_t x = RansLower;
+    for (size_t i = n; i-- > 0;) {
+        const std::uint32_t f = freq[symbols[i]];
+        const std::uint32_t xMax = ((RansLower >> RansScaleBits) << 8) * f;
+        while (x >= xMax) {
+            *--ptr = static_cast<std::uint8_t>(x & 0xFF);
+            x >>= 8;
+        }
+        x = ((x / f) << RansScaleBits) + (x % f) + start[symbols[i]];
+    }
+    ptr -= 4;
+    for (int k = 0; k < 4; ++k) ptr[k] = static_cast<std::uint8_t>(x >> (8 * k));
+
+    const size_t size = static_cast<size_t>(buffer.data() + buffer.size() - ptr);
+    putVarint(out, size);
+    out.insert(out.end(), ptr, ptr + size);
+}
+
+/// 解码一个流, 符号数超过 maxCount 或数据不一致时返回 false
+bool decodeStream(ByteReader& in, size_t maxCount, std::vector<std::uint8_t>& symbols) {
+    const std::uint64_t n = in.varint();
+    if (!in.ok || n > maxCount) return false;
+    symbols.resize(static_cast<size_t>(n));
+    if (n == 0) return true;
+
+    const std::uint64_t distinct = in.varint();
+    if (!in.ok || distinct == 0 || distinct > 256) return false;
+    std::array<std::uint32_t, 256> freq {};
+    std::array<std::uint32_t, 256> start {};
+    std::array<std::uint8_t, RansScale> slotSymbol;
+    std::uint32_t cumulative = 0;
+    for (std::uint64_t i = 0; i < distinct; ++i) {
+        const std::uint8_t s = in.byte();
+        const std::uint64_t f = in.varint();
+        if (!in.ok || f == 0 || freq[s] != 0 || cumulative + f > RansScale) return false;
+        freq[s] = static_cast<std::uint32_t>(f);
+        start[s] = cumulative;
+        std::fill(slotSymbol.begin() + cumulative, slotSymbol.begin() + cumulative + f, s);
+        cumulative += static_cast<std::uint32_t>(f);
+    }
+    const std::uint64_t size = in.varint();
+    if (!in.ok || cumulative != RansScale || size < 4 || size > in.remaining()) return false;
+
+    const std::uint8_t* p = in.p;
+    const std::uint8_t* end = p + size;
+    in.p = end;
+    std::uint32_t x = static_cast<std::uint32_t>(p[0]) | static_cast<std::uint32_t>(p[1]) << 8 |
+                      static_cast<std::uint32_t>(p[2]) << 16 | static_cast<std::uint32_t>(p[3]) << 24;
+    p += 4;
+    for (size_t i = 0; i < n; ++i) {
+        const std::uint32_t slot = x & (RansScale - 1);
+        const std::uint8_t s = slotSymbol[slot];
+        symbols[i] = s;
+        x = freq[s] * (x >> RansScaleBits) + slot - start[s];
+        while (x < RansLower) {
+            if (p == end) return false;
+            x = (x << 8) | *p++;
+        }
+    }
+    return p == end;
+}
+
+// ============================================================================
+// 编码器和解码器共用的模型
+// ============================================================================
+
+/// move-to-front 的最近引用顶点缓存
+struct VertexCache {
+    std::uint32_t entries[VertexCacheSize];
+    int size = 0;
+
+    int find(std::uint32_t v) const {
+        for (int i = 0; i < size; ++i) {
+            if (entries[i] == v) return i;
+        }
+        return -1;
+    }
+    /// 把 v 放到最前面; position 为它当前所在位置, -1 表示不在缓存中
+    void touch(std::uint32_t v, int position) {
+        if (position < 0) {
+            position = size < VertexCacheSize ? size++ : VertexCacheSize - 1;
+        }
+        std::memmove(entries + 1, entries, sizeof(std::uint32_t) * position);
+        entries[0] = v;
+    }
+};
+
+/// 有向边 (u, v) -> 所在三角形的第三个顶点, 开放寻址哈希表
+class EdgeTable {
+public:
+    explicit EdgeTable(size_t edges) {
+        size_t capacity = 16;
+        while (capacity < 2 * edges) capacity <<= 1;
+        keys.assign(capacity, EmptyKey);
+        values.resize(capacity);
+        mask = capacity - 1;
+    }
+    void insert(std::uint32_t u, std::uint32_t v, std::uint32_t opposite) {
+        const std::uint64_t key = (static_cast<std::uint64_t>(u) << 32) | v;
+        size_t i = hash(key);
+        while (keys[i] != EmptyKey && keys[i] != key) i = (i + 1) & mask;
+        keys[i] = key;
+        values[i] = opposite;
+    }
+    /// 找不到时返回 false
+    bool find(std::uint32_t u, std::uint32_t v, std::uint32_t& opposite) const {
+        const std::uint64_t key = (static_cast<std::uint64_t>(u) << 32) | v;
+        for (size_t i = hash(key); keys[i] != EmptyKey; i = (i + 1) & mask) {
+            if (keys[i] == key) {
+                opposite = values[i];
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    static constexpr std::uint64_t EmptyKey = ~std::uint64_t(0);
+    size_t hash(std::uint64_t key) const { return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & mask; }
+
+    std::vector<std::uint64_t> keys;
+    std::vector<std::uint32_t> values;
+    size_t mask = 0;
+};
+
+/**
+ * @brief 块内的位置预测状态
+ * 只有编号在 [first, current) 内的顶点(本块已解码的顶点)可以参与预测。
+ */
+struct PositionPredictor {
+    std::uint32_t first = 0;
+    std::int32_t maxQ = 0;
+    const std::int32_t* q = nullptr; ///< 本块顶点的量化坐标, 下标从 first 开始
+
+    bool known(std::uint32_t v, std::uint32_t current) const { return v >= first && v < current; }
+    const std::int32_t* at(std::uint32_t v) const { return q + 3 * static_cast<size_t>(v - first); }
+
+    /// 面 corners[0..n) 的第 k 个角点是新顶点 current 时的预测值
+    void predict(const std::uint32_t* corners, int n, int k, std::uint32_t current,
+                 const EdgeTable& edges, std::int32_t out[3]) const {
+        const std::uint32_t prev = corners[(k + n - 1) % n];
+        const std::uint32_t next = corners[(k + 1) % n];
+        std::uint32_t opposite;
+        if (n == 3 && known(prev, current) && known(next, current) &&
+            edges.find(prev, next, opposite) && known(opposite, current)) {
+            // 平行四边形: 相邻三角形 (next, prev, opposite) 以 prev-next 为公共边
+            const std::int32_t* a = at(prev);
+            const std::int32_t* b = at(next);
+            const std::int32_t* c = at(opposite);
+            for (int d = 0; d < 3; ++d) out[d] = std::clamp(a[d] + b[d] - c[d], 0, maxQ);
+            return;
+        }
+        const std::int32_t* base = nullptr;
+        if (known(prev, current)) base = at(prev);
+        else if (known(next, current)) base = at(next);
+        else if (current > first) base = at(current - 1);
+        for (int d = 0; d < 3; ++d) out[d] = base ? base[d] : 0;
+    }
+};
+
+void insertTriangleEdges(EdgeTable& edges, const std::uint32_t* c) {
+    edges.insert(c[0], c[1], c[2]);
+    edges.insert(c[1], c[2], c[0]);
+    edges.insert(c[2], c[0], c[1]);
+}
+
+/// 残差的 zigzag 变长编码: 首字节和后续字节分成两个流, 两者的分布差别很大
+void putResidual(std::vector<std::uint8_t>& low, std::vector<std::uint8_t>& high, std::int32_t residual) {
+    std::uint32_t z = zigzag(residual);
+    low.push_back(static_cast<std::uint8_t>((z & 0x7F) | (z >= 0x80 ? 0x80 : 0)));
+    z >>= 7;
+    while (z) {
+        high.push_back(static_cast<std::uint8_t>((z & 0x7F) | (z >= 0x80 ? 0x80 : 0)));
+        z >>= 7;
+    }
+}
+
+/// 从解码后的符号数组中顺序读取
+struct SymbolReader {
+    const std::vector<std::uint8_t>* symbols = nullptr;
+    size_t pos = 0;
+    bool ok = true;
+
+    std::uint8_t next() {
+        if (pos >= symbols->size()) {
+            ok = false;
+            return 0;
+        }
+        return (*symbols)[pos++];
+    }
+    std::uint64_t varint() {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const std::uint8_t b = next();
+            value |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return value;
+        }
+        ok = false;
+        return 0;
+    }
+    bool finished() const { return ok && pos == symbols->size(); }
+};
+
+std::int32_t readResidual(SymbolReader& low, SymbolReader& high) {
+    const std::uint8_t b = low.next();
+    std::uint32_t z = b & 0x7F;
+    if (b & 0x80) z |= static_cast<std::uint32_t>(high.varint() << 7);
+    return unzigzag(z);
+}
+
+/// 块表中的一项
+struct BlockInfo {
+    std::uint64_t faceCount = 0;
+    std::uint64_t cornerCount = 0;
+    std::uint64_t vertexCount = 0;
+    std::uint64_t byteSize = 0;
+    // 以下由前缀和得到
+    std::uint64_t firstFace = 0;
+    std::uint64_t firstCorner = 0;
+    std::uint64_t firstVertex = 0;
+    std::uint64_t byteOffset = 0;
+};
+
+enum BlockStream { DegreeStream, CornerStream, ExtraStream, ResidualLowStream, ResidualHighStream, BlockStreamCount };
+
+// ============================================================================
+// 块编码
+// ============================================================================
+
+/**
+ * @param offsets/corners 遍历顺序下的面(顶点已重新编号), 本块的面是 [block.firstFace, +faceCount)
+ * @param quantized 所有顶点的量化坐标(新编号)
+ */
+void encodeBlock(const BlockInfo& block, const std::vector<std::uint64_t>& offsets,
+                 const std::vector<std::uint32_t>& corners, const std::vector<std::int32_t>& quantized,
+                 std::int32_t maxQ, std::vector<std::uint8_t>& payload) {
+    std::vector<std::uint8_t> streams[BlockStreamCount];
+    VertexCache cache;
+    EdgeTable edges(block.cornerCount);
+    PositionPredictor predictor;
+    predictor.first = static_cast<std::uint32_t>(block.firstVertex);
+    predictor.maxQ = maxQ;
+    predictor.q = quantized.data() + 3 * block.firstVertex;
+
+    std::uint32_t current = static_cast<std::uint32_t>(block.firstVertex);
+    std::int64_t lastExplicit = static_cast<std::int64_t>(block.firstVertex) - 1;
+    std::int32_t predicted[3];
+    auto putPosition = [&](std::uint32_t v) {
+        const std::int32_t* target = quantized.data() + 3 * static_cast<size_t>(v);
+        for (int d = 0; d < 3; ++d) {
+            putResidual(streams[ResidualLowStream], streams[ResidualHighStream], target[d] - predicted[d]);
+        }
+    };
+
+    for (std::uint64_t f = block.firstFace; f < block.firstFace + block.faceCount; ++f) {
+        const std::uint32_t* face = corners.data() + offsets[f];
+        const int n = static_cast<int>(offsets[f + 1] - offsets[f]);
+        if (n < DegreeEscape) {
+            streams[DegreeStream].push_back(static_cast<std::uint8_t>(n));
+        } else {
+            streams[DegreeStream].push_back(DegreeEscape);
+            putVarint(streams[ExtraStream], static_cast<std::uint64_t>(n - DegreeEscape));
+        }
+        // 先编码整个面的连接关系, 再按角点顺序编码新顶点的位置(解码端此时已知道面的所有顶点编号)
+        const std::uint32_t firstNew = current;
+        for (int k = 0; k < n; ++k) {
+            const std::uint32_t v = face[k];
+            if (v == current) {
+                // 顶点按第一次引用编号, 新顶点恰好是下一个编号
+                streams[CornerStream].push_back(SymbolNewVertex);
+                ++current;
+                cache.touch(v, -1);
+                continue;
+            }
+            const int hit = cache.find(v);
+            if (hit >= 0) {
+                streams[CornerStream].push_back(static_cast<std::uint8_t>(1 + hit));
+            } else {
+                streams[CornerStream].push_back(SymbolExplicit);
+                putVarint(streams[ExtraStream], zigzag64(static_cast<std::int64_t>(v) - lastExplicit - 1));
+                lastExplicit = v;
+            }
+            cache.touch(v, hit);
+        }
+        for (int k = 0; k < n; ++k) {
+            if (face[k] < firstNew) continue;
+            predictor.predict(face, n, k, face[k], edges, predicted);
+            putPosition(face[k]);
+        }
+        if (n == 3) insertTriangleEdges(edges, face);
+    }
+    // 块内没有被面引用的顶点(孤立顶点, 只出现在最后一块)按前一个顶点预测
+    const std::uint32_t end = static_cast<std::uint32_t>(block.firstVertex + block.vertexCount);
+    for (; current < end; ++current) {
+        const std::int32_t* base = current > predictor.first ? predictor.at(current - 1) : nullptr;
+        for (int d = 0; d < 3; ++d) predicted[d] = base ? base[d] : 0;
+        putPosition(current);
+    }
+
+    for (const auto& stream : streams) encodeStream(stream, payload);
+}
+
+// ============================================================================
+// 块解码
+// ============================================================================
+
+bool decodeBlock(const BlockInfo& block, const std::uint8_t* bytes, std::uint64_t totalVertices,
+                 std::int32_t maxQ, const float origin[3], float scale, MeshData& data) {
+    ByteReader in(bytes, static_cast<size_t>(block.byteSize));
+    // 符号数的上限: 度数 F, 角点 C, 其余流每个值最多 5 字节
+    const size_t limits[BlockStreamCount] = {
+        static_cast<size_t>(block.faceCount),
+        static_cast<size_t>(block.cornerCount),
+        static_cast<size_t>(5 * (block.cornerCount + block.faceCount)),
+        static_cast<size_t>(3 * block.vertexCount),
+        static_cast<size_t>(15 * block.vertexCount),
+    };
+    std::vector<std::uint8_t> streams[BlockStreamCount];
+    for (int s = 0; s < BlockStreamCount; ++s) {
+        if (!decodeStream(in, limits[s], streams[s])) return false;
+    }
+    if (in.remaining() != 0) return false;
+    SymbolReader reader[BlockStreamCount];
+    for (int s = 0; s < BlockStreamCount; ++s) reader[s].symbols = &streams[s];
+
+    std::vector<std::int32_t> quantized(3 * block.vertexCount);
+    VertexCache cache;
+    EdgeTable edges(block.cornerCount);
+    PositionPredictor predictor;
+    predictor.first = static_cast<std::uint32_t>(block.firstVertex);
+    predictor.maxQ = maxQ;
+    predictor.q = quantized.data();
+    const std::uint64_t end = block.firstVertex + block.vertexCount;
+
+    std::uint32_t current = predictor.first;
+    std::int64_t lastExplicit = static_cast<std::int64_t>(block.firstVertex) - 1;
+    std::int32_t predicted[3];
+    auto readPosition = [&](std::uint32_t v) {
+        std::int32_t* target = quantized.data() + 3 * static_cast<size_t>(v - predictor.first);
+        for (int d = 0; d < 3; ++d) {
+            const std::int64_t value = static_cast<std::int64_t>(predicted[d]) +
+                                       readResidual(reader[ResidualLowStream], reader[ResidualHighStream]);
+            if (value < 0 || value > maxQ) return false;
+            target[d] = static_cast<std::int32_t>(value);
+        }
+        return true;
+    };
+
+    std::uint32_t* outOffsets = data.faceOffsets.data() + block.firstFace + 1;
+    std::int32_t* outCorners = data.faceVertices.data() + block.firstCorner;
+    std::uint64_t cornerCount = 0;
+    for (std::uint64_t f = 0; f < block.faceCount; ++f) {
+        std::uint64_t n = reader[DegreeStream].next();
+        if (n == DegreeEscape) n += reader[ExtraStream].varint();
+        if (n < 3 || cornerCount + n > block.cornerCount) return false;
+        auto* face = reinterpret_cast<std::uint32_t*>(outCorners + cornerCount);
+        const std::uint32_t firstNew = current;
+        for (std::uint64_t k = 0; k < n; ++k) {
+            const std::uint8_t symbol = reader[CornerStream].next();
+            std::uint32_t v;
+            if (symbol == SymbolNewVertex) {
+                if (current >= end) return false;
+                v = current++;
+            } else if (symbol <= VertexCacheSize) {
+                const int hit = symbol - 1;
+                if (hit >= cache.size) return false;
+                v = cache.entries[hit];
+                cache.touch(v, hit);
+                face[k] = v;
+                continue;
+            } else if (symbol == SymbolExplicit) {
+                const std::int64_t w = lastExplicit + 1 + unzigzag64(reader[ExtraStream].varint());
+                if (w < 0 || w >= current) return false;
+                v = static_cast<std::uint32_t>(w);
+                lastExplicit = v;
+            } else {
+                return false;
+            }
+            cache.touch(v, -1);
+            face[k] = v;
+        }
+        for (std::uint64_t k = 0; k < n; ++k) {
+            if (face[k] < firstNew) continue;
+            predictor.predict(face, static_cast<int>(n), static_cast<int>(k), face[k], edges, predicted);
+            if (!readPosition(face[k])) return false;
+        }
+        if (n == 3) insertTriangleEdges(edges, face);
+        cornerCount += n;
+        outOffsets[f] = static_cast<std::uint32_t>(block.firstCorner + cornerCount);
+    }
+    for (; current < end; ++current) {
+        const std::int32_t* base = current > predictor.first ? predictor.at(current - 1) : nullptr;
+        for (int d = 0; d < 3; ++d) predicted[d] = base ? base[d] : 0;
+        if (!readPosition(current)) return false;
+    }
+    if (cornerCount != block.cornerCount || end > totalVertices) return false;
+    for (int s = 0; s < BlockStreamCount; ++s) {
+        if (!reader[s].finished()) return false;
+    }
+
+    float* outPositions = data.positions.data() + 3 * block.firstVertex;
+    for (size_t i = 0; i < quantized.size(); ++i) {
+        outPositions[i] = origin[i % 3] + static_cast<float>(quantized[i]) * scale;
+    }
+    return true;
+}
+
+bool writeBytes(const std::string& path, const std::vector<std::uint8_t>& bytes) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Error: Failed to create file " << path << std::endl;
+        return false;
+    }
+    bool ok = bytes.empty() || std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Error: Failed to write file " << path << std::endl;
+    }
+    return ok;
+}
+
+} // namespace
+
+// ============================================================================
+// 编码
+// ============================================================================
+
+bool encodeMesh(const HalfEdgeMesh& mesh, std::vector<std::uint8_t>& bytes,
+                const MeshCodecOptions& options, std::vector<int>* vertexOrder) {
+    bytes.clear();
+    if (options.positionBits < 1 || options.positionBits > 24) {
+        std::cerr << "Error: positionBits must be in [1, 24], got " << options.positionBits << std::endl;
+        return false;
+    }
+    auto usable = [](const Face* face) { return !face->deleted && face->halfEdge; };
+
+    // 1. 对偶图广度优先遍历, order 同时充当队列
+    const size_t faceSlots = mesh.faces.size();
+    std::vector<char> visited(faceSlots, 0);
+    std::vector<int> order;
+    order.reserve(faceSlots);
+    for (size_t seed = 0; seed < faceSlots; ++seed) {
+        if (visited[seed] || !usable(mesh.faces[seed].get())) continue;
+        visited[seed] = 1;
+        order.push_back(static_cast<int>(seed));
+        for (size_t head = order.size() - 1; head < order.size(); ++head) {
+            const HalfEdge* start = mesh.faces[order[head]]->halfEdge;
+            const HalfEdge* h = start;
+            do {
+                const Face* neighbor = h->pair ? h->pair->face : nullptr;
+                if (neighbor && !visited[neighbor->index] && usable(neighbor)) {
+                    visited[neighbor->index] = 1;
+                    order.push_back(neighbor->index);
+                }
+                h = h->next;
+            } while (h != start);
+        }
+    }
+    std::vector<char>().swap(visited);
+
+    // 2. 按遍历顺序展开角点, 顶点按第一次引用重新编号; 每块开始时记录顶点计数
+    const size_t nF = order.size();
+    const size_t blockFaces = std::max<size_t>(1, options.blockFaces);
+    const size_t blockCount = std::max<size_t>(1, (nF + blockFaces - 1) / blockFaces);
+    std::vector<BlockInfo> blocks(blockCount);
+    std::vector<std::int64_t> newId(mesh.vertices.size(), -1);
+    std::vector<int> newToOld;
+    newToOld.reserve(mesh.vertices.size());
+    std::vector<std::uint64_t> offsets(nF + 1, 0);
+    std::vector<std::uint32_t> corners;
+    corners.reserve(3 * nF);
+    for (size_t f = 0; f < nF; ++f) {
+        if (f % blockFaces == 0) {
+            blocks[f / blockFaces].firstVertex = newToOld.size();
+            blocks[f / blockFaces].firstCorner = corners.size();
+        }
+        const HalfEdge* start = mesh.faces[order[f]]->halfEdge;
+        const HalfEdge* h = start;
+        do {
+            const int v = h->vertex->index;
+            if (newId[v] < 0) {
+                newId[v] = static_cast<std::int64_t>(newToOld.size());
+                newToOld.push_back(v);
+            }
+            corners.push_back(static_cast<std::uint32_t>(newId[v]));
+            h = h->next;
+        } while (h != start);
+        offsets[f + 1] = corners.size();
+    }
+    for (size_t v = 0; v < mesh.vertices.size(); ++v) {
+        if (!mesh.vertices[v]->deleted && newId[v] < 0) {
+            newId[v] = static_cast<std::int64_t>(newToOld.size());
+            newToOld.push_back(static_cast<int>(v));
+        }
+    }
+    const size_t nV = newToOld.size();
+    if (nV == 0) {
+        std::cerr << "Error: Cannot encode an empty mesh" << std::endl;
+        return false;
+    }
+    if (corners.size() > std::numeric_limits<std::uint32_t>::max()) {
+        std::cerr << "Error: Mesh has too many corners to encode" << std::endl;
+        return false;
+    }
+    for (size_t b = 0; b < blockCount; ++b) {
+        BlockInfo& block = blocks[b];
+        block.firstFace = b * blockFaces;
+        block.faceCount = std::min(nF, block.firstFace + blockFaces) - block.firstFace;
+        block.cornerCount = offsets[block.firstFace + block.faceCount] - block.firstCorner;
+        block.vertexCount = (b + 1 < blockCount ? blocks[b + 1].firstVertex : nV) - block.firstVertex;
+    }
+
+    // 3. 按包围盒最长边统一量化
+    Eigen::Vector3d lo = Eigen::Vector3d::Constant(std::numeric_limits<double>::max());
+    Eigen::Vector3d hi = -lo;
+    for (int v : newToOld) {
+        lo = lo.cwiseMin(mesh.vertices[v]->position);
+        hi = hi.cwiseMax(mesh.vertices[v]->position);
+    }
+    const std::int32_t maxQ = static_cast<std::int32_t>((1u << options.positionBits) - 1);
+    const float origin[3] = { static_cast<float>(lo.x()), static_cast<float>(lo.y()), static_cast<float>(lo.z()) };
+    const double range = std::max((hi - lo).maxCoeff(), std::numeric_limits<double>::min());
+    const float scale = static_cast<float>(range / maxQ);
+    std::vector<std::int32_t> quantized(3 * nV);
+    parallel::parallelFor(0, nV, [&](size_t v) {
+        const Eigen::Vector3d& p = mesh.vertices[newToOld[v]]->position;
+        for (int d = 0; d < 3; ++d) {
+            const double u = std::round((p[d] - origin[d]) / range * maxQ);
+            quantized[3 * v + d] = static_cast<std::int32_t>(std::clamp(u, 0.0, static_cast<double>(maxQ)));
+        }
+    });
+
+    // 4. 各块并行编码
+    std::vector<std::vector<std::uint8_t>> payloads(blockCount);
+    parallel::parallelFor(0, blockCount, [&](size_t b) {
+        encodeBlock(blocks[b], offsets, corners, quantized, maxQ, payloads[b]);
+    }, 1);
+
+    // 5. 文件头 + 块表 + 块数据
+    bytes.insert(bytes.end(), MeshCodecMagic, MeshCodecMagic + sizeof(MeshCodecMagic));
+    putVarint(bytes, MeshCodecVersion);
+    putVarint(bytes, nV);
+    putVarint(bytes, nF);
+    putVarint(bytes, corners.size());
+    putVarint(bytes, static_cast<std::uint64_t>(options.positionBits));
+    for (float o : origin) putFloat(bytes, o);
+    putFloat(bytes, scale);
+    putVarint(bytes, blockCount);
+    size_t payloadSize = 0;
+    for (size_t b = 0; b < blockCount; ++b) {
+        putVarint(bytes, blocks[b].faceCount);
+        putVarint(bytes, blocks[b].cornerCount);
+        putVarint(bytes, blocks[b].vertexCount);
+        putVarint(bytes, payloads[b].size());
+        payloadSize += payloads[b].size();
+    }
+    const size_t headerSize = bytes.size();
+    bytes.resize(headerSize + payloadSize);
+    std::vector<size_t> payloadOffset(blockCount, headerSize);
+    for (size_t b = 1; b < blockCount; ++b) payloadOffset[b] = payloadOffset[b - 1] + payloads[b - 1].size();
+    parallel::parallelFor(0, blockCount, [&](size_t b) {
+        std::copy(payloads[b].begin(), payloads[b].end(), bytes.begin() + payloadOffset[b]);
+    }, 1);
+
+    if (vertexOrder) vertexOrder->swap(newToOld);
+    return true;
+}
+
+// ============================================================================
+// 解码
+// ============================================================================
+
+bool decodeMesh(const std::uint8_t* bytes, size_t size, MeshData& data) {
+    data.clear();
+    ByteReader in(bytes, size);
+    if (size < sizeof(MeshCodecMagic) || std::memcmp(bytes, MeshCodecMagic, sizeof(MeshCodecMagic)) != 0) {
+        std::cerr << "Error: Data is not a compressed mesh" << std::endl;
+        return false;
+    }
+    in.p += sizeof(MeshCodecMagic);
+    const std::uint64_t version = in.varint();
+    if (version != MeshCodecVersion) {
+        std::cerr << "Error: Compressed mesh has version " << version << " (expected " << MeshCodecVersion << ")" << std::endl;
+        return false;
+    }
+    const std::uint64_t nV = in.varint();
+    const std::uint64_t nF = in.varint();
+    const std::uint64_t nC = in.varint();
+    const std::uint64_t bits = in.varint();
+    float origin[3];
+    for (float& o : origin) o = in.real();
+    const float scale = in.real();
+    const std::uint64_t blockCount = in.varint();
+    // 每块至少占几个字节, 块数和元素数不可能超过码流长度允许的范围
+    const std::uint64_t sane = 64ull * size;
+    if (!in.ok || nV == 0 || nV > std::numeric_limits<std::int32_t>::max() || nC > std::numeric_limits<std::uint32_t>::max() ||
+        nF > nC || bits < 1 || bits > 24 || blockCount == 0 || blockCount > size || nV > sane || nC > sane) {
+        std::cerr << "Error: Compressed mesh has an invalid header" << std::endl;
+        return false;
+    }
+
+    std::vector<BlockInfo> blocks(static_cast<size_t>(blockCount));
+    std::uint64_t faces = 0, cornerTotal = 0, vertices = 0, payload = 0;
+    for (BlockInfo& block : blocks) {
+        block.faceCount = in.varint();
+        block.cornerCount = in.varint();
+        block.vertexCount = in.varint();
+        block.byteSize = in.varint();
+        block.firstFace = faces;
+        block.firstCorner = cornerTotal;
+        block.firstVertex = vertices;
+        block.byteOffset = payload;
+        faces += block.faceCount;
+        cornerTotal += block.cornerCount;
+        vertices += block.vertexCount;
+        payload += block.byteSize;
+        if (!in.ok || faces > nF || cornerTotal > nC || vertices > nV || payload > size) break;
+    }
+    if (!in.ok || faces != nF || cornerTotal != nC || vertices != nV || payload != in.remaining()) {
+        std::cerr << "Error: Compressed mesh has an inconsistent block table" << std::endl;
+        return false;
+    }
+
+    data.positions.resize(3 * nV);
+    data.faceOffsets.resize(nF + 1);
+    data.faceOffsets[0] = 0;
+    data.faceVertices.resize(nC);
+    const std::uint8_t* payloadStart = in.p;
+    const std::int32_t maxQ = static_cast<std::int32_t>((1u << bits) - 1);
+    std::vector<char> blockOk(blocks.size(), 0);
+    parallel::parallelFor(0, blocks.size(), [&](size_t b) {
+        blockOk[b] = decodeBlock(blocks[b], payloadStart + blocks[b].byteOffset, nV, maxQ, origin, scale, data);
+    }, 1);
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        if (!blockOk[b]) {
+            std::cerr << "Error: Compressed mesh block " << b << " is corrupt" << std::endl;
+            data.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool decodeMesh(const std::uint8_t* bytes, size_t size, HalfEdgeMesh& mesh) {
+    MeshData data;
+    if (!decodeMesh(bytes, size, data)) return false;
+    mesh.buildFromArrays(data.positions,
+                         std::span<const std::uint32_t>(reinterpret_cast<const std::uint32_t*>(data.faceVertices.data()),
+                                                        data.faceVertices.size()),
+                         data.faceOffsets);
+    return true;
+}
+
+// ============================================================================
+// 文件
+// ============================================================================
+
+bool writeCompressedMesh(const std::string& path, const HalfEdgeMesh& mesh, const MeshCodecOptions& options) {
+    std::vector<std::uint8_t> bytes;
+    if (!encodeMesh(mesh, bytes, options)) return false;
+    if (!writeBytes(path, bytes)) return false;
+    std::cout << "Compressed mesh written to " << path << ": " << bytes.size() << " bytes" << std::endl;
+    return true;
+}
+
+bool writeCompressedMesh(const std::string& path, const MeshData& data, const MeshCodecOptions& options) {
+    HalfEdgeMesh mesh;
+    mesh.buildFromArrays(data.positions,
+                         std::span<const std::uint32_t>(reinterpret_cast<const std::uint32_t*>(data.faceVertices.data()),
+                                                        data.faceVertices.size()),
+                         data.faceOffsets);
+    return writeCompressedMesh(path, mesh, options);
+}
+
+bool readCompressedMesh(const std::string& path, MeshData& data) {
+    MappedFile file;
+    if (!file.open(path)) {
+        data.clear();
+        return false;
+    }
+    if (!decodeMesh(reinterpret_cast<const std::uint8_t*>(file.data()), file.size(), data)) {
+        std::cerr << "Error: Failed to decode " << path << std::endl;
+        return false;
+    }
+    std::cout << "Loaded " << data.getVertexCount() << " vertices and "
+              << data.getFaceCount() << " faces from " << path << std::endl;
+    return true;
+}
+
+} // namespace geometry
@@ -1,7 +1,50 @@
 #include "mesh_converter.h"
+#include "mesh_cache.h"
+#include "parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <span>
 
 namespace geometry {
 
+namespace {
+
+/// Ƿ: λͬ,  f  indices[3f] ξ f 
+bool cacheMatchesQtData(const MeshCache& cache, const std::vector<QVector3D>& qVertices,
+                        const std::vector<unsigned int>& indices) {
+    if (!cache.isOpen() || cache.getVertexCount() != qVertices.size() || 3 * cache.getFaceCount() != indices.size() ||
+        cache.getHalfEdgeCount() != indices.size()) {
+        return false;
+    }
+    const auto positions = cache.positions();
+    const auto faceHalfEdge = cache.faceHalfEdge();
+    const auto heVertex = cache.halfEdgeVertex();
+    const auto heNext = cache.halfEdgeNext();
+    const std::int32_t halfEdgeCount = static_cast<std::int32_t>(indices.size());
+    std::atomic<bool> match { true };
+    parallel::parallelFor(0, qVertices.size(), [&](size_t v) {
+        if (positions[3 * v] != qVertices[v].x() || positions[3 * v + 1] != qVertices[v].y() ||
+            positions[3 * v + 2] != qVertices[v].z()) {
+            match.store(false, std::memory_order_relaxed);
+        }
+    });
+    parallel::parallelFor(0, cache.getFaceCount(), [&](size_t f) {
+        std::int32_t h = faceHalfEdge[f];
+        for (size_t k = 0; k < 3; ++k) {
+            if (h < 0 || h >= halfEdgeCount || heVertex[h] < 0 || static_cast<unsigned int>(heVertex[h]) != indices[3 * f + k]) {
+                match.store(false, std::memory_order_relaxed);
+                return;
+            }
+            h = heNext[h];
+        }
+        if (h != faceHalfEdge[f]) match.store(false, std::memory_order_relaxed);
+    });
+    return match.load();
+}
+
+} // namespace
+
 std::vector<Eigen::Vector3d> MeshConverter::convertQtToEigen(const std::vector<QVector3D>& qVertices) {
     std::vector<Eigen::Vector3d> eigenVerts;
     eigenVerts.reserve(qVertices.size());
@@ -37,40 +80,98 @@ std::vector<std::vector<int>> MeshConverter::convertIndicesToFaces(const std::ve
 
 void MeshConverter::buildMeshFromQtData(HalfEdgeMesh& mesh,
                                         const std::vector<QVector3D>& qVertices,
-                                        const std::vector<unsigned int>& indices) {
-    // 1. ʽת
-    auto eigenVerts = convertQtToEigen(qVertices);
-    // 2. б
-    auto facesData  = convertIndicesToFaces(indices);
-    // 3. 
-    mesh.buildFromOBJ(eigenVerts, facesData);
+                                        const std::vector<unsigned int>& indices,
+                                        const MeshCache* cache) {
+    // ӹϵѾԺ, ֻҪԪزָ
+    if (cache && cacheMatchesQtData(*cache, qVertices, indices) && mesh.buildFromCache(*cache)) return;
+
+    // QVector3D  3  float, 鶼ֱΪƽ鴫, мת
+    static_assert(sizeof(QVector3D) == 3 * sizeof(float), "QVector3D must be tightly packed");
+    static_assert(sizeof(unsigned int) == sizeof(std::uint32_t), "unsigned int must be 32-bit");
+    mesh.buildFromArrays(
+        std::span<const float>(reinterpret_cast<const float*>(qVertices.data()), qVertices.size() * 3),
+        std::span<const std::uint32_t>(reinterpret_cast<const std::uint32_t*>(indices.data()), indices.size()));
 }
 
 std::pair<std::vector<QVector3D>, std::vector<unsigned int>>
-MeshConverter::convertMeshToQtData(const HalfEdgeMesh& mesh) {
-    std::vector<QVector3D> qVertices;
+MeshConverter::convertMeshToQtData(const HalfEdgeMesh& mesh, TriangleOrderStats* stats) {
+    std::vector<QVector3D> qVertices(mesh.vertices.size());
     std::vector<unsigned int> indices;
 
     // ݸ
-    qVertices.reserve(mesh.vertices.size());
-    for (const auto& vertex : mesh.vertices) {
-        qVertices.emplace_back(static_cast<float>(vertex->position.x()),
-                               static_cast<float>(vertex->position.y()),
-                               static_cast<float>(vertex->position.z()));
-    }
+    exportPositions(mesh, asFloatSpan(qVertices));
+
+    //  ->  (趼Ǽ򵥶(ĿǰΪ)), ˳һ
+    std::uint64_t version = NoTopologyVersion;
+    exportIndices(mesh, indices, version, stats);
+
+    return { qVertices, indices };
+}
+
+std::span<float> MeshConverter::asFloatSpan(std::vector<QVector3D>& vertices) {
+    static_assert(sizeof(QVector3D) == 3 * sizeof(float), "QVector3D must be tightly packed");
+    return { reinterpret_cast<float*>(vertices.data()), vertices.size() * 3 };
+}
 
-    //  ->  (趼Ǽ򵥶(ĿǰΪ))
+namespace {
+
+/// 𶥵 3 άд out[3i], get(vertex)  Eigen::Vector3d
+template <class Getter>
+void exportVectors(const HalfEdgeMesh& mesh, std::span<float> out, size_t begin, size_t end, Getter get) {
+    end = std::min({ end, mesh.vertices.size(), out.size() / 3 });
+    if (begin >= end) return;
+    parallel::parallelFor(begin, end, [&](size_t i) {
+        const Eigen::Vector3d value = get(*mesh.vertices[i]);
+        out[3 * i] = static_cast<float>(value.x());
+        out[3 * i + 1] = static_cast<float>(value.y());
+        out[3 * i + 2] = static_cast<float>(value.z());
+    });
+}
+
+} // namespace
+
+void MeshConverter::exportPositions(const HalfEdgeMesh& mesh, std::span<float> out, size_t begin, size_t end) {
+    exportVectors(mesh, out, begin, end, [](const Vertex& v) { return v.position; });
+}
+
+void MeshConverter::exportNormals(const HalfEdgeMesh& mesh, std::span<float> out, size_t begin, size_t end) {
+    exportVectors(mesh, out, begin, end, [](const Vertex& v) { return v.normal; });
+}
+
+void MeshConverter::exportColors(const HalfEdgeMesh& mesh, std::span<float> out, size_t begin, size_t end) {
+    const auto* colors = mesh.getVertexProperty<Eigen::Vector3d>("v:color");
+    exportVectors(mesh, out, begin, end, [&](const Vertex& v) {
+        return colors ? (*colors)[v.index] : Eigen::Vector3d(1.0, 1.0, 1.0);
+    });
+}
+
+bool MeshConverter::exportIndices(const HalfEdgeMesh& mesh, std::vector<unsigned int>& indices, std::uint64_t& version,
+                                  TriangleOrderStats* stats) {
+    if (version == mesh.getTopologyVersion()) return false;
+
+    indices.clear();
     indices.reserve(mesh.faces.size() * 3);
+    bool allTriangles = true;
     for (const auto& face : mesh.faces) {
         HalfEdge* he = face->halfEdge;
         if (!he) continue;
+        const size_t first = indices.size();
         do {
             indices.push_back(static_cast<unsigned int>(he->vertex->index));
             he = he->next;
         } while (he && he != face->halfEdge);
+        allTriangles = allTriangles && indices.size() - first == 3;
     }
 
-    return { qVertices, indices };
+    // ΰ㻺/Ȼ(Ų), ʱÿ֡Ҫ塣
+    // ·(convertMeshToQtData ), ͬһõͬ˳
+    if (allTriangles && !indices.empty()) {
+        std::vector<float> positions(mesh.vertices.size() * 3);
+        exportPositions(mesh, positions);
+        optimizeTriangleOrder(indices, mesh.vertices.size(), positions, DefaultVertexCacheSize, stats);
+    }
+    version = mesh.getTopologyVersion();
+    return true;
 }
 
 } // namespace geometry
@@ -0,0 +1,1415 @@
+﻿#include "mesh_io.h"
+#include "mesh_codec.h"
+#include "mapped_file.h"
+#include "parallel.h"
+#include "halfedge.h"
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <iostream>
+#include <sstream>
+
+namespace geometry {
+
+// ============================================================================
+// MeshData
+// ============================================================================
+
+void MeshData::clear() {
+    positions.clear();
+    texCoords.clear();
+    normals.clear();
+    faceOffsets.clear();
+    faceVertices.clear();
+    faceTexCoords.clear();
+    faceNormals.clear();
+    quality.clear();
+}
+
+std::vector<Eigen::Vector3d> MeshData::getPositions() const {
+    std::vector<Eigen::Vector3d> result(getVertexCount());
+    for (size_t i = 0; i < result.size(); ++i) {
+        result[i] = Eigen::Vector3d(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2]);
+    }
+    return result;
+}
+
+std::vector<std::vector<int>> MeshData::getFaceLists() const {
+    std::vector<std::vector<int>> result(getFaceCount());
+    for (size_t f = 0; f < result.size(); ++f) {
+        result[f].assign(faceVertices.begin() + faceOffsets[f], faceVertices.begin() + faceOffsets[f + 1]);
+    }
+    return result;
+}
+
+// ============================================================================
+// OBJ 读取
+// ============================================================================
+
+namespace {
+
+constexpr std::int32_t MissingIndex = std::numeric_limits<std::int32_t>::min();     ///< 角点没有写 vt/vn
+constexpr std::int32_t InvalidIndex = std::numeric_limits<std::int32_t>::min() + 1; ///< 索引为 0 或无法解析
+
+/**
+ * @brief 一个分块的解析结果
+ *
+ * 正索引在解析时就能转换成全局下标; 负索引相对于"到这一行为止已读入的元素数",
+ * 而前面分块有多少元素要等全部解析完才知道, 所以先记为相对本块起点的下标,
+ * 并把角点位置记在 relative* 中, 合并时再加上本块的全局偏移。
+ */
+struct ObjChunk {
+    std::vector<float> positions;
+    std::vector<float> texCoords;
+    std::vector<float> normals;
+    std::vector<std::uint32_t> faceSizes;
+    std::vector<std::int32_t> v, vt, vn; ///< 每个角点的索引
+    std::vector<std::uint32_t> relativeV, relativeVT, relativeVN;
+    bool hasTexCoords = false;
+    bool hasNormals = false;
+    size_t skippedFaces = 0;
+};
+
+inline const char* skipSpaces(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+    return p;
+}
+
+inline bool parseFloat(const char*& p, const char* end, float& value) {
+    p = skipSpaces(p, end);
+    if (p < end && *p == '+') ++p;
+    auto result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) return false;
+    p = result.ptr;
+    return true;
+}
+
+inline bool parseInt(const char*& p, const char* end, int& value) {
+    if (p < end && *p == '+') ++p;
+    auto result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) return false;
+    p = result.ptr;
+    return true;
+}
+
+/// 读取 count 个浮点数追加到 out, 缺少的分量补 0
+inline void parseFloats(const char* p, const char* end, int count, std::vector<float>& out) {
+    for (int i = 0; i < count; ++i) {
+        float value = 0.0f;
+        if (!parseFloat(p, end, value)) value = 0.0f;
+        out.push_back(value);
+    }
+}
+
+/**
+ * @brief OBJ 索引 -> 0 起始下标
+ * 负索引转为相对本块起点的下标并记下角点位置, 合并时补上偏移
+ */
+inline std::int32_t resolveIndex(int index, size_t localCount, std::vector<std::uint32_t>& relative, size_t corner) {
+    if (index > 0) return index - 1;
+    if (index < 0) {
+        relative.push_back(static_cast<std::uint32_t>(corner));
+        return static_cast<std::int32_t>(static_cast<std::int64_t>(localCount) + index);
+    }
+    return InvalidIndex;
+}
+
+void parseFace(const char* p, const char* end, ObjChunk& chunk) {
+    const size_t corner0 = chunk.v.size();
+    const size_t relV0 = chunk.relativeV.size();
+    const size_t relVT0 = chunk.relativeVT.size();
+    const size_t relVN0 = chunk.relativeVN.size();
+    const size_t localV = chunk.positions.size() / 3;
+    const size_t localVT = chunk.texCoords.size() / 2;
+    const size_t localVN = chunk.normals.size() / 3;
+
+    bool ok = true;
+    while (true) {
+        p = skipSpaces(p, end);
+        if (p >= end || *p == '#') break;
+        const size_t corner = chunk.v.size();
+        int vi = 0;
+        if (!parseInt(p, end, vi)) {
+            ok = false;
+            break;
+        }
+        std::int32_t t = MissingIndex;
+        std::int32_t n = MissingIndex;
+        if (p < end && *p == '/') {
+            ++p;
+            if (p < end && *p != '/') {
+                int ti = 0;
+                if (!parseInt(p, end, ti)) {
+                    ok = false;
+                    break;
+                }
+                t = resolveIndex(ti, localVT, chunk.relativeVT, corner);
+                chunk.hasTexCoords = true;
+            }
+            if (p < end && *p == '/') {
+                ++p;
+                int ni = 0;
+                if (!parseInt(p, end, ni)) {
+                    ok = false;
+                    break;
+                }
+                n = resolveIndex(ni, localVN, chunk.relativeVN, corner);
+                chunk.hasNormals = true;
+            }
+        }
+        if (p < end && *p != ' ' && *p != '\t' && *p != '\r') {
+            ok = false;
+            break;
+        }
+        chunk.v.push_back(resolveIndex(vi, localV, chunk.relativeV, corner));
+        chunk.vt.push_back(t);
+        chunk.vn.push_back(n);
+    }
+
+    const size_t cornerCount = chunk.v.size() - corner0;
+    if (!ok || cornerCount < 3) {
+        // 回退这一行已经写入的角点
+        chunk.v.resize(corner0);
+        chunk.vt.resize(corner0);
+        chunk.vn.resize(corner0);
+        chunk.relativeV.resize(relV0);
+        chunk.relativeVT.resize(relVT0);
+        chunk.relativeVN.resize(relVN0);
+        ++chunk.skippedFaces;
+        return;
+    }
+    chunk.faceSizes.push_back(static_cast<std::uint32_t>(cornerCount));
+}
+
+void parseChunk(const char* begin, const char* end, ObjChunk& chunk) {
+    const char* p = begin;
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (!lineEnd) lineEnd = end;
+        const char* q = skipSpaces(p, lineEnd);
+        if (lineEnd - q >= 2) {
+            if (q[0] == 'v') {
+                if (q[1] == ' ' || q[1] == '\t') {
+                    parseFloats(q + 2, lineEnd, 3, chunk.positions);
+                } else if (q[1] == 't' && lineEnd - q >= 3 && (q[2] == ' ' || q[2] == '\t')) {
+                    parseFloats(q + 3, lineEnd, 2, chunk.texCoords);
+                } else if (q[1] == 'n' && lineEnd - q >= 3 && (q[2] == ' ' || q[2] == '\t')) {
+                    parseFloats(q + 3, lineEnd, 3, chunk.normals);
+                }
+            } else if (q[0] == 'f' && (q[1] == ' ' || q[1] == '\t')) {
+                parseFace(q + 2, lineEnd, chunk);
+            }
+        }
+        p = lineEnd + 1;
+    }
+}
+
+/// 检查角点的 vt/vn 索引, 越界或缺失的记为 -1
+inline std::int32_t checkAttributeIndex(std::int32_t index, size_t count) {
+    return (index >= 0 && static_cast<size_t>(index) < count) ? index : -1;
+}
+
+} // namespace
+
+/**
+ * @brief 解析 OBJ 文本
+ *
+ * 1. 按大小切成若干块, 块边界移到下一个换行之后, 保证每行只属于一个块
+ * 2. 各块并行解析到自己的数组
+ * 3. 对各块的元素数求前缀和得到全局偏移, 再并行拷贝到最终数组并修正负索引
+ * 4. 检查索引范围, 含越界顶点索引的面被删除
+ */
+bool parseOBJ(const char* text, size_t size, MeshData& data) {
+    data.clear();
+    if (!text || size == 0) return false;
+
+    // 1. 按换行对齐的分块, 每块至少 1MB
+    const size_t minChunk = size_t(1) << 20;
+    const size_t wanted = std::max<size_t>(1, std::min<size_t>(parallel::hardwareThreads() * 4, size / minChunk));
+    std::vector<const char*> bounds;
+    bounds.push_back(text);
+    for (size_t i = 1; i < wanted; ++i) {
+        const char* p = std::max(text + size * i / wanted, bounds.back());
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', text + size - p));
+        if (!nl) break;
+        bounds.push_back(nl + 1);
+    }
+    bounds.push_back(text + size);
+    const unsigned chunkCount = static_cast<unsigned>(bounds.size() - 1);
+
+    // 2. 并行解析
+    std::vector<ObjChunk> chunks(chunkCount);
+    parallel::runTasks(chunkCount, [&](unsigned c) {
+        parseChunk(bounds[c], bounds[c + 1], chunks[c]);
+    });
+
+    // 3. 前缀和
+    std::vector<size_t> vBase(chunkCount + 1, 0), vtBase(chunkCount + 1, 0), vnBase(chunkCount + 1, 0);
+    std::vector<size_t> faceBase(chunkCount + 1, 0), cornerBase(chunkCount + 1, 0);
+    bool hasTexCoords = false;
+    bool hasNormals = false;
+    size_t skippedFaces = 0;
+    for (unsigned c = 0; c < chunkCount; ++c) {
+        const ObjChunk& chunk = chunks[c];
+        vBase[c + 1] = vBase[c] + chunk.positions.size() / 3;
+        vtBase[c + 1] = vtBase[c] + chunk.texCoords.size() / 2;
+        vnBase[c + 1] = vnBase[c] + chunk.normals.size() / 3;
+        faceBase[c + 1] = faceBase[c] + chunk.faceSizes.size();
+        cornerBase[c + 1] = cornerBase[c] + chunk.v.size();
+        hasTexCoords = hasTexCoords || chunk.hasTexCoords;
+        hasNormals = hasNormals || chunk.hasNormals;
+        skippedFaces += chunk.skippedFaces;
+    }
+    if (skippedFaces > 0) {
+        std::cerr << "Warning: Skipped " << skippedFaces << " malformed or degenerate face record(s)" << std::endl;
+    }
+    if (cornerBase[chunkCount] > std::numeric_limits<std::uint32_t>::max()) {
+        std::cerr << "Error: OBJ has too many face corners" << std::endl;
+        return false;
+    }
+
+    const size_t nV = vBase[chunkCount];
+    const size_t nVT = vtBase[chunkCount];
+    const size_t nVN = vnBase[chunkCount];
+    const size_t nF = faceBase[chunkCount];
+    data.positions.resize(nV * 3);
+    data.texCoords.resize(nVT * 2);
+    data.normals.resize(nVN * 3);
+    data.faceOffsets.resize(nF + 1);
+    data.faceVertices.resize(cornerBase[chunkCount]);
+    if (hasTexCoords) data.faceTexCoords.resize(cornerBase[chunkCount]);
+    if (hasNormals) data.faceNormals.resize(cornerBase[chunkCount]);
+    data.faceOffsets[0] = 0;
+
+    std::vector<size_t> badFaces(chunkCount, 0);
+    parallel::runTasks(chunkCount, [&](unsigned c) {
+        ObjChunk& chunk = chunks[c];
+        std::copy(chunk.positions.begin(), chunk.positions.end(), data.positions.begin() + vBase[c] * 3);
+        std::copy(chunk.texCoords.begin(), chunk.texCoords.end(), data.texCoords.begin() + vtBase[c] * 2);
+        std::copy(chunk.normals.begin(), chunk.normals.end(), data.normals.begin() + vnBase[c] * 3);
+
+        // 负索引补上本块的全局偏移
+        for (std::uint32_t k : chunk.relativeV) chunk.v[k] += static_cast<std::int32_t>(vBase[c]);
+        for (std::uint32_t k : chunk.relativeVT) chunk.vt[k] += static_cast<std::int32_t>(vtBase[c]);
+        for (std::uint32_t k : chunk.relativeVN) chunk.vn[k] += static_cast<std::int32_t>(vnBase[c]);
+
+        const size_t corner0 = cornerBase[c];
+        std::copy(chunk.v.begin(), chunk.v.end(), data.faceVertices.begin() + corner0);
+        for (size_t k = 0; k < chunk.v.size(); ++k) {
+            if (hasTexCoords) data.faceTexCoords[corner0 + k] = checkAttributeIndex(chunk.vt[k], nVT);
+            if (hasNormals) data.faceNormals[corner0 + k] = checkAttributeIndex(chunk.vn[k], nVN);
+        }
+
+        size_t offset = corner0;
+        for (size_t f = 0; f < chunk.faceSizes.size(); ++f) {
+            const size_t begin = offset;
+            offset += chunk.faceSizes[f];
+            data.faceOffsets[faceBase[c] + f + 1] = static_cast<std::uint32_t>(offset);
+            for (size_t k = begin; k < offset; ++k) {
+                const std::int32_t vi = data.faceVertices[k];
+                if (vi < 0 || static_cast<size_t>(vi) >= nV) {
+                    ++badFaces[c];
+                    break;
+                }
+            }
+        }
+        // 释放本块内存, 降低合并时的峰值
+        chunk = ObjChunk();
+    });
+
+    // 4. 删除含越界顶点索引的面(少见, 串行处理)
+    size_t totalBad = 0;
+    for (size_t b : badFaces) totalBad += b;
+    if (totalBad > 0) {
+        std::cerr << "Error: Skipping " << totalBad << " face(s) with invalid vertex indices" << std::endl;
+        size_t write = 0;
+        size_t faceWrite = 0;
+        for (size_t f = 0; f < nF; ++f) {
+            const size_t begin = data.faceOffsets[f];
+            const size_t end = data.faceOffsets[f + 1];
+            bool valid = true;
+            for (size_t k = begin; k < end; ++k) {
+                const std::int32_t vi = data.faceVertices[k];
+                if (vi < 0 || static_cast<size_t>(vi) >= nV) {
+                    valid = false;
+                    break;
+                }
+            }
+            if (!valid) continue;
+            for (size_t k = begin; k < end; ++k, ++write) {
+                data.faceVertices[write] = data.faceVertices[k];
+                if (hasTexCoords) data.faceTexCoords[write] = data.faceTexCoords[k];
+                if (hasNormals) data.faceNormals[write] = data.faceNormals[k];
+            }
+            data.faceOffsets[++faceWrite] = static_cast<std::uint32_t>(write);
+        }
+        data.faceOffsets.resize(faceWrite + 1);
+        data.faceVertices.resize(write);
+        if (hasTexCoords) data.faceTexCoords.resize(write);
+        if (hasNormals) data.faceNormals.resize(write);
+    }
+
+    return !data.isEmpty();
+}
+
+bool readOBJ(const std::string& path, MeshData& data) {
+    MappedFile file(path);
+    if (!file.isOpen()) {
+        data.clear();
+        return false;
+    }
+    const bool ok = parseOBJ(file.data(), file.size(), data);
+    std::cout << "Loaded " << data.getVertexCount() << " vertices and "
+              << data.getFaceCount() << " faces from " << path << std::endl;
+    return ok;
+}
+
+// ============================================================================
+// PLY 读取
+// ============================================================================
+
+namespace {
+
+constexpr bool HostIsBigEndian = std::endian::native == std::endian::big;
+
+enum class PlyType { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64, Invalid };
+
+PlyType parsePlyType(const std::string& name) {
+    if (name == "char" || name == "int8") return PlyType::Int8;
+    if (name == "uchar" || name == "uint8") return PlyType::UInt8;
+    if (name == "short" || name == "int16") return PlyType::Int16;
+    if (name == "ushort" || name == "uint16") return PlyType::UInt16;
+    if (name == "int" || name == "int32") return PlyType::Int32;
+    if (name == "uint" || name == "uint32") return PlyType::UInt32;
+    if (name == "float" || name == "float32") return PlyType::Float32;
+    if (name == "double" || name == "float64") return PlyType::Float64;
+    return PlyType::Invalid;
+}
+
+size_t plyTypeSize(PlyType type) {
+    switch (type) {
+    case PlyType::Int8:
+    case PlyType::UInt8: return 1;
+    case PlyType::Int16:
+    case PlyType::UInt16: return 2;
+    case PlyType::Int32:
+    case PlyType::UInt32:
+    case PlyType::Float32: return 4;
+    case PlyType::Float64: return 8;
+    default: return 0;
+    }
+}
+
+/// 读取一个(可能未对齐的)标量, swap 为 true 时交换字节序
+template <class T>
+inline T loadScalar(const char* p, bool swap) {
+    unsigned char buf[sizeof(T)];
+    std::memcpy(buf, p, sizeof(T));
+    if (swap) std::reverse(buf, buf + sizeof(T));
+    T value;
+    std::memcpy(&value, buf, sizeof(T));
+    return value;
+}
+
+inline double loadPlyValue(const char* p, PlyType type, bool swap) {
+    switch (type) {
+    case PlyType::Int8: return loadScalar<std::int8_t>(p, swap);
+    case PlyType::UInt8: return loadScalar<std::uint8_t>(p, swap);
+    case PlyType::Int16: return loadScalar<std::int16_t>(p, swap);
+    case PlyType::UInt16: return loadScalar<std::uint16_t>(p, swap);
+    case PlyType::Int32: return loadScalar<std::int32_t>(p, swap);
+    case PlyType::UInt32: return loadScalar<std::uint32_t>(p, swap);
+    case PlyType::Float32: return loadScalar<float>(p, swap);
+    case PlyType::Float64: return loadScalar<double>(p, swap);
+    default: return 0.0;
+    }
+}
+
+inline std::int64_t loadPlyInteger(const char* p, PlyType type, bool swap) {
+    switch (type) {
+    case PlyType::Int8: return loadScalar<std::int8_t>(p, swap);
+    case PlyType::UInt8: return loadScalar<std::uint8_t>(p, swap);
+    case PlyType::Int16: return loadScalar<std::int16_t>(p, swap);
+    case PlyType::UInt16: return loadScalar<std::uint16_t>(p, swap);
+    case PlyType::Int32: return loadScalar<std::int32_t>(p, swap);
+    case PlyType::UInt32: return loadScalar<std::uint32_t>(p, swap);
+    default: return static_cast<std::int64_t>(loadPlyValue(p, type, swap));
+    }
+}
+
+struct PlyProperty {
+    std::string name;
+    PlyType type = PlyType::Invalid;
+    bool isList = false;
+    PlyType countType = PlyType::Invalid;
+};
+
+struct PlyElement {
+    std::string name;
+    size_t count = 0;
+    std::vector<PlyProperty> properties;
+
+    /// 所有属性都是定长时的记录字节数, 含列表属性时为 0
+    size_t fixedSize() const {
+        size_t bytes = 0;
+        for (const auto& prop : properties) {
+            if (prop.isList) return 0;
+            bytes += plyTypeSize(prop.type);
+        }
+        return bytes;
+    }
+    /// 一条记录至少占用的字节数: 列表属性只计长度字段(列表可以为空)
+    size_t minRecordSize() const {
+        size_t bytes = 0;
+        for (const auto& prop : properties) {
+            bytes += plyTypeSize(prop.isList ? prop.countType : prop.type);
+        }
+        return bytes;
+    }
+    /**
+     * @brief 头部声明的记录数能否放进 [p, end)
+     * 用除法比较, 伪造的巨大 count 不会因乘法溢出而通过检查; 分配内存前必须先检查
+     */
+    bool fitsIn(const char* p, const char* end) const {
+        const size_t record = minRecordSize();
+        return record == 0 || count <= static_cast<size_t>(end - p) / record;
+    }
+    int find(std::initializer_list<const char*> names) const {
+        for (const char* name : names) {
+            for (size_t k = 0; k < properties.size(); ++k) {
+                if (properties[k].name == name) return static_cast<int>(k);
+            }
+        }
+        return -1;
+    }
+    /// 定长记录中第 k 个属性的字节偏移
+    size_t offsetOf(int k) const {
+        size_t bytes = 0;
+        for (int i = 0; i < k; ++i) bytes += plyTypeSize(properties[i].type);
+        return bytes;
+    }
+};
+
+/**
+ * @brief 解析 PLY 头部, 返回数据区的起始偏移, 失败返回 0
+ */
+size_t parsePlyHeader(const char* bytes, size_t size, std::vector<PlyElement>& elements, bool& bigEndian) {
+    const char* end = bytes + size;
+    const char* p = bytes;
+    bool formatFound = false;
+    bool first = true;
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (!lineEnd) break;
+        std::istringstream line(std::string(p, lineEnd));
+        p = lineEnd + 1;
+        std::string keyword;
+        line >> keyword;
+        if (first) {
+            if (keyword != "ply") {
+                std::cerr << "Error: Not a PLY file" << std::endl;
+                return 0;
+            }
+            first = false;
+        } else if (keyword == "format") {
+            std::string format;
+            line >> format;
+            if (format == "binary_little_endian") {
+                bigEndian = false;
+            } else if (format == "binary_big_endian") {
+                bigEndian = true;
+            } else {
+                std::cerr << "Error: Unsupported PLY format '" << format << "' (only binary is supported)" << std::endl;
+                return 0;
+            }
+            formatFound = true;
+        } else if (keyword == "element") {
+            PlyElement element;
+            line >> element.name >> element.count;
+            elements.push_back(std::move(element));
+        } else if (keyword == "property") {
+            if (elements.empty()) {
+                std::cerr << "Error: PLY property declared before any element" << std::endl;
+                return 0;
+            }
+            PlyProperty prop;
+            std::string type;
+            line >> type;
+            if (type == "list") {
+                std::string countType, itemType;
+                line >> countType >> itemType >> prop.name;
+                prop.isList = true;
+                prop.countType = parsePlyType(countType);
+                prop.type = parsePlyType(itemType);
+                if (prop.countType == PlyType::Invalid) {
+                    std::cerr << "Error: Invalid PLY list count type '" << countType << "'" << std::endl;
+                    return 0;
+                }
+            } else {
+                line >> prop.name;
+                prop.type = parsePlyType(type);
+            }
+            if (prop.type == PlyType::Invalid) {
+                std::cerr << "Error: Invalid PLY property type '" << type << "'" << std::endl;
+                return 0;
+            }
+            elements.back().properties.push_back(std::move(prop));
+        } else if (keyword == "end_header") {
+            if (!formatFound) {
+                std::cerr << "Error: PLY header has no format line" << std::endl;
+                return 0;
+            }
+            return static_cast<size_t>(p - bytes);
+        }
+        // comment / obj_info 等忽略
+    }
+    std::cerr << "Error: PLY header is not terminated by end_header" << std::endl;
+    return 0;
+}
+
+/**
+ * @brief 遍历一条记录的所有属性, 对每个属性调用 f(k, 数据指针, 元素个数)
+ * 标量属性的元素个数为 1。返回记录结束的位置, 数据不完整时返回 nullptr
+ */
+template <class F>
+const char* walkPlyRecord(const char* p, const char* end, const PlyElement& element, bool swap, F&& f) {
+    for (size_t k = 0; k < element.properties.size(); ++k) {
+        const PlyProperty& prop = element.properties[k];
+        size_t count = 1;
+        if (prop.isList) {
+            const size_t countSize = plyTypeSize(prop.countType);
+            if (p + countSize > end) return nullptr;
+            const std::int64_t n = loadPlyInteger(p, prop.countType, swap);
+            if (n < 0) return nullptr;
+            count = static_cast<size_t>(n);
+            p += countSize;
+        }
+        const size_t bytes = count * plyTypeSize(prop.type);
+        if (static_cast<size_t>(end - p) < bytes) return nullptr;
+        f(k, p, count);
+        p += bytes;
+    }
+    return p;
+}
+
+/**
+ * @brief 读取顶点元素中的 components 个属性到 out(每条记录 components 个 float)
+ * 定长记录时并行提取, 记录正好以本机字节序的连续 float 开头时直接拷贝
+ */
+bool readPlyAttributes(const char* base, const char* end, const PlyElement& element, bool swap,
+                       const int* props, int components, std::vector<float>& out) {
+    if (!element.fitsIn(base, end)) return false;
+    const size_t n = element.count;
+    out.resize(n * components);
+    const size_t stride = element.fixedSize();
+    if (stride > 0) {
+        size_t offsets[3];
+        bool contiguousFloats = !swap;
+        for (int c = 0; c < components; ++c) {
+            offsets[c] = element.offsetOf(props[c]);
+            contiguousFloats = contiguousFloats && element.properties[props[c]].type == PlyType::Float32 &&
+                               offsets[c] == offsets[0] + c * sizeof(float);
+        }
+        if (contiguousFloats && stride == components * sizeof(float)) {
+            std::memcpy(out.data(), base, n * stride); // 零拷贝布局: 整块复制
+            return true;
+        }
+        parallel::parallelFor(0, n, [&](size_t i) {
+            const char* record = base + i * stride;
+            if (contiguousFloats) {
+                std::memcpy(&out[i * components], record + offsets[0], components * sizeof(float));
+                return;
+            }
+            for (int c = 0; c < components; ++c) {
+                out[i * components + c] = static_cast<float>(
+                    loadPlyValue(record + offsets[c], element.properties[props[c]].type, swap));
+            }
+        });
+        return true;
+    }
+    // 含列表属性的顶点记录(少见): 顺序遍历
+    const char* p = base;
+    for (size_t i = 0; i < n; ++i) {
+        p = walkPlyRecord(p, end, element, swap, [&](size_t k, const char* data, size_t) {
+            for (int c = 0; c < components; ++c) {
+                if (props[c] == static_cast<int>(k)) {
+                    out[i * components + c] = static_cast<float>(loadPlyValue(data, element.properties[k].type, swap));
+                }
+            }
+        });
+        if (!p) return false;
+    }
+    return true;
+}
+
+/// 元素数据的结束位置, 数据不完整时返回 nullptr
+const char* skipPlyElement(const char* p, const char* end, const PlyElement& element, bool swap) {
+    const size_t stride = element.fixedSize();
+    if (stride > 0 || element.properties.empty()) {
+        if (!element.fitsIn(p, end)) return nullptr;
+        return p + element.count * stride;
+    }
+    for (size_t i = 0; i < element.count && p; ++i) {
+        p = walkPlyRecord(p, end, element, swap, [](size_t, const char*, size_t) {});
+    }
+    return p;
+}
+
+} // namespace
+
+bool parsePLY(const char* bytes, size_t size, MeshData& data) {
+    data.clear();
+    if (!bytes || size == 0) return false;
+
+    std::vector<PlyElement> elements;
+    bool bigEndian = false;
+    const size_t dataOffset = parsePlyHeader(bytes, size, elements, bigEndian);
+    if (dataOffset == 0) return false;
+    const bool swap = bigEndian != HostIsBigEndian;
+
+    const char* end = bytes + size;
+    const char* p = bytes + dataOffset;
+    size_t skippedFaces = 0;
+    bool hasVertices = false;
+    for (const PlyElement& element : elements) {
+        // 先按剩余字节数检查头部声明的记录数, 再按记录数分配内存
+        if (!element.fitsIn(p, end)) {
+            std::cerr << "Error: PLY element '" << element.name << "' declares " << element.count
+                      << " records, more than the remaining " << (end - p) << " bytes can hold" << std::endl;
+            data.clear();
+            return false;
+        }
+        if (element.name == "vertex") {
+            const int xyz[3] = { element.find({ "x" }), element.find({ "y" }), element.find({ "z" }) };
+            if (xyz[0] < 0 || xyz[1] < 0 || xyz[2] < 0) {
+                std::cerr << "Error: PLY vertex element has no x/y/z properties" << std::endl;
+                return false;
+            }
+            if (!readPlyAttributes(p, end, element, swap, xyz, 3, data.positions)) {
+                p = nullptr;
+                break;
+            }
+            const int normal[3] = { element.find({ "nx" }), element.find({ "ny" }), element.find({ "nz" }) };
+            if (normal[0] >= 0 && normal[1] >= 0 && normal[2] >= 0) {
+                if (!readPlyAttributes(p, end, element, swap, normal, 3, data.normals)) {
+                    p = nullptr;
+                    break;
+                }
+            }
+            const int uv[2] = { element.find({ "u", "s", "texture_u", "texture_s" }),
+                                element.find({ "v", "t", "texture_v", "texture_t" }) };
+            if (uv[0] >= 0 && uv[1] >= 0) {
+                if (!readPlyAttributes(p, end, element, swap, uv, 2, data.texCoords)) {
+                    p = nullptr;
+                    break;
+                }
+            }
+            hasVertices = true;
+        } else if (element.name == "face") {
+            const int indexProp = element.find({ "vertex_indices", "vertex_index" });
+            if (indexProp < 0 || !element.properties[indexProp].isList) {
+                std::cerr << "Error: PLY face element has no vertex_indices list" << std::endl;
+                return false;
+            }
+            if (!hasVertices) {
+                std::cerr << "Error: PLY face element appears before vertex element" << std::endl;
+                return false;
+            }
+            const size_t nV = data.getVertexCount();
+            const PlyType indexType = element.properties[indexProp].type;
+            const size_t indexSize = plyTypeSize(indexType);
+            data.faceOffsets.reserve(element.count + 1);
+            data.faceVertices.reserve(element.count * 3);
+            data.faceOffsets.push_back(0);
+            const char* q = p;
+            for (size_t f = 0; f < element.count && q; ++f) {
+                q = walkPlyRecord(q, end, element, swap, [&](size_t k, const char* items, size_t count) {
+                    if (static_cast<int>(k) != indexProp) return;
+                    const size_t corner0 = data.faceVertices.size();
+                    bool valid = count >= 3;
+                    for (size_t c = 0; c < count && valid; ++c) {
+                        const std::int64_t vi = loadPlyInteger(items + c * indexSize, indexType, swap);
+                        valid = vi >= 0 && static_cast<size_t>(vi) < nV;
+                        data.faceVertices.push_back(static_cast<std::int32_t>(vi));
+                    }
+                    if (!valid) {
+                        data.faceVertices.resize(corner0);
+                        ++skippedFaces;
+                        return;
+                    }
+                    data.faceOffsets.push_back(static_cast<std::uint32_t>(data.faceVertices.size()));
+                });
+            }
+            if (!q) {
+                std::cerr << "Error: PLY face data is truncated" << std::endl;
+                data.clear();
+                return false;
+            }
+            p = q;
+            continue;
+        }
+        p = skipPlyElement(p, end, element, swap);
+        if (!p) break;
+    }
+    if (!p) {
+        std::cerr << "Error: PLY data is truncated" << std::endl;
+        data.clear();
+        return false;
+    }
+    if (skippedFaces > 0) {
+        std::cerr << "Error: Skipping " << skippedFaces << " face(s) with invalid vertex indices" << std::endl;
+    }
+    // 逐顶点属性: 角点的 vt/vn 索引就是顶点索引
+    if (!data.normals.empty()) data.faceNormals = data.faceVertices;
+    if (!data.texCoords.empty()) data.faceTexCoords = data.faceVertices;
+    return !data.isEmpty();
+}
+
+bool readPLY(const std::string& path, MeshData& data) {
+    MappedFile file(path);
+    if (!file.isOpen()) {
+        data.clear();
+        return false;
+    }
+    const bool ok = parsePLY(file.data(), file.size(), data);
+    std::cout << "Loaded " << data.getVertexCount() << " vertices and "
+              << data.getFaceCount() << " faces from " << path << std::endl;
+    return ok;
+}
+
+// ============================================================================
+// PLY 流式访问
+// ============================================================================
+
+bool PlyTriangleStream::open(const std::string& path) {
+    close();
+    if (!file.open(path)) return false;
+
+    std::vector<PlyElement> elements;
+    bool bigEndian = false;
+    const size_t dataOffset = parsePlyHeader(file.data(), file.size(), elements, bigEndian);
+    if (dataOffset == 0) {
+        close();
+        return false;
+    }
+    swap = bigEndian != HostIsBigEndian;
+
+    // 所有元素都必须是定长记录(面元素按三角形计算), 这样每条记录的位置可以直接算出
+    size_t offset = dataOffset;
+    for (const PlyElement& element : elements) {
+        size_t stride = element.fixedSize();
+        if (element.name == "vertex") {
+            const int xyz[3] = { element.find({ "x" }), element.find({ "y" }), element.find({ "z" }) };
+            if (stride == 0 || xyz[0] < 0 || xyz[1] < 0 || xyz[2] < 0) {
+                std::cerr << "Error: PLY vertex records must be fixed-size with x/y/z for streaming" << std::endl;
+                close();
+                return false;
+            }
+            vertexCount = element.count;
+            vertexData = file.data() + offset;
+            vertexStride = stride;
+            for (int c = 0; c < 3; ++c) {
+                positionOffset[c] = element.offsetOf(xyz[c]);
+                positionType[c] = static_cast<int>(element.properties[xyz[c]].type);
+            }
+        } else if (element.name == "face") {
+            const int list = element.find({ "vertex_indices", "vertex_index" });
+            stride = 0;
+            for (size_t k = 0; k < element.properties.size(); ++k) {
+                const PlyProperty& prop = element.properties[k];
+                if (static_cast<int>(k) == list) {
+                    indexOffset = stride + plyTypeSize(prop.countType);
+                    stride = indexOffset + 3 * plyTypeSize(prop.type);
+                } else if (prop.isList) {
+                    stride = 0;
+                    break;
+                } else {
+                    stride += plyTypeSize(prop.type);
+                }
+            }
+            if (list < 0 || stride == 0) {
+                std::cerr << "Error: PLY face records must hold only the vertex_indices list for streaming" << std::endl;
+                close();
+                return false;
+            }
+            faceCount = element.count;
+            faceData = file.data() + offset;
+            faceStride = stride;
+            indexType = static_cast<int>(element.properties[list].type);
+
+            // 检查每条记录的计数都是 3(顺序读一遍计数字段)
+            const PlyType countType = element.properties[list].countType;
+            const size_t countOffset = indexOffset - plyTypeSize(countType);
+            // 用除法比较: 伪造的记录数与记录长度相乘可能溢出成一个小值而通过检查
+            if (faceCount > (file.size() - offset) / faceStride) {
+                std::cerr << "Error: PLY data is truncated" << std::endl;
+                close();
+                return false;
+            }
+            for (size_t f = 0; f < faceCount; ++f) {
+                if (loadPlyInteger(faceData + f * faceStride + countOffset, countType, swap) != 3) {
+                    std::cerr << "Error: PLY face " << f << " is not a triangle, streaming needs a triangle mesh" << std::endl;
+                    close();
+                    return false;
+                }
+            }
+        } else if (stride == 0 && !element.properties.empty()) {
+            std::cerr << "Error: PLY element '" << element.name << "' has variable-size records" << std::endl;
+            close();
+            return false;
+        }
+        if (stride > 0 && element.count > (file.size() - offset) / stride) {
+            std::cerr << "Error: PLY data is truncated" << std::endl;
+            close();
+            return false;
+        }
+        offset += element.count * stride;
+    }
+    if (vertexStride == 0 || faceStride == 0) {
+        std::cerr << "Error: PLY file has no vertex or face element" << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void PlyTriangleStream::close() {
+    file.close();
+    vertexCount = faceCount = 0;
+    vertexData = faceData = nullptr;
+    vertexStride = faceStride = 0;
+}
+
+Eigen::Vector3f PlyTriangleStream::position(size_t v) const {
+    const char* record = vertexData + v * vertexStride;
+    Eigen::Vector3f p;
+    for (int c = 0; c < 3; ++c) {
+        p[c] = static_cast<float>(loadPlyValue(record + positionOffset[c], static_cast<PlyType>(positionType[c]), swap));
+    }
+    return p;
+}
+
+void PlyTriangleStream::triangle(size_t f, std::uint32_t vertices[3]) const {
+    const char* items = faceData + f * faceStride + indexOffset;
+    const PlyType type = static_cast<PlyType>(indexType);
+    const size_t size = plyTypeSize(type);
+    for (int k = 0; k < 3; ++k) {
+        vertices[k] = static_cast<std::uint32_t>(loadPlyInteger(items + k * size, type, swap));
+    }
+}
+
+// ============================================================================
+// STL 读取与顶点焊接
+// ============================================================================
+
+namespace {
+
+inline std::uint64_t mixBits(std::uint64_t x) {
+    // splitmix64 的终结函数, 让相邻格子的哈希均匀分布
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+/// 解析 ASCII STL 中 "facet normal" 与 "vertex" 行
+bool parseAsciiSTL(const char* text, size_t size, std::vector<float>& corners, std::vector<float>& facetNormals) {
+    const char* end = text + size;
+    const char* p = text;
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (!lineEnd) lineEnd = end;
+        const char* q = skipSpaces(p, lineEnd);
+        if (lineEnd - q > 6 && std::memcmp(q, "vertex", 6) == 0) {
+            parseFloats(q + 6, lineEnd, 3, corners);
+        } else if (lineEnd - q > 12 && std::memcmp(q, "facet normal", 12) == 0) {
+            parseFloats(q + 12, lineEnd, 3, facetNormals);
+        }
+        p = lineEnd + 1;
+    }
+    if (corners.size() % 9 != 0) {
+        std::cerr << "Error: ASCII STL has an incomplete facet" << std::endl;
+        return false;
+    }
+    facetNormals.resize(corners.size() / 3, 0.0f);
+    return true;
+}
+
+} // namespace
+
+void weldVertices(const std::vector<float>& cornerPositions, float tolerance,
+                  std::vector<float>& positions, std::vector<std::int32_t>& cornerVertex) {
+    const size_t n = cornerPositions.size() / 3;
+    positions.clear();
+    cornerVertex.assign(n, -1);
+    if (n == 0) return;
+
+    // 1. 每个角点的格子坐标与哈希
+    struct Cell {
+        std::int64_t x, y, z;
+        bool operator==(const Cell& other) const { return x == other.x && y == other.y && z == other.z; }
+    };
+    struct WeldKey {
+        std::uint64_t hash;
+        std::int32_t corner;
+    };
+    std::vector<Cell> cells(n);
+    std::vector<WeldKey> keys(n);
+    const double inverse = tolerance > 0 ? 1.0 / tolerance : 0.0;
+    parallel::parallelFor(0, n, [&](size_t c) {
+        std::int64_t q[3];
+        for (int k = 0; k < 3; ++k) {
+            float value = cornerPositions[3 * c + k];
+            if (tolerance > 0) {
+                q[k] = static_cast<std::int64_t>(std::llround(value * inverse));
+            } else {
+                if (value == 0.0f) value = 0.0f; // -0 与 +0 视为同一点
+                std::uint32_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                q[k] = bits;
+            }
+        }
+        cells[c] = { q[0], q[1], q[2] };
+        const std::uint64_t h = mixBits(static_cast<std::uint64_t>(q[0]) ^
+                                        mixBits(static_cast<std::uint64_t>(q[1]) ^
+                                                mixBits(static_cast<std::uint64_t>(q[2]))));
+        keys[c] = { h, static_cast<std::int32_t>(c) };
+    });
+
+    // 2. 按哈希排序(稳定, 同组内角点保持原顺序)
+    parallel::parallelRadixSort(keys, 64, [](const WeldKey& k) { return k.hash; });
+
+    // 3. 组内找代表角点: 第一个格子相同的角点(也是下标最小的)
+    std::vector<std::int32_t> representative(n);
+    const unsigned tasks = std::max(1u, parallel::chunkCount(n, 1 << 16));
+    parallel::runTasks(tasks, [&](unsigned t) {
+        size_t begin = n * t / tasks;
+        size_t end = n * (t + 1) / tasks;
+        // 任务边界移到哈希组的边界上
+        while (begin > 0 && begin < n && keys[begin].hash == keys[begin - 1].hash) ++begin;
+        while (end < n && end > 0 && keys[end].hash == keys[end - 1].hash) ++end;
+        size_t groupStart = begin;
+        for (size_t i = begin; i < end; ++i) {
+            if (keys[i].hash != keys[groupStart].hash) groupStart = i;
+            const std::int32_t c = keys[i].corner;
+            std::int32_t rep = c;
+            for (size_t j = groupStart; j < i; ++j) {
+                if (cells[keys[j].corner] == cells[c]) {
+                    rep = representative[keys[j].corner];
+                    break;
+                }
+            }
+            representative[c] = rep;
+        }
+    });
+
+    // 4. 按代表角点第一次出现的顺序编号
+    for (size_t c = 0; c < n; ++c) {
+        const std::int32_t rep = representative[c];
+        if (rep == static_cast<std::int32_t>(c)) {
+            cornerVertex[c] = static_cast<std::int32_t>(positions.size() / 3);
+            positions.insert(positions.end(), cornerPositions.begin() + 3 * c, cornerPositions.begin() + 3 * c + 3);
+        } else {
+            cornerVertex[c] = cornerVertex[rep];
+        }
+    }
+}
+
+bool parseSTL(const char* bytes, size_t size, MeshData& data, float weldTolerance) {
+    data.clear();
+    if (!bytes || size == 0) return false;
+
+    std::vector<float> corners;
+    std::vector<float> facetNormals;
+    bool binary = false;
+    size_t triangleCount = 0;
+    if (size >= 84) {
+        triangleCount = loadScalar<std::uint32_t>(bytes + 80, HostIsBigEndian);
+        binary = 84 + 50 * static_cast<std::uint64_t>(triangleCount) == size;
+    }
+    if (binary) {
+        // 每个三角形 50 字节: 法向 3 float, 三个顶点 9 float, 2 字节属性, 均为小端
+        corners.resize(triangleCount * 9);
+        facetNormals.resize(triangleCount * 3);
+        parallel::parallelFor(0, triangleCount, [&](size_t f) {
+            const char* record = bytes + 84 + 50 * f;
+            if (!HostIsBigEndian) {
+                std::memcpy(&facetNormals[3 * f], record, 12);
+                std::memcpy(&corners[9 * f], record + 12, 36);
+                return;
+            }
+            for (int k = 0; k < 3; ++k) facetNormals[3 * f + k] = loadScalar<float>(record + 4 * k, true);
+            for (int k = 0; k < 9; ++k) corners[9 * f + k] = loadScalar<float>(record + 12 + 4 * k, true);
+        });
+    } else if (size >= 5 && std::memcmp(bytes, "solid", 5) == 0) {
+        if (!parseAsciiSTL(bytes, size, corners, facetNormals)) return false;
+        triangleCount = corners.size() / 9;
+    } else {
+        std::cerr << "Error: Unrecognized STL file (size does not match the triangle count)" << std::endl;
+        return false;
+    }
+
+    std::vector<std::int32_t> cornerVertex;
+    weldVertices(corners, weldTolerance, data.positions, cornerVertex);
+
+    // 焊接后有重复顶点的三角形是退化的, 删除
+    data.normals = std::move(facetNormals);
+    data.faceOffsets.reserve(triangleCount + 1);
+    data.faceVertices.reserve(triangleCount * 3);
+    data.faceNormals.reserve(triangleCount * 3);
+    data.faceOffsets.push_back(0);
+    size_t degenerate = 0;
+    for (size_t f = 0; f < triangleCount; ++f) {
+        const std::int32_t a = cornerVertex[3 * f], b = cornerVertex[3 * f + 1], c = cornerVertex[3 * f + 2];
+        if (a == b || b == c || a == c) {
+            ++degenerate;
+            continue;
+        }
+        data.faceVertices.insert(data.faceVertices.end(), { a, b, c });
+        data.faceNormals.insert(data.faceNormals.end(), 3, static_cast<std::int32_t>(f));
+        data.faceOffsets.push_back(static_cast<std::uint32_t>(data.faceVertices.size()));
+    }
+    if (degenerate > 0) {
+        std::cerr << "Warning: Removed " << degenerate << " degenerate triangle(s) after welding" << std::endl;
+    }
+    std::cout << "STL welding: " << triangleCount * 3 << " corners -> "
+              << data.getVertexCount() << " vertices" << std::endl;
+    return !data.isEmpty();
+}
+
+bool readSTL(const std::string& path, MeshData& data, float weldTolerance) {
+    MappedFile file(path);
+    if (!file.isOpen()) {
+        data.clear();
+        return false;
+    }
+    const bool ok = parseSTL(file.data(), file.size(), data, weldTolerance);
+    std::cout << "Loaded " << data.getVertexCount() << " vertices and "
+              << data.getFaceCount() << " faces from " << path << std::endl;
+    return ok;
+}
+
+namespace {
+
+/// 小写的扩展名(不含点)
+std::string fileExtension(const std::string& path) {
+    const size_t dot = path.find_last_of('.');
+    std::string ext = dot == std::string::npos ? std::string() : path.substr(dot + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return ext;
+}
+
+} // namespace
+
+bool readMesh(const std::string& path, MeshData& data) {
+    const std::string ext = fileExtension(path);
+    if (ext == "obj") return readOBJ(path, data);
+    if (ext == "ply") return readPLY(path, data);
+    if (ext == "stl") return readSTL(path, data);
+    if (ext == "gpmc") return readCompressedMesh(path, data);
+    std::cerr << "Error: Unsupported mesh file extension '" << ext << "'" << std::endl;
+    data.clear();
+    return false;
+}
+
+// ============================================================================
+// 导出与写出
+// ============================================================================
+
+void exportMeshData(const HalfEdgeMesh& mesh, MeshData& data, bool withNormals) {
+    data.clear();
+
+    // 未删除的顶点按原顺序重新编号
+    std::vector<std::int32_t> vertexId(mesh.vertices.size(), -1);
+    std::vector<size_t> sourceVertex;
+    sourceVertex.reserve(mesh.vertices.size());
+    for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+        if (mesh.vertices[i]->deleted) continue;
+        vertexId[i] = static_cast<std::int32_t>(sourceVertex.size());
+        sourceVertex.push_back(i);
+    }
+    const size_t nV = sourceVertex.size();
+    const auto* texCoords = mesh.getVertexProperty<Eigen::Vector2d>("v:texcoord");
+    const auto* quality = mesh.getVertexProperty<double>("v:quality");
+    data.positions.resize(3 * nV);
+    if (withNormals) data.normals.resize(3 * nV);
+    if (texCoords) data.texCoords.resize(2 * nV);
+    if (quality) data.quality.resize(nV);
+    parallel::parallelFor(0, nV, [&](size_t v) {
+        const Vertex* vertex = mesh.vertices[sourceVertex[v]].get();
+        for (int k = 0; k < 3; ++k) data.positions[3 * v + k] = static_cast<float>(vertex->position[k]);
+        if (withNormals) {
+            for (int k = 0; k < 3; ++k) data.normals[3 * v + k] = static_cast<float>(vertex->normal[k]);
+        }
+        if (texCoords) {
+            const Eigen::Vector2d& uv = (*texCoords)[vertex->index];
+            data.texCoords[2 * v] = static_cast<float>(uv.x());
+            data.texCoords[2 * v + 1] = static_cast<float>(uv.y());
+        }
+        if (quality) data.quality[v] = static_cast<float>((*quality)[vertex->index]);
+    });
+
+    // 面: 先并行统计角点数, 前缀和后并行填入
+    std::vector<size_t> sourceFace;
+    sourceFace.reserve(mesh.faces.size());
+    for (size_t f = 0; f < mesh.faces.size(); ++f) {
+        if (!mesh.faces[f]->deleted && mesh.faces[f]->halfEdge) sourceFace.push_back(f);
+    }
+    const size_t nF = sourceFace.size();
+    std::vector<std::uint32_t> cornerCount(nF);
+    parallel::parallelFor(0, nF, [&](size_t f) {
+        cornerCount[f] = static_cast<std::uint32_t>(mesh.faces[sourceFace[f]]->getVertexCount());
+    });
+    data.faceOffsets.resize(nF + 1);
+    data.faceOffsets[0] = 0;
+    for (size_t f = 0; f < nF; ++f) data.faceOffsets[f + 1] = data.faceOffsets[f] + cornerCount[f];
+    data.faceVertices.resize(data.faceOffsets[nF]);
+    parallel::parallelFor(0, nF, [&](size_t f) {
+        const HalfEdge* start = mesh.faces[sourceFace[f]]->halfEdge;
+        const HalfEdge* he = start;
+        std::uint32_t c = data.faceOffsets[f];
+        do {
+            data.faceVertices[c++] = vertexId[he->vertex->index];
+            he = he->next;
+        } while (he && he != start && c < data.faceOffsets[f + 1]);
+    });
+    if (withNormals) data.faceNormals = data.faceVertices;
+    if (texCoords) data.faceTexCoords = data.faceVertices;
+}
+
+namespace {
+
+constexpr size_t MaxFloatChars = 24; ///< std::to_chars(float) 最短表示的长度上界(含余量)
+constexpr size_t MaxIndexChars = 12; ///< int32 十进制的最大长度
+
+inline char* writeFloat(char* p, float value) {
+    return std::to_chars(p, p + MaxFloatChars, value).ptr;
+}
+
+inline char* writeIndex(char* p, std::int32_t value) {
+    return std::to_chars(p, p + MaxIndexChars, value).ptr;
+}
+
+/**
+ * @brief 把 [0, count) 的记录分块并行格式化, 按顺序追加到 out
+ * bound(b, e) 给出 [b, e) 输出字节数的上界, format(i, p) 写出第 i 条记录并返回结束位置。
+ * 每块先写入按上界预分配的缓冲, 再按前缀和并行拷贝到 out 中的对应位置。
+ */
+template <class Bound, class Format>
+void formatParallel(size_t count, std::vector<char>& out, Bound bound, Format format) {
+    if (count == 0) return;
+    const unsigned tasks = std::max(1u, parallel::chunkCount(count, 1 << 14));
+    std::vector<std::vector<char>> chunks(tasks);
+    std::vector<size_t> offsets(tasks + 1, 0);
+    parallel::runTasks(tasks, [&](unsigned t) {
+        const size_t b = count * t / tasks;
+        const size_t e = count * (t + 1) / tasks;
+        chunks[t].resize(bound(b, e));
+        char* p = chunks[t].data();
+        for (size_t i = b; i < e; ++i) p = format(i, p);
+        offsets[t + 1] = static_cast<size_t>(p - chunks[t].data());
+    });
+    offsets[0] = out.size();
+    for (unsigned t = 0; t < tasks; ++t) offsets[t + 1] += offsets[t];
+    out.resize(offsets[tasks]);
+    parallel::runTasks(tasks, [&](unsigned t) {
+        std::memcpy(out.data() + offsets[t], chunks[t].data(), offsets[t + 1] - offsets[t]);
+        std::vector<char>().swap(chunks[t]);
+    });
+}
+
+/// 整块缓冲一次写入文件(关闭 stdio 缓冲, 不再分段拷贝)
+bool writeBuffer(const std::string& path, const std::vector<char>& buffer) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Error: Failed to create file " << path << std::endl;
+        return false;
+    }
+    std::setvbuf(file, nullptr, _IONBF, 0);
+    bool ok = buffer.empty() || std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Error: Failed to write file " << path << std::endl;
+    }
+    return ok;
+}
+
+/// 属性是否是逐顶点的(个数等于顶点数, 且角点索引等于顶点索引或没有角点索引)
+bool isPerVertex(const MeshData& data, const std::vector<float>& values, size_t components,
+                 const std::vector<std::int32_t>& cornerIndices) {
+    return !values.empty() && values.size() == components * data.getVertexCount() &&
+           (cornerIndices.empty() || cornerIndices == data.faceVertices);
+}
+
+} // namespace
+
+bool writeOBJ(const std::string& path, const MeshData& data) {
+    if (data.isEmpty()) {
+        std::cerr << "Error: Nothing to write to " << path << std::endl;
+        return false;
+    }
+    const bool hasVT = !data.faceTexCoords.empty() && !data.texCoords.empty();
+    const bool hasVN = !data.faceNormals.empty() && !data.normals.empty();
+
+    std::vector<char> buffer;
+    const std::string header = "# " + std::to_string(data.getVertexCount()) + " vertices, " +
+                               std::to_string(data.getFaceCount()) + " faces\n";
+    buffer.insert(buffer.end(), header.begin(), header.end());
+
+    auto writeVectors = [&](const std::vector<float>& values, size_t components, const char* tag) {
+        const size_t tagLength = std::strlen(tag);
+        formatParallel(
+            values.size() / components, buffer,
+            [&](size_t b, size_t e) { return (e - b) * (tagLength + components * (MaxFloatChars + 1) + 1); },
+            [&](size_t i, char* p) {
+                std::memcpy(p, tag, tagLength);
+                p += tagLength;
+                for (size_t k = 0; k < components; ++k) {
+                    *p++ = ' ';
+                    p = writeFloat(p, values[components * i + k]);
+                }
+                *p++ = '\n';
+                return p;
+            });
+    };
+    writeVectors(data.positions, 3, "v");
+    if (hasVT) writeVectors(data.texCoords, 2, "vt");
+    if (hasVN) writeVectors(data.normals, 3, "vn");
+
+    // f v/vt/vn, 索引从 1 开始; 缺少的 vt/vn 按 OBJ 语法省略
+    constexpr size_t cornerBound = 3 * (MaxIndexChars + 1) + 1;
+    formatParallel(
+        data.getFaceCount(), buffer,
+        [&](size_t b, size_t e) { return (data.faceOffsets[e] - data.faceOffsets[b]) * cornerBound + (e - b) * 3; },
+        [&](size_t f, char* p) {
+            *p++ = 'f';
+            for (std::uint32_t c = data.faceOffsets[f]; c < data.faceOffsets[f + 1]; ++c) {
+                *p++ = ' ';
+                p = writeIndex(p, data.faceVertices[c] + 1);
+                const bool vt = hasVT && data.faceTexCoords[c] >= 0;
+                const bool vn = hasVN && data.faceNormals[c] >= 0;
+                if (vt || vn) *p++ = '/';
+                if (vt) p = writeIndex(p, data.faceTexCoords[c] + 1);
+                if (vn) {
+                    *p++ = '/';
+                    p = writeIndex(p, data.faceNormals[c] + 1);
+                }
+            }
+            *p++ = '\n';
+            return p;
+        });
+
+    if (!writeBuffer(path, buffer)) return false;
+    std::cout << "Wrote " << data.getVertexCount() << " vertices and " << data.getFaceCount()
+              << " faces to " << path << " (" << buffer.size() << " bytes)" << std::endl;
+    return true;
+}
+
+bool writePLY(const std::string& path, const MeshData& data) {
+    if (data.isEmpty()) {
+        std::cerr << "Error: Nothing to write to " << path << std::endl;
+        return false;
+    }
+    const size_t nV = data.getVertexCount();
+    const size_t nF = data.getFaceCount();
+    const bool hasNormals = isPerVertex(data, data.normals, 3, data.faceNormals);
+    const bool hasTexCoords = isPerVertex(data, data.texCoords, 2, data.faceTexCoords);
+    if ((!data.normals.empty() && !hasNormals) || (!data.texCoords.empty() && !hasTexCoords)) {
+        std::cerr << "Warning: PLY stores per-vertex attributes only, per-corner normals/texcoords are not written" << std::endl;
+    }
+    const bool hasQuality = data.quality.size() == nV;
+    std::uint32_t maxCorners = 0;
+    for (size_t f = 0; f < nF; ++f) maxCorners = std::max(maxCorners, data.faceOffsets[f + 1] - data.faceOffsets[f]);
+    const bool byteCount = maxCorners <= 255;
+
+    std::string header = "ply\nformat ";
+    header += HostIsBigEndian ? "binary_big_endian" : "binary_little_endian";
+    header += " 1.0\nelement vertex " + std::to_string(nV) + "\nproperty float x\nproperty float y\nproperty float z\n";
+    if (hasNormals) header += "property float nx\nproperty float ny\nproperty float nz\n";
+    if (hasTexCoords) header += "property float u\nproperty float v\n";
+    if (hasQuality) header += "property float quality\n";
+    header += "element face " + std::to_string(nF) + "\nproperty list ";
+    header += byteCount ? "uchar" : "int";
+    header += " int vertex_indices\nend_header\n";
+
+    const size_t components = 3 + (hasNormals ? 3 : 0) + (hasTexCoords ? 2 : 0) + (hasQuality ? 1 : 0);
+    const size_t vertexBytes = nV * components * sizeof(float);
+    const size_t countSize = byteCount ? 1 : sizeof(std::int32_t);
+    const size_t faceBytes = nF * countSize + data.getCornerCount() * sizeof(std::int32_t);
+    std::vector<char> buffer(header.size() + vertexBytes + faceBytes);
+    std::memcpy(buffer.data(), header.data(), header.size());
+
+    char* vertexBlock = buffer.data() + header.size();
+    if (components == 3) {
+        std::memcpy(vertexBlock, data.positions.data(), vertexBytes);
+    } else {
+        parallel::parallelFor(0, nV, [&](size_t v) {
+            char* p = vertexBlock + v * components * sizeof(float);
+            std::memcpy(p, &data.positions[3 * v], 3 * sizeof(float));
+            p += 3 * sizeof(float);
+            if (hasNormals) {
+                std::memcpy(p, &data.normals[3 * v], 3 * sizeof(float));
+                p += 3 * sizeof(float);
+            }
+            if (hasTexCoords) {
+                std::memcpy(p, &data.texCoords[2 * v], 2 * sizeof(float));
+                p += 2 * sizeof(float);
+            }
+            if (hasQuality) std::memcpy(p, &data.quality[v], sizeof(float));
+        });
+    }
+
+    // 面 f 的记录起点 = f 个计数 + 之前的角点索引, 可以直接并行写入
+    char* faceBlock = vertexBlock + vertexBytes;
+    parallel::parallelFor(0, nF, [&](size_t f) {
+        const std::uint32_t begin = data.faceOffsets[f];
+        const std::uint32_t count = data.faceOffsets[f + 1] - begin;
+        char* p = faceBlock + f * countSize + static_cast<size_t>(begin) * sizeof(std::int32_t);
+        if (byteCount) {
+            *p++ = static_cast<char>(count);
+        } else {
+            const std::int32_t n = static_cast<std::int32_t>(count);
+            std::memcpy(p, &n, sizeof(n));
+            p += sizeof(n);
+        }
+        std::memcpy(p, &data.faceVertices[begin], count * sizeof(std::int32_t));
+    });
+
+    if (!writeBuffer(path, buffer)) return false;
+    std::cout << "Wrote " << nV << " vertices and " << nF << " faces to " << path
+              << " (" << buffer.size() << " bytes)" << std::endl;
+    return true;
+}
+
+bool writeOBJ(const std::string& path, const HalfEdgeMesh& mesh) {
+    MeshData data;
+    exportMeshData(mesh, data);
+    return writeOBJ(path, data);
+}
+
+bool writePLY(const std::string& path, const HalfEdgeMesh& mesh) {
+    MeshData data;
+    exportMeshData(mesh, data);
+    return writePLY(path, data);
+}
+
+bool writeMesh(const std::string& path, const MeshData& data) {
+    const std::string ext = fileExtension(path);
+    if (!data.quality.empty() && ext != "ply") {
+        std::cerr << "Warning: Per-vertex quality is only written to PLY, " << path << " will not contain it" << std::endl;
+    }
+    if (ext == "obj") return writeOBJ(path, data);
+    if (ext == "ply") return writePLY(path, data);
+    if (ext == "gpmc") return writeCompressedMesh(path, data);
+    std::cerr << "Error: Unsupported mesh file extension '" << ext << "' for writing" << std::endl;
+    return false;
+}
+
+} // namespace geometry
@@ -0,0 +1,461 @@
+﻿#include "mesh_kernel.h"
+#include "kernel_algorithms.h"
+#include "parallel.h"
+#include <algorithm>
+#include <iostream>
+
+namespace geometry {
+
+// ============================================================================
+// 构建
+// ============================================================================
+
+template <class Scalar>
+void BasicMeshKernel<Scalar>::clear() {
+    positions.clear();
+    vHalfEdge.clear();
+    fHalfEdge.clear();
+    heNext.clear();
+    heVertex.clear();
+    heFace.clear();
+}
+
+/**
+ * @brief 从多边形面列表构建 SoA 半边结构
+ *
+ * 步骤:
+ * 1. 展平所有面的角点(corner), 每个角点对应一条有向边 from->to
+ * 2. 以 (min, max) 为键排序, 相邻的一对反向有向边合并为一条无向边(槽位 2e / 2e+1)
+ * 3. 未配对的有向边生成显式的边界半边; 非流形边(同键 >2 条或同向重复)拆成独立边界边
+ * 4. 连接面内 next, 再沿边界连接边界半边的 next
+ */
+template <class Scalar>
+void BasicMeshKernel<Scalar>::build(const std::vector<Eigen::Vector3d>& vertexPositions,
+                                    const std::vector<std::vector<int>>& faceIndices) {
+    clear();
+    if (vertexPositions.empty() || faceIndices.empty()) {
+        return;
+    }
+    positions.resize(vertexPositions.size());
+    for (size_t i = 0; i < vertexPositions.size(); ++i) {
+        positions[i] = vertexPositions[i].template cast<Scalar>();
+    }
+    buildTopology(faceIndices);
+}
+
+template <class Scalar>
+void BasicMeshKernel<Scalar>::build(const std::vector<Eigen::Vector3f>& vertexPositions,
+                                    const std::vector<std::vector<int>>& faceIndices) {
+    clear();
+    if (vertexPositions.empty() || faceIndices.empty()) {
+        return;
+    }
+    positions.resize(vertexPositions.size());
+    for (size_t i = 0; i < vertexPositions.size(); ++i) {
+        positions[i] = vertexPositions[i].template cast<Scalar>();
+    }
+    buildTopology(faceIndices);
+}
+
+template <class Scalar>
+void BasicMeshKernel<Scalar>::buildTopology(const std::vector<std::vector<int>>& faceIndices) {
+    const Index nV = static_cast<Index>(positions.size());
+
+    // 1. 展平有效面的角点
+    std::vector<Index> cornerVertex;
+    std::vector<Index> faceOffset;
+    cornerVertex.reserve(faceIndices.size() * 3);
+    faceOffset.reserve(faceIndices.size() + 1);
+    faceOffset.push_back(0);
+    for (size_t faceIdx = 0; faceIdx < faceIndices.size(); ++faceIdx) {
+        const auto& faceVerts = faceIndices[faceIdx];
+        if (faceVerts.size() < 3) {
+            std::cerr << "Warning: Skipping face " << faceIdx << " with less than 3 vertices" << std::endl;
+            continue;
+        }
+        bool validFace = true;
+        for (int vertexIdx : faceVerts) {
+            if (vertexIdx < 0 || vertexIdx >= nV) {
+                std::cerr << "Error: Invalid vertex index " << vertexIdx << " in face " << faceIdx << std::endl;
+                validFace = false;
+                break;
+            }
+        }
+        if (!validFace) continue;
+        cornerVertex.insert(cornerVertex.end(), faceVerts.begin(), faceVerts.end());
+        faceOffset.push_back(static_cast<Index>(cornerVertex.size()));
+    }
+
+    const Index nF = static_cast<Index>(faceOffset.size()) - 1;
+    const Index nC = static_cast<Index>(cornerVertex.size());
+    if (nF == 0) {
+        positions.clear();
+        return;
+    }
+
+    // 每个角点的下一个角点(面内循环)
+    std::vector<Index> cornerNext(nC);
+    std::vector<Index> cornerFace(nC);
+    for (Index f = 0; f < nF; ++f) {
+        const Index begin = faceOffset[f];
+        const Index end = faceOffset[f + 1];
+        for (Index c = begin; c < end; ++c) {
+            cornerNext[c] = (c + 1 < end) ? c + 1 : begin;
+            cornerFace[c] = f;
+        }
+    }
+
+    // 2. 有向边按无向键排序
+    struct EdgeKey {
+        std::uint64_t key;
+        Index corner;
+    };
+    // 键只需 2 * bitWidth(nV) 位, 基数排序是稳定的, 相同键内保持角点顺序
+    const int bits = parallel::bitWidth(positions.size());
+    std::vector<EdgeKey> keys(nC);
+    parallel::parallelFor(0, static_cast<size_t>(nC), [&](size_t c) {
+        std::uint64_t a = static_cast<std::uint32_t>(cornerVertex[c]);
+        std::uint64_t b = static_cast<std::uint32_t>(cornerVertex[cornerNext[c]]);
+        if (a > b) std::swap(a, b);
+        keys[c] = { (a << bits) | b, static_cast<Index>(c) };
+    });
+    parallel::parallelRadixSort(keys, 2 * bits, [](const EdgeKey& k) { return k.key; });
+
+    // 3. 分配半边槽位: 每个角点得到一条面半边, 未配对的槽位作为边界半边
+    std::vector<Index> cornerHalfEdge(nC, InvalidIndex);
+    heVertex.reserve(static_cast<size_t>(nC) * 2);
+    heFace.reserve(static_cast<size_t>(nC) * 2);
+    size_t nonManifold = 0;
+
+    auto addEdge = [&](Index c0, Index c1) {
+        // c1 < 0 表示另一侧为边界
+        const Index h = static_cast<Index>(heVertex.size());
+        heVertex.push_back(cornerVertex[c0]);
+        heFace.push_back(cornerFace[c0]);
+        cornerHalfEdge[c0] = h;
+        if (c1 >= 0) {
+            heVertex.push_back(cornerVertex[c1]);
+            heFace.push_back(cornerFace[c1]);
+            cornerHalfEdge[c1] = h + 1;
+        } else {
+            heVertex.push_back(cornerVertex[cornerNext[c0]]);
+            heFace.push_back(InvalidIndex);
+        }
+    };
+
+    for (size_t i = 0; i < keys.size();) {
+        size_t j = i + 1;
+        while (j < keys.size() && keys[j].key == keys[i].key) ++j;
+        const size_t count = j - i;
+        const Index c0 = keys[i].corner;
+        if (count == 1) {
+            addEdge(c0, InvalidIndex);
+        } else if (count == 2 &&
+                   cornerVertex[c0] != cornerVertex[keys[i + 1].corner]) {
+            addEdge(c0, keys[i + 1].corner);
+        } else {
+            // 非流形或方向不一致: 各自成为边界边, 不做覆盖
+            ++nonManifold;
+            for (size_t k = i; k < j; ++k) addEdge(keys[k].corner, InvalidIndex);
+        }
+        i = j;
+    }
+    if (nonManifold > 0) {
+        std::cerr << "Warning: MeshKernel split " << nonManifold
+                  << " non-manifold edge(s) into boundary edges" << std::endl;
+    }
+
+    const Index nH = static_cast<Index>(heVertex.size());
+    heNext.assign(nH, InvalidIndex);
+    fHalfEdge.resize(nF);
+
+    // 4. 面内 next
+    for (Index c = 0; c < nC; ++c) {
+        heNext[cornerHalfEdge[c]] = cornerHalfEdge[cornerNext[c]];
+    }
+    for (Index f = 0; f < nF; ++f) {
+        fHalfEdge[f] = cornerHalfEdge[faceOffset[f]];
+    }
+    linkBoundary();
+
+    std::cout << "MeshKernel built successfully: "
+              << nV << " vertices, "
+              << nF << " faces, "
+              << nH << " half-edges" << std::endl;
+}
+
+/**
+ * @brief 面半边的 heVertex/heFace/heNext 和边界半边的 heVertex 已写入后,
+ * 沿边界连接边界半边的 next, 并为每个顶点选一条出边(边界顶点优先取边界出边)
+ */
+template <class Scalar>
+void BasicMeshKernel<Scalar>::linkBoundary() {
+    const Index nV = static_cast<Index>(positions.size());
+    const Index nH = static_cast<Index>(heVertex.size());
+    vHalfEdge.assign(nV, InvalidIndex);
+
+    // 边界半边: 每个顶点的边界出边链表(非流形顶点可能有多条)
+    std::vector<Index> boundaryHead(nV, InvalidIndex);
+    std::vector<Index> boundaryLink(nH, InvalidIndex);
+    for (Index h = 0; h < nH; ++h) {
+        if (heFace[h] >= 0) continue;
+        const Index v = heVertex[h];
+        boundaryLink[h] = boundaryHead[v];
+        boundaryHead[v] = h;
+        vHalfEdge[v] = h; // 边界顶点优先存边界出边
+    }
+    for (Index h = 0; h < nH; ++h) {
+        if (heFace[h] >= 0) continue;
+        // 边界半边的终点 = 对偶面半边的起点
+        const Index d = heVertex[twin(h)];
+        const Index n = boundaryHead[d];
+        if (n < 0) {
+            std::cerr << "Warning: MeshKernel boundary loop broken at vertex " << d << std::endl;
+            heNext[h] = twin(h);
+            continue;
+        }
+        boundaryHead[d] = boundaryLink[n];
+        heNext[h] = n;
+    }
+
+    // 内部顶点取任意一条出边
+    for (Index h = 0; h < nH; ++h) {
+        Index& vh = vHalfEdge[heVertex[h]];
+        if (vh < 0) vh = h;
+    }
+}
+
+// ============================================================================
+// 拓扑查询
+// ============================================================================
+
+/**
+ * @brief 前一条半边: 绕起点旋转入边, 直到找到 next 为 h 的那条(O(度数))
+ */
+template <class Scalar>
+typename BasicMeshKernel<Scalar>::Index BasicMeshKernel<Scalar>::prev(Index h) const {
+    Index in = twin(h);
+    while (heNext[in] != h) {
+        in = twin(heNext[in]);
+    }
+    return in;
+}
+
+template <class Scalar>
+int BasicMeshKernel<Scalar>::getDegree(Index v) const {
+    const Index start = vHalfEdge[v];
+    if (start < 0) return 0;
+    int degree = 0;
+    Index h = start;
+    do {
+        ++degree;
+        h = rotate(h);
+    } while (h != start);
+    return degree;
+}
+
+template <class Scalar>
+int BasicMeshKernel<Scalar>::getFaceVertexCount(Index f) const {
+    const Index start = fHalfEdge[f];
+    int count = 0;
+    Index h = start;
+    do {
+        ++count;
+        h = heNext[h];
+    } while (h != start);
+    return count;
+}
+
+// ============================================================================
+// 几何
+// ============================================================================
+
+/**
+ * @brief 面法向(Newell 方法, 与 Face::computeNormal 相同)
+ */
+template <class Scalar>
+typename BasicMeshKernel<Scalar>::Vector3 BasicMeshKernel<Scalar>::computeFaceNormal(Index f) const {
+    AccumulatorVector3 normal = AccumulatorVector3::Zero();
+    const Index start = fHalfEdge[f];
+    Index h = start;
+    do {
+        const AccumulatorVector3 v1 = positions[heVertex[h]].template cast<Accumulator>();
+        const AccumulatorVector3 v2 = positions[heVertex[heNext[h]]].template cast<Accumulator>();
+        normal.x() += (v1.y() - v2.y()) * (v1.z() + v2.z());
+        normal.y() += (v1.z() - v2.z()) * (v1.x() + v2.x());
+        normal.z() += (v1.x() - v2.x()) * (v1.y() + v2.y());
+        h = heNext[h];
+    } while (h != start);
+    if (normal.norm() > 0) normal.normalize();
+    return normal.template cast<Scalar>();
+}
+
+/**
+ * @brief 面面积(扇形三角剖分, 与 Face::computeArea 相同)
+ */
+template <class Scalar>
+typename BasicMeshKernel<Scalar>::Accumulator BasicMeshKernel<Scalar>::computeFaceArea(Index f) const {
+    const Index start = fHalfEdge[f];
+    const AccumulatorVector3 v0 = positions[heVertex[start]].template cast<Accumulator>();
+    Accumulator area = 0.0;
+    Index h = heNext[start];
+    while (heNext[h] != start) {
+        const AccumulatorVector3 v1 = positions[heVertex[h]].template cast<Accumulator>();
+        const AccumulatorVector3 v2 = positions[heVertex[heNext[h]]].template cast<Accumulator>();
+        area += 0.5 * (v1 - v0).cross(v2 - v0).norm();
+        h = heNext[h];
+    }
+    return area;
+}
+
+template <class Scalar>
+typename BasicMeshKernel<Scalar>::Accumulator BasicMeshKernel<Scalar>::getTotalSurfaceArea() const {
+    Accumulator total = 0.0;
+    for (Index f = 0; f < static_cast<Index>(fHalfEdge.size()); ++f) {
+        total += computeFaceArea(f);
+    }
+    return total;
+}
+
+template <class Scalar>
+void BasicMeshKernel<Scalar>::computeVertexNormals(std::vector<Vector3>& normals) const {
+    detail::computeVertexNormals(*this, normals);
+}
+
+template <class Scalar>
+void BasicMeshKernel<Scalar>::computeMeanCurvature(std::vector<Scalar>& curvature) const {
+    detail::computeMeanCurvature(*this, curvature);
+}
+
+template <class Scalar>
+void BasicMeshKernel<Scalar>::laplacianSmooth(int iterations, Accumulator lambda, const SmoothCallback& onIteration) {
+    detail::laplacianSmooth(*this, iterations, lambda, [&](int iteration, const std::vector<Vector3>& previous) {
+        return !onIteration || onIteration(iteration, previous);
+    });
+}
+
+/**
+ * @brief 检查数组尺寸与拓扑一致性
+ */
+template <class Scalar>
+bool BasicMeshKernel<Scalar>::isValid() const {
+    const Index nV = static_cast<Index>(positions.size());
+    const Index nF = static_cast<Index>(fHalfEdge.size());
+    const Index nH = static_cast<Index>(heNext.size());
+    if (nH % 2 != 0 || heVertex.size() != heNext.size() || heFace.size() != heNext.size() ||
+        vHalfEdge.size() != positions.size()) {
+        std::cerr << "MeshKernel arrays have inconsistent sizes" << std::endl;
+        return false;
+    }
+    for (Index h = 0; h < nH; ++h) {
+        const Index n = heNext[h];
+        if (n < 0 || n >= nH || heVertex[h] < 0 || heVertex[h] >= nV || heFace[h] >= nF) {
+            std::cerr << "MeshKernel half-edge " << h << " has invalid references" << std::endl;
+            return false;
+        }
+        if (heVertex[n] != heVertex[twin(h)]) {
+            std::cerr << "MeshKernel half-edge " << h << " next/twin connection broken" << std::endl;
+            return false;
+        }
+        if (heFace[n] != heFace[h]) {
+            std::cerr << "MeshKernel half-edge " << h << " face cycle broken" << std::endl;
+            return false;
+        }
+    }
+    for (Index v = 0; v < nV; ++v) {
+        const Index h = vHalfEdge[v];
+        if (h >= 0 && heVertex[h] != v) {
+            std::cerr << "MeshKernel vertex " << v << " outgoing half-edge broken" << std::endl;
+            return false;
+        }
+    }
+    for (Index f = 0; f < nF; ++f) {
+        if (heFace[fHalfEdge[f]] != f) {
+            std::cerr << "MeshKernel face " << f << " half-edge broken" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class Scalar>
+size_t BasicMeshKernel<Scalar>::memoryUsage() const {
+    return positions.capacity() * sizeof(Vector3)
+         + (vHalfEdge.capacity() + fHalfEdge.capacity() + heNext.capacity()
+            + heVertex.capacity() + heFace.capacity()) * sizeof(Index);
+}
+
+// ============================================================================
+// 与 HalfEdgeMesh 的适配
+// ============================================================================
+
+/**
+ * @brief 从 HalfEdgeMesh 构建内核
+ * 网格没有已删除元素、index 与数组下标一致时, 直接按半边的 next/pair 翻译拓扑(O(n), 不排序):
+ * 互为对偶的两条半边占相邻的两个槽位, 没有对偶的面半边的另一个槽位成为边界半边。
+ * 指针只遍历两遍(检查并记下对偶, 写入数组), 槽位分配只读下标数组。
+ * 其余情况按面列表重新构建(detail::fromHalfEdgeMesh)
+ */
+template <class Scalar>
+BasicMeshKernel<Scalar> BasicMeshKernel<Scalar>::fromHalfEdgeMesh(const HalfEdgeMesh& mesh) {
+    const size_t nV = mesh.vertices.size();
+    const size_t nF = mesh.faces.size();
+    const size_t nE = mesh.halfEdges.size();
+
+    // 1. 检查元素并记下每条半边的对偶(没有对偶或对偶不对称时为 -1), 同时复制位置
+    BasicMeshKernel kernel;
+    kernel.positions.resize(nV);
+    std::vector<Index> pairOf(nE);
+    const size_t invalid = parallel::parallelSum<size_t>(0, nV, 0, [&](size_t v) {
+        const Vertex* vertex = mesh.vertices[v].get();
+        kernel.positions[v] = vertex->position.template cast<Scalar>();
+        return vertex->deleted || vertex->index != static_cast<int>(v) ? size_t(1) : size_t(0);
+    }) + parallel::parallelSum<size_t>(0, nF, 0, [&](size_t f) {
+        const Face* face = mesh.faces[f].get();
+        return face->deleted || face->index != static_cast<int>(f) || !face->halfEdge ? size_t(1) : size_t(0);
+    }) + parallel::parallelSum<size_t>(0, nE, 0, [&](size_t i) {
+        const HalfEdge* he = mesh.halfEdges[i].get();
+        pairOf[i] = he->pair && he->pair->pair == he ? he->pair->index : InvalidIndex;
+        return he->deleted || he->index != static_cast<int>(i) || !he->face || !he->next || !he->vertex ? size_t(1) : size_t(0);
+    });
+    if (nF == 0 || invalid > 0) return detail::fromHalfEdgeMesh<BasicMeshKernel>(mesh);
+
+    // 2. 槽位: 先出现的一条取 2e, 它的对偶取 2e + 1
+    std::vector<Index> slot(nE, InvalidIndex);
+    Index nH = 0;
+    for (size_t i = 0; i < nE; ++i) {
+        if (slot[i] >= 0) continue;
+        slot[i] = nH;
+        if (pairOf[i] >= 0) slot[pairOf[i]] = nH + 1;
+        nH += 2;
+    }
+
+    // 3. 写入面半边, 以及没有对偶的面半边旁边的边界半边的起点
+    kernel.heVertex.resize(nH);
+    kernel.heFace.assign(nH, InvalidIndex);
+    kernel.heNext.assign(nH, InvalidIndex);
+    parallel::parallelFor(0, nE, [&](size_t i) {
+        const HalfEdge* he = mesh.halfEdges[i].get();
+        const Index s = slot[i];
+        kernel.heVertex[s] = he->vertex->index;
+        kernel.heFace[s] = he->face->index;
+        kernel.heNext[s] = slot[he->next->index];
+        if (pairOf[i] < 0) kernel.heVertex[twin(s)] = he->next->vertex->index; // 边界半边: 终点 -> 起点
+    });
+    kernel.fHalfEdge.resize(nF);
+    for (size_t f = 0; f < nF; ++f) {
+        kernel.fHalfEdge[f] = slot[mesh.faces[f]->halfEdge->index];
+    }
+    kernel.linkBoundary();
+    return kernel;
+}
+
+template <class Scalar>
+void BasicMeshKernel<Scalar>::toHalfEdgeMesh(HalfEdgeMesh& mesh) const {
+    detail::toHalfEdgeMesh(*this, mesh);
+}
+
+template class BasicMeshKernel<float>;
+template class BasicMeshKernel<double>;
+
+} // namespace geometry
@@ -0,0 +1,320 @@
+﻿#include "mesh_reorder.h"
+#include "halfedge.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <utility>
+
+namespace geometry {
+
+namespace {
+
+constexpr int CurveBits = 21; ///< 空间填充曲线每个坐标轴的位数, 3 * 21 = 63 位键
+
+/// 把 21 位整数的每一位之间插入两个 0
+std::uint64_t spreadBits(std::uint32_t x) {
+    std::uint64_t v = x & 0x1FFFFF;
+    v = (v | (v << 32)) & 0x1F00000000FFFFull;
+    v = (v | (v << 16)) & 0x1F0000FF0000FFull;
+    v = (v | (v << 8)) & 0x100F00F00F00F00Full;
+    v = (v | (v << 4)) & 0x10C30C30C30C30C3ull;
+    v = (v | (v << 2)) & 0x1249249249249249ull;
+    return v;
+}
+
+std::uint64_t mortonKey(const std::uint32_t q[3]) {
+    return (spreadBits(q[0]) << 2) | (spreadBits(q[1]) << 1) | spreadBits(q[2]);
+}
+
+/**
+ * @brief 三维 Hilbert 曲线上的位置
+ * Skilling 的 AxesToTranspose 变换: 原地把坐标变为"转置"形式的 Hilbert 索引, 再按位交错。
+ */
+std::uint64_t hilbertKey(const std::uint32_t q[3]) {
+    std::uint32_t x[3] = { q[0], q[1], q[2] };
+    const std::uint32_t top = 1u << (CurveBits - 1);
+    for (std::uint32_t bit = top; bit > 1; bit >>= 1) {
+        const std::uint32_t lower = bit - 1;
+        for (int i = 0; i < 3; ++i) {
+            if (x[i] & bit) {
+                x[0] ^= lower;
+            } else {
+                const std::uint32_t t = (x[0] ^ x[i]) & lower;
+                x[0] ^= t;
+                x[i] ^= t;
+            }
+        }
+    }
+    for (int i = 1; i < 3; ++i) x[i] ^= x[i - 1];
+    std::uint32_t t = 0;
+    for (std::uint32_t bit = top; bit > 1; bit >>= 1) {
+        if (x[2] & bit) t ^= bit - 1;
+    }
+    for (int i = 0; i < 3; ++i) x[i] ^= t;
+    return (spreadBits(x[0]) << 2) | (spreadBits(x[1]) << 1) | spreadBits(x[2]);
+}
+
+/// 按空间填充曲线排序未删除的顶点
+std::vector<int> curveVertexOrder(const HalfEdgeMesh& mesh, bool hilbert) {
+    std::vector<int> live;
+    live.reserve(mesh.vertices.size());
+    Eigen::Vector3d lo = Eigen::Vector3d::Constant(std::numeric_limits<double>::max());
+    Eigen::Vector3d hi = -lo;
+    for (const auto& v : mesh.vertices) {
+        if (v->deleted) continue;
+        live.push_back(v->index);
+        lo = lo.cwiseMin(v->position);
+        hi = hi.cwiseMax(v->position);
+    }
+    if (live.empty()) return live;
+
+    // 按最长边统一缩放到 [0, 2^21), 保持各轴比例
+    const double extent = std::max((hi - lo).maxCoeff(), std::numeric_limits<double>::min());
+    const double scale = ((1u << CurveBits) - 1) / extent;
+    std::vector<std::pair<std::uint64_t, int>> keys(live.size());
+    parallel::parallelFor(0, live.size(), [&](size_t i) {
+        const Eigen::Vector3d& p = mesh.vertices[live[i]]->position;
+        std::uint32_t q[3];
+        for (int d = 0; d < 3; ++d) q[d] = static_cast<std::uint32_t>(std::clamp((p[d] - lo[d]) * scale, 0.0, double((1u << CurveBits) - 1)));
+        keys[i] = { hilbert ? hilbertKey(q) : mortonKey(q), live[i] };
+    });
+    parallel::parallelRadixSort(keys, 3 * CurveBits, [](const auto& k) { return k.first; });
+    for (size_t i = 0; i < keys.size(); ++i) live[i] = keys[i].second;
+    return live;
+}
+
+/**
+ * @brief 逆 Cuthill-McKee 顺序
+ * 每个连通分量从伪外围顶点(反复取最远层中度数最小的顶点)出发广度优先,
+ * 同一顶点的未访问邻居按度数升序加入, 最后整体反转。
+ */
+std::vector<int> rcmVertexOrder(const HalfEdgeMesh& mesh) {
+    const size_t nV = mesh.vertices.size();
+    // 顶点邻接 CSR(不含自身), 由半边两端得到, 边界边只出现一次, 所以两个方向都加入后去重
+    std::vector<int> offsets(nV + 1, 0);
+    for (const auto& he : mesh.halfEdges) {
+        if (he->deleted) continue;
+        ++offsets[he->vertex->index + 1];
+        ++offsets[he->next->vertex->index + 1];
+    }
+    for (size_t v = 0; v < nV; ++v) offsets[v + 1] += offsets[v];
+    std::vector<int> neighbors(offsets[nV]);
+    std::vector<int> cursor(offsets.begin(), offsets.end() - 1);
+    for (const auto& he : mesh.halfEdges) {
+        if (he->deleted) continue;
+        const int a = he->vertex->index;
+        const int b = he->next->vertex->index;
+        neighbors[cursor[a]++] = b;
+        neighbors[cursor[b]++] = a;
+    }
+    std::vector<int> degree(nV, 0);
+    parallel::parallelFor(0, nV, [&](size_t v) {
+        auto first = neighbors.begin() + offsets[v];
+        auto last = neighbors.begin() + offsets[v + 1];
+        std::sort(first, last);
+        degree[v] = static_cast<int>(std::unique(first, last) - first);
+    }, 1024);
+
+    std::vector<int> level(nV, -1);
+    std::vector<int> queue;
+    queue.reserve(nV);
+    // 从 start 广度优先, 返回最后一层中度数最小的顶点和层数; 访问过的顶点在返回前复位
+    auto farthest = [&](int start, int& depth) {
+        queue.clear();
+        queue.push_back(start);
+        level[start] = 0;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            const int v = queue[head];
+            for (int k = offsets[v]; k < offsets[v] + degree[v]; ++k) {
+                const int w = neighbors[k];
+                if (level[w] < 0) {
+                    level[w] = level[v] + 1;
+                    queue.push_back(w);
+                }
+            }
+        }
+        depth = level[queue.back()];
+        int best = queue.back();
+        for (int v : queue) {
+            if (level[v] == depth && degree[v] < degree[best]) best = v;
+        }
+        for (int v : queue) level[v] = -1;
+        return best;
+    };
+
+    // 按度数升序尝试种子, 保证每个分量都从低度数顶点开始
+    std::vector<int> byDegree;
+    byDegree.reserve(nV);
+    for (const auto& v : mesh.vertices) {
+        if (!v->deleted) byDegree.push_back(v->index);
+    }
+    std::stable_sort(byDegree.begin(), byDegree.end(), [&](int a, int b) { return degree[a] < degree[b]; });
+
+    std::vector<char> visited(nV, 0);
+    std::vector<int> order;
+    order.reserve(byDegree.size());
+    std::vector<int> candidates;
+    for (int seed : byDegree) {
+        if (visited[seed]) continue;
+        int start = seed;
+        int depth = 0;
+        int next = farthest(start, depth);
+        for (int iteration = 0; iteration < 8; ++iteration) {
+            int nextDepth = 0;
+            const int candidate = farthest(next, nextDepth);
+            if (nextDepth <= depth) break;
+            start = next;
+            depth = nextDepth;
+            next = candidate;
+        }
+
+        visited[start] = 1;
+        order.push_back(start);
+        for (size_t head = order.size() - 1; head < order.size(); ++head) {
+            const int v = order[head];
+            candidates.clear();
+            for (int k = offsets[v]; k < offsets[v] + degree[v]; ++k) {
+                const int w = neighbors[k];
+                if (!visited[w]) {
+                    visited[w] = 1;
+                    candidates.push_back(w);
+                }
+            }
+            std::stable_sort(candidates.begin(), candidates.end(), [&](int a, int b) { return degree[a] < degree[b]; });
+            order.insert(order.end(), candidates.begin(), candidates.end());
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+/// 面按最小的新顶点编号稳定排序, 每个面的半边按环顺序连续存放
+void orderFacesByVertices(const HalfEdgeMesh& mesh, MeshPermutation& permutation) {
+    const std::vector<int> vertexNew = invertOrder(permutation.vertexOrder, mesh.vertices.size());
+    std::vector<std::pair<std::uint64_t, int>> keys;
+    keys.reserve(mesh.faces.size());
+    for (const auto& f : mesh.faces) {
+        if (f->deleted) continue;
+        int key = std::numeric_limits<int>::max();
+        if (const HalfEdge* start = f->halfEdge) {
+            const HalfEdge* he = start;
+            do {
+                if (vertexNew[he->vertex->index] >= 0) key = std::min(key, vertexNew[he->vertex->index]);
+                he = he->next;
+            } while (he != start);
+        }
+        keys.emplace_back(static_cast<std::uint64_t>(key), f->index);
+    }
+    parallel::parallelRadixSort(keys, 32, [](const auto& k) { return k.first; });
+
+    permutation.faceOrder.resize(keys.size());
+    permutation.halfEdgeOrder.clear();
+    permutation.halfEdgeOrder.reserve(mesh.halfEdges.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        permutation.faceOrder[i] = keys[i].second;
+        const HalfEdge* start = mesh.faces[keys[i].second]->halfEdge;
+        if (!start) continue;
+        const HalfEdge* he = start;
+        do {
+            permutation.halfEdgeOrder.push_back(he->index);
+            he = he->next;
+        } while (he != start);
+    }
+}
+
+/// 面按对偶图广度优先(order 本身作为队列), 顶点按第一次被访问的顺序, 孤立顶点放在最后
+void faceLocalityOrder(const HalfEdgeMesh& mesh, MeshPermutation& permutation) {
+    auto& vertexOrder = permutation.vertexOrder;
+    auto& faceOrder = permutation.faceOrder;
+    auto& halfEdgeOrder = permutation.halfEdgeOrder;
+    vertexOrder.reserve(mesh.vertices.size());
+    faceOrder.reserve(mesh.faces.size());
+    halfEdgeOrder.reserve(mesh.halfEdges.size());
+    std::vector<char> faceVisited(mesh.faces.size(), 0);
+    std::vector<char> vertexVisited(mesh.vertices.size(), 0);
+    for (const auto& seed : mesh.faces) {
+        if (seed->deleted || faceVisited[seed->index]) continue;
+        faceVisited[seed->index] = 1;
+        faceOrder.push_back(seed->index);
+        for (size_t head = faceOrder.size() - 1; head < faceOrder.size(); ++head) {
+            const HalfEdge* start = mesh.faces[faceOrder[head]]->halfEdge;
+            if (!start) continue;
+            const HalfEdge* he = start;
+            do {
+                halfEdgeOrder.push_back(he->index);
+                if (!vertexVisited[he->vertex->index]) {
+                    vertexVisited[he->vertex->index] = 1;
+                    vertexOrder.push_back(he->vertex->index);
+                }
+                const Face* neighbor = he->pair ? he->pair->face : nullptr;
+                if (neighbor && !neighbor->deleted && !faceVisited[neighbor->index]) {
+                    faceVisited[neighbor->index] = 1;
+                    faceOrder.push_back(neighbor->index);
+                }
+                he = he->next;
+            } while (he != start);
+        }
+    }
+    for (const auto& v : mesh.vertices) {
+        if (!v->deleted && !vertexVisited[v->index]) vertexOrder.push_back(v->index);
+    }
+}
+
+bool hasDeletedElements(const HalfEdgeMesh& mesh) {
+    auto anyDeleted = [](const auto& elements) {
+        return std::any_of(elements.begin(), elements.end(), [](const auto& e) { return e->deleted; });
+    };
+    return anyDeleted(mesh.vertices) || anyDeleted(mesh.faces) || anyDeleted(mesh.halfEdges);
+}
+
+} // namespace
+
+std::vector<int> invertOrder(const std::vector<int>& order, size_t size) {
+    std::vector<int> inverse(size, -1);
+    for (size_t i = 0; i < order.size(); ++i) inverse[order[i]] = static_cast<int>(i);
+    return inverse;
+}
+
+MeshPermutation computeMeshOrdering(const HalfEdgeMesh& mesh, MeshOrdering ordering) {
+    MeshPermutation permutation;
+    switch (ordering) {
+    case MeshOrdering::FaceLocality:
+        faceLocalityOrder(mesh, permutation);
+        return permutation;
+    case MeshOrdering::Morton:
+        permutation.vertexOrder = curveVertexOrder(mesh, false);
+        break;
+    case MeshOrdering::Hilbert:
+        permutation.vertexOrder = curveVertexOrder(mesh, true);
+        break;
+    case MeshOrdering::ReverseCuthillMcKee:
+        permutation.vertexOrder = rcmVertexOrder(mesh);
+        break;
+    }
+    orderFacesByVertices(mesh, permutation);
+    return permutation;
+}
+
+MeshPermutation reorderMesh(HalfEdgeMesh& mesh, MeshOrdering ordering) {
+    if (hasDeletedElements(mesh)) mesh.garbageCollection();
+    MeshPermutation permutation = computeMeshOrdering(mesh, ordering);
+    mesh.permute(permutation.vertexOrder, permutation.faceOrder, permutation.halfEdgeOrder, true);
+    return permutation;
+}
+
+bool restoreMeshOrder(HalfEdgeMesh& mesh, const MeshPermutation& permutation) {
+    if (permutation.vertexOrder.size() != mesh.getVertexCount() || permutation.faceOrder.size() != mesh.getFaceCount() ||
+        permutation.halfEdgeOrder.size() != mesh.getHalfEdgeCount()) {
+        std::cerr << "Error: Mesh permutation does not match the mesh (topology changed after reordering?)" << std::endl;
+        return false;
+    }
+    // 重排后第 i 个元素原来在 order[i], 所以原来的第 j 个元素现在在 inverse[j]
+    mesh.permute(invertOrder(permutation.vertexOrder, mesh.getVertexCount()),
+                 invertOrder(permutation.faceOrder, mesh.getFaceCount()),
+                 invertOrder(permutation.halfEdgeOrder, mesh.getHalfEdgeCount()), true);
+    return true;
+}
+
+} // namespace geometry
@@ -0,0 +1,502 @@
+﻿#include "out_of_core.h"
+#include "mesh_io.h"
+#include "mesh_kernel.h"
+#include "parallel.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace geometry {
+
+namespace {
+
+constexpr size_t MaxCells = size_t(1) << 18;            ///< 分块用的均匀格子数上限
+constexpr size_t BucketBudgetBytes = size_t(64) << 20; ///< 所有分块写缓冲的总字节数上限
+constexpr size_t HaloWarningFactor = 4;                 ///< 含重叠区的顶点数超过目标的这个倍数时给出警告
+
+using CellCoords = std::array<size_t, 3>;
+
+/**
+ * @brief 覆盖包围盒的均匀格子(边长 cellSize, 每轴 dims 个), 盒外的点归入最近的格子
+ */
+struct CellGrid {
+    Eigen::Vector3f origin;
+    float cellSize = 1.0f;
+    CellCoords dims { 1, 1, 1 };
+
+    size_t cellCount() const { return dims[0] * dims[1] * dims[2]; }
+    size_t index(const CellCoords& c) const { return (c[2] * dims[1] + c[1]) * dims[0] + c[0]; }
+    CellCoords coords(const Eigen::Vector3f& p) const {
+        CellCoords c;
+        for (int i = 0; i < 3; ++i) {
+            const double u = (static_cast<double>(p[i]) - origin[i]) / cellSize;
+            c[i] = std::min(dims[i] - 1, static_cast<size_t>(std::max(0.0, u)));
+        }
+        return c;
+    }
+    size_t cellOf(const Eigen::Vector3f& p) const { return index(coords(p)); }
+    CellCoords coordsOf(size_t cell) const { return { cell % dims[0], cell / dims[0] % dims[1], cell / dims[0] / dims[1] }; }
+};
+
+/// 格子坐标的闭区间 [lo, hi]
+struct CellBox {
+    CellCoords lo, hi;
+
+    template <class F>
+    void forEachCell(const CellGrid& grid, F&& f) const {
+        for (size_t z = lo[2]; z <= hi[2]; ++z) {
+            for (size_t y = lo[1]; y <= hi[1]; ++y) {
+                for (size_t x = lo[0]; x <= hi[0]; ++x) f(grid.index({ x, y, z }));
+            }
+        }
+    }
+    CellBox expanded(const CellGrid& grid, size_t cells) const {
+        CellBox box;
+        for (int i = 0; i < 3; ++i) {
+            box.lo[i] = lo[i] > cells ? lo[i] - cells : 0;
+            box.hi[i] = std::min(grid.dims[i] - 1, hi[i] + cells);
+        }
+        return box;
+    }
+};
+
+/**
+ * @brief 块的重叠区: 从块的格子出发走 rings 步能到达的所有格子(含块本身), 结果写入 cells
+ * 以格子 c 内顶点为端点的边不超过 cellEdge[c], 所以一步最多走到 c 周围 ceil(cellEdge[c] / cellSize) 圈格子;
+ * 每个格子按首次到达的步数展开, 长边只加宽它所在的地方。reached 是全为 0 的临时标记, 返回时恢复为 0。
+ */
+void collectHalo(const CellGrid& grid, const std::vector<float>& cellEdge, const CellBox& chunk, int rings,
+                 std::vector<char>& reached, std::vector<size_t>& cells) {
+    cells.clear();
+    chunk.forEachCell(grid, [&](size_t cell) {
+        reached[cell] = 1;
+        cells.push_back(cell);
+    });
+    size_t frontier = 0;
+    for (int step = 0; step < rings; ++step) {
+        const size_t frontierEnd = cells.size();
+        for (size_t i = frontier; i < frontierEnd; ++i) {
+            const size_t cell = cells[i];
+            if (cellEdge[cell] <= 0.0f) continue;
+            const CellCoords c = grid.coordsOf(cell);
+            const size_t radius = static_cast<size_t>(std::ceil(cellEdge[cell] / grid.cellSize));
+            CellBox { c, c }.expanded(grid, radius).forEachCell(grid, [&](size_t next) {
+                if (reached[next]) return;
+                reached[next] = 1;
+                cells.push_back(next);
+            });
+        }
+        frontier = frontierEnd;
+    }
+    for (size_t cell : cells) reached[cell] = 0;
+}
+
+/**
+ * @brief 按顶点数递归二分格子盒(每次沿格子数最多的轴在中位数处切开), 叶子即为块
+ * 叶子拥有的顶点数不超过 target, 只剩一个格子时除外; 没有顶点的叶子被丢弃
+ */
+void splitCells(const CellGrid& grid, const std::vector<std::uint32_t>& cellVertices, const CellBox& box,
+                size_t target, std::vector<CellBox>& chunks) {
+    size_t total = 0;
+    box.forEachCell(grid, [&](size_t cell) { total += cellVertices[cell]; });
+    if (total == 0) return;
+    int axis = 0;
+    for (int i = 1; i < 3; ++i) {
+        if (box.hi[i] - box.lo[i] > box.hi[axis] - box.lo[axis]) axis = i;
+    }
+    if (total <= target || box.hi[axis] == box.lo[axis]) {
+        if (total > target) {
+            std::cerr << "Warning: " << total << " vertices share one cell, chunk exceeds maxChunkVertices" << std::endl;
+        }
+        chunks.push_back(box);
+        return;
+    }
+    // 沿 axis 的逐层顶点数, 切在前缀和首次达到一半的层之后(两侧都不为空盒)
+    std::vector<size_t> layers(box.hi[axis] - box.lo[axis] + 1, 0);
+    for (size_t layer = 0; layer < layers.size(); ++layer) {
+        CellBox slice = box;
+        slice.lo[axis] = slice.hi[axis] = box.lo[axis] + layer;
+        slice.forEachCell(grid, [&](size_t cell) { layers[layer] += cellVertices[cell]; });
+    }
+    size_t split = 0, running = layers[0];
+    while (split + 2 < layers.size() && 2 * running < total) running += layers[++split];
+    CellBox lower = box, upper = box;
+    lower.hi[axis] = box.lo[axis] + split;
+    upper.lo[axis] = lower.hi[axis] + 1;
+    splitCells(grid, cellVertices, lower, target, chunks);
+    splitCells(grid, cellVertices, upper, target, chunks);
+}
+
+/**
+ * @brief 一个块的临时面文件, 写满缓冲后追加到文件(文件只在刷新时打开)
+ */
+struct ChunkBucket {
+    std::string path;
+    std::vector<std::uint32_t> buffer;
+    size_t faceCount = 0;
+
+    bool flush() {
+        if (buffer.empty()) return true;
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        const bool ok = static_cast<bool>(out.write(reinterpret_cast<const char*>(buffer.data()),
+                                                    static_cast<std::streamsize>(buffer.size() * sizeof(std::uint32_t))));
+        buffer.clear();
+        return ok;
+    }
+};
+
+/// 把 count 条定长记录分批写出, fill(i, dst) 填写第 i 条
+template <class Fill>
+bool writeRecords(std::ofstream& out, size_t count, size_t recordBytes, Fill fill) {
+    constexpr size_t batchBytes = size_t(4) << 20;
+    const size_t batch = std::max<size_t>(1, batchBytes / recordBytes);
+    std::vector<char> buffer;
+    for (size_t begin = 0; begin < count; begin += batch) {
+        const size_t end = std::min(count, begin + batch);
+        buffer.resize((end - begin) * recordBytes);
+        parallel::parallelFor(begin, end, [&](size_t i) {
+            fill(i, buffer.data() + (i - begin) * recordBytes);
+        });
+        if (!out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()))) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool processOutOfCore(const std::string& inputPath, const std::string& outputPath,
+                      const StreamingOptions& options, StreamingStats* stats) {
+    PlyTriangleStream input;
+    if (!input.open(inputPath)) return false;
+    const size_t nV = input.getVertexCount();
+    const size_t nF = input.getFaceCount();
+    if (nV == 0 || nF == 0) {
+        std::cerr << "Error: " << inputPath << " has no triangles" << std::endl;
+        return false;
+    }
+    if (nV > std::numeric_limits<std::uint32_t>::max()) {
+        std::cerr << "Error: Streaming supports at most 2^32 - 1 vertices" << std::endl;
+        return false;
+    }
+
+    // 1. 包围盒; 只统计面的角点, 孤立的离群顶点不应影响格子的范围
+    const unsigned tasks = std::max(1u, parallel::chunkCount(nV, 1 << 16));
+    const unsigned faceTasks = std::max(1u, parallel::chunkCount(nF, 1 << 16));
+    auto isValid = [&](const std::uint32_t tri[3]) { return tri[0] < nV && tri[1] < nV && tri[2] < nV; };
+    std::vector<Eigen::AlignedBox3f> taskBoxes(faceTasks);
+    parallel::runTasks(faceTasks, [&](unsigned t) {
+        std::uint32_t tri[3];
+        for (size_t f = nF * t / faceTasks; f < nF * (t + 1) / faceTasks; ++f) {
+            input.triangle(f, tri);
+            if (!isValid(tri)) continue;
+            for (int k = 0; k < 3; ++k) taskBoxes[t].extend(input.position(tri[k]));
+        }
+    });
+    Eigen::AlignedBox3f box;
+    for (const auto& b : taskBoxes) box.extend(b);
+    if (box.isEmpty()) {
+        std::cerr << "Error: " << inputPath << " has no valid triangles" << std::endl;
+        return false;
+    }
+
+    // 2. 均匀格子: 格子边长从"最长轴切成 MaxCells 段"开始放大, 直到总格子数不超过 MaxCells
+    //    (细长、扁平和块状的网格都能用满格子数)
+    CellGrid grid;
+    grid.origin = box.min();
+    const Eigen::Vector3f sizes = box.sizes();
+    grid.cellSize = std::max(sizes.maxCoeff(), std::numeric_limits<float>::min()) / MaxCells;
+    auto cellsAlong = [&](int i) { return std::max<size_t>(1, static_cast<size_t>(std::ceil(sizes[i] / grid.cellSize))); };
+    while (static_cast<double>(cellsAlong(0)) * cellsAlong(1) * cellsAlong(2) > MaxCells) grid.cellSize *= 1.25f;
+    for (int i = 0; i < 3; ++i) grid.dims[i] = cellsAlong(i);
+    const size_t cellCount = grid.cellCount();
+
+    // 每个格子的顶点数, 以及以格子内顶点为端点的最长边(决定从这里出发的邻域能走多远)
+    std::vector<std::vector<std::uint32_t>> taskCounts(tasks, std::vector<std::uint32_t>(cellCount, 0));
+    parallel::runTasks(tasks, [&](unsigned t) {
+        for (size_t v = nV * t / tasks; v < nV * (t + 1) / tasks; ++v) ++taskCounts[t][grid.cellOf(input.position(v))];
+    });
+    std::vector<std::uint32_t> cellVertices(cellCount, 0);
+    for (const auto& counts : taskCounts) {
+        for (size_t cell = 0; cell < cellCount; ++cell) cellVertices[cell] += counts[cell];
+    }
+    std::vector<std::vector<std::uint32_t>>().swap(taskCounts);
+    std::vector<std::vector<float>> taskEdges(faceTasks, std::vector<float>(cellCount, 0.0f));
+    parallel::runTasks(faceTasks, [&](unsigned t) {
+        std::uint32_t tri[3];
+        for (size_t f = nF * t / faceTasks; f < nF * (t + 1) / faceTasks; ++f) {
+            input.triangle(f, tri);
+            if (!isValid(tri)) continue;
+            const Eigen::Vector3f p[3] = { input.position(tri[0]), input.position(tri[1]), input.position(tri[2]) };
+            const float longest = std::max({ (p[0] - p[1]).norm(), (p[1] - p[2]).norm(), (p[2] - p[0]).norm() });
+            for (int k = 0; k < 3; ++k) {
+                float& edge = taskEdges[t][grid.cellOf(p[k])];
+                edge = std::max(edge, longest);
+            }
+        }
+    });
+    std::vector<float> cellEdge(cellCount, 0.0f);
+    for (const auto& edges : taskEdges) {
+        for (size_t cell = 0; cell < cellCount; ++cell) cellEdge[cell] = std::max(cellEdge[cell], edges[cell]);
+    }
+    std::vector<std::vector<float>>().swap(taskEdges);
+
+    // 3. 按顶点数递归二分格子得到块, 格子 -> 拥有它的块
+    const size_t target = std::max<size_t>(1, options.maxChunkVertices);
+    std::vector<CellBox> chunkBoxes;
+    splitCells(grid, cellVertices, CellBox { { 0, 0, 0 }, { grid.dims[0] - 1, grid.dims[1] - 1, grid.dims[2] - 1 } },
+               target, chunkBoxes);
+    const size_t chunkCount = chunkBoxes.size();
+    std::vector<std::uint32_t> cellChunk(cellCount, std::numeric_limits<std::uint32_t>::max());
+    for (size_t c = 0; c < chunkCount; ++c) {
+        chunkBoxes[c].forEachCell(grid, [&](size_t cell) { cellChunk[cell] = static_cast<std::uint32_t>(c); });
+    }
+    auto chunkOf = [&](const Eigen::Vector3f& p) { return cellChunk[grid.cellOf(p)]; };
+
+    // 4. 每块的重叠区: 从块出发按格子内的最长边走"环数"步能到达的格子,
+    //    环数 = 平滑迭代次数 + (需要法向或曲率时再加 1); 格子 -> 重叠区包含它的块(CSR, 列表按块号递增)
+    const int rings = std::max(0, options.smoothIterations) + ((options.computeNormals || options.computeCurvature) ? 1 : 0);
+    std::vector<std::vector<size_t>> haloCells(chunkCount);
+    {
+        std::vector<char> reached(cellCount, 0);
+        for (size_t c = 0; c < chunkCount; ++c) {
+            collectHalo(grid, cellEdge, chunkBoxes[c], rings, reached, haloCells[c]);
+            size_t haloVertices = 0;
+            for (size_t cell : haloCells[c]) haloVertices += cellVertices[cell];
+            if (haloVertices > HaloWarningFactor * target) {
+                std::cerr << "Warning: Chunk " << c << " holds " << haloVertices << " vertices with its halo (long edges nearby)" << std::endl;
+            }
+        }
+    }
+    std::vector<float>().swap(cellEdge);
+    std::vector<std::uint32_t>().swap(cellVertices);
+    std::vector<size_t> cellHaloOffsets(cellCount + 1, 0);
+    for (const auto& cells : haloCells) {
+        for (size_t cell : cells) ++cellHaloOffsets[cell + 1];
+    }
+    for (size_t cell = 0; cell < cellCount; ++cell) cellHaloOffsets[cell + 1] += cellHaloOffsets[cell];
+    std::vector<std::uint32_t> cellHaloChunks(cellHaloOffsets[cellCount]);
+    {
+        std::vector<size_t> cursor(cellHaloOffsets.begin(), cellHaloOffsets.end() - 1);
+        for (size_t c = 0; c < chunkCount; ++c) {
+            for (size_t cell : haloCells[c]) cellHaloChunks[cursor[cell]++] = static_cast<std::uint32_t>(c);
+            std::vector<size_t>().swap(haloCells[c]);
+        }
+    }
+
+    // 5. 面分桶: 面写入它的任一顶点所在格子的重叠区所属的所有块
+    const std::filesystem::path outPath(outputPath);
+    const std::filesystem::path tempDir = options.tempDirectory.empty()
+        ? (outPath.has_parent_path() ? outPath.parent_path() : std::filesystem::path("."))
+        : std::filesystem::path(options.tempDirectory);
+    const size_t bucketCapacity = std::max<size_t>(3 * 256, BucketBudgetBytes / sizeof(std::uint32_t) / chunkCount / 3 * 3);
+    std::vector<ChunkBucket> buckets(chunkCount);
+    for (size_t c = 0; c < chunkCount; ++c) {
+        buckets[c].path = (tempDir / (outPath.filename().string() + ".chunk" + std::to_string(c) + ".tmp")).string();
+        // 桶文件以追加方式写入, 删不掉的旧文件会混进结果
+        std::error_code ec;
+        std::filesystem::remove(buckets[c].path, ec);
+        if (ec) {
+            std::cerr << "Error: Cannot remove stale temporary file " << buckets[c].path << ": " << ec.message() << std::endl;
+            return false;
+        }
+        buckets[c].buffer.reserve(bucketCapacity);
+    }
+    auto removeTemp = [&]() {
+        std::error_code ec;
+        for (const auto& bucket : buckets) std::filesystem::remove(bucket.path, ec);
+    };
+    // 索引越界的面不参与处理, 也不写入输出; 记下它们的下标, 输出时跳过
+    std::vector<size_t> invalidFaces;
+    std::vector<std::uint32_t> targets;
+    for (size_t f = 0; f < nF; ++f) {
+        std::uint32_t tri[3];
+        input.triangle(f, tri);
+        if (!isValid(tri)) {
+            invalidFaces.push_back(f);
+            continue;
+        }
+        targets.clear();
+        for (int k = 0; k < 3; ++k) {
+            const size_t cell = grid.cellOf(input.position(tri[k]));
+            targets.insert(targets.end(), cellHaloChunks.begin() + cellHaloOffsets[cell],
+                           cellHaloChunks.begin() + cellHaloOffsets[cell + 1]);
+        }
+        std::sort(targets.begin(), targets.end());
+        targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+        for (std::uint32_t c : targets) {
+            ChunkBucket& bucket = buckets[c];
+            bucket.buffer.insert(bucket.buffer.end(), tri, tri + 3);
+            ++bucket.faceCount;
+            if (bucket.buffer.size() >= bucketCapacity && !bucket.flush()) {
+                std::cerr << "Error: Failed to write temporary file " << bucket.path << std::endl;
+                removeTemp();
+                return false;
+            }
+        }
+    }
+    std::vector<size_t>().swap(cellHaloOffsets);
+    std::vector<std::uint32_t>().swap(cellHaloChunks);
+    for (auto& bucket : buckets) {
+        if (!bucket.flush()) {
+            std::cerr << "Error: Failed to write temporary file " << bucket.path << std::endl;
+            removeTemp();
+            return false;
+        }
+        std::vector<std::uint32_t>().swap(bucket.buffer);
+    }
+    if (!invalidFaces.empty()) {
+        std::cerr << "Warning: Skipping " << invalidFaces.size() << " face(s) with invalid vertex indices" << std::endl;
+    }
+
+    // 6. 输出文件: 头部 + 顶点块(先写原始位置, 处理后按块覆盖) + 面块(有效的面按原顺序直接转写)
+    const size_t floatsPerVertex = 3 + (options.computeNormals ? 3 : 0) + (options.computeCurvature ? 1 : 0);
+    const size_t vertexBytes = floatsPerVertex * sizeof(float);
+    constexpr size_t faceBytes = 1 + 3 * sizeof(std::int32_t);
+    std::string header = "ply\nformat ";
+    header += std::endian::native == std::endian::big ? "binary_big_endian" : "binary_little_endian";
+    header += " 1.0\nelement vertex " + std::to_string(nV) + "\nproperty float x\nproperty float y\nproperty float z\n";
+    if (options.computeNormals) header += "property float nx\nproperty float ny\nproperty float nz\n";
+    if (options.computeCurvature) header += "property float curvature\n";
+    const size_t outputFaces = nF - invalidFaces.size();
+    header += "element face " + std::to_string(outputFaces) + "\nproperty list uchar int vertex_indices\nend_header\n";
+    // 第 i 个输出面的输入下标为 i + k, k 是满足 invalidFaces[j] - j <= i 的 j 的个数(该序列不减)
+    std::vector<size_t> invalidShift(invalidFaces.size());
+    for (size_t j = 0; j < invalidFaces.size(); ++j) invalidShift[j] = invalidFaces[j] - j;
+    {
+        std::ofstream out(outputPath, std::ios::binary | std::ios::trunc);
+        bool ok = static_cast<bool>(out.write(header.data(), static_cast<std::streamsize>(header.size())));
+        ok = ok && writeRecords(out, nV, vertexBytes, [&](size_t v, char* dst) {
+            float record[7] = {};
+            const Eigen::Vector3f p = input.position(v);
+            record[0] = p.x();
+            record[1] = p.y();
+            record[2] = p.z();
+            std::memcpy(dst, record, vertexBytes);
+        });
+        ok = ok && writeRecords(out, outputFaces, faceBytes, [&](size_t i, char* dst) {
+            const size_t skipped = std::upper_bound(invalidShift.begin(), invalidShift.end(), i) - invalidShift.begin();
+            std::uint32_t tri[3];
+            input.triangle(i + skipped, tri);
+            dst[0] = 3;
+            std::memcpy(dst + 1, tri, sizeof(tri));
+        });
+        if (!ok) {
+            std::cerr << "Error: Failed to write " << outputPath << std::endl;
+            removeTemp();
+            return false;
+        }
+    }
+
+    // 7. 逐块处理, 只写回本块拥有的顶点
+    std::fstream out(outputPath, std::ios::binary | std::ios::in | std::ios::out);
+    if (!out) {
+        std::cerr << "Error: Failed to reopen " << outputPath << std::endl;
+        removeTemp();
+        return false;
+    }
+    StreamingStats result;
+    result.chunkCount = chunkCount;
+    for (size_t c = 0; c < chunkCount; ++c) {
+        std::vector<std::uint32_t> triangles(buckets[c].faceCount * 3);
+        if (!triangles.empty()) {
+            std::ifstream in(buckets[c].path, std::ios::binary);
+            in.read(reinterpret_cast<char*>(triangles.data()), static_cast<std::streamsize>(triangles.size() * sizeof(std::uint32_t)));
+            if (!in) {
+                std::cerr << "Error: Failed to read temporary file " << buckets[c].path << std::endl;
+                removeTemp();
+                return false;
+            }
+        }
+        std::error_code ec;
+        std::filesystem::remove(buckets[c].path, ec);
+        if (ec) {
+            std::cerr << "Warning: Cannot remove temporary file " << buckets[c].path << ": " << ec.message() << std::endl;
+        }
+
+        // 全局顶点号 -> 局部顶点号(按首次出现顺序)
+        std::unordered_map<std::uint32_t, int> localIndex;
+        localIndex.reserve(triangles.size() / 2);
+        std::vector<std::uint32_t> globalIndex;
+        std::vector<Eigen::Vector3f> positions;
+        std::vector<std::vector<int>> faces(triangles.size() / 3);
+        for (size_t f = 0; f < faces.size(); ++f) {
+            faces[f].resize(3);
+            for (int k = 0; k < 3; ++k) {
+                const std::uint32_t g = triangles[3 * f + k];
+                auto [it, inserted] = localIndex.try_emplace(g, static_cast<int>(globalIndex.size()));
+                if (inserted) {
+                    globalIndex.push_back(g);
+                    positions.push_back(input.position(g));
+                }
+                faces[f][k] = it->second;
+            }
+        }
+        std::vector<std::uint32_t>().swap(triangles);
+        if (faces.empty()) continue; // 只有孤立顶点的块: 位置已原样写出
+        result.maxLocalVertices = std::max(result.maxLocalVertices, positions.size());
+        result.maxLocalFaces = std::max(result.maxLocalFaces, faces.size());
+
+        // 本块拥有的顶点: 原始坐标落在本块的格子内
+        std::vector<std::pair<std::uint32_t, int>> owned;
+        for (size_t i = 0; i < positions.size(); ++i) {
+            if (chunkOf(positions[i]) == c) owned.emplace_back(globalIndex[i], static_cast<int>(i));
+        }
+        std::sort(owned.begin(), owned.end());
+
+        MeshKernelf kernel;
+        kernel.build(positions, faces);
+        std::vector<std::vector<int>>().swap(faces);
+        if (options.smoothIterations > 0) kernel.laplacianSmooth(options.smoothIterations, options.smoothLambda);
+        std::vector<Eigen::Vector3f> normals;
+        std::vector<float> curvature;
+        if (options.computeNormals) kernel.computeVertexNormals(normals);
+        if (options.computeCurvature) kernel.computeMeanCurvature(curvature);
+
+        // 全局编号连续的顶点合并成一次写入
+        std::vector<char> run;
+        for (size_t k = 0; k < owned.size();) {
+            size_t end = k + 1;
+            while (end < owned.size() && owned[end].first == owned[end - 1].first + 1) ++end;
+            run.resize((end - k) * vertexBytes);
+            for (size_t j = k; j < end; ++j) {
+                const int i = owned[j].second;
+                float record[7];
+                size_t n = 0;
+                const Eigen::Vector3f& p = kernel.position(i);
+                record[n++] = p.x();
+                record[n++] = p.y();
+                record[n++] = p.z();
+                if (options.computeNormals) {
+                    record[n++] = normals[i].x();
+                    record[n++] = normals[i].y();
+                    record[n++] = normals[i].z();
+                }
+                if (options.computeCurvature) record[n++] = curvature[i];
+                std::memcpy(run.data() + (j - k) * vertexBytes, record, vertexBytes);
+            }
+            out.seekp(static_cast<std::streamoff>(header.size() + static_cast<size_t>(owned[k].first) * vertexBytes));
+            out.write(run.data(), static_cast<std::streamsize>(run.size()));
+            k = end;
+        }
+        if (!out) {
+            std::cerr << "Error: Failed to write " << outputPath << std::endl;
+            removeTemp();
+            return false;
+        }
+    }
+
+    std::cout << "Out-of-core processing finished: " << chunkCount << " chunks, max chunk " << result.maxLocalVertices << " vertices / " << result.maxLocalFaces << " faces" << std::endl;
+    if (stats) *stats = result;
+    return true;
+}
+
+} // namespace geometry
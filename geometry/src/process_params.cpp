@@ -0,0 +1,69 @@
+﻿#include "process_params.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <iostream>
+
+namespace geometry {
+
+namespace {
+
+/// 整个字符串都被解析时才算成功
+template <class T>
+bool parseNumber(const std::string& text, T& value) {
+    const char* end = text.data() + text.size();
+    const auto result = std::from_chars(text.data(), end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+void warnInvalid(const std::string& key, const std::string& text, const char* expected) {
+    std::cerr << "Warning: Parameter " << key << "=" << text << " is not " << expected << ", using default" << std::endl;
+}
+
+} // namespace
+
+bool ProcessParams::parse(std::string_view assignment) {
+    const size_t eq = assignment.find('=');
+    if (eq == std::string_view::npos || eq == 0) {
+        std::cerr << "Error: Expected key=value, got '" << assignment << "'" << std::endl;
+        return false;
+    }
+    set(std::string(assignment.substr(0, eq)), std::string(assignment.substr(eq + 1)));
+    return true;
+}
+
+std::string ProcessParams::getString(const std::string& key, const std::string& fallback) const {
+    const auto it = values.find(key);
+    return it == values.end() ? fallback : it->second;
+}
+
+double ProcessParams::getDouble(const std::string& key, double fallback) const {
+    const auto it = values.find(key);
+    if (it == values.end()) return fallback;
+    double value = 0.0;
+    if (parseNumber(it->second, value)) return value;
+    warnInvalid(key, it->second, "a number");
+    return fallback;
+}
+
+int ProcessParams::getInt(const std::string& key, int fallback) const {
+    const auto it = values.find(key);
+    if (it == values.end()) return fallback;
+    int value = 0;
+    if (parseNumber(it->second, value)) return value;
+    warnInvalid(key, it->second, "an integer");
+    return fallback;
+}
+
+bool ProcessParams::getBool(const std::string& key, bool fallback) const {
+    const auto it = values.find(key);
+    if (it == values.end()) return fallback;
+    std::string text = it->second;
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (text == "1" || text == "true" || text == "on" || text == "yes") return true;
+    if (text == "0" || text == "false" || text == "off" || text == "no") return false;
+    warnInvalid(key, it->second, "a boolean");
+    return fallback;
+}
+
+} // namespace geometry
@@ -0,0 +1,162 @@
+﻿#include "thread_pool.h"
+#include <algorithm>
+#include <exception>
+
+namespace geometry {
+namespace parallel {
+
+namespace {
+// 当前线程所属的线程池和 worker 编号(池外线程为 nullptr)
+thread_local const ThreadPool* currentPool = nullptr;
+thread_local size_t currentWorker = 0;
+}
+
+/// 一次 run() 调用; 放在发起线程的栈上, 所有任务结束前不会销毁
+struct ThreadPool::Batch {
+    void (*call)(void*, unsigned);
+    void* context;
+    std::atomic<unsigned> remaining;
+    std::mutex mutex;
+    std::condition_variable done;
+    std::exception_ptr error;
+};
+
+ThreadPool::ThreadPool(unsigned workerCount) {
+    workerCount = std::max(1u, workerCount);
+    for (unsigned i = 0; i <= workerCount; ++i) queues.push_back(std::make_unique<Queue>());
+    workers.reserve(workerCount);
+    for (unsigned i = 0; i < workerCount; ++i) {
+        workers.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& w : workers) w.join();
+}
+
+ThreadPool& ThreadPool::global() {
+    static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return pool;
+}
+
+bool ThreadPool::isWorkerThread() const { return currentPool == this; }
+
+size_t ThreadPool::queueIndex() const { return currentPool == this ? currentWorker : workers.size(); }
+
+void ThreadPool::notifyWorkers(size_t count) {
+    // 先经过 sleepMutex 再通知: worker 检查 pending 和进入等待是在锁内完成的, 不会错过这次唤醒
+    { std::lock_guard<std::mutex> lock(sleepMutex); }
+    if (count == 1) wake.notify_one();
+    else wake.notify_all();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(taskMutex);
+        tasks.push_back(std::move(task));
+    }
+    pending.fetch_add(1);
+    notifyWorkers(1);
+}
+
+void ThreadPool::runBatch(unsigned count, void (*call)(void*, unsigned), void* context) {
+    Batch batch;
+    batch.call = call;
+    batch.context = context;
+    batch.remaining.store(count);
+
+    const size_t self = queueIndex();
+    {
+        // 倒序压入尾部: 自己从尾部按 1, 2, ... 的顺序取, 窃取者从头部拿走编号最大的
+        Queue& queue = *queues[self];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        for (unsigned t = count - 1; t >= 1; --t) queue.items.push_back({ &batch, t });
+    }
+    pending.fetch_add(count - 1);
+    notifyWorkers(count - 1);
+
+    execute({ &batch, 0 });
+    Item item;
+    while (batch.remaining.load() > 0 && takeItem(self, item)) execute(item);
+
+    // 剩下的任务都已被其他线程取走; 在锁内确认完成, 保证最后一个任务已经离开 batch 再销毁它
+    std::unique_lock<std::mutex> lock(batch.mutex);
+    batch.done.wait(lock, [&]() { return batch.remaining.load() == 0; });
+    if (batch.error) std::rethrow_exception(batch.error);
+}
+
+void ThreadPool::execute(const Item& item) {
+    Batch& batch = *item.batch;
+    std::exception_ptr error;
+    try {
+        batch.call(batch.context, item.index);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    std::lock_guard<std::mutex> lock(batch.mutex);
+    if (error && !batch.error) batch.error = error;
+    if (batch.remaining.fetch_sub(1) == 1) batch.done.notify_all();
+}
+
+bool ThreadPool::takeItem(size_t self, Item& item) {
+    {
+        Queue& own = *queues[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.items.empty()) {
+            item = own.items.back();
+            own.items.pop_back();
+            pending.fetch_sub(1);
+            return true;
+        }
+    }
+    const size_t n = queues.size();
+    for (size_t k = 1; k < n; ++k) {
+        Queue& victim = *queues[(self + k) % n];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.items.empty()) {
+            item = victim.items.front();
+            victim.items.pop_front();
+            pending.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::takeTask(std::function<void()>& task) {
+    std::lock_guard<std::mutex> lock(taskMutex);
+    if (tasks.empty()) return false;
+    task = std::move(tasks.front());
+    tasks.pop_front();
+    pending.fetch_sub(1);
+    return true;
+}
+
+void ThreadPool::workerLoop(size_t id) {
+    currentPool = this;
+    currentWorker = id;
+    Item item;
+    std::function<void()> task;
+    for (;;) {
+        if (takeItem(id, item)) {
+            execute(item);
+            continue;
+        }
+        if (takeTask(task)) {
+            task();
+            task = nullptr; // 尽早释放任务捕获的数据
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [&]() { return stopping || pending.load() > 0; });
+        if (stopping && pending.load() == 0) return;
+    }
+}
+
+} // namespace parallel
+} // namespace geometry
@@ -0,0 +1,269 @@
+﻿#include "tri_mesh.h"
+#include "kernel_algorithms.h"
+#include "parallel.h"
+#include <algorithm>
+#include <iostream>
+
+namespace geometry {
+
+// ============================================================================
+// 构建
+// ============================================================================
+
+template <class Scalar>
+void BasicTriangleMesh<Scalar>::clear() {
+    positions.clear();
+    vHalfEdge.clear();
+    heVertex.clear();
+    heTwin.clear();
+}
+
+template <class Scalar>
+void BasicTriangleMesh<Scalar>::build(const std::vector<Eigen::Vector3d>& vertexPositions,
+                                      const std::vector<std::vector<int>>& faceIndices) {
+    clear();
+    if (vertexPositions.empty() || faceIndices.empty()) {
+        return;
+    }
+    positions.resize(vertexPositions.size());
+    for (size_t i = 0; i < vertexPositions.size(); ++i) {
+        positions[i] = vertexPositions[i].template cast<Scalar>();
+    }
+    buildTopology(faceIndices);
+}
+
+template <class Scalar>
+void BasicTriangleMesh<Scalar>::build(const std::vector<Eigen::Vector3f>& vertexPositions,
+                                      const std::vector<std::vector<int>>& faceIndices) {
+    clear();
+    if (vertexPositions.empty() || faceIndices.empty()) {
+        return;
+    }
+    positions.resize(vertexPositions.size());
+    for (size_t i = 0; i < vertexPositions.size(); ++i) {
+        positions[i] = vertexPositions[i].template cast<Scalar>();
+    }
+    buildTopology(faceIndices);
+}
+
+/**
+ * @brief 由面列表建立三角形半边结构
+ *
+ * 步骤:
+ * 1. 写入每个三角形的三个角点(多边形按扇形三角化), 半边 3f + k 的起点即第 k 个角点
+ * 2. 以 (min, max) 为键基数排序, 键相同且方向相反的恰好两条半边互为对偶,
+ *    其余(边界、非流形、方向不一致)都没有对偶
+ * 3. 顶点出边: 边界顶点取扇形的第一条出边, 保证沿 rotate 能覆盖完整扇形
+ */
+template <class Scalar>
+void BasicTriangleMesh<Scalar>::buildTopology(const std::vector<std::vector<int>>& faceIndices) {
+    const Index nV = static_cast<Index>(positions.size());
+
+    // 1. 三角形角点
+    heVertex.reserve(faceIndices.size() * 3);
+    size_t triangulated = 0;
+    for (size_t faceIdx = 0; faceIdx < faceIndices.size(); ++faceIdx) {
+        const auto& faceVerts = faceIndices[faceIdx];
+        if (faceVerts.size() < 3) {
+            std::cerr << "Warning: Skipping face " << faceIdx << " with less than 3 vertices" << std::endl;
+            continue;
+        }
+        bool validFace = true;
+        for (int vertexIdx : faceVerts) {
+            if (vertexIdx < 0 || vertexIdx >= nV) {
+                std::cerr << "Error: Invalid vertex index " << vertexIdx << " in face " << faceIdx << std::endl;
+                validFace = false;
+                break;
+            }
+        }
+        if (!validFace) continue;
+        if (faceVerts.size() > 3) ++triangulated;
+        for (size_t k = 1; k + 1 < faceVerts.size(); ++k) {
+            heVertex.push_back(faceVerts[0]);
+            heVertex.push_back(faceVerts[k]);
+            heVertex.push_back(faceVerts[k + 1]);
+        }
+    }
+    if (triangulated > 0) {
+        std::cerr << "Warning: TriangleMesh fan-triangulated " << triangulated
+                  << " polygon face(s)" << std::endl;
+    }
+
+    const Index nH = static_cast<Index>(heVertex.size());
+    if (nH == 0) {
+        positions.clear();
+        return;
+    }
+
+    // 2. 对偶配对
+    struct EdgeKey {
+        std::uint64_t key;
+        Index halfEdge;
+    };
+    const int bits = parallel::bitWidth(positions.size());
+    std::vector<EdgeKey> keys(nH);
+    parallel::parallelFor(0, static_cast<size_t>(nH), [&](size_t h) {
+        std::uint64_t a = static_cast<std::uint32_t>(heVertex[h]);
+        std::uint64_t b = static_cast<std::uint32_t>(heVertex[next(static_cast<Index>(h))]);
+        if (a > b) std::swap(a, b);
+        keys[h] = { (a << bits) | b, static_cast<Index>(h) };
+    });
+    parallel::parallelRadixSort(keys, 2 * bits, [](const EdgeKey& k) { return k.key; });
+
+    heTwin.assign(nH, InvalidIndex);
+    size_t nonManifold = 0;
+    for (size_t i = 0; i < keys.size();) {
+        size_t j = i + 1;
+        while (j < keys.size() && keys[j].key == keys[i].key) ++j;
+        const size_t count = j - i;
+        if (count == 2 && heVertex[keys[i].halfEdge] != heVertex[keys[i + 1].halfEdge]) {
+            heTwin[keys[i].halfEdge] = keys[i + 1].halfEdge;
+            heTwin[keys[i + 1].halfEdge] = keys[i].halfEdge;
+        } else if (count > 1) {
+            ++nonManifold; // 非流形或方向不一致: 各自保持边界
+        }
+        i = j;
+    }
+    if (nonManifold > 0) {
+        std::cerr << "Warning: TriangleMesh left " << nonManifold
+                  << " non-manifold edge(s) unpaired" << std::endl;
+    }
+
+    // 3. 顶点出边, 边界扇形的第一条出边优先
+    vHalfEdge.assign(nV, InvalidIndex);
+    for (Index h = 0; h < nH; ++h) {
+        Index& vh = vHalfEdge[heVertex[h]];
+        if (vh < 0 || heTwin[prev(h)] < 0) vh = h;
+    }
+
+    std::cout << "TriangleMesh built successfully: "
+              << nV << " vertices, "
+              << nH / 3 << " faces, "
+              << nH << " half-edges" << std::endl;
+}
+
+// ============================================================================
+// 拓扑查询
+// ============================================================================
+
+/**
+ * @brief 顶点度数(邻接顶点数), 边界顶点额外计入扇形末端的邻接顶点
+ */
+template <class Scalar>
+int BasicTriangleMesh<Scalar>::getDegree(Index v) const {
+    const Index start = vHalfEdge[v];
+    if (start < 0) return 0;
+    int degree = 0;
+    Index h = start;
+    do {
+        ++degree;
+        h = rotate(h);
+    } while (h >= 0 && h != start);
+    return h < 0 ? degree + 1 : degree;
+}
+
+// ============================================================================
+// 几何
+// ============================================================================
+
+template <class Scalar>
+typename BasicTriangleMesh<Scalar>::Vector3 BasicTriangleMesh<Scalar>::computeFaceNormal(Index f) const {
+    const Index* fv = faceVertices(f);
+    const AccumulatorVector3 p0 = positions[fv[0]].template cast<Accumulator>();
+    const AccumulatorVector3 p1 = positions[fv[1]].template cast<Accumulator>();
+    const AccumulatorVector3 p2 = positions[fv[2]].template cast<Accumulator>();
+    AccumulatorVector3 normal = (p1 - p0).cross(p2 - p0);
+    if (normal.norm() > 0) normal.normalize();
+    return normal.template cast<Scalar>();
+}
+
+template <class Scalar>
+typename BasicTriangleMesh<Scalar>::Accumulator BasicTriangleMesh<Scalar>::computeFaceArea(Index f) const {
+    const Index* fv = faceVertices(f);
+    const AccumulatorVector3 p0 = positions[fv[0]].template cast<Accumulator>();
+    const AccumulatorVector3 p1 = positions[fv[1]].template cast<Accumulator>();
+    const AccumulatorVector3 p2 = positions[fv[2]].template cast<Accumulator>();
+    return 0.5 * (p1 - p0).cross(p2 - p0).norm();
+}
+
+template <class Scalar>
+typename BasicTriangleMesh<Scalar>::Accumulator BasicTriangleMesh<Scalar>::getTotalSurfaceArea() const {
+    Accumulator total = 0.0;
+    const Index nF = static_cast<Index>(getFaceCount());
+    for (Index f = 0; f < nF; ++f) {
+        total += computeFaceArea(f);
+    }
+    return total;
+}
+
+template <class Scalar>
+void BasicTriangleMesh<Scalar>::computeVertexNormals(std::vector<Vector3>& normals) const {
+    detail::computeVertexNormals(*this, normals);
+}
+
+template <class Scalar>
+void BasicTriangleMesh<Scalar>::computeMeanCurvature(std::vector<Scalar>& curvature) const {
+    detail::computeMeanCurvature(*this, curvature);
+}
+
+template <class Scalar>
+void BasicTriangleMesh<Scalar>::laplacianSmooth(int iterations, Accumulator lambda) {
+    detail::laplacianSmooth(*this, iterations, lambda);
+}
+
+/**
+ * @brief 检查数组尺寸与拓扑一致性
+ */
+template <class Scalar>
+bool BasicTriangleMesh<Scalar>::isValid() const {
+    const Index nV = static_cast<Index>(positions.size());
+    const Index nH = static_cast<Index>(heVertex.size());
+    if (nH % 3 != 0 || heTwin.size() != heVertex.size() || vHalfEdge.size() != positions.size()) {
+        std::cerr << "TriangleMesh arrays have inconsistent sizes" << std::endl;
+        return false;
+    }
+    for (Index h = 0; h < nH; ++h) {
+        const Index t = heTwin[h];
+        if (heVertex[h] < 0 || heVertex[h] >= nV || t >= nH) {
+            std::cerr << "TriangleMesh half-edge " << h << " has invalid references" << std::endl;
+            return false;
+        }
+        if (t >= 0 && (heTwin[t] != h || heVertex[t] != toVertex(h))) {
+            std::cerr << "TriangleMesh half-edge " << h << " twin connection broken" << std::endl;
+            return false;
+        }
+    }
+    for (Index v = 0; v < nV; ++v) {
+        const Index h = vHalfEdge[v];
+        if (h >= 0 && heVertex[h] != v) {
+            std::cerr << "TriangleMesh vertex " << v << " outgoing half-edge broken" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class Scalar>
+size_t BasicTriangleMesh<Scalar>::memoryUsage() const {
+    return positions.capacity() * sizeof(Vector3)
+         + (vHalfEdge.capacity() + heVertex.capacity() + heTwin.capacity()) * sizeof(Index);
+}
+
+// ============================================================================
+// 与 HalfEdgeMesh 的适配
+// ============================================================================
+
+template <class Scalar>
+BasicTriangleMesh<Scalar> BasicTriangleMesh<Scalar>::fromHalfEdgeMesh(const HalfEdgeMesh& mesh) {
+    return detail::fromHalfEdgeMesh<BasicTriangleMesh>(mesh);
+}
+
+template <class Scalar>
+void BasicTriangleMesh<Scalar>::toHalfEdgeMesh(HalfEdgeMesh& mesh) const {
+    detail::toHalfEdgeMesh(*this, mesh);
+}
+
+template class BasicTriangleMesh<float>;
+template class BasicTriangleMesh<double>;
+
+} // namespace geometry
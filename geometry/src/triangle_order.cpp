@@ -0,0 +1,211 @@
+﻿#include "triangle_order.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <Eigen/Dense>
+
+namespace geometry {
+
+namespace {
+
+constexpr size_t MaxClusterTriangles = 2048; ///< 过度绘制排序中簇的最大三角形数
+
+/**
+ * @brief Tipsify 三角形顺序
+ * @param order 输出, 三角形的新顺序(新位置 -> 旧三角形)
+ * @param clusterStarts 输出, 簇在 order 中的起始位置(第一个为 0)
+ */
+void tipsify(std::span<const std::uint32_t> indices, size_t vertexCount, int cacheSize,
+             std::vector<std::uint32_t>& order, std::vector<size_t>& clusterStarts) {
+    const size_t triangleCount = indices.size() / 3;
+
+    // 顶点 -> 相邻三角形(CSR)
+    std::vector<std::uint32_t> offsets(vertexCount + 1, 0);
+    for (std::uint32_t v : indices) ++offsets[v + 1];
+    for (size_t v = 0; v < vertexCount; ++v) offsets[v + 1] += offsets[v];
+    std::vector<std::uint32_t> adjacency(indices.size());
+    {
+        std::vector<std::uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t k = 0; k < indices.size(); ++k) adjacency[cursor[indices[k]]++] = static_cast<std::uint32_t>(k / 3);
+    }
+    std::vector<std::uint32_t> live(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) live[v] = offsets[v + 1] - offsets[v];
+
+    std::vector<std::int64_t> cacheTime(vertexCount, -static_cast<std::int64_t>(cacheSize) - 1);
+    std::vector<char> emitted(triangleCount, 0);
+    std::vector<std::uint32_t> deadEnd;     // 最近输出的顶点, 用来在扇心用尽时就近找下一个扇心
+    std::vector<std::uint32_t> candidates;  // 本次扇形输出的顶点
+    std::int64_t time = cacheSize + 1;
+    size_t cursor = 0;                      // 按编号顺序扫描仍有剩余三角形的顶点
+
+    order.clear();
+    order.reserve(triangleCount);
+    clusterStarts.assign(1, 0);
+
+    auto skipDeadEnd = [&]() -> std::int64_t {
+        while (!deadEnd.empty()) {
+            const std::uint32_t d = deadEnd.back();
+            deadEnd.pop_back();
+            if (live[d] > 0) return d;
+        }
+        while (cursor < vertexCount) {
+            if (live[cursor] > 0) return static_cast<std::int64_t>(cursor);
+            ++cursor;
+        }
+        return -1;
+    };
+
+    std::int64_t fan = skipDeadEnd();
+    while (fan >= 0) {
+        // 簇太大时在扇形之间切开, 每次切开最多多出一个缓存大小的未命中
+        if (order.size() - clusterStarts.back() >= MaxClusterTriangles) clusterStarts.push_back(order.size());
+        candidates.clear();
+        for (std::uint32_t k = offsets[fan]; k < offsets[fan + 1]; ++k) {
+            const std::uint32_t t = adjacency[k];
+            if (emitted[t]) continue;
+            emitted[t] = 1;
+            order.push_back(t);
+            for (int c = 0; c < 3; ++c) {
+                const std::uint32_t v = indices[3 * t + c];
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                --live[v];
+                if (time - cacheTime[v] > cacheSize) cacheTime[v] = time++;
+            }
+        }
+
+        // 选择仍在缓存中、且输出其剩余三角形后不会被挤出缓存的最老顶点
+        std::int64_t next = -1;
+        std::int64_t bestPriority = -1;
+        for (std::uint32_t v : candidates) {
+            if (live[v] == 0) continue;
+            std::int64_t priority = 0;
+            if (time - cacheTime[v] + 2 * static_cast<std::int64_t>(live[v]) <= cacheSize) priority = time - cacheTime[v];
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                next = v;
+            }
+        }
+        if (next < 0) {
+            next = skipDeadEnd();
+            // 新扇心已不在缓存中时是真正的跳转, 作为簇边界
+            if (next >= 0 && time - cacheTime[next] > cacheSize && order.size() > clusterStarts.back()) {
+                clusterStarts.push_back(order.size());
+            }
+        }
+        fan = next;
+    }
+}
+
+/**
+ * @brief 簇按朝外程度排序(Sander 等的线性过度绘制排序)
+ * 每个簇的法向为面积加权的面法向之和, 中心为面积加权的三角形中心。
+ */
+void sortClustersForOverdraw(std::span<const std::uint32_t> indices, std::span<const float> positions,
+                             std::vector<std::uint32_t>& order, const std::vector<size_t>& clusterStarts) {
+    auto position = [&](std::uint32_t v) {
+        return Eigen::Vector3d(positions[3 * v], positions[3 * v + 1], positions[3 * v + 2]);
+    };
+    const size_t clusterCount = clusterStarts.size();
+    std::vector<Eigen::Vector3d> centers(clusterCount), normals(clusterCount);
+    std::vector<double> areas(clusterCount);
+    parallel::parallelFor(0, clusterCount, [&](size_t c) {
+        const size_t end = c + 1 < clusterCount ? clusterStarts[c + 1] : order.size();
+        Eigen::Vector3d center = Eigen::Vector3d::Zero();
+        Eigen::Vector3d normal = Eigen::Vector3d::Zero();
+        double area = 0.0;
+        for (size_t i = clusterStarts[c]; i < end; ++i) {
+            const std::uint32_t t = order[i];
+            const Eigen::Vector3d a = position(indices[3 * t]);
+            const Eigen::Vector3d b = position(indices[3 * t + 1]);
+            const Eigen::Vector3d p = position(indices[3 * t + 2]);
+            const Eigen::Vector3d n = (b - a).cross(p - a); // 长度为面积的两倍
+            const double w = n.norm();
+            center += w * (a + b + p) / 3.0;
+            normal += n;
+            area += w;
+        }
+        centers[c] = area > 0.0 ? Eigen::Vector3d(center / area) : position(indices[3 * order[clusterStarts[c]]]);
+        normals[c] = normal;
+        areas[c] = area;
+    }, 64);
+
+    Eigen::Vector3d meshCenter = Eigen::Vector3d::Zero();
+    double totalArea = 0.0;
+    for (size_t c = 0; c < clusterCount; ++c) {
+        meshCenter += areas[c] * centers[c];
+        totalArea += areas[c];
+    }
+    if (totalArea > 0.0) meshCenter /= totalArea;
+
+    std::vector<std::pair<double, std::uint32_t>> keys(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c) {
+        keys[c] = { (centers[c] - meshCenter).dot(normals[c]), static_cast<std::uint32_t>(c) };
+    }
+    std::stable_sort(keys.begin(), keys.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    std::vector<std::uint32_t> sorted;
+    sorted.reserve(order.size());
+    for (const auto& key : keys) {
+        const size_t c = key.second;
+        const size_t end = c + 1 < clusterCount ? clusterStarts[c + 1] : order.size();
+        sorted.insert(sorted.end(), order.begin() + clusterStarts[c], order.begin() + end);
+    }
+    order.swap(sorted);
+}
+
+} // namespace
+
+double computeACMR(std::span<const std::uint32_t> indices, size_t vertexCount, int cacheSize) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) return 0.0;
+    // FIFO: 只有未命中时入队, 顶点入队后又有 cacheSize 个顶点入队即被挤出
+    std::vector<std::int64_t> stamp(vertexCount, -static_cast<std::int64_t>(cacheSize) - 1);
+    std::int64_t time = 0;
+    size_t misses = 0;
+    for (size_t k = 0; k < 3 * triangleCount; ++k) {
+        const std::uint32_t v = indices[k];
+        if (v >= vertexCount) {
+            ++misses;
+            continue;
+        }
+        if (time - stamp[v] >= cacheSize) {
+            stamp[v] = ++time;
+            ++misses;
+        }
+    }
+    return static_cast<double>(misses) / static_cast<double>(triangleCount);
+}
+
+void optimizeTriangleOrder(std::span<std::uint32_t> indices, size_t vertexCount, std::span<const float> positions,
+                           int cacheSize, TriangleOrderStats* stats) {
+    const size_t triangleCount = indices.size() / 3;
+    const double before = computeACMR(indices, vertexCount, cacheSize);
+    if (stats) *stats = TriangleOrderStats { before, before, 0 };
+    if (triangleCount == 0 || cacheSize < 3) return;
+    if (std::any_of(indices.begin(), indices.begin() + 3 * triangleCount, [&](std::uint32_t v) { return v >= vertexCount; })) {
+        std::cerr << "Warning: Index buffer references missing vertices, triangle order left unchanged" << std::endl;
+        return;
+    }
+
+    std::vector<std::uint32_t> order;
+    std::vector<size_t> clusterStarts;
+    tipsify(indices, vertexCount, cacheSize, order, clusterStarts);
+    const bool sortClusters = positions.size() >= 3 * vertexCount && clusterStarts.size() > 1;
+    if (sortClusters) sortClustersForOverdraw(indices, positions, order, clusterStarts);
+
+    std::vector<std::uint32_t> reordered(3 * triangleCount);
+    parallel::parallelFor(0, triangleCount, [&](size_t i) {
+        for (int c = 0; c < 3; ++c) reordered[3 * i + c] = indices[3 * order[i] + c];
+    });
+    std::copy(reordered.begin(), reordered.end(), indices.begin());
+
+    if (stats) {
+        stats->acmrAfter = computeACMR(indices, vertexCount, cacheSize);
+        stats->clusters = sortClusters ? clusterStarts.size() : 0;
+    }
+}
+
+} // namespace geometry
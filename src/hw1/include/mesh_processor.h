@@ -4,6 +4,7 @@
 #include <vector>
 #include <utility>
 #include <halfedge.h>
+#include <process_context.h>
 
 /**
  * @brief ࣬ڽOBJתΪ߽ṹмδ
@@ -32,11 +33,15 @@ public:
      * 
      * @param vertices Ķλ飨QVector3Dʽ
      * @param indices 
+     * @param context ȡϱ; ȡʱ񲢷ؿս
+     * @param cache  vertices/indices Ӧİ߻(Ϊ), ʱֱ
      * @return Ķݶ
      */
     std::pair<std::vector<QVector3D>, std::vector<unsigned int>> 
     processOBJData(const std::vector<QVector3D>& vertices,
-                   const std::vector<unsigned int>& indices);
+                   const std::vector<unsigned int>& indices,
+                   const geometry::ProcessContext& context = {},
+                   const geometry::MeshCache* cache = nullptr);
 
     /**
      * @brief ȡǰİֻ
@@ -61,11 +66,12 @@ public:
      */
     std::vector<QVector3D> extractColors() const;
 
-    //  halfEdges  edgeColor (ɫʾ MST) ̬ȡ MST  (first < second)
+    // ڰɫ "h:color" (ɫʾ MST) ̬ȡ MST  (first < second)
     std::vector<std::pair<int,int>> extractMSTEdges() const;
 
 private:
     geometry::HalfEdgeMesh mesh;  ///< 󣬴洢ת
+    geometry::ProcessContext processContext; ///< ǰȡ/( processOBJData )
 
     /**
      * @brief ִоļδ
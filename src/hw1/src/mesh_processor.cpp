@@ -14,22 +14,31 @@
  * -------------------------------------------------------------------------- */
 std::pair<std::vector<QVector3D>, std::vector<unsigned int>>
 MeshProcessor::processOBJData(const std::vector<QVector3D>& vertices,
-                              const std::vector<unsigned int>& indices) {
-    geometry::MeshConverter::buildMeshFromQtData(mesh, vertices, indices);
+                              const std::vector<unsigned int>& indices,
+                              const geometry::ProcessContext& context,
+                              const geometry::MeshCache* cache) {
+    geometry::MeshConverter::buildMeshFromQtData(mesh, vertices, indices, cache);
+    context.setProgress(0.05);
+    processContext = context.subRange(0.05, 0.95); // δռ 5%-95%, Ϊת
     if (!mesh.isValid()) {
         std::cerr << "Warning: Generated half-edge mesh is invalid!" << std::endl;
     }
     std::vector<int> placeholder = {1, 2, 3, 4}; // ǰδʹ, Ԥӿ
     processGeometry(placeholder);
+    if (context.isCancelled()) {
+        mesh = geometry::HalfEdgeMesh(); // ȡ: ͬһͷ, Ҫ
+        return {};
+    }
     return geometry::MeshConverter::convertMeshToQtData(mesh);
 }
 
 /* ȡɫ (δ㷨д붥ɫ) */
 std::vector<QVector3D> MeshProcessor::extractColors() const {
     std::vector<QVector3D> cols; cols.reserve(mesh.vertices.size());
+    const auto* colors = mesh.getVertexProperty<Eigen::Vector3d>("v:color");
     for (const auto& vp : mesh.vertices) {
-        if (vp) {
-            const auto& c = vp->color;
+        if (vp && colors) {
+            const auto& c = (*colors)[vp->index];
             cols.emplace_back((float)c.x(), (float)c.y(), (float)c.z());
         } else {
             cols.emplace_back(1.f, 1.f, 1.f);
@@ -38,9 +47,11 @@ std::vector<QVector3D> MeshProcessor::extractColors() const {
     return cols;
 }
 
-/* ɨ halfEdges,  edgeColor==, 鲢Ϊ MST  */
+/* ɨ halfEdges, ɫ( "h:color")==, 鲢Ϊ MST  */
 std::vector<std::pair<int, int>> MeshProcessor::extractMSTEdges() const {
     std::vector<std::pair<int, int>> result;
+    const auto* edgeColor = mesh.getHalfEdgeProperty<Eigen::Vector3d>("h:color");
+    if (!edgeColor) return result;
     result.reserve(mesh.halfEdges.size() / 2);
     std::unordered_set<long long> used;
     auto keyFn = [](int a, int b) {
@@ -49,7 +60,7 @@ std::vector<std::pair<int, int>> MeshProcessor::extractMSTEdges() const {
     for (const auto& heUP : mesh.halfEdges) {
         auto* he = heUP.get();
         if (!he || !he->vertex || !he->next) continue;
-        if (he->edgeColor == Eigen::Vector3d(1, 0, 0)) {
+        if ((*edgeColor)[he->index] == Eigen::Vector3d(1, 0, 0)) {
             int a = he->vertex->index;
             int b = he->getEndVertex()->index;
             if (a == b) continue;
@@ -64,7 +75,7 @@ std::vector<std::pair<int, int>> MeshProcessor::extractMSTEdges() const {
 
 /* --------------------------------------------------------------------------
  * ļδ: е·(res),  Prim  MST,
- *  MST ߶Ӧ halfEdge.edgeColor Ϊɫ.
+ *  MST ߶Ӧ halfEdge ɫ "h:color" Ϊɫ.
  * -------------------------------------------------------------------------- */
 void MeshProcessor::processGeometry(std::vector<int>& /*indexPlaceholder*/) {
     int n = static_cast<int>(mesh.vertices.size());
@@ -78,7 +89,9 @@ void MeshProcessor::processGeometry(std::vector<int>& /*indexPlaceholder*/) {
 
     // 1. Դ· (ÿһ dijkstra)  Ӷȸ, ѧʾ
     for (int i = 0; i < n; ++i) {
+        if (processContext.isCancelled()) return; // res 溯ͷ
         res[i] = dijkstra(i, mesh);
+        processContext.setProgress(0.8 * (i + 1) / n);
     }
     std::cout << "==== Complete Graph Constructed ====\n";
 
@@ -91,6 +104,7 @@ void MeshProcessor::processGeometry(std::vector<int>& /*indexPlaceholder*/) {
     key[0] = 0.0;
 
     for (int c = 0; c < n; ++c) {
+        if ((c & 255) == 0 && processContext.isCancelled()) return;
         int u = -1; double minVal = static_cast<double>(INT_MAX);
         for (int i = 0; i < n; ++i) {
             if (!inMST[i] && key[i] < minVal) { minVal = key[i]; u = i; }
@@ -109,8 +123,13 @@ void MeshProcessor::processGeometry(std::vector<int>& /*indexPlaceholder*/) {
         }
     }
 
-    // 3. öɫΪ
-    for (auto& vp : mesh.vertices) if (vp) vp->color = Eigen::Vector3d(1, 1, 1);
+    processContext.setProgress(0.9);
+
+    // 3. öɫΪ, ɫĬϰɫ
+    auto& vertexColor = mesh.vertexProperty<Eigen::Vector3d>("v:color", Eigen::Vector3d::Ones());
+    auto& edgeColor = mesh.halfEdgeProperty<Eigen::Vector3d>("h:color", Eigen::Vector3d::Ones());
+    vertexColor.reset();
+    edgeColor.reset();
 
     // 4.  MST , ǶӦ halfEdge Ϊɫ
     int marked = 0;
@@ -123,8 +142,8 @@ void MeshProcessor::processGeometry(std::vector<int>& /*indexPlaceholder*/) {
                 do {
                     int endIdx = he->getEndVertex()->index;
                     if (endIdx == j) {
-                        he->edgeColor = Eigen::Vector3d(1, 0, 0);
-                        if (he->pair) he->pair->edgeColor = Eigen::Vector3d(1, 0, 0);
+                        edgeColor[he->index] = Eigen::Vector3d(1, 0, 0);
+                        if (he->pair) edgeColor[he->pair->index] = Eigen::Vector3d(1, 0, 0);
                         ++marked;
                         break;
                     }
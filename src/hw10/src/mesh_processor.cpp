@@ -1,13 +1,19 @@
 #include "mesh_processor.h"
 #include <mesh_converter.h>
+#include <mesh_kernel.h>
+#include <parallel.h>
 #include <iostream>
 
 std::pair<std::vector<QVector3D>, std::vector<unsigned int>> 
 MeshProcessor::processOBJData(const std::vector<QVector3D>& vertices,
-                              const std::vector<unsigned int>& indices) {
+                              const std::vector<unsigned int>& indices,
+                              const geometry::ProcessContext& context,
+                              const geometry::MeshCache* cache) {
     
     // 1ʹgeometryģMeshConverter
-    geometry::MeshConverter::buildMeshFromQtData(mesh, vertices, indices);
+    geometry::MeshConverter::buildMeshFromQtData(mesh, vertices, indices, cache);
+    context.setProgress(0.05);
+    processContext = context.subRange(0.05, 0.95); // δռ 5%-95%, Ϊת
 
     // 2֤߽ṹȷ
     if (!mesh.isValid()) {
@@ -17,116 +23,100 @@ MeshProcessor::processOBJData(const std::vector<QVector3D>& vertices,
     // 3ִʵʵļδҪԼʵֵĲ֣
     processGeometry();
 
+    if (context.isCancelled()) {
+        mesh = geometry::HalfEdgeMesh(); // ȡ: ͬһͷ, Ҫ
+        return {};
+    }
+
     // 4ʹgeometryģMeshConverterתQtʽ
     return geometry::MeshConverter::convertMeshToQtData(mesh);
 }
 
+namespace {
+
+/**
+ * @brief  Kernel(MeshKernel  MeshKernelf)Ȩ Laplace ƽ, д mesh Ķλ
+ * ں˰ vertex->index Ӧ; ÿελͳơϱȲȡ
+ */
+template <class Kernel>
+void smoothWithKernel(geometry::HalfEdgeMesh& mesh, int iterations, double lambda,
+                      const geometry::ProcessContext& context) {
+    using Vector3 = typename Kernel::Vector3;
+    Kernel kernel = Kernel::fromHalfEdgeMesh(mesh);
+    const size_t vertexCount = kernel.getVertexCount();
+    if (vertexCount != mesh.vertices.size()) {
+        std::cerr << "Warning: Mesh has no valid faces, smoothing skipped" << std::endl;
+        return;
+    }
+
+    // Сλ޹, ֻͳһ
+    const Eigen::Vector2i neighborStats = geometry::parallel::parallelSum(0, vertexCount, Eigen::Vector2i(0, 0), [&](size_t i) {
+        const int degree = kernel.getDegree(static_cast<typename Kernel::Index>(i));
+        return degree > 0 ? Eigen::Vector2i(1, degree) : Eigen::Vector2i(0, 0);
+    }, 1024);
+    const int verticesWithNeighbors = neighborStats[0];
+    const double avgNeighbors = verticesWithNeighbors > 0 ?
+        static_cast<double>(neighborStats[1]) / verticesWithNeighbors : 0.0;
+
+    kernel.laplacianSmooth(iterations, lambda, [&](int iteration, const std::vector<Vector3>& previous) {
+        // λͳ(ȷԲйԼ, ߳޹)
+        const Eigen::Vector2d displacementStats = geometry::parallel::parallelReduce(0, vertexCount, Eigen::Vector2d(0.0, 0.0),
+            [&](size_t i) {
+                const double displacement = (kernel.positions[i] - previous[i]).template cast<double>().norm();
+                return Eigen::Vector2d(displacement, displacement);
+            },
+            [](const Eigen::Vector2d& a, const Eigen::Vector2d& b) { return Eigen::Vector2d(a[0] + b[0], std::max(a[1], b[1])); });
+
+        std::cout << "Iteration " << iteration << ": "
+                  << "Avg displacement = " << displacementStats[0] / vertexCount
+                  << ", Max displacement = " << displacementStats[1] << std::endl;
+
+        // ÿ5εһϸϢ
+        if (iteration % 5 == 0) {
+            std::cout << "  -> Progress: " << (iteration * 100 / iterations) << "% "
+                      << "(Vertices with neighbors = " << verticesWithNeighbors
+                      << ", Avg neighbors = " << avgNeighbors << ")" << std::endl;
+        }
+        context.setProgress(iteration, iterations);
+        if (context.isCancelled()) {
+            std::cout << "==== Laplace Smoothing Cancelled after " << iteration << " iterations ====" << std::endl;
+            return false;
+        }
+        return true;
+    });
+
+    geometry::parallel::parallelFor(0, vertexCount, [&](size_t i) {
+        mesh.vertices[i]->position = kernel.positions[i].template cast<double>();
+    });
+}
+
+} // namespace
+
 void MeshProcessor::processGeometry() {
     // Laplaceƽ㷨 - 
     // 
-    const int iterations = 20;       // ӵ20
-    const double lambda = 0.9;       // ƽϵ0.9ӽ1ƽ
+    const int iterations = params.getInt("iterations", 20);   // Ĭӵ20
+    const double lambda = params.getDouble("lambda", 0.9);    // Ĭƽϵ0.9ӽ1ƽ
+    const std::string precision = params.getString("precision", "double");
     
     std::cout << "==== Laplace Smoothing Started ====" << std::endl;
     std::cout << "Vertices: " << mesh.vertices.size() << std::endl;
     std::cout << "Faces: " << mesh.faces.size() << std::endl;
-    std::cout << "Iterations: " << iterations << ", Lambda: " << lambda << std::endl;
+    std::cout << "Iterations: " << iterations << ", Lambda: " << lambda << ", Precision: " << precision << std::endl;
     std::cout << "WARNING: Using aggressive smoothing parameters!" << std::endl;
-    
-    for (int iter = 0; iter < iterations; ++iter) {
-        // 洢ÿλ
-        std::vector<Eigen::Vector3d> newPositions(mesh.vertices.size());
-        int verticesWithNeighbors = 0;
-        int totalNeighbors = 0;
-        
-        // ÿ򶥵ƽλ
-        for (size_t i = 0; i < mesh.vertices.size(); ++i) {
-            auto& vertex = mesh.vertices[i];
-            
-            // ռ򶥵㣨һ
-            std::vector<Eigen::Vector3d> neighborPositions;
-            
-            // ͨ߱򶥵
-            if (vertex->halfEdge) {
-                auto startHE = vertex->halfEdge;
-                auto currentHE = startHE;
-                int maxIterations = 100; // ֹѭ
-                int iterCount = 0;
-                
-                do {
-                    // ǰߵյ򶥵
-                    if (currentHE->next && currentHE->next->vertex) {
-                        neighborPositions.push_back(currentHE->next->vertex->position);
-                    }
-                    
-                    // ƶһΧƸöİ
-                    // ͨpairߵnextƶת
-                    if (currentHE->pair && currentHE->pair->next) {
-                        currentHE = currentHE->pair->next;
-                    } else {
-                        // ߽ûpair˵Ǳ߽
-                        break;
-                    }
-                    
-                    iterCount++;
-                    if (iterCount >= maxIterations) {
-                        std::cerr << "Warning: Potential infinite loop at vertex " << i << std::endl;
-                        break;
-                    }
-                    
-                } while (currentHE && currentHE != startHE);
-                
-                if (!neighborPositions.empty()) {
-                    verticesWithNeighbors++;
-                    totalNeighbors += neighborPositions.size();
-                }
-            }
-            
-            // 򶥵ƽλãLaplaceӣ
-            if (!neighborPositions.empty()) {
-                Eigen::Vector3d laplacian(0.0, 0.0, 0.0);
-                for (const auto& pos : neighborPositions) {
-                    laplacian += pos;
-                }
-                laplacian /= static_cast<double>(neighborPositions.size());
-                
-                // ʹüȨƽλ
-                // new_pos = old_pos + lambda * (laplacian - old_pos)
-                newPositions[i] = vertex->position + lambda * (laplacian - vertex->position);
-            } else {
-                // û򣨹߽磩ԭλ
-                newPositions[i] = vertex->position;
-            }
-        }
-        
-        // λͳ
-        double totalDisplacement = 0.0;
-        double maxDisplacement = 0.0;
-        
-        // жλ
-        for (size_t i = 0; i < mesh.vertices.size(); ++i) {
-            double displacement = (newPositions[i] - mesh.vertices[i]->position).norm();
-            totalDisplacement += displacement;
-            maxDisplacement = std::max(maxDisplacement, displacement);
-            
-            mesh.vertices[i]->position = newPositions[i];
-        }
-        
-        double avgDisplacement = totalDisplacement / mesh.vertices.size();
-        double avgNeighbors = verticesWithNeighbors > 0 ? 
-            static_cast<double>(totalNeighbors) / verticesWithNeighbors : 0.0;
-        
-        std::cout << "Iteration " << (iter + 1) << ": "
-                  << "Avg displacement = " << avgDisplacement
-                  << ", Max displacement = " << maxDisplacement << std::endl;
-        
-        // ÿ5εһϸϢ
-        if ((iter + 1) % 5 == 0) {
-            std::cout << "  -> Progress: " << ((iter + 1) * 100 / iterations) << "% "
-                      << "(Vertices with neighbors = " << verticesWithNeighbors
-                      << ", Avg neighbors = " << avgNeighbors << ")" << std::endl;
-        }
+    if (processContext.isCancelled()) {
+        std::cout << "==== Laplace Smoothing Cancelled after 0 iterations ====" << std::endl;
+        return;
     }
+
+    // ƽ洢ںϽ: һɽ±, ʱپָ
+    if (precision == "float") {
+        smoothWithKernel<geometry::MeshKernelf>(mesh, iterations, lambda, processContext);
+    } else {
+        if (precision != "double") std::cerr << "Warning: Unknown precision '" << precision << "', using double" << std::endl;
+        smoothWithKernel<geometry::MeshKernel>(mesh, iterations, lambda, processContext);
+    }
+    if (processContext.isCancelled()) return;
     
     std::cout << "==== Laplace Smoothing Completed ====" << std::endl;
-}
\ No newline at end of file
+}
@@ -24,24 +24,26 @@ int main(int argc, char* argv[])
     // 2ʵ첽
     MeshProcessor processor;
     AsyncMeshProcessor* asyncProcessor = new AsyncMeshProcessor(&window);
+    asyncProcessor->setQueuePolicy(AsyncMeshProcessor::QueuePolicy::LatestWins); // ظʱֻµ, ڽص
 
     // 첽
     asyncProcessor->setProcessFunction(
         [&processor](const std::vector<QVector3D>& vertices,
-            const std::vector<unsigned int>& indices) {
+            const std::vector<unsigned int>& indices,
+            const geometry::ProcessContext& context,
+            const geometry::MeshCache* cache) {
                 // ڶִ߳УUI
                 std::cout << "Processing mesh in worker thread..." << std::endl;
-                return processor.processOBJData(vertices, indices);
+                return processor.processOBJData(vertices, indices, context, cache);
         });
 
     // 3¼Ӧ·
 
     // 3.1 ڼOBJļʱ첽
     QObject::connect(&window, &MainWindow::objLoaded,
-        [asyncProcessor](const std::vector<QVector3D>& vertices,
-            const std::vector<unsigned int>& indices) {
+        [asyncProcessor](const MeshSnapshotPtr& mesh) {
                 std::cout << "OBJ file loaded, starting async processing..." << std::endl;
-                asyncProcessor->startProcessing(vertices, indices);
+                asyncProcessor->startProcessing(mesh);
         });
 
     // ʼʱķ
@@ -52,10 +54,9 @@ int main(int argc, char* argv[])
 
     // ʱʾ
     QObject::connect(asyncProcessor, &AsyncMeshProcessor::processingFinished,
-        [&window, &processor](const std::vector<QVector3D>& vertices,
-            const std::vector<unsigned int>& indices) {
+        [&window, &processor](const MeshSnapshotPtr& mesh) {
                 auto colors = processor.extractColors();
-                window.updateMeshWithColors(vertices, indices, colors);
+                window.updateMeshWithColors(mesh, colors);
                 std::cout << "Async mesh processing completed. Updating display..." << std::endl;
         });
 
@@ -67,6 +68,15 @@ int main(int argc, char* argv[])
                 "Mesh processing failed: " + errorMessage);
         });
 
+    // ȡťжϵǰ, ʾ״̬
+    QObject::connect(&window, &MainWindow::cancelRequested, asyncProcessor, &AsyncMeshProcessor::cancel);
+    QObject::connect(asyncProcessor, &AsyncMeshProcessor::progressUpdated, &window, &MainWindow::showProcessingProgress);
+    QObject::connect(asyncProcessor, &AsyncMeshProcessor::processingCancelled,
+        [&window]() {
+            std::cout << "Processing cancelled" << std::endl;
+            window.showProcessingCancelled();
+        });
+
     // 4ʾڲӦó¼ѭ
     window.show();
     return app.exec();
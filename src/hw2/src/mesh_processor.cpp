@@ -1,13 +1,20 @@
 ﻿#include "mesh_processor.h"
 #include <mesh_converter.h>
+#include <circulators.h>
+#include <parallel.h>
 #include <iostream>
+#include <limits>
 
 std::pair<std::vector<QVector3D>, std::vector<unsigned int>> 
 MeshProcessor::processOBJData(const std::vector<QVector3D>& vertices,
-                              const std::vector<unsigned int>& indices) {
+                              const std::vector<unsigned int>& indices,
+                              const geometry::ProcessContext& context,
+                              const geometry::MeshCache* cache) {
     
     // 步骤1：使用geometry模块的MeshConverter构建半边网格
-    geometry::MeshConverter::buildMeshFromQtData(mesh, vertices, indices);
+    geometry::MeshConverter::buildMeshFromQtData(mesh, vertices, indices, cache);
+    context.setProgress(0.05);
+    processContext = context.subRange(0.05, 0.95); // 几何处理占 5%-95%, 其余为构建和转换
 
     // 步骤2：验证半边结构的正确性
     if (!mesh.isValid()) {
@@ -17,17 +24,34 @@ MeshProcessor::processOBJData(const std::vector<QVector3D>& vertices,
     // 步骤3：执行实际的几何处理操作（这是需要自己实现的部分）
     processGeometry();
 
+    if (context.isCancelled()) {
+        mesh = geometry::HalfEdgeMesh(); // 取消: 连同属性一起释放, 结果不再需要
+        return {};
+    }
+
     // 步骤4：使用geometry模块的MeshConverter将结果转回Qt格式
     return geometry::MeshConverter::convertMeshToQtData(mesh);
 }
 
+namespace {
+
+/// 逐顶点曲率标量, 导出时写成 PLY 的 quality 属性; 没有计算的顶点(边界点)为 NaN
+geometry::Property<double>& curvatureQuality(geometry::HalfEdgeMesh& mesh) {
+    auto& quality = mesh.vertexProperty<double>("v:quality", std::numeric_limits<double>::quiet_NaN());
+    quality.reset(); // 处理器被重复使用时, 清掉上一次的结果
+    return quality;
+}
+
+} // namespace
+
 /* 提取顶点颜色 (若未来算法写入顶点颜色) */
 std::vector<QVector3D> MeshProcessor::extractColors() const {
     std::vector<QVector3D> cols; 
     cols.reserve(mesh.vertices.size());
+    const auto* colors = mesh.getVertexProperty<Eigen::Vector3d>("v:color");
     for (const auto& vp : mesh.vertices) {
-        if (vp) {
-            const auto& c = vp->color;
+        if (vp && colors) {
+            const auto& c = (*colors)[vp->index];
             cols.emplace_back((float)c.x(), (float)c.y(), (float)c.z());
         }
         else {
@@ -40,57 +64,57 @@ std::vector<QVector3D> MeshProcessor::extractColors() const {
 //homework2
 // 用的是封闭曲面
 void MeshProcessor::processGeometry() {
-    //meanCurvature();
-	cotangentCurvature();
-	//gaussianCurvature();
+	const std::string type = params.getString("type", "cotangent");
+	if (type == "mean") {
+		meanCurvature();
+	} else if (type == "gaussian") {
+		gaussianCurvature();
+	} else {
+		if (type != "cotangent") std::cerr << "Warning: Unknown curvature type '" << type << "', using cotangent" << std::endl;
+		cotangentCurvature();
+	}
 }
 //平均曲率实现
 void MeshProcessor::meanCurvature() {
-    int size = mesh.vertices.size();
+    auto& vertexColor = mesh.vertexProperty<Eigen::Vector3d>("v:color", Eigen::Vector3d::Ones());
+    auto& vertexQuality = curvatureQuality(mesh);
 
-    for (int i = 0; i < size; i++) {
+    // 每个顶点只写自己的颜色, 可以直接并行
+    geometry::parallel::forEachVertex(mesh, [&](geometry::Vertex* vi) {
         //对于每个顶点，计算它的一阶邻域对应的平均曲率
-        geometry::HalfEdge* hf = mesh.vertices[i]->halfEdge;
         Eigen::Vector3d mean_curvature = { 0 , 0, 0 };
         Eigen::Vector3d total_value = { 0 , 0, 0 };//记录定点数总和
         int count = 0;//记录这个邻域的大小
-        do {
-            total_value += hf->getEndVertex()->position;
+        for (geometry::Vertex* vj : geometry::vertexVertices(vi)) {
+            total_value += vj->position;
             count++;
-            hf = hf->pair->next;// 遍历下一个顶点
-        } while (hf != mesh.vertices[i]->halfEdge);
-        mean_curvature = mesh.vertices[i]->position * count - total_value;// 颜色对应基本系数
-        mesh.vertices[i]->color = mean_curvature * 255;
-    }
+        }
+        mean_curvature = vi->position * count - total_value;// 颜色对应基本系数
+        vertexColor[vi->index] = mean_curvature * 255;
+        vertexQuality[vi->index] = mean_curvature.norm();
+    });
 }
 // cotangent曲率实现
 void MeshProcessor::cotangentCurvature() {
 	int size = mesh.vertices.size();
+    auto& vertexColor = mesh.vertexProperty<Eigen::Vector3d>("v:color", Eigen::Vector3d::Ones());
+    auto& vertexQuality = curvatureQuality(mesh);
 
-    std::vector<double> curvature_magnitudes(size);
-    double global_max_mag = -1e10;
-    double global_min_mag = 1e10;
+    // 边界点不参与统计, 记为 NaN
+    std::vector<double> curvature_magnitudes(size, std::numeric_limits<double>::quiet_NaN());
 
-	//遍历每个顶点，先拿到一阶邻域的所有顶点个数
-    for (int i = 0; i < size; i++) {
-		if (mesh.vertices[i]->isBoundary()) continue;//跳过边界点
+	//遍历每个顶点，先拿到一阶邻域的所有顶点个数(各顶点互不依赖, 并行计算)
+    geometry::parallel::forEachVertex(mesh, [&](geometry::Vertex* vi) {
+		if (vi->isBoundary()) return;//跳过边界点
 		double area = 0.0;//记录区域面积
         Eigen::Vector3d cotangent_curvature = { 0, 0, 0 };
-		geometry::HalfEdge* hf = mesh.vertices[i]->halfEdge;
-        // 从这个点出发，先拿到所有的一阶邻域的顶点
-		std::vector<geometry::Vertex*> one_ring_vertices;
-        while(hf -> pair -> next != mesh.vertices[i]->halfEdge){
-            one_ring_vertices.push_back(hf->getEndVertex());
-            hf = hf->pair->next;
-		}
-		int one_ring_size = one_ring_vertices.size();
-
-        for (int j = 0; j < one_ring_size; j++) {
+        // 从这个点出发，依次遍历一阶邻域: 出边 hf 指向 v1, 环上前一个顶点 v0 和后一个顶点 v2
+        // 分别是 hf 两侧三角形的第三个顶点(即 cot 权重对应的两个对角顶点)
+        for (geometry::HalfEdge* hf : geometry::outgoingHalfEdges(vi)) {
 			//开始计算这个顶点的cotangent曲率
-			geometry::Vertex* v0 = one_ring_vertices[(j - 1 + one_ring_size) %one_ring_size];
-			geometry::Vertex* v1 = one_ring_vertices[j];
-			geometry::Vertex* v2 = one_ring_vertices[(j + 1)%one_ring_size];
-			geometry::Vertex* vi = mesh.vertices[i].get();
+			geometry::Vertex* v0 = hf->prev->vertex;
+			geometry::Vertex* v1 = hf->getEndVertex();
+			geometry::Vertex* v2 = hf->pair->prev->vertex;
 
 			Eigen::Vector3d v0v1 = v1->position - v0->position;
 			Eigen::Vector3d v0vi = vi->position - v0->position;
@@ -117,16 +141,26 @@ void MeshProcessor::cotangentCurvature() {
         // --- 最终归一化，计算模长，并记录 ---
         double curvature_magnitude = cotangent_curvature.norm();
 
-        curvature_magnitudes[i] = curvature_magnitude;
-
-        // 更新全局最大/最小值
-        global_max_mag = std::max(global_max_mag, curvature_magnitude);
-        global_min_mag = std::min(global_min_mag, curvature_magnitude);
-
-        // 颜色映射: 低曲率 -> 淡蓝, 中等 -> 绿色, 高曲率 -> 红色
-        double range = std::max(1e-12, global_max_mag - global_min_mag); // 防止除零
-        double lowT  = global_min_mag + range * 0.1; // 低阈值
-        double highT = global_min_mag + range * 0.35; // 高阈值
+        curvature_magnitudes[vi->index] = curvature_magnitude;
+        vertexQuality[vi->index] = curvature_magnitude;
+    });
+
+    // 全局最大/最小值(确定性并行归约, NaN 的比较为 false, 边界点自动被跳过)
+    const double global_max_mag = geometry::parallel::parallelMax<double>(0, size, -1e10, [&](size_t i) {
+        return curvature_magnitudes[i] > -1e10 ? curvature_magnitudes[i] : -1e10;
+    });
+    const double global_min_mag = geometry::parallel::parallelMin<double>(0, size, 1e10, [&](size_t i) {
+        return curvature_magnitudes[i] < 1e10 ? curvature_magnitudes[i] : 1e10;
+    });
+    std::cout << "cotangent curvature range: [" << global_min_mag << ", " << global_max_mag << "]" << std::endl;
+
+    // 颜色映射: 低曲率 -> 淡蓝, 中等 -> 绿色, 高曲率 -> 红色
+    const double range = std::max(1e-12, global_max_mag - global_min_mag); // 防止除零
+    const double lowT  = global_min_mag + range * 0.1; // 低阈值
+    const double highT = global_min_mag + range * 0.35; // 高阈值
+    geometry::parallel::parallelFor(0, size, [&](size_t i) {
+        if (mesh.vertices[i]->isBoundary()) return;
+        const double curvature_magnitude = curvature_magnitudes[i];
         Eigen::Vector3d color;
         if (curvature_magnitude <= lowT) {
             // 淡蓝 (light blue)
@@ -138,38 +172,29 @@ void MeshProcessor::cotangentCurvature() {
             // 红色 (high)
             color = Eigen::Vector3d(1.0, 0.0, 0.0);
         }
-        mesh.vertices[i]->color = color * 255.0;
-        std::cout << "vertex " << i << " cotangent_curvature: " << cotangent_curvature.transpose() << std::endl;
-    }
+        vertexColor[i] = color * 255.0;
+    });
 
 }
 
 void MeshProcessor::gaussianCurvature() {
     int size = mesh.vertices.size();
+    auto& vertexColor = mesh.vertexProperty<Eigen::Vector3d>("v:color", Eigen::Vector3d::Ones());
+    auto& vertexQuality = curvatureQuality(mesh);
     std::vector<double> curvature(size, 0);
-    double max_curvature = 1;
-    //遍历每个顶点，先拿到一阶邻域的所有顶点个数
-    for (int i = 0; i < size; i++) {
-        if (mesh.vertices[i]->isBoundary()) continue;//跳过边界点
+    //遍历每个顶点，先拿到一阶邻域的所有顶点个数(各顶点互不依赖, 并行计算)
+    geometry::parallel::forEachVertex(mesh, [&](geometry::Vertex* vi) {
+        if (vi->isBoundary()) return;//跳过边界点
         
         double gauss_curvature = 0.0;
 
         double theta = 0.0;
 		double area = 0.0;//记录区域面积
-        geometry::HalfEdge* hf = mesh.vertices[i]->halfEdge;
-        // 从这个点出发，先拿到所有的一阶邻域的顶点
-        std::vector<geometry::Vertex*> one_ring_vertices;
-        while (hf->pair->next != mesh.vertices[i]->halfEdge) {
-            one_ring_vertices.push_back(hf->getEndVertex());
-            hf = hf->pair->next;
-        }
-        int one_ring_size = one_ring_vertices.size();
-
-        for (int j = 0; j < one_ring_size; j++) {
+        // 从这个点出发，依次遍历一阶邻域, 每条出边对应其左侧三角形在 vi 处的内角
+        for (geometry::HalfEdge* hf : geometry::outgoingHalfEdges(vi)) {
             //开始计算这个顶点的gauss曲率
-            geometry::Vertex* v0 = one_ring_vertices[(j - 1 + one_ring_size) % one_ring_size];
-            geometry::Vertex* v1 = one_ring_vertices[j];
-            geometry::Vertex* vi = mesh.vertices[i].get();
+            geometry::Vertex* v0 = hf->prev->vertex;
+            geometry::Vertex* v1 = hf->getEndVertex();
 
 			Eigen::Vector3d viv1 = v1->position - vi->position;
 			Eigen::Vector3d viv0 = v0->position - vi->position;
@@ -182,18 +207,21 @@ void MeshProcessor::gaussianCurvature() {
         }
         gauss_curvature = (2 * M_PI - theta) / area;
 
-        curvature[i] = gauss_curvature;
-        max_curvature = std::min(max_curvature, std::abs(gauss_curvature));
-		std::cout << "vertex " << i << " gauss_curvature: " << gauss_curvature << std::endl;
-		//mesh.vertices[i]->color = Eigen::Vector3d(gauss_curvature, gauss_curvature, gauss_curvature) * 255;
-    }
+        curvature[vi->index] = gauss_curvature;
+        vertexQuality[vi->index] = gauss_curvature;
+		//vertexColor[i] = Eigen::Vector3d(gauss_curvature, gauss_curvature, gauss_curvature) * 255;
+    });
+    // 边界点被跳过(返回初值 1, 不影响最小值)
+    const double max_curvature = geometry::parallel::parallelMin<double>(0, size, 1.0, [&](size_t i) {
+        return mesh.vertices[i]->isBoundary() ? 1.0 : std::abs(curvature[i]);
+    });
     std::cout << "max gauss_curvature: " << max_curvature << std::endl;
 
     // 复制并排序，用于查找百分位数
     std::vector<double> sorted_curvatures = curvature;
     std::sort(sorted_curvatures.begin(), sorted_curvatures.end());
 
-    for (int i = 0; i < size; i++) {
+    geometry::parallel::parallelFor(0, size, [&](size_t i) {
 		// 直接设置颜色，蓝色表示负曲率，红色表示正曲率
 		double K_i = curvature[i];
 		Eigen::Vector3d color;
@@ -203,8 +231,8 @@ void MeshProcessor::gaussianCurvature() {
         else {
             color = Eigen::Vector3d(0.0, 0.0, 1.0); // 红色分量: 0, 绿色分量: 0, 蓝色分量: 1
 		}
-		mesh.vertices[i]->color = color * 255.0;
-    }
+		vertexColor[i] = color * 255.0;
+    });
 
     //// --- 1. 确定鲁棒归一化范围 ---
     //// 使用 95% 和 5% 百分位数来排除最极端的 10% 异常值
@@ -255,7 +283,7 @@ void MeshProcessor::gaussianCurvature() {
     //    }
 
     //    // 转换为 [0, 255] 范围
-    //    mesh.vertices[i]->color = color * 255.0;
+    //    vertexColor[i] = color * 255.0;
     //}
 
 
@@ -4,6 +4,8 @@
 #include <vector>
 #include <utility>
 #include <halfedge.h>
+#include <process_context.h>
+#include <process_params.h>
 
 /**
  * @brief ࣬ڽOBJתΪ߽ṹмδ
@@ -32,11 +34,23 @@ public:
      * 
      * @param vertices Ķλ飨QVector3Dʽ
      * @param indices 
+     * @param context ȡϱ; ȡʱ񲢷ؿս
+     * @param cache  vertices/indices Ӧİ߻(Ϊ), ʱֱ
      * @return Ķݶ
      */
     std::pair<std::vector<QVector3D>, std::vector<unsigned int>> 
     processOBJData(const std::vector<QVector3D>& vertices,
-                   const std::vector<unsigned int>& indices);
+                   const std::vector<unsigned int>& indices,
+                   const geometry::ProcessContext& context = {},
+                   const geometry::MeshCache* cache = nullptr);
+
+    /**
+     * @brief 㷨, δõĲʹĬֵ(Ϊһ)
+     *  - method: flow(Ĭ, ˹) / bilateral(˫߷˲ȥ)
+     *  - sigma_r, sigma_s: ˫˲ֵ/ռȨؿ, Ĭ 0.25
+     *  - step: ÿεĲ, Ĭ 0.0001
+     */
+    void setParams(const geometry::ProcessParams& newParams) { params = newParams; }
 
     /**
      * @brief ȡǰİֻ
@@ -59,6 +73,8 @@ public:
 
 private:
     geometry::HalfEdgeMesh mesh;  ///< 󣬴洢ת
+    geometry::ProcessContext processContext; ///< ǰȡ/( processOBJData )
+    geometry::ProcessParams params;          ///< 㷨( setParams )
 
     /**
      * @brief ִоļδ
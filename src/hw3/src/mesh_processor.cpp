@@ -1,13 +1,20 @@
 #include "mesh_processor.h"
 #include <mesh_converter.h>
+#include <circulators.h>
+#include <parallel.h>
 #include <iostream>
+#include <cmath>
 
 std::pair<std::vector<QVector3D>, std::vector<unsigned int>> 
 MeshProcessor::processOBJData(const std::vector<QVector3D>& vertices,
-                              const std::vector<unsigned int>& indices) {
+                              const std::vector<unsigned int>& indices,
+                              const geometry::ProcessContext& context,
+                              const geometry::MeshCache* cache) {
     
     // 1ʹgeometryģMeshConverter
-    geometry::MeshConverter::buildMeshFromQtData(mesh, vertices, indices);
+    geometry::MeshConverter::buildMeshFromQtData(mesh, vertices, indices, cache);
+    context.setProgress(0.05);
+    processContext = context.subRange(0.05, 0.95); // δռ 5%-95%, Ϊת
 
     // 2֤߽ṹȷ
     if (!mesh.isValid()) {
@@ -15,32 +22,56 @@ MeshProcessor::processOBJData(const std::vector<QVector3D>& vertices,
     }
 
     // 3ִʵʵļδҪԼʵֵĲ֣
-    //processGeometry();
+    // method=bilateral ʱ˫߷˲ȥ, Ĭ
+    const std::string method = params.getString("method", "flow");
+    if (method == "bilateral") {
+        processGeometry();
+    } else {
+        if (method != "flow") std::cerr << "Warning: Unknown method '" << method << "', using flow" << std::endl;
+        cotangentCurvature();
+    }
 
-	cotangentCurvature();
+    if (context.isCancelled()) {
+        mesh = geometry::HalfEdgeMesh(); // ȡ: ͬһͷ, Ҫ
+        return {};
+    }
 
     // 4ʹgeometryģMeshConverterתQtʽ
     return geometry::MeshConverter::convertMeshToQtData(mesh);
 }
+// ͵Ľȹ: вӵһεֵ½ target ʱΪ
+static double convergenceProgress(double first, double residual, double target) {
+	if (!(first > target) || !(residual > target)) return 1.0;
+	return std::log(first / residual) / std::log(first / target);
+}
+
 // bilateral normal filtering + gauss-seidel position update
 void MeshProcessor::processGeometry() {
-	double sigma_r = 0.25;
-	double sigma_s = 0.25;
+	const double sigma_r = params.getDouble("sigma_r", 0.25);
+	const double sigma_s = params.getDouble("sigma_s", 0.25);
+	auto& oldNormal = mesh.faceProperty<Eigen::Vector3d>("f:old_normal", Eigen::Vector3d::Zero());
+	auto& centerPoint = mesh.faceProperty<Eigen::Vector3d>("f:center_point", Eigen::Vector3d::Zero());// 
+	auto& oldPosition = mesh.vertexProperty<Eigen::Vector3d>("v:old_position", Eigen::Vector3d::Zero());
 
 	int flag = 1;
 	int face_size = mesh.faces.size();
 	// 淨
 	double threshold = 1;
+	double firstThreshold = -1.0;
+	const auto normalStage = processContext.subRange(0.0, 0.5);
+	const auto positionStage = processContext.subRange(0.5, 1.0);
 	do {
+		if (processContext.isCancelled()) return; // ֮ѯȡ
 		threshold = 0;
-		for (int i = 0; i < face_size; i++) {
+		// ÿֻĶλáֻдԼķ, Բ; ֵȷԵĲ min Լ
+		threshold = geometry::parallel::parallelMin(0, face_size, threshold, [&](size_t i) {
 			// ֱС sigma_s
 
 			//faceiķ˫˲
 			geometry::Face* f = mesh.faces[i].get();// ǰΪʲôҪget
 			//f->computeNormal();
 			Eigen::Vector3d new_normal = { 0 , 0, 0 };
-			f->old_normal = f->normal;// ȴ洢ɷ
+			oldNormal[f->index] = f->normal;// ȴ洢ɷ
 
 			Eigen::Vector3d fi = f->normal;
 			Eigen::Vector3d point1 = f->halfEdge->vertex->position;
@@ -48,7 +79,7 @@ void MeshProcessor::processGeometry() {
 			Eigen::Vector3d point3 = f->halfEdge->next->next->vertex->position;
 			Eigen::Vector3d center_i = (point1 + point2 + point3) / 3;
 
-			f->center_point = center_i;// Ĵ洢
+			centerPoint[f->index] = center_i;// Ĵ洢
 
 			geometry::HalfEdge* hf = f->halfEdge;
 			double kp = 0.0;
@@ -84,47 +115,45 @@ void MeshProcessor::processGeometry() {
 
 			new_normal.normalize();
 			f->normal = new_normal;// ·߸ֵ
-			threshold = std::min(threshold,1.0 - std::abs(f->normal.dot(f->old_normal)));
-		}
+			return 1.0 - std::abs(f->normal.dot(oldNormal[f->index]));
+		}, 256);
 		if(threshold < 1e-5) flag = 0;
+		if (firstThreshold < 0) firstThreshold = threshold;
+		normalStage.setProgress(convergenceProgress(firstThreshold, threshold, 1e-5));
 	} while (flag != 0);
 	//ÿƽķúˣҪÿλ
 	int vector_size = mesh.vertices.size();
+	firstThreshold = -1.0;
 
 	do {
-		
+		if (processContext.isCancelled()) return;
 
-		for (int i = 0; i < vector_size; i++) {
-			geometry::HalfEdge* hf = mesh.vertices[i]->halfEdge;
-			geometry::Vertex* vertex = hf->vertex;
-			vertex->old_position = vertex->position;// ȴ洢λ
+		// ֻĺ淨, λ, ͬԲ
+		threshold = geometry::parallel::parallelMin(0, vector_size, threshold, [&](size_t i) {
+			geometry::Vertex* vertex = mesh.vertices[i].get();
+			oldPosition[vertex->index] = vertex->position;// ȴ洢λ
 			Eigen::Vector3d gauss_seidel = { 0, 0, 0 };
 			int count = 0;
-			Eigen::Vector3d xi = vertex->old_position;
+			Eigen::Vector3d xi = oldPosition[vertex->index];
 
-			do {
-				geometry::Face* face = hf->face;
-				Eigen::Vector3d cj = face->center_point;
+			for (geometry::Face* face : geometry::vertexFaces(vertex)) {
+				Eigen::Vector3d cj = centerPoint[face->index];
 				Eigen::Vector3d nj = face->normal;
 
 				gauss_seidel += nj * nj.transpose() * (cj - xi);
 
 				count++;
-				if (hf->pair == nullptr) {
-					break;
-				}
-				hf = hf->pair->next;
-			} while (hf != mesh.vertices[i]->halfEdge);
+			}
 
 			if (count > 0) {
 				gauss_seidel /= count;
 				vertex->position += gauss_seidel;
 			}
 
-			threshold = std::min(threshold, (vertex->position - vertex->old_position).norm());
-
-		}
-
+			return (vertex->position - oldPosition[vertex->index]).norm();
+		}, 1024);
+		if (firstThreshold < 0) firstThreshold = threshold;
+		positionStage.setProgress(convergenceProgress(firstThreshold, threshold, 1e-5));
 
 	} while (threshold > 1e-5);
 
@@ -132,34 +161,30 @@ void MeshProcessor::processGeometry() {
 // cotangent laplacian curvature
 void MeshProcessor::cotangentCurvature() {
 	int size = mesh.vertices.size();
+	auto& oldPosition = mesh.vertexProperty<Eigen::Vector3d>("v:old_position", Eigen::Vector3d::Zero());
+	const double step = params.getDouble("step", 0.0001);
 
 	std::vector<double> curvature_magnitudes(size);
 	double global_max_mag = -1e10;
 	double global_min_mag = 1e10;
 	double threshold = 1.0;
+	double firstThreshold = -1.0;
 
 	do {
+		if (processContext.isCancelled()) return; // ֮ѯȡ
 		//ÿ㣬õһж
 		for (int i = 0; i < size; i++) {
-			mesh.vertices[i]->old_position = mesh.vertices[i]->position;
+			oldPosition[i] = mesh.vertices[i]->position;
 			if (mesh.vertices[i]->isBoundary()) continue;//߽
 			double area = 0.0;//¼
 			Eigen::Vector3d cotangent_curvature = { 0, 0, 0 };
-			geometry::HalfEdge* hf = mesh.vertices[i]->halfEdge;
-			// õеһĶ
-			std::vector<geometry::Vertex*> one_ring_vertices;
-			while (hf->pair->next != mesh.vertices[i]->halfEdge) {
-				one_ring_vertices.push_back(hf->getEndVertex());
-				hf = hf->pair->next;
-			}
-			int one_ring_size = one_ring_vertices.size();
-
-			for (int j = 0; j < one_ring_size; j++) {
+			geometry::Vertex* vi = mesh.vertices[i].get();
+			// αһ:  hf ָ v1, v0/v2  hf εĶԽǶ
+			for (geometry::HalfEdge* hf : geometry::outgoingHalfEdges(vi)) {
 				//ʼcotangent
-				geometry::Vertex* v0 = one_ring_vertices[(j - 1 + one_ring_size) % one_ring_size];
-				geometry::Vertex* v1 = one_ring_vertices[j];
-				geometry::Vertex* v2 = one_ring_vertices[(j + 1) % one_ring_size];
-				geometry::Vertex* vi = mesh.vertices[i].get();
+				geometry::Vertex* v0 = hf->prev->vertex;
+				geometry::Vertex* v1 = hf->getEndVertex();
+				geometry::Vertex* v2 = hf->pair->prev->vertex;
 
 				Eigen::Vector3d v0v1 = v1->position - v0->position;
 				Eigen::Vector3d v0vi = vi->position - v0->position;
@@ -196,10 +221,12 @@ void MeshProcessor::cotangentCurvature() {
 			global_min_mag = std::min(global_min_mag, curvature_magnitude);
 			
 			
-			mesh.vertices[i]->position += cotangent_curvature * 0.0001;// ƶľ
+			mesh.vertices[i]->position += cotangent_curvature * step;// ƶľ
 
-			threshold = std::min(threshold, (mesh.vertices[i]->position - mesh.vertices[i]->old_position).norm());
+			threshold = std::min(threshold, (mesh.vertices[i]->position - oldPosition[i]).norm());
 		}
+		if (firstThreshold < 0) firstThreshold = threshold;
+		processContext.setProgress(convergenceProgress(firstThreshold, threshold, 1e-5));
 	} while (threshold > 1e-5);
 
 }
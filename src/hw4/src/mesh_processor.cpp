@@ -1,15 +1,19 @@
 #include "mesh_processor.h"
 #include <mesh_converter.h>
+#include <circulators.h>
 #include <iostream>
 #include <Eigen/Sparse>
-#include <unordered_set>
 
 std::pair<std::vector<QVector3D>, std::vector<unsigned int>>
 MeshProcessor::processOBJData(const std::vector<QVector3D>& vertices,
-	const std::vector<unsigned int>& indices) {
+	const std::vector<unsigned int>& indices,
+	const geometry::ProcessContext& context,
+	const geometry::MeshCache* cache) {
 
 	// 1ʹgeometryģMeshConverter
-	geometry::MeshConverter::buildMeshFromQtData(mesh, vertices, indices);
+	geometry::MeshConverter::buildMeshFromQtData(mesh, vertices, indices, cache);
+	context.setProgress(0.05);
+	processContext = context.subRange(0.05, 0.95); // δռ 5%-95%, Ϊת
 
 	// 2֤߽ṹȷ
 	if (!mesh.isValid()) {
@@ -21,53 +25,32 @@ MeshProcessor::processOBJData(const std::vector<QVector3D>& vertices,
     //processGeometry_ultimate();
     //LSCM();
 
+	if (context.isCancelled()) {
+		mesh = geometry::HalfEdgeMesh(); // ȡ: ͬһͷ, Ҫ
+		return {};
+	}
+
 	// 4ʹgeometryģMeshConverterתQtʽ
 	return geometry::MeshConverter::convertMeshToQtData(mesh);
 }
 
 // Tutte's embedding parameterization
 void MeshProcessor::processGeometry() {
+	auto& boundaryIndex = mesh.vertexProperty<int>("v:boundary_index", -1); // ߽-1ʾǱ߽綥
 	int size = mesh.vertices.size();
 	if (size == 0) return;
 	for (auto& v : mesh.vertices) {
-		v->boundary_index = -1; // 
+		boundaryIndex[v->index] = -1; // 
 	}
 
-	// б߽ߣǱ߽綥 boundary_index
-	// ˳߽绷** Ҫ
+	// ߽绷񻺴(˲ʱ±), ˳߽綥
+	const geometry::BoundaryLoops& loops = mesh.getBoundaryLoops();
 	int boundary_size = 0;          // ܱ߽綥
-	int boundary_cycle = 0;         // ߽绷
-	std::unordered_set<geometry::HalfEdge*> visitedBoundaryHE;// ʹı߽
-	// аߣҵ߽
-	for (auto& hePtr : mesh.halfEdges) {
-		geometry::HalfEdge* start = hePtr.get();
-		if (start->pair) continue;// Ǳ߽
-		if (visitedBoundaryHE.count(start)) continue;// ˣ
-		// ﱣ֤ȡ˵һδı߽
-		geometry::HalfEdge* he = start;
-		int step = 0;
-		do {
-			visitedBoundaryHE.insert(he);
-			geometry::Vertex* v = he->vertex;
-			if (v->boundary_index < 0) {
-				v->boundary_index = boundary_size++; //  0 ʼ
-			}
-
-			// һ߽
-			geometry::HalfEdge* candidate = he->next;
-			while (candidate && candidate->pair) {
-				candidate = candidate->pair->next;
-			}
-			he = candidate;//Ǳ߽
-			step++;
-			if (step > (int)mesh.halfEdges.size()) { // ȫ˳쳣
-				std::cerr << "Warning: boundary walk aborted (non-manifold?)" << std::endl;
-				break;
-			}
-		} while (he && he != start);
-        // he ض startΪһ߽绷ضǱպϵģ
-
-		boundary_cycle++;
+	int boundary_cycle = loops.loopCount(); // ߽绷
+	for (int v : loops.vertices) {
+		if (boundaryIndex[v] < 0) {
+			boundaryIndex[v] = boundary_size++; //  0 ʼ
+		}
 	}
     // ¼ÿ߽绷㣬 Ⱦ
 
@@ -83,6 +66,10 @@ void MeshProcessor::processGeometry() {
 		return;
 	}
 	Eigen::SparseMatrix<double> A(size, size);// һ
+	// ģʽֱȡڽ CSR, ϵͨ valuePtr() д
+	const geometry::VertexAdjacency& adjacency = mesh.getAdjacency();
+	adjacency.initMatrix(A);
+	double* values = A.valuePtr();
 
 	Eigen::VectorXd b_x = Eigen::VectorXd::Zero(size);
 
@@ -110,12 +97,12 @@ void MeshProcessor::processGeometry() {
 			//b_x(column) = x;//  x 
 			//b_y(column) = y;//  y 
 
-			double t = (double)mesh.vertices[i]->boundary_index / (double)boundary_size;// [0, B-1], B=boundary_size
+			double t = (double)boundaryIndex[i] / (double)boundary_size;// [0, B-1], B=boundary_size
 			double theta = 2.0 * M_PI * t;
 			double x = std::cos(theta);
 			double y = std::sin(theta);
 			int index = mesh.vertices[i]->index;
-			A.coeffRef(column, index) = 1;
+			values[adjacency.diagonal[index]] = 1;
 			b_x(column) = x;
 			b_y(column) = y;
 			column++;
@@ -123,27 +110,27 @@ void MeshProcessor::processGeometry() {
 		}
 		// ڲĵ
 		else {
-			geometry::HalfEdge* hf = mesh.vertices[i]->halfEdge;
 			count = 0;
-			do {
-
-				A.coeffRef(column, hf->pair->vertex->index) = -1;
-				hf = hf->pair->next;// һ
-				// i У
+			for (geometry::HalfEdge* he : geometry::outgoingHalfEdges(mesh.vertices[i].get())) {
+				values[adjacency.halfEdgeSlot[he->index]] = -1;// һ򶥵
 				count++;
-			} while (hf != mesh.vertices[i]->halfEdge);
+			}
 		}
-		A.coeffRef(column, mesh.vertices[i].get()->index) = count;
+		values[adjacency.diagonal[i]] = count;
 		column++;
 	}
 
 	// ʼ
+	if (processContext.isCancelled()) return; // ֽⲻж, ǰѯȡ
+	processContext.setProgress(0.3);
 	Eigen::SparseLU<Eigen::SparseMatrix<double>> solver;
 	solver.compute(A);
 	if (solver.info() != Eigen::Success) {
 		std::cerr << "Decomposition failed!" << std::endl;
 		return;
 	}
+	if (processContext.isCancelled()) return;
+	processContext.setProgress(0.8);
 	pos_x = solver.solve(b_x);
 	pos_y = solver.solve(b_y);
 
@@ -155,43 +142,16 @@ void MeshProcessor::processGeometry() {
 
 
 void MeshProcessor::processGeometry_ultimate() {
+    auto& boundaryIndex = mesh.vertexProperty<int>("v:boundary_index", -1); // ߽-1ʾǱ߽綥
     int n = (int)mesh.vertices.size();
     if (n == 0) return;
 
     //  boundary_index
-    for (auto& v : mesh.vertices) v->boundary_index = -1;
-
-    // ռб߽绷
-    std::vector<std::vector<geometry::HalfEdge*>> loops;
-    std::unordered_set<geometry::HalfEdge*> visitedHE;
+    for (auto& v : mesh.vertices) boundaryIndex[v->index] = -1;
 
-    for (auto& hePtr : mesh.halfEdges) {
-        geometry::HalfEdge* start = hePtr.get();
-        if (start->pair) continue;                // ֻӱ߽߿ʼ
-        if (visitedHE.count(start)) continue;
-
-        std::vector<geometry::HalfEdge*> loop;
-        geometry::HalfEdge* he = start;
-        int guard = 0;
-        do {
-            loop.push_back(he);// ֱͰߣΪǰ
-            visitedHE.insert(he);
-            // һ߽
-            geometry::HalfEdge* cand = he->next;
-            while (cand && cand->pair) {
-                cand = cand->pair->next;
-            }
-            he = cand;
-            if (++guard > (int)mesh.halfEdges.size()) {
-                std::cerr << "Warning: boundary traversal aborted\n";
-                break;
-            }
-        } while (he && he != start);
-
-        if (!loop.empty()) loops.push_back(loop);
-    }
-
-    if (loops.empty()) {
+    // ߽绷񻺴
+    const geometry::BoundaryLoops& loops = mesh.getBoundaryLoops();
+    if (loops.loopCount() == 0) {
         std::cerr << "No boundary loops found.\n";
         return;
     }
@@ -202,16 +162,16 @@ void MeshProcessor::processGeometry_ultimate() {
         std::vector<geometry::Vertex*> verts;
     };
     std::vector<LoopInfo> loopInfos;
-    loopInfos.reserve(loops.size());
+    loopInfos.reserve(loops.loopCount());
 
-    for (size_t li = 0; li < loops.size(); ++li) {
+    for (int li = 0; li < loops.loopCount(); ++li) {
         LoopInfo info;
-        auto& loopHEs = loops[li];
+        info.verts.reserve(loops.loopSize(li));
         // 㶥˳
-        for (auto* he : loopHEs) {
-            geometry::Vertex* v = he->vertex;
-            if (v->boundary_index < 0) {
-                v->boundary_index = globalBoundaryCount++;
+        for (int k = loops.loopOffsets[li]; k < loops.loopOffsets[li + 1]; ++k) {
+            geometry::Vertex* v = mesh.vertices[loops.vertices[k]].get();
+            if (boundaryIndex[v->index] < 0) {
+                boundaryIndex[v->index] = globalBoundaryCount++;
                 info.verts.push_back(v);
             }
         }
@@ -223,10 +183,11 @@ void MeshProcessor::processGeometry_ultimate() {
         return;
     }
 
-    // Ԥϡ
+    // ϡģʽȡڽ CSR, ϵֱۼӵ valuePtr()
     Eigen::SparseMatrix<double> A(n, n);
-    std::vector<Eigen::Triplet<double>> triplets;
-    triplets.reserve(n * 6);
+    const geometry::VertexAdjacency& adjacency = mesh.getAdjacency();
+    adjacency.initMatrix(A);
+    double* values = A.valuePtr();
 
     Eigen::VectorXd bx = Eigen::VectorXd::Zero(n);
     Eigen::VectorXd by = Eigen::VectorXd::Zero(n);
@@ -248,7 +209,7 @@ void MeshProcessor::processGeometry_ultimate() {
             double theta = 2.0 * M_PI * t;
             double x = r * std::cos(theta) + a;
             double y = r * std::sin(theta);
-            triplets.emplace_back(v->index, v->index, 1.0);
+            values[adjacency.diagonal[v->index]] += 1.0;
             bx(v->index) = x;
             by(v->index) = y;
         }
@@ -257,11 +218,11 @@ void MeshProcessor::processGeometry_ultimate() {
     // ڲ㣺Uniform Laplacian
     for (auto& vPtr : mesh.vertices) {
         geometry::Vertex* v = vPtr.get();
-        if (v->boundary_index >= 0) continue;
+        if (boundaryIndex[v->index] >= 0) continue;
 
         geometry::HalfEdge* startHE = v->halfEdge;
         if (!startHE) {
-            triplets.emplace_back(v->index, v->index, 1.0);
+            values[adjacency.diagonal[v->index]] += 1.0;
             bx(v->index) = v->position.x();
             by(v->index) = v->position.y();
             continue;
@@ -277,7 +238,7 @@ void MeshProcessor::processGeometry_ultimate() {
             }
             geometry::Vertex* nbr = he->next->vertex;
             if (nbr) {
-                triplets.emplace_back(v->index, nbr->index, -1.0);
+                values[adjacency.halfEdgeSlot[he->index]] += -1.0;
                 degree++;
             }
             he = he->pair->next;
@@ -285,23 +246,25 @@ void MeshProcessor::processGeometry_ultimate() {
         } while (he && he != startHE);
 
         if (degree > 0) {
-            triplets.emplace_back(v->index, v->index, double(degree));
+            values[adjacency.diagonal[v->index]] += double(degree);
         }
         else {
-            triplets.emplace_back(v->index, v->index, 1.0);
+            values[adjacency.diagonal[v->index]] += 1.0;
             bx(v->index) = v->position.x();
             by(v->index) = v->position.y();
         }
     }
 
-    A.setFromTriplets(triplets.begin(), triplets.end());
-
+    if (processContext.isCancelled()) return;
+    processContext.setProgress(0.3);
     Eigen::SparseLU<Eigen::SparseMatrix<double>> solver;
     solver.compute(A);
     if (solver.info() != Eigen::Success) {
         std::cerr << "Decomposition failed.\n";
         return;
     }
+    if (processContext.isCancelled()) return;
+    processContext.setProgress(0.8);
     Eigen::VectorXd solx = solver.solve(bx);
     Eigen::VectorXd soly = solver.solve(by);
     if (solver.info() != Eigen::Success) {
@@ -317,6 +280,7 @@ void MeshProcessor::processGeometry_ultimate() {
 
 
 void MeshProcessor::LSCM() {
+    auto& oldPosition = mesh.vertexProperty<Eigen::Vector3d>("v:old_position", Eigen::Vector3d::Zero());
     //  LSCM: ˻һֱ
     // ˻ԭչ y ӽ 0 (/)Լֻһϡ
     // ȶԣ
@@ -330,20 +294,20 @@ void MeshProcessor::LSCM() {
     if (n == 0 || f == 0) return;
 
     // ¼ԭʼ 3D  old_position (֮ǰδд)
-    for (auto& v : mesh.vertices) v->old_position = v->position;
+    for (auto& v : mesh.vertices) oldPosition[v->index] = v->position;
 
     // ѡ߽ê: Զ (߽粻)
     int anchorA = -1, anchorB = -1;
     for (int i = 0; i < n; ++i) if (mesh.vertices[i]->isBoundary()) { anchorA = i; break; }
     if (anchorA >= 0) {
-        double maxD = -1.0; Eigen::Vector3d pA = mesh.vertices[anchorA]->old_position;
+        double maxD = -1.0; Eigen::Vector3d pA = oldPosition[anchorA];
         for (int i = 0; i < n; ++i) if (i != anchorA && mesh.vertices[i]->isBoundary()) {
-            double d = (mesh.vertices[i]->old_position - pA).norm(); if (d > maxD) { maxD = d; anchorB = i; }
+            double d = (oldPosition[i] - pA).norm(); if (d > maxD) { maxD = d; anchorB = i; }
         }
     }
     if (anchorA < 0 || anchorB < 0) { // 㹻߽
         anchorA = 0; anchorB = (n > 1 ? 1 : 0); double maxD = -1.0;
-        for (int i = 0; i < n; i++)for (int j = i + 1; j < n; j++) { double d = (mesh.vertices[i]->old_position - mesh.vertices[j]->old_position).norm(); if (d > maxD) { maxD = d; anchorA = i; anchorB = j; } }
+        for (int i = 0; i < n; i++)for (int j = i + 1; j < n; j++) { double d = (oldPosition[i] - oldPosition[j]).norm(); if (d > maxD) { maxD = d; anchorA = i; anchorB = j; } }
     }
     if (anchorA == anchorB) return;
 
@@ -364,9 +328,9 @@ void MeshProcessor::LSCM() {
         int j = he1->vertex->index;
         int k = he2->vertex->index;
 
-        Eigen::Vector3d p_i = mesh.vertices[i]->old_position;
-        Eigen::Vector3d p_j = mesh.vertices[j]->old_position;
-        Eigen::Vector3d p_k = mesh.vertices[k]->old_position;
+        Eigen::Vector3d p_i = oldPosition[i];
+        Eigen::Vector3d p_j = oldPosition[j];
+        Eigen::Vector3d p_k = oldPosition[k];
         Eigen::Vector3d e_ij = p_j - p_i;
         Eigen::Vector3d e_ik = p_k - p_i;
         double Lij = e_ij.norm();
@@ -422,8 +386,12 @@ void MeshProcessor::LSCM() {
     Eigen::VectorXd MtB = M.transpose() * b_use;
     for (int i = 0; i < cols; i++) MtM.coeffRef(i, i) += 1e-10; // 
 
+    if (processContext.isCancelled()) return;
+    processContext.setProgress(0.3);
     Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> solver; solver.compute(MtM);
     if (solver.info() != Eigen::Success) { std::cerr << "LSCM: factorization failed" << std::endl; return; }
+    if (processContext.isCancelled()) return;
+    processContext.setProgress(0.8);
     Eigen::VectorXd sol = solver.solve(MtB);
     if (solver.info() != Eigen::Success) { std::cerr << "LSCM: solve failed" << std::endl; return; }
 
@@ -4,6 +4,9 @@
 #include <vector>
 #include <utility>
 #include <halfedge.h>
+#include <process_context.h>
+#include <mesh_converter.h>
+#include <cstdint>
 
 /**
  * @brief ࣬ڽOBJתΪ߽ṹмδ
@@ -15,7 +18,11 @@ public:
     /**
      * @brief 캯
      */
-    MeshProcessor() = default;
+    MeshProcessor();
+
+    // ָָ mesh ڲ, ܸƻƶ
+    MeshProcessor(const MeshProcessor&) = delete;
+    MeshProcessor& operator=(const MeshProcessor&) = delete;
 
     /**
      * @brief 
@@ -32,11 +39,15 @@ public:
      * 
      * @param vertices Ķλ飨QVector3Dʽ
      * @param indices 
+     * @param context ȡϱ; ȡʱ񲢷ؿս
+     * @param cache  vertices/indices Ӧİ߻(Ϊ), ʱֱ
      * @return Ķݶ
      */
     std::pair<std::vector<QVector3D>, std::vector<unsigned int>> 
     processOBJData(const std::vector<QVector3D>& vertices,
-                   const std::vector<unsigned int>& indices);
+                   const std::vector<unsigned int>& indices,
+                   const geometry::ProcessContext& context = {},
+                   const geometry::MeshCache* cache = nullptr);
 
     /**
      * @brief ȡǰİֻ
@@ -123,28 +134,43 @@ public:
      * @brief ӦARAPק
      * @param handleIndex handle
      * @param newPosition handleλãû϶3Dλã
-     * @return κݣ¶λú
+     * @param vertices ʾõĶ, κλֱд(·)
+     * @param indices ʾõ, ֻ˰汾仯ʱд
+     * @return indices дʱ true
      * 
      * ãhandleλú͹̶ԼִARAP㷨Ż
      *       λãʵֱΣas-rigid-as-possibleЧ
      * 
      * ǰù̶
-     * handleIndexЧֱӷصǰmesh
+     * handleIndexЧֱӵǰmesh
      * 
      * ̣
      *   1. handleIndexΪhandle
   *   2. handleλ
      *   3. handleҲΪfixedΪλԼ
      *   4. processGeometry()ִARAPŻ
-     *   5. رκmeshGUIʾ
+     *   5. ѱκλõGUIʾ
      * 
      * ʱû϶handleʱÿƶ
      */
-    std::pair<std::vector<QVector3D>, std::vector<unsigned int>> 
-    applyArapDrag(int handleIndex, const QVector3D& newPosition);
+    bool applyArapDrag(int handleIndex, const QVector3D& newPosition,
+                       std::vector<QVector3D>& vertices, std::vector<unsigned int>& indices);
 
 private:
     geometry::HalfEdgeMesh mesh;  ///< 󣬴洢ת
+    geometry::ProcessContext processContext; ///< ǰȡ/( processOBJData )
+    std::uint64_t exportedTopologyVersion = geometry::MeshConverter::NoTopologyVersion; ///< ϴεʱ˰汾
+
+    // ARAP õĶ,  bindProperties аֲһ, ֱ֮Ӱ index 
+    geometry::Property<Eigen::Vector3d>* oldPositions = nullptr; ///< "v:old_position" ǰĲολ
+    geometry::Property<bool>* fixedFlags = nullptr;  ///< "v:fixed" Ƿǹ̶ĵ
+    geometry::Property<bool>* handleFlags = nullptr; ///< "v:handle" ǷקƵ
+
+    /// עᲢ; mesh 滻Ҫµ
+    void bindProperties();
+
+    /// λд vertices, ˱仯ʱд indices
+    bool exportDeformed(std::vector<QVector3D>& vertices, std::vector<unsigned int>& indices);
 
     /**
      * @brief ִоļδ
@@ -155,5 +181,5 @@ private:
 
     void tuttes_embedding();
 
-    double wij_caculate(geometry::HalfEdge* he, int i);
+    static double wij_caculate(const geometry::Property<Eigen::Vector3d>& oldPosition, geometry::HalfEdge* he, int i);
 };
\ No newline at end of file
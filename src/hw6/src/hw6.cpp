@@ -30,13 +30,16 @@ int main(int argc, char* argv[])
 	MeshProcessor processor;   // 첽meshȥȣ
 	MeshProcessor arapProcessor;    // רARAP
 	AsyncMeshProcessor* asyncProcessor = new AsyncMeshProcessor(&window);
+	asyncProcessor->setQueuePolicy(AsyncMeshProcessor::QueuePolicy::LatestWins); // ظʱֻµ, ڽص
 
 	// 첽ͨȥȲ
 	asyncProcessor->setProcessFunction(
 		[&processor](const std::vector<QVector3D>& vertices,
-			const std::vector<unsigned int>& indices) {
+			const std::vector<unsigned int>& indices,
+			const geometry::ProcessContext& context,
+			const geometry::MeshCache* cache) {
 				std::cout << "Processing mesh in worker thread..." << std::endl;
-				return processor.processOBJData(vertices, indices);
+				return processor.processOBJData(vertices, indices, context, cache);
 		});
 
 	// 3ARAPصGLWidget
@@ -45,9 +48,8 @@ int main(int argc, char* argv[])
 	window.findChild<GLWidget*>()->arapBeginCallback = [&arapProcessor, &window]() {
 		std::cout << "[ARAP] Begin ARAP session - saving current mesh state" << std::endl;
 		// GLWidgetȡǰmeshݹ߽ṹ
-		auto verts = window.findChild<GLWidget*>()->getVertices();
-		auto inds = window.findChild<GLWidget*>()->getIndices();
-		geometry::MeshConverter::buildMeshFromQtData(arapProcessor.getMesh(), verts, inds);
+		const MeshSnapshotPtr mesh = window.findChild<GLWidget*>()->getMesh(); // ֻ, 
+		geometry::MeshConverter::buildMeshFromQtData(arapProcessor.getMesh(), mesh->vertices, mesh->indices, mesh->cache.get());
 		arapProcessor.beginArapSession();
 		};
 
@@ -64,26 +66,26 @@ int main(int argc, char* argv[])
 		};
 
 	// 3.4 ϶handleصִARAPβµmesh
-	window.findChild<GLWidget*>()->arapDragCallback = [&arapProcessor](int handleIndex, const QVector3D& newPos) {
+	window.findChild<GLWidget*>()->arapDragCallback = [&arapProcessor](int handleIndex, const QVector3D& newPos,
+		std::vector<QVector3D>& vertices, std::vector<unsigned int>& indices) {
 		std::cout << "[ARAP] Dragging handle vertex " << handleIndex
 			<< " to (" << newPos.x() << ", " << newPos.y() << ", " << newPos.z() << ")" << std::endl;
-		return arapProcessor.applyArapDrag(handleIndex, newPos);
+		return arapProcessor.applyArapDrag(handleIndex, newPos, vertices, indices);
 		};
 
 	// 4ͨmesh¼Ӧ·
 
 	// 4.1 ڼOBJļʱʼARAP
 	QObject::connect(&window, &MainWindow::objLoaded,
-		[asyncProcessor, &arapProcessor](const std::vector<QVector3D>& vertices,
-			const std::vector<unsigned int>& indices) {
-				std::cout << "OBJ file loaded with " << vertices.size() << " vertices" << std::endl;
+		[asyncProcessor, &arapProcessor](const MeshSnapshotPtr& mesh) {
+				std::cout << "OBJ file loaded with " << mesh->vertices.size() << " vertices" << std::endl;
 				// ʼARAPmesh
 				geometry::MeshConverter::buildMeshFromQtData(
 					const_cast<geometry::HalfEdgeMesh&>(arapProcessor.getMesh()),
-					vertices, indices);
+					mesh->vertices, mesh->indices, mesh->cache.get());
 
 				// ѡ첽ȥ봦
-				// asyncProcessor->startProcessing(vertices, indices);
+				// asyncProcessor->startProcessing(mesh);
 		});
 
 	// ʼʱķ
@@ -94,10 +96,9 @@ int main(int argc, char* argv[])
 
 	// ʱʾ
 	QObject::connect(asyncProcessor, &AsyncMeshProcessor::processingFinished,
-		[&window](const std::vector<QVector3D>& vertices,
-			const std::vector<unsigned int>& indices) {
+		[&window](const MeshSnapshotPtr& mesh) {
 				std::cout << "Async mesh processing completed. Updating display..." << std::endl;
-				window.updateMesh(vertices, indices);
+				window.updateMesh(mesh);
 		});
 
 	// 
@@ -108,6 +109,15 @@ int main(int argc, char* argv[])
 				"Mesh processing failed: " + errorMessage);
 		});
 
+	// ȡťжϵǰ, ʾ״̬
+	QObject::connect(&window, &MainWindow::cancelRequested, asyncProcessor, &AsyncMeshProcessor::cancel);
+	QObject::connect(asyncProcessor, &AsyncMeshProcessor::progressUpdated, &window, &MainWindow::showProcessingProgress);
+	QObject::connect(asyncProcessor, &AsyncMeshProcessor::processingCancelled,
+		[&window]() {
+			std::cout << "Processing cancelled" << std::endl;
+			window.showProcessingCancelled();
+		});
+
 	// 5ʾڲӦó¼ѭ
 	window.show();
 
@@ -1,43 +1,67 @@
 ﻿#include "mesh_processor.h"
 #include <mesh_converter.h>
+#include <circulators.h>
+#include <parallel.h>
 #include <iostream>
 #include <Eigen/Dense>
 #include <algorithm>
 #include <Eigen/Sparse>
 
+MeshProcessor::MeshProcessor() {
+	bindProperties();
+}
+
+// 属性只在这里按名字查找; 重建网格(clear + build)会保留已注册的属性, 指针仍然有效
+void MeshProcessor::bindProperties() {
+	oldPositions = &mesh.vertexProperty<Eigen::Vector3d>("v:old_position", Eigen::Vector3d::Zero());
+	fixedFlags = &mesh.vertexProperty<bool>("v:fixed", false);
+	handleFlags = &mesh.vertexProperty<bool>("v:handle", false);
+}
+
 std::pair<std::vector<QVector3D>, std::vector<unsigned int>>
 MeshProcessor::processOBJData(const std::vector<QVector3D>& vertices,
-	const std::vector<unsigned int>& indices) {
+	const std::vector<unsigned int>& indices,
+	const geometry::ProcessContext& context,
+	const geometry::MeshCache* cache) {
 
 	// 步骤1：使用geometry模块的MeshConverter构建半边网格
-	geometry::MeshConverter::buildMeshFromQtData(mesh, vertices, indices);
+	geometry::MeshConverter::buildMeshFromQtData(mesh, vertices, indices, cache);
+	context.setProgress(0.05);
+	processContext = context.subRange(0.05, 0.95); // 几何处理占 5%-95%, 其余为构建和转换
 
 	// 步骤2：验证半边结构的正确性
 	if (!mesh.isValid()) {
 		std::cerr << "Warning: Generated half-edge mesh is invalid!" << std::endl;
 	}
 
+	auto& oldPosition = *oldPositions; // 变形前的参考位置
+
 	for (auto& vertex : mesh.vertices) {
-		vertex->old_position = vertex->position;
+		oldPosition[vertex->index] = vertex->position;
 	}
 	// 在第一步arap之前，先把老顶点保存起来
 
 	//// 步骤3：执行实际的几何处理操作（这是需要自己实现的部分）
 	//processGeometry();
 
+	if (context.isCancelled()) {
+		mesh = geometry::HalfEdgeMesh(); // 取消: 连同属性一起释放, 结果不再需要
+		bindProperties();
+		return {};
+	}
+
 	// 步骤4：使用geometry模块的MeshConverter将结果转回Qt格式
 	return geometry::MeshConverter::convertMeshToQtData(mesh);
 }
 
 // arap变形
 void MeshProcessor::processGeometry() {
+	auto& isFixed = *fixedFlags; // 是否是固定的点
+	auto& oldPosition = *oldPositions; // 变形前的参考位置
 	int v_size = mesh.vertices.size();
 
 	// ===== 调试输出 =====
-	int fixed_count = 0;
-	for (const auto& v : mesh.vertices) {
-		if (v->fixed) fixed_count++;
-	}
+	const int fixed_count = geometry::parallel::parallelSum(0, v_size, 0, [&](size_t i) { return isFixed[i] ? 1 : 0; });
 	std::cout << "[ARAP] Fixed vertices: " << fixed_count << " / " << v_size << std::endl;
 	
 	if (fixed_count == 0) {
@@ -45,36 +69,33 @@ void MeshProcessor::processGeometry() {
 		return;
 	}
 
-	// ===== Local 步骤：计算每个顶点的旋转矩阵 =====
+	// ===== Local 步骤：计算每个顶点的旋转矩阵(各顶点互不依赖, 并行) =====
 	std::vector<Eigen::Matrix3d> rotations(v_size);
 	
-	for (int i = 0; i < v_size; i++) {
-		if (mesh.vertices[i]->fixed) {
+	geometry::parallel::parallelFor(0, v_size, [&](size_t i) {
+		if (isFixed[i]) {
 			// 固定点不需要计算旋转矩阵，使用单位矩阵
 			rotations[i] = Eigen::Matrix3d::Identity();
-			continue;
+			return;
 		}
 		
 		// 非固定点：计算协方差矩阵 J
 		Eigen::Matrix3d J = Eigen::Matrix3d::Zero();
-		geometry::HalfEdge* hf = mesh.vertices[i]->halfEdge;
 		Eigen::Vector3d pi_new = mesh.vertices[i]->position;
-		Eigen::Vector3d pi_old = mesh.vertices[i]->old_position;
+		Eigen::Vector3d pi_old = oldPosition[i];
 		
-		do {
+		for (geometry::HalfEdge* hf : geometry::outgoingHalfEdges(mesh.vertices[i].get())) {
 			Eigen::Vector3d pj_new = hf->next->vertex->position;
-			Eigen::Vector3d pj_old = hf->next->vertex->old_position;
+			Eigen::Vector3d pj_old = oldPosition[hf->next->vertex->index];
 			
 			// 计算 cotangent 权重
-			double wij = wij_caculate(hf, i);
+			double wij = wij_caculate(oldPosition, hf, i);
 			
 			// 构建协方差矩阵：J = sum(wij * (pi_old - pj_old) * (pi_new - pj_new)^T)
 			Eigen::Vector3d eij_old = pi_old - pj_old;
 			Eigen::Vector3d eij_new = pi_new - pj_new;
 			J += wij * eij_old * eij_new.transpose();
-			
-			hf = hf->pair->next;
-		} while (hf != mesh.vertices[i]->halfEdge);
+		}
 		
 		// SVD 分解求旋转矩阵
 		Eigen::JacobiSVD<Eigen::Matrix3d> svd(J, Eigen::ComputeFullU | Eigen::ComputeFullV);
@@ -89,16 +110,21 @@ void MeshProcessor::processGeometry() {
 		}
 		
 		rotations[i] = R;
-	}
+	}, 256);
 
 	// ===== Global 步骤：构建并求解线性系统 Ax = b =====
-	std::vector<Eigen::Triplet<double>> triplets;
+	// 模式直接取自网格的邻接 CSR(拓扑不变时一直复用), 权值写入 valuePtr()
+	Eigen::SparseMatrix<double> A(v_size, v_size);
+	const geometry::VertexAdjacency& adjacency = mesh.getAdjacency();
+	adjacency.initMatrix(A);
+	double* values = A.valuePtr();
 	Eigen::MatrixXd B = Eigen::MatrixXd::Zero(v_size, 3);
 	
-	for (int i = 0; i < v_size; i++) {
-		if (mesh.vertices[i]->fixed) {
+	// 顶点 i 只写第 i 行(对角元和出边对应的非对角元)以及 B 的第 i 行, 各行可以并行组装
+	geometry::parallel::parallelFor(0, v_size, [&](size_t i) {
+		if (isFixed[i]) {
 			// ===== Fixed 点：使用恒等约束 =====
-			triplets.push_back(Eigen::Triplet<double>(i, i, 1.0));
+			values[adjacency.diagonal[i]] += 1.0;
 			
 			B(i, 0) = mesh.vertices[i]->position.x();
 			B(i, 1) = mesh.vertices[i]->position.y();
@@ -106,39 +132,32 @@ void MeshProcessor::processGeometry() {
 		}
 		else {
 			// ===== 非 Fixed 点：使用 ARAP 能量最小化方程 =====
-			geometry::HalfEdge* hf = mesh.vertices[i]->halfEdge;
-			Eigen::Vector3d pi_old = mesh.vertices[i]->old_position;
+			Eigen::Vector3d pi_old = oldPosition[i];
 			Eigen::Vector3d rhs = Eigen::Vector3d::Zero();
 			
 			double wii_sum = 0.0;
 			
-			do {
+			for (geometry::HalfEdge* hf : geometry::outgoingHalfEdges(mesh.vertices[i].get())) {
 				int j = hf->next->vertex->index;
-				Eigen::Vector3d pj_old = hf->next->vertex->old_position;
+				Eigen::Vector3d pj_old = oldPosition[hf->next->vertex->index];
 				
-				double wij = wij_caculate(hf, i);
+				double wij = wij_caculate(oldPosition, hf, i);
 				
 				// 矩阵 A 的构建
 				wii_sum += wij;
-				triplets.push_back(Eigen::Triplet<double>(i, j, -wij));
+				values[adjacency.halfEdgeSlot[hf->index]] -= wij;
 				
 				// 右端项 b
 				rhs += wij * 0.5 * (rotations[i] + rotations[j]) * (pi_old - pj_old);
-				
-				hf = hf->pair->next;
-			} while (hf != mesh.vertices[i]->halfEdge);
+			}
 			
-			triplets.push_back(Eigen::Triplet<double>(i, i, wii_sum));
+			values[adjacency.diagonal[i]] += wii_sum;
 			
 			B(i, 0) = rhs.x();
 			B(i, 1) = rhs.y();
 			B(i, 2) = rhs.z();
 		}
-	}
-	
-	// 构建稀疏矩阵
-	Eigen::SparseMatrix<double> A(v_size, v_size);
-	A.setFromTriplets(triplets.begin(), triplets.end());
+	}, 256);
 	
 	// ===== 求解线性系统 =====
 	Eigen::SparseLU<Eigen::SparseMatrix<double>> solver;
@@ -160,8 +179,9 @@ void MeshProcessor::processGeometry() {
 	
 	// ===== 更新顶点位置（只更新非 fixed 点）=====
 	for (int i = 0; i < v_size; i++) {
-		if (!mesh.vertices[i]->fixed) {
+		if (!isFixed[i]) {
 			mesh.vertices[i]->position = Eigen::Vector3d(new_pos(i, 0), new_pos(i, 1), new_pos(i, 2));
+			mesh.markVertexDirty(i);
 		} else {
 			// 验证 fixed 点是否被正确约束
 			Eigen::Vector3d expected = mesh.vertices[i]->position;
@@ -176,11 +196,11 @@ void MeshProcessor::processGeometry() {
 }
 
 // 计算wij
-double MeshProcessor::wij_caculate(geometry::HalfEdge* hf, int i) {
-	Eigen::Vector3d pi_old = mesh.vertices[i]->old_position;
-	Eigen::Vector3d pj_old = hf->next->vertex->old_position;
-	Eigen::Vector3d p1_old = hf->next->getEndVertex()->old_position;
-	Eigen::Vector3d p0_old = hf->pair->next->getEndVertex()->old_position;
+double MeshProcessor::wij_caculate(const geometry::Property<Eigen::Vector3d>& oldPosition, geometry::HalfEdge* hf, int i) {
+	Eigen::Vector3d pi_old = oldPosition[i];
+	Eigen::Vector3d pj_old = oldPosition[hf->next->vertex->index];
+	Eigen::Vector3d p1_old = oldPosition[hf->next->getEndVertex()->index];
+	Eigen::Vector3d p0_old = oldPosition[hf->pair->next->getEndVertex()->index];
 
 	Eigen::Vector3d e1i_old = pi_old - p1_old;
 	Eigen::Vector3d e1j_old = pj_old - p1_old;
@@ -201,31 +221,37 @@ double MeshProcessor::wij_caculate(geometry::HalfEdge* hf, int i) {
 // ================== ARAP交互API方法实现 ==================
 
 void MeshProcessor::beginArapSession() {
+	auto& oldPosition = *oldPositions; // 变形前的参考位置
+	auto& isFixed = *fixedFlags; // 是否是固定的点
+	auto& isHandle = *handleFlags; // 是否是拖拽控制点（handle点）
 	// 保存当前所有顶点位置为old_position（变形前的参考位置）
 	for (auto& vertex : mesh.vertices) {
-		vertex->old_position = vertex->position;
-		vertex->fixed = false;
-		vertex->handle = false;  // 清空handle标记
+		oldPosition[vertex->index] = vertex->position;
+		isFixed[vertex->index] = false;
+		isHandle[vertex->index] = false;  // 清空handle标记
 	}
 	std::cout << "[MeshProcessor] ARAP session started, saved " << mesh.vertices.size()
 		<< " vertex positions as old_position" << std::endl;
 }
 
 void MeshProcessor::endArapSession() {
+	auto& isFixed = *fixedFlags; // 是否是固定的点
+	auto& isHandle = *handleFlags; // 是否是拖拽控制点（handle点）
 	// 清空所有 ARAP 相关标记
 	for (auto& vertex : mesh.vertices) {
-		vertex->fixed = false;
-		vertex->handle = false;
+		isFixed[vertex->index] = false;
+		isHandle[vertex->index] = false;
 	}
 	std::cout << "[MeshProcessor] ARAP session ended" << std::endl;
 }
 
 void MeshProcessor::setFixedVertex(int index, bool fixed) {
+	auto& isFixed = *fixedFlags; // 是否是固定的点
 	if (index < 0 || index >= static_cast<int>(mesh.vertices.size())) {
 		std::cerr << "[MeshProcessor] Invalid vertex index: " << index << std::endl;
 		return;
 	}
-	mesh.vertices[index]->fixed = fixed;
+	isFixed[index] = fixed;
 	std::cout << "[MeshProcessor] Vertex " << index << " set to "
 		<< (fixed ? "FIXED" : "FREE") << std::endl;
 }
@@ -237,6 +263,7 @@ void MeshProcessor::setFixedVertices(const std::vector<int>& indices) {
 }
 
 void MeshProcessor::setHandleVertex(int index, bool handle) {
+	auto& isHandle = *handleFlags; // 是否是拖拽控制点（handle点）
 	if (index < 0 || index >= static_cast<int>(mesh.vertices.size())) {
 		std::cerr << "[MeshProcessor] Invalid vertex index: " << index << std::endl;
 		return;
@@ -247,40 +274,44 @@ void MeshProcessor::setHandleVertex(int index, bool handle) {
 		clearHandleVertex();
 	}
 	
-	mesh.vertices[index]->handle = handle;
+	isHandle[index] = handle;
 	std::cout << "[MeshProcessor] Vertex " << index << " set to "
 		<< (handle ? "HANDLE" : "NOT_HANDLE") << std::endl;
 }
 
 void MeshProcessor::clearFixedVertices() {
+	auto& isFixed = *fixedFlags; // 是否是固定的点
 	for (auto& vertex : mesh.vertices) {
-		vertex->fixed = false;
+		isFixed[vertex->index] = false;
 	}
 	std::cout << "[MeshProcessor] Cleared all fixed vertices" << std::endl;
 }
 
 void MeshProcessor::clearHandleVertex() {
+	auto& isHandle = *handleFlags; // 是否是拖拽控制点（handle点）
 	for (auto& vertex : mesh.vertices) {
-		vertex->handle = false;
+		isHandle[vertex->index] = false;
 	}
 	std::cout << "[MeshProcessor] Cleared handle vertex" << std::endl;
 }
 
 int MeshProcessor::getHandleIndex() const {
+	const auto& isHandle = *handleFlags;
 	for (size_t i = 0; i < mesh.vertices.size(); ++i) {
-		if (mesh.vertices[i]->handle) {
+		if (isHandle[i]) {
 			return static_cast<int>(i);
 		}
 	}
 	return -1;  // 没有 handle 点
 }
 
-std::pair<std::vector<QVector3D>, std::vector<unsigned int>>
-MeshProcessor::applyArapDrag(int handleIndex, const QVector3D& newPosition) {
+bool MeshProcessor::applyArapDrag(int handleIndex, const QVector3D& newPosition,
+                                  std::vector<QVector3D>& vertices, std::vector<unsigned int>& indices) {
+	auto& isFixed = *fixedFlags; // 是否是固定的点
 	// 验证 handleIndex 有效性
 	if (handleIndex < 0 || handleIndex >= static_cast<int>(mesh.vertices.size())) {
 		std::cerr << "[MeshProcessor] Invalid handle vertex index: " << handleIndex << std::endl;
-		return geometry::MeshConverter::convertMeshToQtData(mesh);
+		return exportDeformed(vertices, indices);
 	}
 
 	std::cout << "[MeshProcessor] Dragging vertex " << handleIndex 
@@ -295,20 +326,32 @@ MeshProcessor::applyArapDrag(int handleIndex, const QVector3D& newPosition) {
 		newPosition.z()  // 使用完整 3D 坐标
 		//original_z
 	);
+	mesh.markVertexDirty(handleIndex);
 
 	// 2. 临时将handle点标记为fixed（作为ARAP约束）
-	bool wasFixed = mesh.vertices[handleIndex]->fixed;
-	mesh.vertices[handleIndex]->fixed = true;
+	bool wasFixed = isFixed[handleIndex];
+	isFixed[handleIndex] = true;
 
 	// 3. 执行 ARAP 优化（fixed点和handle点都保持不动，其他点通过ARAP计算）
 	processGeometry();
 
 	// 4. 恢复handle点的fixed状态（如果原本不是fixed点）
 	if (!wasFixed) {
-		mesh.vertices[handleIndex]->fixed = false;
+		isFixed[handleIndex] = false;
 	}
+
+	// 5. 只重算被移动顶点周围的面/顶点法向量
+	mesh.updateNormals();
 	// ===================
 
-	// 返回变形后的mesh
-	return geometry::MeshConverter::convertMeshToQtData(mesh);
+	// 导出变形后的位置(连接关系不变, 索引不会重写)
+	return exportDeformed(vertices, indices);
+}
+
+bool MeshProcessor::exportDeformed(std::vector<QVector3D>& vertices, std::vector<unsigned int>& indices) {
+	if (vertices.size() != mesh.vertices.size()) {
+		vertices.resize(mesh.vertices.size());
+	}
+	geometry::MeshConverter::exportPositions(mesh, geometry::MeshConverter::asFloatSpan(vertices));
+	return geometry::MeshConverter::exportIndices(mesh, indices, exportedTopologyVersion);
 }
\ No newline at end of file
@@ -1,15 +1,18 @@
 #include "mesh_processor.h"
 #include <mesh_converter.h>
 #include <iostream>
-#include <unordered_set>
 #include <Eigen/sparse>
 
 std::pair<std::vector<QVector3D>, std::vector<unsigned int>>
 MeshProcessor::processOBJData(const std::vector<QVector3D>& vertices,
-	const std::vector<unsigned int>& indices) {
+	const std::vector<unsigned int>& indices,
+	const geometry::ProcessContext& context,
+	const geometry::MeshCache* cache) {
 
 	// 1ʹgeometryģMeshConverter
-	geometry::MeshConverter::buildMeshFromQtData(mesh, vertices, indices);
+	geometry::MeshConverter::buildMeshFromQtData(mesh, vertices, indices, cache);
+	context.setProgress(0.05);
+	processContext = context.subRange(0.05, 0.95); // δռ 5%-95%, Ϊת
 
 	// 2֤߽ṹȷ
 	if (!mesh.isValid()) {
@@ -19,11 +22,17 @@ MeshProcessor::processOBJData(const std::vector<QVector3D>& vertices,
 	// 3ִʵʵļδҪԼʵֵĲ֣
 	processGeometry();
 
+	if (context.isCancelled()) {
+		mesh = geometry::HalfEdgeMesh(); // ȡ: ͬһͷ, Ҫ
+		return {};
+	}
+
 	// 4ʹgeometryģMeshConverterתQtʽ
 	return geometry::MeshConverter::convertMeshToQtData(mesh);
 }
 // tuttes emedding귽 harmonic coordinates
 void MeshProcessor::processGeometry() {
+	auto& boundaryIndex = mesh.vertexProperty<int>("v:boundary_index", -1); // ߽-1ʾǱ߽綥
 	// ˳,ҳ߽綥㣬еԲ
 	int vertexCount = mesh.getVertexCount();
 
@@ -31,41 +40,14 @@ void MeshProcessor::processGeometry() {
 
 	// ؼǣδһ߳˳
 
-	std::unordered_set<geometry::HalfEdge*> halfedgeVisitedSet;
-
 	int boundary_index = 0;// ߽綥
 
 	int size = mesh.vertices.size();
 
-	for (auto& he : mesh.halfEdges) {// а
-		if (he->pair != nullptr) continue;//Ǳ߽ߣֱһ
-		else if (halfedgeVisitedSet.find(he.get()) != halfedgeVisitedSet.end()) continue; //Ѿʹ
-
-		//  ûзʹı߽
-		geometry::HalfEdge* start = he.get();
-		halfedgeVisitedSet.insert(start);// Ϊʹ
-		start->vertex->boundary_index = boundary_index++;// Ǳ߽綥z
-
-		geometry::HalfEdge* currentHE = start;// Եǰ߽յΪ㣬һ߽
-		// ҪѺcurrentHEб߽߶ҳ
-		do {
-			geometry::HalfEdge* nextHE = currentHE->next;// ҵǰ߽ߵһ
-			while (nextHE && nextHE->pair != nullptr) {
-				nextHE = nextHE->pair->next;// һǷһ߽
-			}
-			//if (nextHE == currentHE->next) break;
-			// ΪʲôҪж nextHE ǷΪգΪ߽Ƿյģֿյٴһ߽ڵǰһ
-			// µı߽
-
-			if (halfedgeVisitedSet.find(nextHE) == halfedgeVisitedSet.end())
-				// ˵ûзʹ
-				nextHE->vertex->boundary_index = boundary_index++;// Ǳ߽綥
-
-
-			halfedgeVisitedSet.insert(nextHE);// Ϊʹ
-			currentHE = nextHE;// µǰ߽
-		} while (currentHE != start);
-		// currentHE ض startΪһ߽绷ضǱպϵģ
+	// ߽绷񻺴: ÿһ߽߳, ر߽θ
+	const geometry::BoundaryLoops& loops = mesh.getBoundaryLoops();
+	for (int v : loops.vertices) {
+		boundaryIndex[v] = boundary_index++;// Ǳ߽綥
 	}
 
 	Eigen::SparseMatrix<double> A(size, size);// һ
@@ -77,7 +59,10 @@ void MeshProcessor::processGeometry() {
 	Eigen::VectorXd pos_x = Eigen::VectorXd::Zero(size);
 	Eigen::VectorXd pos_y = Eigen::VectorXd::Zero(size);
 
-	std::vector<Eigen::Triplet<double>> triplets;
+	// ģʽֱȡڽ CSR, Ȩֱֵд valuePtr(), پԪ
+	const geometry::VertexAdjacency& adjacency = mesh.getAdjacency();
+	adjacency.initMatrix(A);
+	double* values = A.valuePtr();
 
 	for (int i = 0; i < mesh.vertices.size(); i++) {
 		mesh.vertices[i]->index = i;// 洢λ
@@ -85,14 +70,14 @@ void MeshProcessor::processGeometry() {
 
 	// 濪ʼ
 	for (int i = 0; i < mesh.vertices.size(); i++) {
-		if (mesh.vertices[i]->boundary_index >= 0) {
+		if (boundaryIndex[i] >= 0) {
 			// Ǳ߽綥
-			double theta = (double)2.0 * M_PI * mesh.vertices[i]->boundary_index / (double)boundary_index;
+			double theta = (double)2.0 * M_PI * boundaryIndex[i] / (double)boundary_index;
 			double x = cos(theta);
 			double y = sin(theta);
 			//mesh.vertices[i]->position = Eigen::Vector3d(x, y, 0.0);
 
-			triplets.emplace_back(i, i, 1.0);// ֱ߽粻
+			values[adjacency.diagonal[i]] += 1.0;// ֱ߽粻
 			b_x[i] = x;
 			b_y[i] = y;
 		}
@@ -141,22 +126,24 @@ void MeshProcessor::processGeometry() {
 
 				double fai_i = wi / wi_sum;
 
-				triplets.emplace_back(i, he->getEndVertex()->index, -fai_i);// ڽӵȨֵΪ
-				triplets.emplace_back(i, i, fai_i);// ȨֵΪ
+				values[adjacency.halfEdgeSlot[he->index]] -= fai_i;// ڽӵȨֵΪ
+				values[adjacency.diagonal[i]] += fai_i;// ȨֵΪ
 
 				he = he->pair->next;// һ
 			} while (he != mesh.vertices[i]->halfEdge);
 		}
 	}
-	// ʼϡ
-	A.setFromTriplets(triplets.begin(), triplets.end());
 	// Է
+	if (processContext.isCancelled()) return; // ֽⲻж, ǰѯȡ
+	processContext.setProgress(0.3);
 	Eigen::SparseLU<Eigen::SparseMatrix<double>> solver;
 	solver.compute(A);
 	if (solver.info() != Eigen::Success) {
 		std::cerr << "Decomposition failed!" << std::endl;
 		return;
 	}
+	if (processContext.isCancelled()) return;
+	processContext.setProgress(0.8);
 	pos_x = solver.solve(b_x);
 	pos_y = solver.solve(b_y);
 
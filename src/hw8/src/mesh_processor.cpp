@@ -1,18 +1,23 @@
 #include "mesh_processor.h"
 #include <mesh_converter.h>
+#include <circulators.h>
+#include <parallel.h>
 #include <iostream>
 #include <Eigen/Core>
 #include <Eigen/Sparse>
 #include <Eigen/SVD>
-#include <unordered_set>
 
 
 std::pair<std::vector<QVector3D>, std::vector<unsigned int>> 
 MeshProcessor::processOBJData(const std::vector<QVector3D>& vertices,
-                              const std::vector<unsigned int>& indices) {
+                              const std::vector<unsigned int>& indices,
+                              const geometry::ProcessContext& context,
+                              const geometry::MeshCache* cache) {
     
     // 1ʹgeometryģMeshConverter
-    geometry::MeshConverter::buildMeshFromQtData(mesh, vertices, indices);
+    geometry::MeshConverter::buildMeshFromQtData(mesh, vertices, indices, cache);
+    context.setProgress(0.05);
+    processContext = context.subRange(0.05, 0.5); // ռ 5%-50%, ռ 50%-95%
 
     // 2֤߽ṹȷ
     if (!mesh.isValid()) {
@@ -22,8 +27,14 @@ MeshProcessor::processOBJData(const std::vector<QVector3D>& vertices,
 	tuttes_embedding();
 
     // 3ִʵʵļδҪԼʵֵĲ֣
+    processContext = context.subRange(0.5, 0.95);
     processGeometry();
 
+    if (context.isCancelled()) {
+        mesh = geometry::HalfEdgeMesh(); // ȡ: ͬһͷ, Ҫ
+        return {};
+    }
+
     // 4ʹgeometryģMeshConverterתQtʽ
     return geometry::MeshConverter::convertMeshToQtData(mesh);
 }
@@ -31,6 +42,7 @@ MeshProcessor::processOBJData(const std::vector<QVector3D>& vertices,
 // local - global  ʵֲӳ
 // Most-Isometric Parameterizations of Surface Meshes
 void MeshProcessor::processGeometry() {
+    auto& oldPosition = mesh.vertexProperty<Eigen::Vector3d>("v:old_position", Eigen::Vector3d::Zero());
     // jacobΪŻ, ԹϵkŻ
     // ˼ֱӶjacobȾ任    
 	int total_faces = static_cast<int>(mesh.faces.size());
@@ -49,7 +61,8 @@ void MeshProcessor::processGeometry() {
 
 	std::vector<std::array<int, 3>> v_id(total_faces);
 
-	for (int fi = 0; fi < total_faces; ++fi) {
+	// ÿ Jacobian  SVD ֻд, 沢
+	geometry::parallel::parallelFor(0, total_faces, [&](size_t fi) {
 		geometry::Face* face = mesh.faces[fi].get();
 		geometry::HalfEdge* he = face->halfEdge;
 		int i0 = he->vertex->index;
@@ -57,12 +70,12 @@ void MeshProcessor::processGeometry() {
 		int i2 = he->next->next->vertex->index;
 		v_id[fi] = { i0, i1, i2 };
 
-		Eigen::Vector3d p0 = mesh.vertices[i0]->old_position;
-		Eigen::Vector3d p1 = mesh.vertices[i1]->old_position;
-		Eigen::Vector3d p2 = mesh.vertices[i2]->old_position;
+		Eigen::Vector3d p0 = oldPosition[i0];
+		Eigen::Vector3d p1 = oldPosition[i1];
+		Eigen::Vector3d p2 = oldPosition[i2];
 		double a = (p1 - p0).cross(p2 - p0).norm() * 0.5;
 		area[fi] = a;
-		if (a < 1e-12) continue;
+		if (a < 1e-12) return;
 
 		xx[fi] = Eigen::Vector3d(p2.x() - p1.x(), p0.x() - p2.x(), p1.x() - p0.x());
 		yy[fi] = Eigen::Vector3d(p1.y() - p2.y(), p2.y() - p0.y(), p0.y() - p1.y());
@@ -88,7 +101,7 @@ void MeshProcessor::processGeometry() {
 		Sigma(1, 1) = svd.singularValues()(1);
 		S[fi] = V * Sigma * V.transpose();
 		angle[fi] = std::atan2(R(1, 0), R(1, 1));
-	}
+	}, 512);
 
 	// ̶һ㣨οʵֱɾ penalty ȼ۹̶
 	int fixed = nv - 1;
@@ -118,15 +131,19 @@ void MeshProcessor::processGeometry() {
 	trip.emplace_back(2 * fixed + 1, 2 * fixed + 1, penalty);
 
 	A.setFromTriplets(trip.begin(), trip.end());
+	if (processContext.isCancelled()) return; // ֽⲻж, ǰѯȡ
+	processContext.setProgress(0.3);
 	Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> solver;
 	solver.compute(A);
 	if (solver.info() != Eigen::Success) {
 		std::cout << "ֽʧܣ" << std::endl;
 		return;
 	}
+	if (processContext.isCancelled()) return;
+	processContext.setProgress(0.8);
 
-	// ȡһ t=1 ⣨ȼۻҵֻҪղ
-	double t = 1.0;
+	// ȡһ t ⣨Ĭ t=1, ȼۻҵֻҪղ
+	const double t = params.getDouble("t", 1.0);
 	Eigen::Matrix2d I = Eigen::Matrix2d::Identity();
 	Eigen::VectorXd b(2 * nv);
 	b.setZero();
@@ -156,57 +173,33 @@ void MeshProcessor::processGeometry() {
 		return;
 	}
 
-	for (int i = 0; i < nv; ++i) {
+	geometry::parallel::parallelFor(0, nv, [&](size_t i) {
 		mesh.vertices[i]->position.x() = result(2 * i);
 		mesh.vertices[i]->position.y() = result(2 * i + 1);
 		mesh.vertices[i]->position.z() = 0.0;
-	}
+	});
 }
 
 
 
 void MeshProcessor::tuttes_embedding() {
+	auto& boundaryIndex = mesh.vertexProperty<int>("v:boundary_index", -1); // ߽-1ʾǱ߽綥
+	auto& oldPosition = mesh.vertexProperty<Eigen::Vector3d>("v:old_position", Eigen::Vector3d::Zero());
 
 	int size = mesh.vertices.size();
 	if (size == 0) return;
 	for (auto& v : mesh.vertices) {
-		v->boundary_index = -1; // 
+		boundaryIndex[v->index] = -1; // 
 	}
 
-	// б߽ߣǱ߽綥 boundary_index
-	// ˳߽绷** Ҫ
+	// ߽绷񻺴(˲ʱ±), ˳߽綥
+	const geometry::BoundaryLoops& loops = mesh.getBoundaryLoops();
 	int boundary_size = 0;          // ܱ߽綥
-	int boundary_cycle = 0;         // ߽绷
-	std::unordered_set<geometry::HalfEdge*> visitedBoundaryHE;// ʹı߽
-	// аߣҵ߽
-	for (auto& hePtr : mesh.halfEdges) {
-		geometry::HalfEdge* start = hePtr.get();
-		if (start->pair) continue;// Ǳ߽
-		if (visitedBoundaryHE.count(start)) continue;// ˣ
-
-		geometry::HalfEdge* he = start;
-		int step = 0;
-		do {
-			visitedBoundaryHE.insert(he);
-			geometry::Vertex* v = he->vertex;
-			if (v->boundary_index < 0) {
-				v->boundary_index = boundary_size++; //  0 ʼ
-			}
-
-			// һ߽
-			geometry::HalfEdge* candidate = he->next;
-			while (candidate && candidate->pair) {
-				candidate = candidate->pair->next;
-			}
-			he = candidate;
-			step++;
-			if (step > (int)mesh.halfEdges.size()) { // ȫ˳쳣
-				std::cerr << "Warning: boundary walk aborted (non-manifold?)" << std::endl;
-				break;
-			}
-		} while (he && he != start);
-
-		boundary_cycle++;
+	int boundary_cycle = loops.loopCount(); // ߽绷
+	for (int v : loops.vertices) {
+		if (boundaryIndex[v] < 0) {
+			boundaryIndex[v] = boundary_size++; //  0 ʼ
+		}
 	}
 	// ¼ÿ߽绷㣬 Ⱦ
 	std::cout << "Boundary cycles: " << boundary_cycle
@@ -218,6 +211,10 @@ void MeshProcessor::tuttes_embedding() {
 		return;
 	}
 	Eigen::SparseMatrix<double> A(size, size);// һ
+	// ģʽֱȡڽ CSR, ϵͨ valuePtr() д
+	const geometry::VertexAdjacency& adjacency = mesh.getAdjacency();
+	adjacency.initMatrix(A);
+	double* values = A.valuePtr();
 
 	Eigen::VectorXd b_x = Eigen::VectorXd::Zero(size);
 
@@ -229,16 +226,16 @@ void MeshProcessor::tuttes_embedding() {
 	int column = 0;
 	int count = 0;// ¼С
 	for (int i = 0; i < size; i++) {
-		mesh.vertices[i]->old_position = mesh.vertices[i]->position; // ¼λ
+		oldPosition[i] = mesh.vertices[i]->position; // ¼λ
 
 		if (mesh.vertices[i]->isBoundary()) {
 
-			double t = (double)mesh.vertices[i]->boundary_index / (double)boundary_size;// [0, B-1], B=boundary_size
+			double t = (double)boundaryIndex[i] / (double)boundary_size;// [0, B-1], B=boundary_size
 			double theta = 2.0 * M_PI * t;
 			double x = std::cos(theta);
 			double y = std::sin(theta);
 			int index = mesh.vertices[i]->index;
-			A.coeffRef(column, index) = 1;
+			values[adjacency.diagonal[index]] = 1;
 			b_x(column) = x;
 			b_y(column) = y;
 			column++;
@@ -246,27 +243,27 @@ void MeshProcessor::tuttes_embedding() {
 		}
 		// ڲĵ
 		else {
-			geometry::HalfEdge* hf = mesh.vertices[i]->halfEdge;
 			count = 0;
-			do {
-
-				A.coeffRef(column, hf->pair->vertex->index) = -1;
-				hf = hf->pair->next;// һ
-				// i У
+			for (geometry::HalfEdge* he : geometry::outgoingHalfEdges(mesh.vertices[i].get())) {
+				values[adjacency.halfEdgeSlot[he->index]] = -1;// һ򶥵
 				count++;
-			} while (hf != mesh.vertices[i]->halfEdge);
+			}
 		}
-		A.coeffRef(column, mesh.vertices[i].get()->index) = count;
+		values[adjacency.diagonal[i]] = count;
 		column++;
 	}
 
 	// ʼ
+	if (processContext.isCancelled()) return;
+	processContext.setProgress(0.3);
 	Eigen::SparseLU<Eigen::SparseMatrix<double>> solver;
 	solver.compute(A);
 	if (solver.info() != Eigen::Success) {
 		std::cerr << "Decomposition failed!" << std::endl;
 		return;
 	}
+	if (processContext.isCancelled()) return;
+	processContext.setProgress(0.8);
 	pos_x = solver.solve(b_x);
 	pos_y = solver.solve(b_y);
 
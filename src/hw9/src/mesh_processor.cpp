@@ -7,23 +7,51 @@
 #include <OpenMesh/Core/Mesh/TriMesh_ArrayKernelT.hh>
 #include <OpenMesh/Tools/Decimater/DecimaterT.hh>
 #include <OpenMesh/Tools/Decimater/ModQuadricT.hh>
+#include <OpenMesh/Tools/Decimater/Observer.hh>
+
+namespace {
+
+// ѼĽȺȡӵ ProcessContext : ÿ 256 ۵صһ, ȡʱ decimater ͣһ״̬
+class DecimationObserver : public OpenMesh::Decimater::Observer {
+public:
+    DecimationObserver(const geometry::ProcessContext& context, size_t collapses)
+        : OpenMesh::Decimater::Observer(256), context(context), collapses(collapses) {}
+
+    void notify(size_t step) override { context.setProgress(step, collapses); }
+    bool abort() const override { return context.isCancelled(); }
+
+private:
+    geometry::ProcessContext context;
+    size_t collapses; ///< ԤƵ۵(ÿ۵Լ)
+};
+
+} // namespace
 
 std::pair<std::vector<QVector3D>, std::vector<unsigned int>> 
 MeshProcessor::processOBJData(const std::vector<QVector3D>& vertices,
-                              const std::vector<unsigned int>& indices) {
+                              const std::vector<unsigned int>& indices,
+                              const geometry::ProcessContext& context,
+                              const geometry::MeshCache* cache) {
     
     // 1ʹgeometryģMeshConverter
-    geometry::MeshConverter::buildMeshFromQtData(mesh, vertices, indices);
+    geometry::MeshConverter::buildMeshFromQtData(mesh, vertices, indices, cache);
+    context.setProgress(0.05);
+    processContext = context.subRange(0.05, 0.95); // δռ 5%-95%, Ϊת
 
     // 2֤߽ṹȷ
     if (!mesh.isValid()) {
         std::cerr << "Warning: Generated half-edge mesh is invalid!" << std::endl;
     }
 
-    int n = 100;
+    int n = params.getInt("faces", 100);
     // 3ִʵʵļδҪԼʵֵĲ֣
     processGeometry(n);
 
+    if (context.isCancelled()) {
+        mesh = geometry::HalfEdgeMesh(); // ȡ: ͬһͷ, Ҫ
+        return {};
+    }
+
     // 4ʹgeometryģMeshConverterתQtʽ
     return geometry::MeshConverter::convertMeshToQtData(mesh);
 }
@@ -74,6 +102,8 @@ void MeshProcessor::processGeometry(int n) {
     }
 
     if (om.n_faces() == 0) return;
+    if (processContext.isCancelled()) return;
+    processContext.setProgress(0.1);
 
     // 2) OpenMesh QEM decimation
     // ʹ OpenMesh Դ Quadric Error Metrics ģ飬ڲϷ edge collapse
@@ -89,7 +119,11 @@ void MeshProcessor::processGeometry(int n) {
     if (target_faces < 1) target_faces = 1;
     if (target_faces >= om.n_faces()) return;
 
+    DecimationObserver observer(processContext.subRange(0.1, 0.9), (om.n_faces() - target_faces + 1) / 2);
+    decimater.set_observer(&observer);
     decimater.decimate_to_faces(target_faces);
+    decimater.set_observer(nullptr);
+    if (processContext.isCancelled()) return; // om 溯ͷ
     // ɾԪأѹ
     om.garbage_collection();
 
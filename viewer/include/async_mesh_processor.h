@@ -2,22 +2,31 @@
 #define ASYNC_MESH_PROCESSOR_H
 
 #include <QObject>
-#include <QThread>
 #include <QVector3D>
 #include <functional>
 #include <vector>
 #include <memory>
+#include <deque>
+#include <future>
+#include <process_context.h>
+#include "mesh_snapshot.h"
 
 /* --------------------------------------------------------------------------
  * MeshProcessWorker
- * ˵: ڶִ߳кʱɺͨźŷؽ
+ * ˵: ִ̳߳߳кʱɺͨźŷؽ
+ *       յ ProcessContext, ڵ֮ѯȡϱ;
+ *       ȡ cancelled  finished
+ *       ͽ MeshSnapshotPtr, ̴߳ʱָֻ롣
+ *       մа߻ʱһ(ûʱΪ nullptr)
  * -------------------------------------------------------------------------- */
 class MeshProcessWorker : public QObject {
     Q_OBJECT
 public:
     using ProcessFunction = std::function<std::pair<std::vector<QVector3D>, std::vector<unsigned int>>(
         const std::vector<QVector3D>&,
-        const std::vector<unsigned int>&)>;
+        const std::vector<unsigned int>&,
+        const geometry::ProcessContext&,
+        const geometry::MeshCache*)>;
 
     explicit MeshProcessWorker(QObject* parent = nullptr);
     ~MeshProcessWorker();
@@ -25,13 +34,14 @@ public:
     void setProcessFunction(ProcessFunction func);
 
 public slots:
-    void process(const std::vector<QVector3D>& vertices,
-                 const std::vector<unsigned int>& indices);
+    void process(quint64 generation,
+                 const MeshSnapshotPtr& mesh,
+                 const geometry::ProcessContext& context);
 
 signals:
-    void finished(const std::vector<QVector3D>& vertices,
-                  const std::vector<unsigned int>& indices);
-    void error(const QString& errorMessage);
+    void finished(quint64 generation, const MeshSnapshotPtr& mesh);
+    void error(quint64 generation, const QString& errorMessage);
+    void cancelled(quint64 generation);
     void progressUpdated(int progress); // 0-100
 
 private:
@@ -40,42 +50,66 @@ private:
 
 /* --------------------------------------------------------------------------
  * AsyncMeshProcessor
- * ˵: װ worker ߳ڣṩ startProcessing ýӿڡ
+ * ˵: ṩ startProcessing ýӿ, 񽻸 geometry ȫִ̳߳,
+ *       뼸ںеĲѭͬһ߳, ռ CPU ġ
+ *       ÿеĴ(generation), ٴύʱ QueuePolicy ȥ;
+ *       ύ˳ɷ(ͬһʱֻһ), ȡһѯʱ˳
+ *       ʹʱѱȡ(򱻸µȡ),  processingCancelled,
+ *       Թڽᵽ档
  * -------------------------------------------------------------------------- */
 class AsyncMeshProcessor : public QObject {
     Q_OBJECT
 public:
     using ProcessFunction = MeshProcessWorker::ProcessFunction;
 
+    /// յʱĲ
+    enum class QueuePolicy {
+        DropNew,    ///< (Ĭ); ǰȡʱճύ
+        LatestWins, ///< ȡкŶӵ, ֻĽᷢ
+        Fifo        ///< ύ˳δ, ÿ
+    };
+
     explicit AsyncMeshProcessor(QObject* parent = nullptr);
     ~AsyncMeshProcessor();
 
     void setProcessFunction(ProcessFunction func);
-    void startProcessing(const std::vector<QVector3D>& vertices,
-                         const std::vector<unsigned int>& indices);
+    void startProcessing(const MeshSnapshotPtr& mesh); // ָ뱻
     bool isProcessing() const;
-    void cancel(); // ǰδʵжϣʾչλ
+    void cancel(); // ȡδ(Эʽ, )
+
+    void setQueuePolicy(QueuePolicy policy);
+    QueuePolicy queuePolicy() const;
+    quint64 latestGeneration() const; // һαܵĴ, ʱΪ 0
 
 signals:
-    void processingFinished(const std::vector<QVector3D>& vertices,
-                            const std::vector<unsigned int>& indices);
+    void processingFinished(const MeshSnapshotPtr& mesh);
     void processingStarted();
     void processingError(const QString& errorMessage);
+    void processingCancelled();
     void progressUpdated(int progress);
 
 private slots:
-    void onWorkerFinished(const std::vector<QVector3D>& vertices,
-                          const std::vector<unsigned int>& indices);
-    void onWorkerError(const QString& errorMessage);
+    void onWorkerFinished(quint64 generation, const MeshSnapshotPtr& mesh);
+    void onWorkerError(quint64 generation, const QString& errorMessage);
+    void onWorkerCancelled(quint64 generation);
     void onWorkerProgress(int progress);
 
 private:
-    void startProcessInternal(const std::vector<QVector3D>& vertices,
-                              const std::vector<unsigned int>& indices);
+    bool finishJob(quint64 generation); // Ƴѽɷһ, ǷȻЧ
+    void dispatchNext();                // ûʱѶύ̳߳
+
+    struct Job {
+        quint64 generation;
+        geometry::ProcessContext context;
+        MeshSnapshotPtr mesh; ///< , ɷʱƽ̳߳
+    };
 
-    QThread* workerThread { nullptr };
     MeshProcessWorker* worker { nullptr };
-    bool processing { false };
+    bool running { false };                    ///< ɷδ
+    std::future<void> runningTask;             ///< ɷ, ʱȴ
+    std::deque<Job> jobs;                      ///< ύδ(//ȡ), ύ˳
+    quint64 generationCounter { 0 };           ///< һαܵĴ
+    QueuePolicy policy { QueuePolicy::DropNew };
 };
 
 #endif // ASYNC_MESH_PROCESSOR_H
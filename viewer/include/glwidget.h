@@ -7,6 +7,7 @@
 #include <QMatrix4x4>
 #include <QVector2D>
 #include "objloader.h"
+#include "mesh_snapshot.h"
 #include <QOpenGLShaderProgram>
 #include <QString>
 #include <vector>
@@ -43,9 +44,9 @@ public:
     explicit GLWidget(QWidget *parent = nullptr);
     ~GLWidget() override;
 
-    void updateMesh(const std::vector<QVector3D>& vertices, const std::vector<unsigned int>& indices);
-    void updateMeshWithColors(const std::vector<QVector3D>& vertices,
-     const std::vector<unsigned int>& indices,
+    /// ʾһ, ָֻ벢ϴ GPU; ָ뱻
+    void updateMesh(MeshSnapshotPtr snapshot);
+    void updateMeshWithColors(MeshSnapshotPtr snapshot,
        const std::vector<QVector3D>& colorsIn);
     void updateMSTEdges(const std::vector<std::pair<int,int>>& edges);
     void clearMSTEdges();
@@ -53,6 +54,8 @@ public:
     bool loadObject(const QString& fileName);
     const std::vector<QVector3D>& getVertices() const;
     const std::vector<unsigned int>& getIndices() const;
+    /// ǰʾ(Ϊ),  worker ʱ
+    MeshSnapshotPtr getMesh() const;
 
     void setWireframe(bool enabled) { wireframe = enabled; update(); }
     void setShowColoredPoints(bool enabled) { showColoredPoints = enabled; update(); }
@@ -120,11 +123,13 @@ public:
      * @brief ARAPקλص
      * @param int handle
      * @param QVector3D handleλ
-     * @return κݣ
-     * ⲿô˺ִARAP㷨mesh
+     * @param vertices ǰʾĶ, صֱӰѱκλдȥ
+     * @param indices ǰʾ, ֻ˸ıʱصд
+     * @return дʱ true
+     * ⲿô˺ִARAP㷨, ÿֻ֡λ, ݸ mesh
      * ʱûקʱʵʱ
      */
-    std::function<std::pair<std::vector<QVector3D>, std::vector<unsigned int>>(int, const QVector3D&)> arapDragCallback;
+    std::function<bool(int, const QVector3D&, std::vector<QVector3D>&, std::vector<unsigned int>&)> arapDragCallback;
 
 protected:
     void initializeGL() override;
@@ -196,8 +201,8 @@ QVector2D panOffset;
 QVector3D modelCenter;
   float modelRadius;
 
-    std::vector<QVector3D> vertices;
-    std::vector<unsigned int> indices;
+    MeshSnapshotPtr mesh;                    // ǰʾ,  worker/MainWindow 
+    std::shared_ptr<MeshSnapshot> arapMesh;  // ARAP קʱ˽и(дʱ), mesh ָ
     std::vector<QVector3D> colors;
     std::vector<QVector3D> mstLineVertices;
 
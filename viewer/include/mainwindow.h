@@ -19,6 +19,7 @@
  *- ṩ첽ź(objLoaded)
  *   - ɫ/ʾлť
  *   - : ARAP˵4ť
+ *   - ȡť(cancelRequested) ״̬еĴ
  * -------------------------------------------------------------------------- */
 class MainWindow : public QMainWindow {
     Q_OBJECT
@@ -26,18 +27,19 @@ public:
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow() override;
 
-    void updateMesh(const std::vector<QVector3D>& vertices,
-       const std::vector<unsigned int>& indices);
-    void updateMeshWithColors(const std::vector<QVector3D>& vertices,
-   const std::vector<unsigned int>& indices,
+    void updateMesh(const MeshSnapshotPtr& mesh);
+    void updateMeshWithColors(const MeshSnapshotPtr& mesh,
       const std::vector<QVector3D>& colors);
+    void showProcessingProgress(int progress); // ״̬ʾ(0-100)
+    void showProcessingCancelled();
 
 signals:
-    void objLoaded(const std::vector<QVector3D>& vertices,
-        const std::vector<unsigned int>& indices);
+    void objLoaded(const MeshSnapshotPtr& mesh); // ֻݿָ, 
+    void cancelRequested(); // ȡڽеĴ
 
 private slots:
     void openFile();       // ģ
+    void saveFile();       // ǰģ(OBJ/PLY)
     void restoreModel();   // ָԭʼģ
     void requestProcess(); // ٴδ
     void togglePoints();   // ʾ/زɫ
@@ -57,6 +59,7 @@ private:
     GLWidget *glWidget { nullptr };
     QPushButton *restoreButton { nullptr };
     QPushButton *processButton { nullptr };
+    QPushButton *cancelButton { nullptr };
     QPushButton *togglePointsButton { nullptr };
     QPushButton *colorModeButton { nullptr };
     QPushButton *filledFaceButton { nullptr };
@@ -71,8 +74,7 @@ private:
 
     bool pointsVisible = true;
 
-    std::vector<QVector3D> originalVertices;
-    std::vector<unsigned int> originalIndices;
+    MeshSnapshotPtr originalMesh; // ļʱ, ڻָ
 };
 
 #endif // MAINWINDOW_H
\ No newline at end of file
@@ -0,0 +1,35 @@
+﻿#ifndef MESH_SNAPSHOT_H
+#define MESH_SNAPSHOT_H
+
+#include <QVector3D>
+#include <vector>
+#include <memory>
+
+namespace geometry { class MeshCache; }
+
+/* --------------------------------------------------------------------------
+ * MeshSnapshot
+ * 说明: 一份三角网格(顶点 + 索引)。通过 MeshSnapshotPtr(shared_ptr<const>) 在
+ *       加载器 -> worker 线程 -> 界面 -> GL 上传之间传递, 各环节只复制指针;
+ *       发布之后任何持有者都不再修改它, 需要修改时先复制(见 GLWidget 的 ARAP 拖拽)。
+ * -------------------------------------------------------------------------- */
+struct MeshSnapshot {
+    std::vector<QVector3D> vertices;
+    std::vector<unsigned int> indices; ///< 三角形索引 (每3个为一面)
+    /// 与 vertices/indices 完全对应的半边缓存(从 OBJ 加载时才有, 否则为空), 处理函数由它构建半边网格时不用重新配对半边
+    std::shared_ptr<const geometry::MeshCache> cache;
+};
+
+using MeshSnapshotPtr = std::shared_ptr<const MeshSnapshot>;
+
+/// 把顶点/索引移入一个新的快照(调用方传右值时不复制数据)
+inline MeshSnapshotPtr makeMeshSnapshot(std::vector<QVector3D> vertices, std::vector<unsigned int> indices,
+                                        std::shared_ptr<const geometry::MeshCache> cache = nullptr) {
+    auto snapshot = std::make_shared<MeshSnapshot>();
+    snapshot->vertices = std::move(vertices);
+    snapshot->indices = std::move(indices);
+    snapshot->cache = std::move(cache);
+    return snapshot;
+}
+
+#endif // MESH_SNAPSHOT_H
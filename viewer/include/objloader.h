@@ -3,11 +3,18 @@
 
 #include <vector>
 #include <string>
+#include <memory>
 #include <QVector3D>
 
+namespace geometry { struct MeshData; class MeshCache; }
+
 /**
- * @brief  OBJ ļ (֧ v / f )
- * ֧:  /  /  / ı߼϶
+ * @brief ļ,  geometry::readOBJ/readPLY/readSTL (ڴӳ + ߳)
+ * ֧ v / vt / vn / f, ΰǻд indices,  OBJ 
+ * Ҳֶ֧ PLY  STL(STL ʱẸغ϶)
+ * loadMesh  OBJ ʱʹͬĿ¼µĶƻ(<ļ>.hecache), ȱʧʱ;
+ * 汣ǻź,  vertices/indices һһӦ, ֱ
+ * ֧: 
  */
 class ObjLoader {
 public:
@@ -18,10 +25,26 @@ public:
      */
     bool loadOBJ(const std::string& path);
 
+    /**
+     * @brief չ .obj / .ply / .stl
+     * @param path ļ·
+     * @return ɹ true
+     */
+    bool loadMesh(const std::string& path);
+
     std::vector<QVector3D> vertices;   ///< λ
     std::vector<QVector3D> colors;     ///< (δʹ) չ
-    std::vector<QVector3D> normals;    ///< (δ) չ
+    std::vector<QVector3D> normals;    ///< 㷨(ļ vn ʱǵ, Ϊ)
     std::vector<unsigned int> indices; ///<  (ÿ3Ϊһ)
+    std::shared_ptr<const geometry::MeshCache> cache; ///<  vertices/indices Ӧİ߻(ֻ OBJ , Ϊ)
+
+private:
+    /// MeshData -> //𶥵㷨
+    bool assign(const geometry::MeshData& data);
+    /// ƻ -> /(ֱӱеİ, ѾŹ)
+    bool assign(const geometry::MeshCache& cache);
+    /// 㻺/ȻŻ˳, ǰ ACMR
+    void reorderTriangles();
 };
 
 #endif // OBJLOADER_H
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "async_mesh_processor.h"
 #include <QDebug>
+#include <algorithm>
+#include <thread_pool.h>
 
 /* ============================ MeshProcessWorker ============================ */
 MeshProcessWorker::MeshProcessWorker(QObject *parent) : QObject(parent) {}
@@ -7,89 +9,156 @@ MeshProcessWorker::~MeshProcessWorker() = default;
 
 void MeshProcessWorker::setProcessFunction(ProcessFunction func) { processFunc = std::move(func); }
 
-void MeshProcessWorker::process(const std::vector<QVector3D>& vertices,
-                                const std::vector<unsigned int>& indices) {
+void MeshProcessWorker::process(quint64 generation,
+                                const MeshSnapshotPtr& mesh,
+                                const geometry::ProcessContext& context) {
     try {
         if (!processFunc) {
-            emit error("Process function not set");
+            emit error(generation, "Process function not set");
+            return;
+        }
+        if (context.isCancelled()) { // Ŷڼѱȡ򱻸µȡ
+            emit cancelled(generation);
             return;
         }
         qDebug() << "Worker thread: Starting mesh processing...";
-        emit progressUpdated(0);
-        auto result = processFunc(vertices, indices); // ִкʱ
-        emit progressUpdated(100);
+        context.setProgress(0.0);
+        auto result = processFunc(mesh->vertices, mesh->indices, context, mesh->cache.get()); // ִкʱ
+        if (context.isCancelled()) {
+            result = {}; // Ч, ͷ֪ͨ, һ񲻱ص
+            qDebug() << "Worker thread: Mesh processing cancelled.";
+            emit cancelled(generation);
+            return;
+        }
+        context.setProgress(1.0);
         qDebug() << "Worker thread: Mesh processing completed.";
-        emit finished(result.first, result.second);
+        // ֻ, ֮ GL ϴһ
+        emit finished(generation, makeMeshSnapshot(std::move(result.first), std::move(result.second)));
     } catch (const std::exception& e) {
-        emit error(QString("Processing error: %1").arg(e.what()));
+        emit error(generation, QString("Processing error: %1").arg(e.what()));
     } catch (...) {
-        emit error("Unknown processing error");
+        emit error(generation, "Unknown processing error");
     }
 }
 
 /* =========================== AsyncMeshProcessor ============================ */
 AsyncMeshProcessor::AsyncMeshProcessor(QObject *parent)
     : QObject(parent) {
-    workerThread = new QThread(this);
-    worker = new MeshProcessWorker();
-    worker->moveToThread(workerThread);
+    // worker ڱ߳; źŴ̷̳߳߳, ԶŶӷʽص
+    worker = new MeshProcessWorker(this);
 
     connect(worker, &MeshProcessWorker::finished,
             this, &AsyncMeshProcessor::onWorkerFinished);
     connect(worker, &MeshProcessWorker::error,
             this, &AsyncMeshProcessor::onWorkerError);
+    connect(worker, &MeshProcessWorker::cancelled,
+            this, &AsyncMeshProcessor::onWorkerCancelled);
     connect(worker, &MeshProcessWorker::progressUpdated,
             this, &AsyncMeshProcessor::onWorkerProgress);
-
-    connect(workerThread, &QThread::finished,
-            worker, &QObject::deleteLater);
-
-    workerThread->start();
 }
 
 AsyncMeshProcessor::~AsyncMeshProcessor() {
-    if (workerThread) {
-        workerThread->quit();
-        workerThread->wait();
-    }
+    cancel(); // еһѯʱ˳, ص
+    if (runningTask.valid()) runningTask.wait(); // worker ʹҪ񷵻
 }
 
 void AsyncMeshProcessor::setProcessFunction(ProcessFunction func) { worker->setProcessFunction(std::move(func)); }
 
-void AsyncMeshProcessor::startProcessing(const std::vector<QVector3D>& vertices,
-                                         const std::vector<unsigned int>& indices) {
-    if (processing) {
-        qWarning() << "AsyncMeshProcessor: Already processing, ignoring new request";
-        return;
+void AsyncMeshProcessor::startProcessing(const MeshSnapshotPtr& mesh) {
+    if (!mesh) return;
+    const bool busy = std::any_of(jobs.begin(), jobs.end(),
+                                  [](const Job& job) { return !job.context.isCancelled(); });
+    if (busy) {
+        switch (policy) {
+        case QueuePolicy::DropNew:
+            qWarning() << "AsyncMeshProcessor: Already processing, ignoring new request";
+            return;
+        case QueuePolicy::LatestWins:
+            qDebug() << "AsyncMeshProcessor: Superseding" << jobs.size() << "pending request(s)";
+            for (const Job& job : jobs) job.context.cancel(); // еһѯʱ˳
+            break;
+        case QueuePolicy::Fifo:
+            break;
+        }
     }
-    processing = true;
+
+    // Ȼص̳߳߳е,  worker źŶӻص߳
+    MeshProcessWorker* target = worker;
+    const quint64 generation = ++generationCounter;
+    jobs.push_back({ generation, geometry::ProcessContext::create([target](int progress) {
+        emit target->progressUpdated(progress);
+    }), mesh });
     emit processingStarted();
-    qDebug() << "AsyncMeshProcessor: Starting async processing...";
+    qDebug() << "AsyncMeshProcessor: Starting async processing, generation" << generation;
+    dispatchNext();
+}
 
-    QMetaObject::invokeMethod(worker, [this, vertices, indices]() {
-        worker->process(vertices, indices);
-    }, Qt::QueuedConnection);
+void AsyncMeshProcessor::dispatchNext() {
+    if (running || jobs.empty()) return;
+    // ύ˳, ׾һҪе
+    Job& job = jobs.front();
+    running = true;
+    auto done = std::make_shared<std::promise<void>>();
+    runningTask = done->get_future();
+    // ֻпָ; ʹ, ҲһֱЧ
+    geometry::parallel::ThreadPool::global().submit(
+        [target = worker, done, generation = job.generation, mesh = std::move(job.mesh), context = job.context]() {
+            target->process(generation, mesh, context);
+            done->set_value();
+        });
 }
 
-bool AsyncMeshProcessor::isProcessing() const { return processing; }
+bool AsyncMeshProcessor::isProcessing() const { return !jobs.empty(); }
 
 void AsyncMeshProcessor::cancel() {
-    if (processing) {
-        qDebug() << "AsyncMeshProcessor: Cancel requested (not implemented)";
+    if (!jobs.empty()) {
+        qDebug() << "AsyncMeshProcessor: Cancel requested";
+        for (const Job& job : jobs) job.context.cancel();
     }
 }
 
-void AsyncMeshProcessor::onWorkerFinished(const std::vector<QVector3D>& vertices,
-                                          const std::vector<unsigned int>& indices) {
-    processing = false;
+void AsyncMeshProcessor::setQueuePolicy(QueuePolicy newPolicy) { policy = newPolicy; }
+
+AsyncMeshProcessor::QueuePolicy AsyncMeshProcessor::queuePolicy() const { return policy; }
+
+quint64 AsyncMeshProcessor::latestGeneration() const { return generationCounter; }
+
+bool AsyncMeshProcessor::finishJob(quint64 generation) {
+    auto it = std::find_if(jobs.begin(), jobs.end(),
+                           [generation](const Job& job) { return job.generation == generation; });
+    if (it == jobs.end()) return false;
+    // ɺűȡ(ȡ)ͬΪ
+    const bool valid = !it->context.isCancelled();
+    jobs.erase(it);
+    running = false;
+    dispatchNext();
+    return valid;
+}
+
+void AsyncMeshProcessor::onWorkerFinished(quint64 generation, const MeshSnapshotPtr& mesh) {
+    if (!finishJob(generation)) {
+        qDebug() << "AsyncMeshProcessor: Discarding stale result, generation" << generation;
+        emit processingCancelled();
+        return;
+    }
     qDebug() << "AsyncMeshProcessor: Processing finished successfully";
-    emit processingFinished(vertices, indices);
+    emit processingFinished(mesh);
 }
 
-void AsyncMeshProcessor::onWorkerError(const QString& errorMessage) {
-    processing = false;
+void AsyncMeshProcessor::onWorkerError(quint64 generation, const QString& errorMessage) {
+    if (!finishJob(generation)) {
+        qDebug() << "AsyncMeshProcessor: Ignoring error of stale request:" << errorMessage;
+        emit processingCancelled();
+        return;
+    }
     qWarning() << "AsyncMeshProcessor: Processing error:" << errorMessage;
     emit processingError(errorMessage);
 }
 
+void AsyncMeshProcessor::onWorkerCancelled(quint64 generation) {
+    finishJob(generation);
+    qDebug() << "AsyncMeshProcessor: Processing cancelled, generation" << generation;
+    emit processingCancelled();
+}
+
 void AsyncMeshProcessor::onWorkerProgress(int progress) { emit progressUpdated(progress); }
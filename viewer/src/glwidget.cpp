@@ -19,7 +19,8 @@ GLWidget::GLWidget(QWidget* parent)
 	rotationY(0.0f),
 	panOffset(0.0f, 0.0f),
 	modelCenter(0, 0, 0),
-	modelRadius(1.0f) {
+	modelRadius(1.0f),
+	mesh(std::make_shared<const MeshSnapshot>()) {
 	Q_INIT_RESOURCE(resources);
 	setFocusPolicy(Qt::StrongFocus);
 }
@@ -43,10 +44,12 @@ void GLWidget::cycleColorDisplayMode() {
 }
 
 /* ---------------------------- 数据更新: 主网格 ---------------------------- */
-void GLWidget::updateMesh(const std::vector<QVector3D>& v,
-	const std::vector<unsigned int>& idx) {
-	vertices = v;
-	indices = idx;
+void GLWidget::updateMesh(MeshSnapshotPtr snapshot) {
+	if (!snapshot) return;
+	mesh = std::move(snapshot);
+	arapMesh.reset();
+	const auto& vertices = mesh->vertices;
+	const auto& indices = mesh->indices;
 	perVertexColor = false;
 	colors.assign(vertices.size(), QVector3D(1.0f, 1.0f, 1.0f));
 
@@ -67,18 +70,20 @@ void GLWidget::updateMesh(const std::vector<QVector3D>& v,
 }
 
 /* ---------------------------- 数据更新: 带颜色 ----------------------------- */
-void GLWidget::updateMeshWithColors(const std::vector<QVector3D>& v,
-	const std::vector<unsigned int>& idx,
+void GLWidget::updateMeshWithColors(MeshSnapshotPtr snapshot,
 	const std::vector<QVector3D>& cols) {
-	vertices = v;
-	indices = idx;
+	if (!snapshot) return;
+	mesh = std::move(snapshot);
+	arapMesh.reset();
+	const auto& vertices = mesh->vertices;
+	const auto& indices = mesh->indices;
 
-	if (cols.size() == v.size()) {
+	if (cols.size() == vertices.size()) {
 		colors = cols;
 		perVertexColor = true;
 	}
 	else {
-		colors.assign(v.size(), QVector3D(1.0f, 1.0f, 1.0f));
+		colors.assign(vertices.size(), QVector3D(1.0f, 1.0f, 1.0f));
 		perVertexColor = false;
 	}
 
@@ -100,6 +105,7 @@ void GLWidget::updateMeshWithColors(const std::vector<QVector3D>& v,
 
 /* ------------------------------ 更新 MST 线段 ----------------------------- */
 void GLWidget::updateMSTEdges(const std::vector<std::pair<int, int>>& edges) {
+	const auto& vertices = mesh->vertices;
 	mstLineVertices.clear();
 	mstLineVertices.reserve(edges.size() * 2);
 
@@ -131,8 +137,9 @@ void GLWidget::clearMSTEdges() {
 }
 
 /* ------------------------------- 访问接口 ------------------------------- */
-const std::vector<QVector3D>& GLWidget::getVertices() const { return vertices; }
-const std::vector<unsigned int>& GLWidget::getIndices() const { return indices; }
+const std::vector<QVector3D>& GLWidget::getVertices() const { return mesh->vertices; }
+const std::vector<unsigned int>& GLWidget::getIndices() const { return mesh->indices; }
+MeshSnapshotPtr GLWidget::getMesh() const { return mesh; }
 
 /* ------------------------------- Fallback Shader -------------------------- */
 static const char* fallbackVert = R"GLSL(
@@ -198,7 +205,7 @@ void GLWidget::initializeGL() {
 /* --------------------------------- 绘制 ---------------------------------- */
 void GLWidget::paintGL() {
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-	if (vertices.empty() || !program || !program->isLinked()) return;
+	if (mesh->vertices.empty() || !program || !program->isLinked()) return;
 
 	// 线框模式始终保持，用于轮廓；填充面可选叠加
 	glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
@@ -243,7 +250,7 @@ void GLWidget::paintGL() {
 			glVertexAttrib3f(1, 0.85f, 0.85f, 0.85f); // 默认淡灰
 		}
 		indexBuf.bind();
-		glDrawElements(GL_TRIANGLES, static_cast<int>(indices.size()), GL_UNSIGNED_INT, nullptr);
+		glDrawElements(GL_TRIANGLES, static_cast<int>(mesh->indices.size()), GL_UNSIGNED_INT, nullptr);
 	}
 
 	// 再绘制线框
@@ -254,7 +261,7 @@ void GLWidget::paintGL() {
 	program->disableAttributeArray(1);
 	glVertexAttrib3f(1, 1.0f, 1.0f, 1.0f);
 	indexBuf.bind();
-	glDrawElements(GL_TRIANGLES, static_cast<int>(indices.size()), GL_UNSIGNED_INT, nullptr);
+	glDrawElements(GL_TRIANGLES, static_cast<int>(mesh->indices.size()), GL_UNSIGNED_INT, nullptr);
 
 	// MST 线
 	if (!mstLineVertices.empty()) {
@@ -283,7 +290,7 @@ void GLWidget::paintGL() {
 			program->disableAttributeArray(1);
 			glVertexAttrib3f(1, 1.0f, 1.0f, 1.0f);
 		}
-		glDrawArrays(GL_POINTS, 0, static_cast<int>(vertices.size()));
+		glDrawArrays(GL_POINTS, 0, static_cast<int>(mesh->vertices.size()));
 	}
 
 	// ARAP模式：高亮显示所有fixed顶点（蓝色大点）
@@ -297,7 +304,7 @@ void GLWidget::paintGL() {
 
 		// 绘制所有fixed顶点
 		for (int vertexIndex : fixedVertices) {
-			if (vertexIndex >= 0 && vertexIndex < static_cast<int>(vertices.size())) {
+			if (vertexIndex >= 0 && vertexIndex < static_cast<int>(mesh->vertices.size())) {
 				glDrawArrays(GL_POINTS, vertexIndex, 1);
 			}
 		}
@@ -322,7 +329,7 @@ void GLWidget::paintGL() {
 
 /* ------------------------------- 计算包围盒 ------------------------------- */
 void GLWidget::calculateModelBounds() {
-	if (vertices.empty()) return;
+	if (mesh->vertices.empty()) return;
 
 	float minX = std::numeric_limits<float>::max();
 	float maxX = -std::numeric_limits<float>::max();
@@ -331,7 +338,7 @@ void GLWidget::calculateModelBounds() {
 	float minZ = std::numeric_limits<float>::max();
 	float maxZ = -std::numeric_limits<float>::max();
 
-	for (const auto& v : vertices) {
+	for (const auto& v : mesh->vertices) {
 		minX = std::min(minX, v.x()); maxX = std::max(maxX, v.x());
 		minY = std::min(minY, v.y()); maxY = std::max(maxY, v.y());
 		minZ = std::min(minZ, v.z()); maxZ = std::max(maxZ, v.z());
@@ -353,8 +360,9 @@ void GLWidget::resetView() {
 
 /* ------------------------------- 载入 OBJ 文件 ---------------------------- */
 bool GLWidget::loadObject(const QString& file) {
-	if (objLoader.loadOBJ(file.toStdString())) {
-		updateMesh(objLoader.vertices, objLoader.indices);
+	if (objLoader.loadMesh(file.toStdString())) {
+		// 载入的数据直接移入快照, 之后交给 worker/界面时只复制指针
+		updateMesh(makeMeshSnapshot(std::move(objLoader.vertices), std::move(objLoader.indices), std::move(objLoader.cache)));
 		mstLineVertices.clear();
 		return true;
 	}
@@ -404,7 +412,7 @@ void GLWidget::mousePressEvent(QMouseEvent* e) {
 				QVector3D target = modelCenter + QVector3D(panOffset.x(), panOffset.y(), 0.0f);
 				camPos += target;
 				//记录handle深度（距离相机）
-				handleDepth = (vertices[hitVertex] - camPos).length();
+				handleDepth = (mesh->vertices[hitVertex] - camPos).length();
 				//允许后续 mouseMoveEvent触发拖拽
 				leftButtonDraggingHandle = true;
 				std::cout << "[GLWidget] Selected vertex " << hitVertex << " as HANDLE (ready to drag)" << std::endl;
@@ -545,7 +553,7 @@ void GLWidget::beginArapIfNeeded() {
  * 4. 返回距离最近且在15像素阈值内的顶点
  */
 int GLWidget::pickVertex(const QPoint& pos) const {
-	if (vertices.empty()) return -1;
+	if (mesh->vertices.empty()) return -1;
 
 	// 构建MVP矩阵（与paintGL中相同）
 	float aspect = (width() > 0 && height() > 0) ? (float)width() / (float)height() : 1.0f;
@@ -573,9 +581,9 @@ int GLWidget::pickVertex(const QPoint& pos) const {
 	int bestVertex = -1;
 	float bestDistance = 15.0f; // 像素阈值：只拾取15像素内的顶点
 
-	for (int i = 0; i < (int)vertices.size(); ++i) {
+	for (int i = 0; i < (int)mesh->vertices.size(); ++i) {
 		// 顶点变换到裁剪空间
-		QVector4D clipPos = mvp * QVector4D(vertices[i], 1.0f);
+		QVector4D clipPos = mvp * QVector4D(mesh->vertices[i], 1.0f);
 
 		if (clipPos.w() == 0) continue; // 避免除零
 
@@ -684,21 +692,34 @@ void GLWidget::performArapDrag(const QPoint& pos) {
 	// 将屏幕坐标转换为3D世界坐标
 	QVector3D newWorldPos = screenToWorld(pos, handleDepth);
 
-	// 调用ARAP算法回调
-	auto result = arapDragCallback(arapHandleVertex, newWorldPos);
+	// 快照是共享只读的: 第一次拖拽(或快照又被别处持有)时复制一份私有副本, 之后每帧原地修改
+	if (mesh != arapMesh || mesh.use_count() > 2) {
+		arapMesh = std::make_shared<MeshSnapshot>(*mesh);
+		arapMesh->cache.reset(); // 拖拽会移动顶点, 缓存不再对应
+		mesh = arapMesh;
+	}
+	auto& vertices = arapMesh->vertices;
+	auto& indices = arapMesh->indices;
 
-	// 只更新顶点数据，不重置视图或重新计算包围盒
-	vertices = result.first;
-	indices = result.second;
+	// 调用ARAP算法回调: 位置直接写入 vertices, 拓扑不变时 indices 保持原样
+	const bool topologyChanged = arapDragCallback(arapHandleVertex, newWorldPos, vertices, indices);
 
 	if (!isValid()) return;
 
-	// 只更新 GPU 缓冲区
+	// 只更新 GPU 缓冲区, 大小不变时原地覆写
+	const int vertexBytes = static_cast<int>(vertices.size() * sizeof(QVector3D));
 	vertexBuf.bind();
-	vertexBuf.allocate(vertices.data(), static_cast<int>(vertices.size() * sizeof(QVector3D)));
+	if (vertexBuf.size() == vertexBytes) {
+		vertexBuf.write(0, vertices.data(), vertexBytes);
+	}
+	else {
+		vertexBuf.allocate(vertices.data(), vertexBytes);
+	}
 
-	indexBuf.bind();
-	indexBuf.allocate(indices.data(), static_cast<int>(indices.size() * sizeof(unsigned int)));
+	if (topologyChanged) {
+		indexBuf.bind();
+		indexBuf.allocate(indices.data(), static_cast<int>(indices.size() * sizeof(unsigned int)));
+	}
 
 	// 不调用 calculateModelBounds() 和 resetView()
 	update();  // 仅触发重绘
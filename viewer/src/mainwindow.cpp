@@ -2,6 +2,9 @@
 #include <QVBoxLayout>
 #include <QWidget>
 #include <QHBoxLayout>
+#include <QStatusBar>
+#include <QMessageBox>
+#include <mesh_io.h>
 
 MainWindow::MainWindow(QWidget *parent)
   : QMainWindow(parent) {
@@ -9,6 +12,7 @@ MainWindow::MainWindow(QWidget *parent)
     glWidget         = new GLWidget(this);
     restoreButton    = new QPushButton(tr("recover model"), this);
     processButton    = new QPushButton(tr("denoise"), this);
+    cancelButton     = new QPushButton(tr("cancel"), this);
     togglePointsButton  = new QPushButton(tr("hide points"), this);
     colorModeButton     = new QPushButton(tr("mode: points"), this);
     filledFaceButton = new QPushButton(tr("show filled"), this);
@@ -53,6 +57,7 @@ MainWindow::MainWindow(QWidget *parent)
     auto *buttonLayout = new QHBoxLayout();
     buttonLayout->addWidget(restoreButton);
     buttonLayout->addWidget(processButton);
+    buttonLayout->addWidget(cancelButton);
     buttonLayout->addWidget(togglePointsButton);
     buttonLayout->addWidget(colorModeButton);
     buttonLayout->addWidget(filledFaceButton);
@@ -70,6 +75,7 @@ mainLayout->addLayout(buttonLayout);
     // źŲ
     connect(restoreButton, &QPushButton::clicked, this, &MainWindow::restoreModel);
     connect(processButton, &QPushButton::clicked, this, &MainWindow::requestProcess);
+    connect(cancelButton, &QPushButton::clicked, this, &MainWindow::cancelRequested);
     connect(togglePointsButton, &QPushButton::clicked, this, &MainWindow::togglePoints);
     connect(colorModeButton, &QPushButton::clicked, this, &MainWindow::cycleColorMode);
     connect(filledFaceButton, &QPushButton::clicked, this, &MainWindow::toggleFilledFaces);
@@ -82,40 +88,76 @@ MainWindow::~MainWindow() = default;
 void MainWindow::createMenus() {
     QMenu *fileMenu = menuBar()->addMenu(tr("&File"));
     fileMenu->addAction(tr("&Open"), this, &MainWindow::openFile);
+    fileMenu->addAction(tr("&Save As"), this, &MainWindow::saveFile);
     fileMenu->addSeparator();
     fileMenu->addAction(tr("E&xit"), this, &QWidget::close);
 }
 
 void MainWindow::openFile() {
-    QString fileName = QFileDialog::getOpenFileName(this, tr("Open OBJ File"), "", tr("OBJ Files (*.obj)"));
+    QString fileName = QFileDialog::getOpenFileName(this, tr("Open Mesh File"), "", tr("Mesh Files (*.obj *.ply *.stl *.gpmc)"));
     if (!fileName.isEmpty() && glWidget->loadObject(fileName)) {
-   originalVertices = glWidget->getVertices();
-        originalIndices  = glWidget->getIndices();
+   originalMesh = glWidget->getMesh(); //  GLWidget ͬһݿ
       glWidget->clearMSTEdges();
-        emit objLoaded(glWidget->getVertices(), glWidget->getIndices());
+        emit objLoaded(originalMesh);
 }
 }
 
+void MainWindow::saveFile() {
+    // п: Իڼ䴦滻 GLWidget ǰ
+    const MeshSnapshotPtr mesh = glWidget->getMesh();
+    const auto& vertices = mesh->vertices;
+    const auto& indices = mesh->indices;
+    if (vertices.empty() || indices.empty()) return;
+    QString fileName = QFileDialog::getSaveFileName(this, tr("Save Mesh File"), "", tr("OBJ Files (*.obj);;PLY Files (*.ply);;Compressed Mesh (*.gpmc)"));
+    if (fileName.isEmpty()) return;
+
+    // ǰʾ -> MeshData
+    geometry::MeshData data;
+    data.positions.reserve(vertices.size() * 3);
+    for (const auto& v : vertices) {
+        data.positions.insert(data.positions.end(), { v.x(), v.y(), v.z() });
+    }
+    data.faceVertices.assign(indices.begin(), indices.end());
+    data.faceOffsets.resize(indices.size() / 3 + 1);
+    for (size_t f = 0; f < data.faceOffsets.size(); ++f) {
+        data.faceOffsets[f] = static_cast<std::uint32_t>(3 * f);
+    }
+    data.faceVertices.resize(3 * (data.faceOffsets.size() - 1));
+    if (!geometry::writeMesh(fileName.toStdString(), data)) {
+        QMessageBox::warning(this, tr("Save Mesh File"), tr("Failed to write %1").arg(fileName));
+    }
+}
+
 void MainWindow::restoreModel() {
-    if (!originalVertices.empty()) {
-        glWidget->updateMesh(originalVertices, originalIndices);
+    if (originalMesh) {
+        glWidget->updateMesh(originalMesh);
    glWidget->clearMSTEdges();
     }
 }
 
 void MainWindow::requestProcess() {
-    emit objLoaded(glWidget->getVertices(), glWidget->getIndices());
+    emit objLoaded(glWidget->getMesh());
+}
+
+void MainWindow::showProcessingProgress(int progress) {
+    if (progress >= 100) {
+        statusBar()->showMessage(tr("processing done"), 2000);
+    } else {
+        statusBar()->showMessage(tr("processing %1%").arg(progress));
+    }
+}
+
+void MainWindow::showProcessingCancelled() {
+    statusBar()->showMessage(tr("processing cancelled"), 2000);
 }
 
-void MainWindow::updateMesh(const std::vector<QVector3D>& vertices,
-      const std::vector<unsigned int>& indices) {
-    glWidget->updateMesh(vertices, indices);
+void MainWindow::updateMesh(const MeshSnapshotPtr& mesh) {
+    glWidget->updateMesh(mesh);
 }
 
-void MainWindow::updateMeshWithColors(const std::vector<QVector3D>& vertices,
-       const std::vector<unsigned int>& indices,
+void MainWindow::updateMeshWithColors(const MeshSnapshotPtr& mesh,
       const std::vector<QVector3D>& colors) {
-    glWidget->updateMeshWithColors(vertices, indices, colors);
+    glWidget->updateMeshWithColors(mesh, colors);
 }
 
 void MainWindow::togglePoints() {
@@ -1,51 +1,154 @@
 #include "objloader.h"
-#include <fstream>
-#include <sstream>
+#include <mesh_io.h>
+#include <mesh_cache.h>
+#include <mesh_converter.h>
+#include <halfedge.h>
+#include <triangle_order.h>
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
 #include <iostream>
 
 bool ObjLoader::loadOBJ(const std::string& path) {
+    geometry::MeshData data;
+    if (!geometry::readOBJ(path, data)) {
+        std::cout << "Failed to open file: " << path << std::endl;
+        return false;
+    }
+    return assign(data);
+}
+
+bool ObjLoader::loadMesh(const std::string& path) {
+    std::string ext = path.size() >= 4 ? path.substr(path.size() - 4) : std::string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    const bool isObj = ext == ".obj";
+    const std::string cachePath = geometry::meshCachePath(path);
+    cache.reset();
+
+    // ԴļĴС޸ʱһʱֱӳ仺, ٽı; ӳһ𽻸
+    if (isObj && std::filesystem::exists(cachePath)) {
+        auto mapped = std::make_shared<geometry::MeshCache>();
+        if (mapped->open(cachePath) && mapped->matchesSource(path) && assign(*mapped)) {
+            std::cout << "Loaded mesh cache " << cachePath << std::endl;
+            cache = std::move(mapped);
+            return true;
+        }
+    }
+
+    geometry::MeshData data;
+    if (!geometry::readMesh(path, data)) {
+        std::cout << "Failed to open file: " << path << std::endl;
+        return false;
+    }
+    if (!assign(data)) return false;
+
+    // һδ(Դļ޸)ʱǻźĶ/ɻ, 봦İȫͬ,
+    // εĴͿʹ; ʧܲӰ챾μ
+    if (isObj) {
+        geometry::HalfEdgeMesh mesh;
+        geometry::MeshConverter::buildMeshFromQtData(mesh, vertices, indices);
+        if (!mesh.isEmpty() && geometry::writeMeshCache(cachePath, mesh, path)) {
+            auto mapped = std::make_shared<geometry::MeshCache>();
+            if (mapped->open(cachePath)) cache = std::move(mapped);
+        }
+    }
+    return true;
+}
+
+void ObjLoader::reorderTriangles() {
+    // ļе˳ͨԶ㻺治Ѻ, źֻı˳, Ų
+    std::vector<float> positions(3 * vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        positions[3 * i] = vertices[i].x();
+        positions[3 * i + 1] = vertices[i].y();
+        positions[3 * i + 2] = vertices[i].z();
+    }
+    geometry::TriangleOrderStats stats;
+    geometry::optimizeTriangleOrder(indices, vertices.size(), positions, geometry::DefaultVertexCacheSize, &stats);
+    std::cout << "Index buffer ACMR " << stats.acmrBefore << " -> " << stats.acmrAfter << std::endl;
+}
+
+bool ObjLoader::assign(const geometry::MeshCache& cache) {
+    vertices.clear();
+    normals.clear();
+    indices.clear();
+
+    const auto positions = cache.positions();
+    const size_t vertexCount = cache.getVertexCount();
+    vertices.resize(vertexCount);
+    for (size_t i = 0; i < vertexCount; ++i) {
+        vertices[i] = QVector3D(static_cast<float>(positions[3 * i]),
+                                static_cast<float>(positions[3 * i + 1]),
+                                static_cast<float>(positions[3 * i + 2]));
+    }
+
+    //  next ÿ, ǻ
+    const auto faceHalfEdge = cache.faceHalfEdge();
+    const auto heVertex = cache.halfEdgeVertex();
+    const auto heNext = cache.halfEdgeNext();
+    const size_t halfEdgeCount = cache.getHalfEdgeCount();
+    auto valid = [&](std::int32_t h) { return h >= 0 && static_cast<size_t>(h) < halfEdgeCount; };
+    for (size_t h = 0; h < halfEdgeCount; ++h) {
+        if (heVertex[h] < 0 || static_cast<size_t>(heVertex[h]) >= vertexCount) return false;
+    }
+    indices.reserve(halfEdgeCount);
+    for (size_t f = 0; f < cache.getFaceCount(); ++f) {
+        const std::int32_t first = faceHalfEdge[f];
+        if (!valid(first) || !valid(heNext[first])) return false;
+        std::int32_t h = heNext[first];
+        size_t steps = 0;
+        while (valid(heNext[h]) && heNext[h] != first && ++steps < halfEdgeCount) {
+            indices.push_back(static_cast<unsigned int>(heVertex[first]));
+            indices.push_back(static_cast<unsigned int>(heVertex[h]));
+            indices.push_back(static_cast<unsigned int>(heVertex[heNext[h]]));
+            h = heNext[h];
+        }
+    }
+
+    // ź, ˳Ż
+    std::cout << "Loaded " << vertices.size() << " vertices and "
+              << indices.size() << " indices" << std::endl;
+
+    return !vertices.empty() && !indices.empty();
+}
+
+bool ObjLoader::assign(const geometry::MeshData& data) {
     // վ
     vertices.clear();
     normals.clear();
     indices.clear();
 
-    std::ifstream file(path);
-    if (!file.is_open()) {
-        std::cout << "Failed to open file: " << path << std::endl;
-        return false;
+    const size_t vertexCount = data.getVertexCount();
+    vertices.resize(vertexCount);
+    for (size_t i = 0; i < vertexCount; ++i) {
+        vertices[i] = QVector3D(data.positions[3 * i], data.positions[3 * i + 1], data.positions[3 * i + 2]);
     }
 
-    std::vector<QVector3D> tempVertices;
-    std::string line;
-
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
-        std::istringstream iss(line);
-        std::string tag;
-        iss >> tag;
-
-        if (tag == "v") {
-            float x, y, z; iss >> x >> y >> z;
-            tempVertices.emplace_back(x, y, z);
-        } else if (tag == "f") {
-            // ֧ "f v1 v2 v3" ʽ/(index/index/index)
-            std::string a, b, c; iss >> a >> b >> c;
-			
-            unsigned int vi[3];
-			// stoiǽַתΪ
-			vi[0] = static_cast<unsigned int>(std::stoi(a)) - 1;// OBJ  1 ʼ
-            vi[1] = static_cast<unsigned int>(std::stoi(b)) - 1;
-            vi[2] = static_cast<unsigned int>(std::stoi(c)) - 1;
-            indices.push_back(vi[0]);
-            indices.push_back(vi[1]);
-            indices.push_back(vi[2]);
+    // ΰǻ: (c0, ck, ck+1)
+    indices.reserve((data.getCornerCount() - 2 * data.getFaceCount()) * 3);
+    for (size_t f = 0; f < data.getFaceCount(); ++f) {
+        const std::uint32_t begin = data.faceOffsets[f];
+        const std::uint32_t end = data.faceOffsets[f + 1];
+        for (std::uint32_t k = begin + 1; k + 1 < end; ++k) {
+            indices.push_back(static_cast<unsigned int>(data.faceVertices[begin]));
+            indices.push_back(static_cast<unsigned int>(data.faceVertices[k]));
+            indices.push_back(static_cast<unsigned int>(data.faceVertices[k + 1]));
         }
     }
 
-    vertices = std::move(tempVertices);
+    // vn ǰǵ, ת𶥵㷨(ͬһжʱȡһ)
+    if (!data.faceNormals.empty()) {
+        normals.assign(vertexCount, QVector3D(0.0f, 0.0f, 0.0f));
+        for (size_t k = 0; k < data.faceNormals.size(); ++k) {
+            const std::int32_t n = data.faceNormals[k];
+            if (n < 0) continue;
+            normals[data.faceVertices[k]] = QVector3D(data.normals[3 * n], data.normals[3 * n + 1], data.normals[3 * n + 2]);
+        }
+    }
 
+    reorderTriangles();
     std::cout << "Loaded " << vertices.size() << " vertices and "
               << indices.size() << " indices" << std::endl;
 
     return !vertices.empty() && !indices.empty();
-}
\ No newline at end of file
+}